@@ -37,6 +37,13 @@ if (MYSQL_UNIX_SOCK_ADDR)
   add_definitions(-DPHP_MYSQL_UNIX_SOCK_ADDR="${MYSQL_UNIX_SOCK_ADDR}")
 endif()
 
+set(CMAKE_REQUIRED_LIBRARIES "${MYSQL_LIB}")
+CHECK_FUNCTION_EXISTS("mysql_real_query_start" HAVE_MYSQL_NONBLOCKING)
+if (HAVE_MYSQL_NONBLOCKING)
+	add_definitions(-DHAVE_MYSQL_NONBLOCKING=1)
+endif()
+set(CMAKE_REQUIRED_LIBRARIES)
+
 # libmemcached checks
 find_package(Libmemcached REQUIRED)
 if (LIBMEMCACHED_VERSION VERSION_LESS "0.39")
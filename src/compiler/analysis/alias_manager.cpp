@@ -2416,8 +2416,13 @@ void AliasManager::gatherInfo(AnalysisResultConstPtr ar, MethodStatementPtr m) {
   }
 
   if (m_inlineAsExpr) {
-    if (!Option::AutoInline ||
-        cost > Option::AutoInline ||
+    int maxCost = Option::AutoInline;
+    if (maxCost && Option::PgoInlineCost > maxCost &&
+        Option::PgoHotFunctions.count(func->getOriginalFullName())) {
+      maxCost = Option::PgoInlineCost;
+    }
+    if (!maxCost ||
+        cost > maxCost ||
         func->isVariableArgument() ||
         m_variables->getAttribute(VariableTable::ContainsDynamicVariable) ||
         m_variables->getAttribute(VariableTable::ContainsExtract) ||
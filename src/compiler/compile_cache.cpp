@@ -0,0 +1,180 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <compiler/compile_cache.h>
+#include <runtime/base/zend/zend_string.h>
+#include <util/logger.h>
+#include <util/util.h>
+#include <dirent.h>
+
+using namespace HPHP;
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * File format, one record per line:
+ *
+ *   options <hash>
+ *   file <hash> <name>
+ *   output <hash> <name>
+ */
+
+string CompileCache::HashString(const string &s) {
+  int len;
+  char *md5 = string_md5(s.data(), s.size(), false, len);
+  string hash(md5, len);
+  free(md5);
+  return hash;
+}
+
+string CompileCache::HashFile(const string &fullPath) {
+  ifstream f(fullPath.c_str(), ios::in | ios::binary);
+  if (!f) return "";
+  ostringstream content;
+  content << f.rdbuf();
+  return HashString(content.str());
+}
+
+string CompileCache::HashDir(const string &dir) {
+  DIR *dp = opendir(dir.c_str());
+  if (!dp) return "";
+  vector<string> names;
+  while (dirent *de = readdir(dp)) {
+    string path = dir + "/" + de->d_name;
+    struct stat sb;
+    if (stat(path.c_str(), &sb) == 0 && S_ISREG(sb.st_mode)) {
+      names.push_back(de->d_name);
+    }
+  }
+  closedir(dp);
+
+  // readdir() order differs between copies of the same directory
+  sort(names.begin(), names.end());
+  ostringstream out;
+  for (unsigned int i = 0; i < names.size(); i++) {
+    out << names[i] << " " << HashFile(dir + "/" + names[i]) << "\n";
+  }
+  return HashString(out.str());
+}
+
+bool CompileCache::load(const string &filename) {
+  ifstream f(filename.c_str());
+  if (!f) return false;
+
+  Lock lock(m_mutex);
+  m_files.clear();
+  m_outputs.clear();
+  string line;
+  while (getline(f, line)) {
+    size_t pos = line.find(' ');
+    if (pos == string::npos) continue;
+    string kind = line.substr(0, pos);
+    string rest = line.substr(pos + 1);
+    if (kind == "options") {
+      m_optionsHash = rest;
+      continue;
+    }
+    pos = rest.find(' ');
+    if (pos == string::npos) continue;
+    if (kind == "file") {
+      m_files[rest.substr(pos + 1)] = rest.substr(0, pos);
+    } else if (kind == "output") {
+      m_outputs[rest.substr(pos + 1)] = rest.substr(0, pos);
+    }
+  }
+  return true;
+}
+
+bool CompileCache::save(const string &filename) const {
+  string tmp = filename + ".tmp";
+  {
+    ofstream f(tmp.c_str());
+    if (!f) {
+      Logger::Error("Unable to write compile cache %s", tmp.c_str());
+      return false;
+    }
+    Lock lock(m_mutex);
+    f << "options " << m_optionsHash << "\n";
+    for (HashMap::const_iterator iter = m_files.begin();
+         iter != m_files.end(); ++iter) {
+      f << "file " << iter->second << " " << iter->first << "\n";
+    }
+    for (HashMap::const_iterator iter = m_outputs.begin();
+         iter != m_outputs.end(); ++iter) {
+      f << "output " << iter->second << " " << iter->first << "\n";
+    }
+    if (!f) return false;
+  }
+  // so an interrupted save never leaves a truncated cache behind
+  return rename(tmp.c_str(), filename.c_str()) == 0;
+}
+
+void CompileCache::setFileHash(const string &name, const string &hash) {
+  Lock lock(m_mutex);
+  m_files[name] = hash;
+}
+
+void CompileCache::getFiles(vector<string> &names) const {
+  Lock lock(m_mutex);
+  for (HashMap::const_iterator iter = m_files.begin();
+       iter != m_files.end(); ++iter) {
+    names.push_back(iter->first);
+  }
+}
+
+bool CompileCache::hasFile(const string &name) const {
+  Lock lock(m_mutex);
+  return m_files.find(name) != m_files.end();
+}
+
+void CompileCache::setOutputHash(const string &name, const string &hash) {
+  Lock lock(m_mutex);
+  m_outputs[name] = hash;
+}
+
+bool CompileCache::isUpToDate(const CompileCache &current) const {
+  Lock lock1(m_mutex);
+  Lock lock2(current.m_mutex);
+  if (m_optionsHash.empty() || m_optionsHash != current.m_optionsHash ||
+      m_files.size() != current.m_files.size()) {
+    return false;
+  }
+  for (HashMap::const_iterator iter = current.m_files.begin();
+       iter != current.m_files.end(); ++iter) {
+    HashMap::const_iterator old = m_files.find(iter->first);
+    if (old == m_files.end() || iter->second.empty() ||
+        old->second != iter->second) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CompileCache::hasOutputs(const string &outputDir) const {
+  Lock lock(m_mutex);
+  if (m_outputs.empty()) return false;
+  for (HashMap::const_iterator iter = m_outputs.begin();
+       iter != m_outputs.end(); ++iter) {
+    if (HashFile(outputDir + "/" + iter->first) != iter->second) {
+      Logger::Verbose("output %s is missing or changed", iter->first.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
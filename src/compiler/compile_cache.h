@@ -0,0 +1,87 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __COMPILE_CACHE_H__
+#define __COMPILE_CACHE_H__
+
+#include <compiler/hphp.h>
+#include <util/mutex.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+DECLARE_BOOST_TYPES(CompileCache);
+
+/**
+ * Persistent record of a compilation: the content hash of every parsed file,
+ * a hash of whatever else affects the output (options, config files, the
+ * compiler itself), and the content hash of every file it generated.
+ * Comparing a new run's record against the saved one tells whether the
+ * saved run's outputs can be used as they are.
+ */
+class CompileCache {
+public:
+  /**
+   * Hex MD5s. HashFile() returns empty string if the file can't be read.
+   * HashDir() covers the names and contents of the regular files directly
+   * in a directory, and returns empty string if it can't be read.
+   */
+  static std::string HashString(const std::string &s);
+  static std::string HashFile(const std::string &fullPath);
+  static std::string HashDir(const std::string &dir);
+
+  bool load(const std::string &filename);
+  bool save(const std::string &filename) const;
+
+  void setOptionsHash(const std::string &hash) { m_optionsHash = hash;}
+  const std::string &getOptionsHash() const { return m_optionsHash;}
+
+  /**
+   * Thread-safe, so parser threads can record files as they parse them.
+   */
+  void setFileHash(const std::string &name, const std::string &hash);
+  void getFiles(std::vector<std::string> &names) const;
+  bool hasFile(const std::string &name) const;
+
+  /**
+   * Generated files, named relative to the output directory.
+   */
+  void setOutputHash(const std::string &name, const std::string &hash);
+
+  /**
+   * Whether "current" has the same options and the same files with the same
+   * contents, so that a new compilation would produce the same output.
+   */
+  bool isUpToDate(const CompileCache &current) const;
+
+  /**
+   * Whether every file this compilation generated is still in outputDir
+   * with the same contents. False if none were recorded.
+   */
+  bool hasOutputs(const std::string &outputDir) const;
+
+private:
+  typedef std::map<std::string, std::string> HashMap;
+
+  mutable Mutex m_mutex;
+  std::string m_optionsHash;
+  HashMap m_files;
+  HashMap m_outputs;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+#endif // __COMPILE_CACHE_H__
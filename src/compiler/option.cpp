@@ -24,6 +24,7 @@
 #include <util/db_query.h>
 #include <util/util.h>
 #include <util/process.h>
+#include <util/pgo_profile.h>
 #include <boost/algorithm/string/trim.hpp>
 #include <runtime/base/preg.h>
 
@@ -173,6 +174,11 @@ std::string Option::RTTIDirectory;
 bool Option::GenRTTIProfileData = false;
 bool Option::UseRTTIProfileData = false;
 
+std::string Option::PgoProfileFile;
+double Option::PgoHotCoverage = 0.9;
+int Option::PgoInlineCost = 0;
+std::set<std::string> Option::PgoHotFunctions;
+
 bool Option::GenerateCPPMacros = true;
 bool Option::GenerateCPPMain = false;
 bool Option::GenerateCPPComments = true;
@@ -414,6 +420,9 @@ void Option::Load(Hdf &config) {
   }
 
   RTTIOutputFile = config["RTTIOutputFile"].getString();
+  PgoProfileFile = config["PgoProfile"].getString();
+  PgoHotCoverage = config["PgoHotCoverage"].getDouble(0.9);
+  PgoInlineCost = config["PgoInlineCost"].getInt32(0);
   EnableEval = (EvalLevel)config["EnableEval"].getByte(0);
   AllDynamic = config["AllDynamic"].getBool(true);
   AllVolatile = config["AllVolatile"].getBool();
@@ -460,6 +469,27 @@ void Option::Load() {
   OnLoad();
 }
 
+bool Option::LoadPgoProfile() {
+  PgoProfile profile;
+  if (!profile.load(PgoProfileFile.c_str())) return false;
+
+  vector<string> hot;
+  profile.getHotFunctions(PgoHotCoverage, hot);
+  for (unsigned int i = 0; i < hot.size(); i++) {
+    PgoHotFunctions.insert(hot[i]);
+    // Numbered so that ld --sort-section=name lays them out hottest first;
+    // sections given in FunctionSections take precedence.
+    if (FunctionSections.find(hot[i]) == FunctionSections.end()) {
+      char section[32];
+      snprintf(section, sizeof(section), "hot.%05u", i);
+      FunctionSections[hot[i]] = section;
+    }
+  }
+  Logger::Info("%d hot functions in %lld samples from %s",
+               (int)hot.size(), profile.getSamples(), PgoProfileFile.c_str());
+  return true;
+}
+
 void Option::OnLoad() {
   // all lambda functions are dynamic automatically
   DynamicFunctionPrefixes.push_back(LambdaPrefix);
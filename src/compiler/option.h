@@ -36,6 +36,11 @@ public:
   static void Load(Hdf &config);
   static void Load(); // load default options
 
+  /**
+   * Reads PgoProfileFile into PgoHotFunctions and FunctionSections.
+   */
+  static bool LoadPgoProfile();
+
   /**
    * Directories to add to a package.
    */
@@ -135,6 +140,17 @@ public:
   static bool GenRTTIProfileData;
   static bool UseRTTIProfileData;
 
+  /**
+   * Profile sampled from production requests (the server's /prof-pgo), for
+   * a profile-guided build. The functions running in PgoHotCoverage of the
+   * samples go in their own .text.hot.* sections, hottest first, and may be
+   * inlined when they cost up to PgoInlineCost rather than AutoInline.
+   */
+  static std::string PgoProfileFile;
+  static double PgoHotCoverage;
+  static int PgoInlineCost;
+  static std::set<std::string> PgoHotFunctions;
+
   /**
    * Generate array_createN service routines
    */
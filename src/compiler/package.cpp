@@ -20,6 +20,7 @@
 #include <unistd.h>
 #include <dirent.h>
 #include <compiler/analysis/analysis_result.h>
+#include <compiler/compile_cache.h>
 #include <compiler/parser/parser.h>
 #include <compiler/analysis/symbol_table.h>
 #include <compiler/analysis/variable_table.h>
@@ -316,6 +317,10 @@ bool Package::parseImpl(const char *fileName) {
     return false;
   }
 
+  if (m_compileCache) {
+    m_compileCache->setFileHash(fileName, CompileCache::HashFile(fullPath));
+  }
+
   m_lineCount += lines;
   struct stat fst;
   stat(fullPath.c_str(), &fst);
@@ -27,6 +27,7 @@ namespace HPHP {
 
 DECLARE_BOOST_TYPES(ServerData);
 DECLARE_BOOST_TYPES(AnalysisResult);
+DECLARE_BOOST_TYPES(CompileCache);
 
 /**
  * A package contains a list of directories and files that will be parsed
@@ -67,6 +68,15 @@ public:
   const std::string& getRoot() const { return m_root;}
   FileCachePtr getFileCache();
 
+  const std::set<std::string> &getFilesToParse() const {
+    return m_filesToParse;
+  }
+
+  /**
+   * When set, content hashes of parsed files are recorded into the cache.
+   */
+  void setCompileCache(CompileCachePtr cache) { m_compileCache = cache;}
+
 private:
   std::string m_root;
   bool m_bShortTags;
@@ -85,6 +95,8 @@ private:
   std::set<std::string> m_staticDirectories;
   std::set<std::string> m_extraStaticFiles;
   std::map<std::string,std::string> m_discoveredStaticFiles;
+
+  CompileCachePtr m_compileCache;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
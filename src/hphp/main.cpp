@@ -20,7 +20,9 @@
 #include <boost/program_options/parsers.hpp>
 
 #include <compiler/package.h>
+#include <compiler/compile_cache.h>
 #include <compiler/analysis/analysis_result.h>
+#include <compiler/analysis/file_scope.h>
 #include <compiler/analysis/alias_manager.h>
 #include <compiler/analysis/code_error.h>
 #include <compiler/analysis/type.h>
@@ -92,7 +94,9 @@ struct ProgramOptions {
   int clusterCount;
   int optimizeLevel;
   string filecache;
+  string compileCache;
   string rttiDirectory;
+  string pgoProfile;
   string javaRoot;
   bool generateFFI;
   bool dump;
@@ -137,12 +141,16 @@ int lintTarget(const ProgramOptions &po);
 int analyzeTarget(const ProgramOptions &po, AnalysisResultPtr ar);
 int phpTarget(const ProgramOptions &po, AnalysisResultPtr ar);
 int cppTarget(const ProgramOptions &po, AnalysisResultPtr ar,
-              AsyncFileCacheSaver &fcThread, bool allowSys = true);
+              AsyncFileCacheSaver &fcThread, bool allowSys = true,
+              vector<string> *outputs = NULL);
 int runTargetCheck(const ProgramOptions &po, AnalysisResultPtr ar,
                    AsyncFileCacheSaver &fcThread);
 int buildTarget(const ProgramOptions &po);
 int runTarget(const ProgramOptions &po);
 int generateSepExtCpp(const ProgramOptions &po, AnalysisResultPtr ar);
+string hashCompileOptions(const ProgramOptions &po);
+bool isCompileCacheUpToDate(const Package &package, CompileCachePtr oldCache,
+                            CompileCachePtr newCache);
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -313,8 +321,16 @@ int prepareOptions(ProgramOptions &po, int argc, char **argv) {
     ("file-cache",
      value<string>(&po.filecache),
      "if specified, generate a static file cache with this file name")
+    ("compile-cache",
+     value<string>(&po.compileCache),
+     "if specified, remember source and output file hashes in this file, "
+     "so a cpp target with no changes since last time is skipped as long as "
+     "its outputs are still there")
     ("rtti-directory", value<string>(&po.rttiDirectory)->default_value(""),
      "the directory of rtti profiling data")
+    ("pgo-profile", value<string>(&po.pgoProfile)->default_value(""),
+     "a profile sampled from a server running the first build, to lay out "
+     "and inline hot functions in this one")
     ("java-root",
      value<string>(&po.javaRoot)->default_value("php"),
      "the root package of generated Java FFI classes")
@@ -441,6 +457,13 @@ cout << "Compiler: " << COMPILER_ID << "\n";
 
   if (po.dump) Option::DumpAst = true;
 
+  if (!po.pgoProfile.empty()) Option::PgoProfileFile = po.pgoProfile;
+  if (!Option::PgoProfileFile.empty() && !Option::LoadPgoProfile()) {
+    Logger::Error("Unable to read profile %s",
+                  Option::PgoProfileFile.c_str());
+    return 1;
+  }
+
   if (po.inputDir.empty()) {
     po.inputDir = '.';
   }
@@ -552,6 +575,7 @@ int process(const ProgramOptions &po) {
 
   Timer timer(Timer::WallTime);
   AnalysisResultPtr ar;
+  CompileCachePtr oldCache, newCache;
 
   // prepare a package
   Package package(po.inputDir.c_str());
@@ -615,6 +639,19 @@ int process(const ProgramOptions &po) {
         }
       }
     }
+    if (!po.compileCache.empty() && po.target == "cpp") {
+      oldCache = CompileCachePtr(new CompileCache());
+      newCache = CompileCachePtr(new CompileCache());
+      newCache->setOptionsHash(hashCompileOptions(po));
+      // static files are not hashed, so a file cache has to be rebuilt
+      if (oldCache->load(po.compileCache) && po.filecache.empty() &&
+          isCompileCacheUpToDate(package, oldCache, newCache) &&
+          oldCache->hasOutputs(po.outputDir)) {
+        Logger::Info("no changes since last compilation, skipping");
+        return 0;
+      }
+      package.setCompileCache(newCache);
+    }
     if (po.target != "filecache") {
       {
         if (!package.parse(!po.force)) {
@@ -641,7 +678,16 @@ int process(const ProgramOptions &po) {
   } else if (po.target == "php") {
     ret = phpTarget(po, ar);
   } else if (po.target == "cpp") {
-    ret = cppTarget(po, ar, fileCacheThread);
+    vector<string> outputs;
+    ret = cppTarget(po, ar, fileCacheThread, true,
+                    newCache ? &outputs : NULL);
+    if (ret == 0 && newCache) {
+      for (unsigned int i = 0; i < outputs.size(); i++) {
+        newCache->setOutputHash(outputs[i], CompileCache::HashFile(
+                                  po.outputDir + "/" + outputs[i]));
+      }
+      newCache->save(po.compileCache);
+    }
   } else if (po.target == "run") {
     ret = runTargetCheck(po, ar, fileCacheThread);
   } else if (po.target == "filecache") {
@@ -810,8 +856,26 @@ int phpTarget(const ProgramOptions &po, AnalysisResultPtr ar) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Files under dir, relative to it, that were written at or after "since".
+ */
+static void findOutputs(vector<string> &outputs, const string &dir,
+                        time_t since) {
+  string root = dir;
+  if (root.empty() || root[root.size() - 1] != '/') root += '/';
+  vector<string> files;
+  Util::find(files, root, "", false);
+  for (unsigned int i = 0; i < files.size(); i++) {
+    struct stat sb;
+    if (stat(files[i].c_str(), &sb) == 0 && sb.st_mtime >= since) {
+      outputs.push_back(files[i].substr(root.size()));
+    }
+  }
+}
+
 int cppTarget(const ProgramOptions &po, AnalysisResultPtr ar,
-              AsyncFileCacheSaver &fcThread, bool allowSys /* = true */) {
+              AsyncFileCacheSaver &fcThread, bool allowSys /* = true */,
+              vector<string> *outputs /* = NULL */) {
   int ret = 0;
   int clusterCount = po.clusterCount;
   // format
@@ -848,14 +912,18 @@ int cppTarget(const ProgramOptions &po, AnalysisResultPtr ar,
   {
     Timer timer(Timer::WallTime, "creating CPP files");
     if (po.syncDir.empty()) {
+      time_t start = time(NULL);
       ar->setOutputPath(po.outputDir);
       ar->outputAllCPP(format, clusterCount, NULL);
+      // anything else in the output directory is left from earlier builds
+      if (outputs) findOutputs(*outputs, po.outputDir, start);
     } else {
       ar->setOutputPath(po.syncDir);
       ar->outputAllCPP(format, clusterCount, &po.outputDir);
       if (!po.filecache.empty()) {
         fcThread.waitForEnd();
       }
+      if (outputs) findOutputs(*outputs, po.syncDir, 0);
       Util::syncdir(po.outputDir, po.syncDir);
       boost::filesystem::remove_all(po.syncDir);
     }
@@ -873,6 +941,94 @@ int generateSepExtCpp(const ProgramOptions &po, AnalysisResultPtr ar) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static void hashStrings(ostream &out, const vector<string> &strs) {
+  out << strs.size() << "\n";
+  for (unsigned int i = 0; i < strs.size(); i++) {
+    out << strs[i] << "\n";
+  }
+}
+
+/**
+ * Everything besides the input files that may change the generated code:
+ * options that select, analyze or emit code, and the contents of the files
+ * they name.
+ */
+string hashCompileOptions(const ProgramOptions &po) {
+  ostringstream out;
+  out << po.target << "\n" << po.format << "\n" << po.outputDir << "\n"
+      << po.outputFile << "\n" << po.configDir << "\n"
+      << po.inputDir << "\n" << po.inputList << "\n"
+      << po.parseOnDemand << "\n" << po.program << "\n"
+      << po.programArgs << "\n" << po.branch << "\n" << po.revision << "\n"
+      << po.genStats << "\n" << po.noTypeInference << "\n"
+      << po.noMinInclude << "\n" << po.noMetaInfo << "\n"
+      << po.clusterCount << "\n" << po.optimizeLevel << "\n"
+      << po.filecache << "\n" << po.rttiDirectory << "\n"
+      << po.javaRoot << "\n" << po.generateFFI << "\n"
+      << po.fl_annotate << "\n" << po.optimizations << "\n"
+      << po.ppp << "\n";
+  for (unsigned int i = 0; i < po.config.size(); i++) {
+    out << CompileCache::HashFile(po.config[i]) << "\n";
+  }
+  hashStrings(out, po.confStrings);
+  hashStrings(out, po.inputs);
+  hashStrings(out, po.includePaths);
+  hashStrings(out, po.modules);
+  hashStrings(out, po.excludeDirs);
+  hashStrings(out, po.excludeFiles);
+  hashStrings(out, po.excludePatterns);
+  hashStrings(out, po.excludeStaticDirs);
+  hashStrings(out, po.excludeStaticFiles);
+  hashStrings(out, po.excludeStaticPatterns);
+  hashStrings(out, po.fmodules);
+  hashStrings(out, po.ffiles);
+  hashStrings(out, po.cfiles);
+  hashStrings(out, po.cmodules);
+  hashStrings(out, po.parseOnDemandDirs);
+  if (!po.inputList.empty()) {
+    out << CompileCache::HashFile(po.inputList) << "\n";
+  }
+
+  // RTTI profiles decide which functions get cloned and specialized
+  if (!po.rttiDirectory.empty()) {
+    out << CompileCache::HashFile(Option::RTTIOutputFile) << "\n"
+        << CompileCache::HashDir(po.rttiDirectory) << "\n";
+  }
+
+  // PGO profiles decide which functions get inlined and placed as hot
+  out << po.pgoProfile << "\n" << Option::PgoProfileFile << "\n"
+      << Option::PgoHotCoverage << "\n" << Option::PgoInlineCost << "\n";
+  if (!Option::PgoProfileFile.empty()) {
+    out << CompileCache::HashFile(Option::PgoProfileFile) << "\n";
+  }
+
+  // a rebuilt compiler may generate different code
+  struct stat sb;
+  if (stat("/proc/self/exe", &sb) == 0) {
+    out << sb.st_size << " " << sb.st_mtime << "\n";
+  }
+  return CompileCache::HashString(out.str());
+}
+
+bool isCompileCacheUpToDate(const Package &package, CompileCachePtr oldCache,
+                            CompileCachePtr newCache) {
+  // Files parsed on demand last time are only known from the old cache.
+  vector<string> names;
+  oldCache->getFiles(names);
+  const set<string> &toParse = package.getFilesToParse();
+  names.insert(names.end(), toParse.begin(), toParse.end());
+
+  CompileCache current;
+  current.setOptionsHash(newCache->getOptionsHash());
+  const string &root = package.getRoot();
+  for (unsigned int i = 0; i < names.size(); i++) {
+    const string &name = names[i];
+    string fullPath = name[0] == '/' ? name : root + name;
+    current.setFileHash(name, CompileCache::HashFile(fullPath));
+  }
+  return oldCache->isUpToDate(current);
+}
+
 int buildTarget(const ProgramOptions &po) {
   const char *HPHP_HOME = getenv("HPHP_HOME");
   if (!HPHP_HOME || !*HPHP_HOME) {
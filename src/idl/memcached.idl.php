@@ -163,6 +163,12 @@ DefineConstant(
     'type'   => Int32,
   ));
 
+DefineConstant(
+  array(
+    'name'   => "SERIALIZER_BINARY",
+    'type'   => Int32,
+  ));
+
 DefineConstant(
   array(
     'name'   => "OPT_PREFIX_KEY",
@@ -41,6 +41,7 @@ ArrayData *ArrayData::GetScalarArray(ArrayData *arr) {
   string key(s.data(), s.size());
   ArrayDataMap::accessor acc;
   if (s_arrayDataMap.insert(acc, key)) {
+    MemoryManager::MaskArena mask;
     ArrayData *ad = arr->nonSmartCopy();
     ad->setStatic();
     ad->onSetEvalScalar();
@@ -294,6 +294,17 @@ class ArrayData : public Countable {
    */
   virtual void renumber() {}
 
+  /**
+   * Relink the elements at these positions, which are all of this array's
+   * positions, into this order, and re-index all keys from 0 if renumber is
+   * true. Only called on arrays that are not shared. Returns false if this
+   * kind of array can't do it in place, so that the caller has to build a
+   * new array instead.
+   */
+  virtual bool reorder(const std::vector<ssize_t> &order, bool renumber) {
+    return false;
+  }
+
   /**
    * When an array data is set static, some calculated data members need to
    * be initialized, for example, Map::getKeyVector(). More importantly, all
@@ -108,12 +108,25 @@ static inline bool isIntegerKey(CVarRef v) {
   return false;
 }
 
+inline TypedValue* HphpArray::valueAt(ssize_t pos) const {
+  ASSERT(pos != ArrayData::invalid_index && pos <= ssize_t(m_lastE));
+  if (m_packed) {
+    return &packedData()[pos];
+  }
+  Elm* e = &data2Elms(m_data)[pos];
+  ASSERT(e->data.m_type != KindOfTombstone);
+  if (LIKELY(e->data.m_type != KindOfIndirect)) {
+    return &e->data;
+  }
+  return e->data.m_data.ptv;
+}
+
 //=============================================================================
 // Construction/destruction.
 
 HphpArray::HphpArray(uint nSize /* = 0 */)
   : m_data(NULL), m_nextKI(0), m_nElms(0), m_hLoad(0), m_lastE(ElmIndEmpty),
-    m_linear(false), m_siPastEnd(false),
+    m_linear(false), m_siPastEnd(false), m_packed(true),
 #ifndef USE_JEMALLOC
     m_dataPad(0),
 #endif
@@ -124,12 +137,8 @@ HphpArray::HphpArray(uint nSize /* = 0 */)
   }
 #endif
   m_tableMask = computeMaskFromNumElms(nSize);
-  size_t tableSize = computeTableSize(m_tableMask);
-  size_t maxElms = computeMaxElms(m_tableMask);
-  reallocData(maxElms, tableSize);
-  Elm* elms = data2Elms(m_data);
-  m_hash = elms2Hash(elms, maxElms);
-  initHash(m_hash, tableSize);
+  reallocPacked(computeMaxElms(m_tableMask));
+  m_hash = NULL;
   m_pos = ArrayData::invalid_index;
 }
 
@@ -138,8 +147,18 @@ HphpArray::HphpArray(int,int) {
 }
 
 HphpArray::~HphpArray() {
-  Elm* elms = data2Elms(m_data);
   ssize_t lastE = (ssize_t)m_lastE;
+  if (m_packed) {
+    TypedValue* tvs = packedData();
+    for (ssize_t pos = 0; pos <= lastE; ++pos) {
+      tvRefcountedDecRef(&tvs[pos]);
+    }
+    if (m_data != NULL && !m_linear) {
+      smart_free(getBlock());
+    }
+    return;
+  }
+  Elm* elms = data2Elms(m_data);
   for (ssize_t /*ElmInd*/ pos = 0; pos <= lastE; ++pos) {
     Elm* e = &elms[pos];
     ASSERT(e->data.m_type != KindOfIndirect);
@@ -155,7 +174,7 @@ HphpArray::~HphpArray() {
   }
   if (m_data != NULL) {
     if (!m_linear) {
-      free(getBlock());
+      smart_free(getBlock());
     }
   }
 }
@@ -193,12 +212,29 @@ void HphpArray::dumpDebugInfo() const {
   fprintf(stderr, "m_data = %p\n"
          "elms   = %p\tm_hash = %p\n"
          "m_tableMask = %u\tm_nElms = %d\tm_hLoad = %d\n"
-         "m_nextKI = %lld\t\tm_lastE = %d\tm_pos = %zd\tm_linear = %s\n",
+         "m_nextKI = %lld\t\tm_lastE = %d\tm_pos = %zd\tm_linear = %s\t"
+         "m_packed = %s\n",
          m_data, elms, m_hash,
          m_tableMask, m_nElms, m_hLoad, m_nextKI, m_lastE, m_pos,
-         m_linear ? "true" : "false");
+         m_linear ? "true" : "false", m_packed ? "true" : "false");
   fprintf(stderr, "Elements:\n");
   ssize_t lastE = m_lastE;
+  if (m_packed) {
+    TypedValue* tvs = packedData();
+    for (ssize_t i = 0; i <= lastE; ++i) {
+      Variant v = tvAsVariant(&tvs[i]);
+      VariableSerializer vs(VariableSerializer::DebugDump);
+      String s = vs.serialize(v, true);
+      fprintf(stderr, "  [%3d] data=(%.*s)\n", int(i), s.size()-1, s.data());
+    }
+    if (size_t(m_lastE+1) < maxElms) {
+      fprintf(stderr, "  [%3d..%-3zd] <uninitialized>\n", m_lastE+1,
+              maxElms-1);
+    }
+    fprintf(stderr,
+            "---------------------------------------------------------------\n");
+    return;
+  }
   for (ssize_t /*ElmInd*/ i = 0; i <= lastE; ++i) {
     if (elms[i].data.m_type < KindOfTombstone) {
       Variant v = tvAsVariant(&elms[i].data);
@@ -253,6 +289,9 @@ inline /*ElmInd*/ ssize_t HphpArray::nextElm(Elm* elms,
                                              /*ElmInd*/ ssize_t ei) const {
   ASSERT(ei >= -1);
   ssize_t lastE = m_lastE;
+  if (m_packed) {
+    return ei < lastE ? ei + 1 : (ssize_t)ElmIndEmpty;
+  }
   while (ei < lastE) {
     ++ei;
     if (elms[ei].data.m_type < KindOfTombstone) {
@@ -269,6 +308,9 @@ inline /*ElmInd*/ ssize_t HphpArray::nextElm(Elm* elms,
 inline /*ElmInd*/ ssize_t HphpArray::prevElm(Elm* elms,
                                              /*ElmInd*/ ssize_t ei) const {
   ASSERT(ei <= (ssize_t)(m_lastE+1));
+  if (m_packed) {
+    return ei > 0 ? ei - 1 : (ssize_t)ElmIndEmpty;
+  }
   while (ei > 0) {
     --ei;
     if (elms[ei].data.m_type < KindOfTombstone) {
@@ -299,6 +341,9 @@ ssize_t HphpArray::iter_advance(ssize_t pos) const {
   // Since lastE is always less than 2^32-1 and invalid_index == -1,
   // we can save a check by doing an unsigned comparison instead
   // of a signed comparison.
+  if (m_packed) {
+    return size_t(pos) < size_t(lastE) ? pos+1 : ArrayData::invalid_index;
+  }
   if (size_t(pos) < size_t(lastE) &&
       elms[pos+1].data.m_type < KindOfTombstone) {
     return pos+1;
@@ -335,6 +380,9 @@ ssize_t HphpArray::iter_rewind(ssize_t pos) const {
 
 Variant HphpArray::getKey(ssize_t pos) const {
   ASSERT(pos != ArrayData::invalid_index);
+  if (m_packed) {
+    return (int64)pos;
+  }
   Elm* elms = data2Elms(m_data);
   Elm* e = &elms[/*(ElmInd)*/pos];
   ASSERT(e->data.m_type != KindOfTombstone);
@@ -345,31 +393,15 @@ Variant HphpArray::getKey(ssize_t pos) const {
 }
 
 Variant HphpArray::getValue(ssize_t pos) const {
-  ASSERT(pos != ArrayData::invalid_index);
-  Elm* elms = data2Elms(m_data);
-  Elm* e = &elms[/*(ElmInd)*/pos];
-  ASSERT(e->data.m_type != KindOfTombstone);
-  if (LIKELY(e->data.m_type != KindOfIndirect)) {
-    return tvAsCVarRef(&e->data);
-  } else {
-    return tvAsCVarRef(e->data.m_data.ptv);
-  }
+  return tvAsCVarRef(valueAt(pos));
 }
 
 CVarRef HphpArray::getValueRef(ssize_t pos) const {
-  ASSERT(pos != ArrayData::invalid_index);
-  Elm* elms = data2Elms(m_data);
-  Elm* e = &elms[/*(ElmInd)*/pos];
-  ASSERT(e->data.m_type != KindOfTombstone);
-  if (LIKELY(e->data.m_type != KindOfIndirect)) {
-    return tvAsCVarRef(&e->data);
-  } else {
-    return tvAsCVarRef(e->data.m_data.ptv);
-  }
+  return tvAsCVarRef(valueAt(pos));
 }
 
 bool HphpArray::isVectorData() const {
-  if (m_nElms == 0) {
+  if (m_packed || m_nElms == 0) {
     return true;
   }
   Elm* elms = data2Elms(m_data);
@@ -395,12 +427,7 @@ Variant HphpArray::reset() {
   Elm* elms = data2Elms(m_data);
   m_pos = ssize_t(nextElm(elms, ElmIndEmpty));
   if (m_pos != ArrayData::invalid_index) {
-    Elm* e = &elms[(ElmInd)m_pos];
-    if (LIKELY(e->data.m_type != KindOfIndirect)) {
-      return tvAsCVarRef(&e->data);
-    } else {
-      return tvAsCVarRef(e->data.m_data.ptv);
-    }
+    return tvAsCVarRef(valueAt(m_pos));
   }
   m_pos = ArrayData::invalid_index;
   return false;
@@ -411,12 +438,7 @@ Variant HphpArray::prev() {
     Elm* elms = data2Elms(m_data);
     m_pos = prevElm(elms, m_pos);
     if (m_pos != ArrayData::invalid_index) {
-      Elm* e = &elms[m_pos];
-      if (LIKELY(e->data.m_type != KindOfIndirect)) {
-        return tvAsCVarRef(&e->data);
-      } else {
-        return tvAsCVarRef(e->data.m_data.ptv);
-      }
+      return tvAsCVarRef(valueAt(m_pos));
     }
   }
   return false;
@@ -427,13 +449,7 @@ Variant HphpArray::next() {
     Elm* elms = data2Elms(m_data);
     m_pos = nextElm(elms, m_pos);
     if (m_pos != ArrayData::invalid_index) {
-      Elm* e = &elms[m_pos];
-      ASSERT(e->data.m_type != KindOfTombstone);
-      if (LIKELY(e->data.m_type != KindOfIndirect)) {
-        return tvAsCVarRef(&e->data);
-      } else {
-        return tvAsCVarRef(e->data.m_data.ptv);
-      }
+      return tvAsCVarRef(valueAt(m_pos));
     }
   }
   return false;
@@ -443,13 +459,7 @@ Variant HphpArray::end() {
   Elm* elms = data2Elms(m_data);
   m_pos = prevElm(elms, (ssize_t)(m_lastE+1));
   if (m_pos != ArrayData::invalid_index) {
-    Elm* e = &elms[m_pos];
-    ASSERT(e->data.m_type != KindOfTombstone);
-    if (LIKELY(e->data.m_type != KindOfIndirect)) {
-      return tvAsCVarRef(&e->data);
-    } else {
-      return tvAsCVarRef(e->data.m_data.ptv);
-    }
+    return tvAsCVarRef(valueAt(m_pos));
   }
   return false;
 }
@@ -457,6 +467,9 @@ Variant HphpArray::end() {
 Variant HphpArray::key() const {
   if (m_pos != ArrayData::invalid_index) {
     ASSERT(m_pos <= (ssize_t)m_lastE);
+    if (m_packed) {
+      return (int64)m_pos;
+    }
     Elm* elms = data2Elms(m_data);
     Elm* e = &elms[(ElmInd)m_pos];
     ASSERT(e->data.m_type != KindOfTombstone);
@@ -470,28 +483,14 @@ Variant HphpArray::key() const {
 
 Variant HphpArray::value(ssize_t& pos) const {
   if (pos != ArrayData::invalid_index) {
-    Elm* elms = data2Elms(m_data);
-    Elm* e = &elms[pos];
-    ASSERT(e->data.m_type != KindOfTombstone);
-    if (LIKELY(e->data.m_type != KindOfIndirect)) {
-      return tvAsCVarRef(&e->data);
-    } else {
-      return tvAsCVarRef(e->data.m_data.ptv);
-    }
+    return tvAsCVarRef(valueAt(pos));
   }
   return false;
 }
 
 Variant HphpArray::current() const {
   if (m_pos != ArrayData::invalid_index) {
-    Elm* elms = data2Elms(m_data);
-    Elm* e = &elms[m_pos];
-    ASSERT(e->data.m_type != KindOfTombstone);
-    if (LIKELY(e->data.m_type != KindOfIndirect)) {
-      return tvAsCVarRef(&e->data);
-    } else {
-      return tvAsCVarRef(e->data.m_data.ptv);
-    }
+    return tvAsCVarRef(valueAt(m_pos));
   }
   return false;
 }
@@ -584,11 +583,18 @@ static bool hitIntKey(const HphpArray::Elm* e, int64 ki) {
   }
 
 ssize_t /*ElmInd*/ HphpArray::find(int64 ki) const {
+  if (m_packed) {
+    // Unsigned comparison to reject negative keys as well.
+    return size_t(ki) < size_t(m_lastE+1) ? ssize_t(ki) : ssize_t(ElmIndEmpty);
+  }
   FIND_BODY(ki, hitIntKey(&elms[pos], ki));
 }
 
 ssize_t /*ElmInd*/ HphpArray::find(const char* k, int len,
                                    int64 prehash) const {
+  if (m_packed) {
+    return ssize_t(ElmIndEmpty);
+  }
   FIND_BODY(prehash, hitStringKey(&elms[pos], k, len, prehash));
 }
 #undef FIND_BODY
@@ -686,11 +692,8 @@ bool HphpArray::idxExists(ssize_t idx) const {
 CVarRef HphpArray::get(int64 k, bool error /* = false */) const {
   ElmInd pos = find(k);
   if (pos != ElmIndEmpty) {
-    Elm* elms = data2Elms(m_data);
-    Elm* e = &elms[pos];
     // Integer keys do not support KindOfIndirect
-    ASSERT(e->data.m_type != KindOfIndirect);
-    return tvAsCVarRef(&e->data);
+    return tvAsCVarRef(valueAt(pos));
   }
   if (error) {
     raise_notice("Undefined index: %lld", k);
@@ -748,11 +751,8 @@ CVarRef HphpArray::get(CVarRef k, bool error /* = false */) const {
   if (isIntegerKey(k)) {
     pos = find(k.toInt64());
     if (pos != ElmIndEmpty) {
-      Elm* elms = data2Elms(m_data);
-      Elm* e = &elms[pos];
       // Integer keys do not support KindOfIndirect
-      ASSERT(e->data.m_type != KindOfIndirect);
-      return tvAsCVarRef(&e->data);
+      return tvAsCVarRef(valueAt(pos));
     }
   } else {
     StringData* strkey = k.getStringData();
@@ -806,7 +806,9 @@ void HphpArray::load(CVarRef k, Variant& v) const {
     int64 prehash = strkey->hash();
     pos = find(strkey->data(), strkey->size(), prehash);
   }
-  if (pos != (ssize_t)ElmIndEmpty) {
+  if (pos != (ssize_t)ElmIndEmpty && m_packed) {
+    v.setWithRef(tvAsCVarRef(&packedData()[pos]));
+  } else if (pos != (ssize_t)ElmIndEmpty) {
     Elm* elms = data2Elms(m_data);
     Elm* e = &elms[pos];
     TypedValue* tv;
@@ -850,7 +852,7 @@ ssize_t HphpArray::getIndex(CVarRef k) const {
 // Append/insert/update.
 
 HphpArray::Elm* HphpArray::allocElm(ElmInd* ei) {
-  ASSERT(!m_linear);
+  ASSERT(!m_linear && !m_packed);
   ASSERT(!validElmInd(*ei));
   ASSERT(m_nElms != 0 || m_lastE == ElmIndEmpty);
 #ifdef PEDANTIC
@@ -884,43 +886,97 @@ HphpArray::Elm* HphpArray::allocElm(ElmInd* ei) {
   if (m_pos == ArrayData::invalid_index) {
     m_pos = ssize_t(m_lastE);
   }
-  // If there could be any strong iterators that are past the end, we need to
-  // do a pass and update these iterators to point to the newly added element.
   if (m_siPastEnd) {
-    m_siPastEnd = false;
-    int sz = m_strongIterators.size();
-    bool shouldWarn = false;
-    for (int i = 0; i < sz; ++i) {
-      if (m_strongIterators.get(i)->pos == ssize_t(ElmIndEmpty)) {
-        m_strongIterators.get(i)->pos = ssize_t(*ei);
-        shouldWarn = true;
-      }
-    }
-    if (shouldWarn) {
-      raise_warning("An element was added to an array inside foreach "
-                    "by reference when iterating over the last "
-                    "element. This may lead to unexpeced results.");
-    }
+    updateStrongIteratorsPastEnd(m_lastE);
   }
   return e;
 }
 
+TypedValue* HphpArray::allocPacked() {
+  ASSERT(!m_linear && m_packed);
+  ASSERT(m_nElms == m_lastE+1 && m_nextKI == m_lastE+1);
+  if (uint32(m_lastE)+1 == computeMaxElms(m_tableMask)) {
+    growPacked();
+  }
+  ++m_nElms;
+  ++m_lastE;
+  if (m_pos == ArrayData::invalid_index) {
+    m_pos = ssize_t(m_lastE);
+  }
+  if (m_siPastEnd) {
+    updateStrongIteratorsPastEnd(m_lastE);
+  }
+  return &packedData()[m_lastE];
+}
+
+// If there could be any strong iterators that are past the end, we need to
+// do a pass and update these iterators to point to the newly added element.
+void HphpArray::updateStrongIteratorsPastEnd(ElmInd ei) {
+  m_siPastEnd = false;
+  int sz = m_strongIterators.size();
+  bool shouldWarn = false;
+  for (int i = 0; i < sz; ++i) {
+    if (m_strongIterators.get(i)->pos == ssize_t(ElmIndEmpty)) {
+      m_strongIterators.get(i)->pos = ssize_t(ei);
+      shouldWarn = true;
+    }
+  }
+  if (shouldWarn) {
+    raise_warning("An element was added to an array inside foreach "
+                  "by reference when iterating over the last "
+                  "element. This may lead to unexpeced results.");
+  }
+}
+
 void HphpArray::reallocData(size_t maxElms, size_t tableSize) {
+  ASSERT(!m_packed);
+  reallocBlock((maxElms * sizeof(Elm)) + (tableSize * sizeof(ElmInd)),
+               (m_lastE+1) * sizeof(Elm));
+}
+
+void HphpArray::reallocPacked(size_t maxElms) {
+  ASSERT(m_packed);
+  reallocBlock(maxElms * sizeof(TypedValue),
+               (m_lastE+1) * sizeof(TypedValue));
+}
+
+// Resizes m_data to allocSize bytes, of which the first liveSize bytes are
+// in use and get moved along with it.
+void HphpArray::reallocBlock(size_t allocSize, size_t liveSize) {
 #ifdef USE_JEMALLOC
-  size_t allocSize = (maxElms * sizeof(Elm)) + (tableSize * sizeof(ElmInd));
+  // Arena blocks are aligned to their power-of-two size, which is at least
+  // sizeof(Elm), so they need no padding either.
+  MemoryManager* mm = MemoryManager::TheMemoryManager().getNoCheck();
+  RequestArena* arena = mm ? &mm->getArena() : NULL;
   if (m_data == NULL) {
     ASSERT(!m_linear);
+    if (arena && arena->active() &&
+        (m_data = arena->alloc(allocSize)) != NULL) {
+      return;
+    }
     if (allocm(&m_data, NULL, allocSize, ALLOCM_ALIGN(sizeof(Elm)))) {
       throw OutOfMemoryException(allocSize);
     }
   } else if (m_linear) {
     Elm* oldElms = data2Elms(m_data);
-    if (allocm(&m_data, NULL, allocSize, ALLOCM_ALIGN(sizeof(Elm)))) {
+    m_data = (arena && arena->active()) ? arena->alloc(allocSize) : NULL;
+    if (m_data == NULL &&
+        allocm(&m_data, NULL, allocSize, ALLOCM_ALIGN(sizeof(Elm)))) {
       throw OutOfMemoryException(allocSize);
     }
-    Elm* elms = data2Elms(m_data);
-    memcpy((void*)elms, (void*)oldElms, (m_lastE+1) * sizeof(Elm));
+    memcpy(m_data, (void*)oldElms, liveSize);
     m_linear = false;
+  } else if (arena && arena->owns(m_data)) {
+    void* data = arena->realloc(m_data, allocSize);
+    if (data == NULL) {
+      // arena exhausted
+      if (allocm(&data, NULL, allocSize, ALLOCM_ALIGN(sizeof(Elm)))) {
+        throw OutOfMemoryException(allocSize);
+      }
+      memcpy(data, m_data, arena->blockSize(m_data));
+      arena->free(m_data);
+    }
+    m_data = data;
   } else {
     if (rallocm(&m_data, NULL, allocSize, 0, ALLOCM_ALIGN(sizeof(Elm)))) {
       throw OutOfMemoryException(allocSize);
@@ -935,10 +991,8 @@ void HphpArray::reallocData(size_t maxElms, size_t tableSize) {
   // reallocate if alignment was inadquate.  However, this would not save very
   // much memory in practice, and recovering from the OOM failure case for the
   // reallocation would be messy to handle correctly.
-  size_t allocSize = (maxElms * sizeof(Elm))
-                     + (tableSize * sizeof(ElmInd))
-                     + ElmAlignment; // <-- pad
-  void* block = realloc(m_linear ? NULL : getBlock(), allocSize);
+  allocSize += ElmAlignment; // <-- pad
+  void* block = smart_realloc(m_linear ? NULL : getBlock(), allocSize);
   if (block == NULL) {
     throw OutOfMemoryException(allocSize);
   }
@@ -951,12 +1005,12 @@ void HphpArray::reallocData(size_t maxElms, size_t tableSize) {
       // array to its proper offset.
       Elm* misalignedElms = (Elm*)(uintptr_t(block) + oldPad);
       Elm* elms = (Elm*)newData;
-      memmove((void*)elms, (void*)misalignedElms, (m_lastE+1) * sizeof(Elm));
+      memmove((void*)elms, (void*)misalignedElms, liveSize);
     }
   } else {
     Elm* oldElms = data2Elms(m_data);
     Elm* elms = (Elm*)newData;
-    memcpy((void*)elms, (void*)oldElms, (m_lastE+1) * sizeof(Elm));
+    memcpy((void*)elms, (void*)oldElms, liveSize);
     m_linear = false;
   }
   m_dataPad = newPad;
@@ -966,6 +1020,10 @@ void HphpArray::reallocData(size_t maxElms, size_t tableSize) {
 
 void HphpArray::delinearize() {
   size_t maxElms = computeMaxElms(m_tableMask);
+  if (m_packed) {
+    reallocPacked(maxElms);
+    return;
+  }
   size_t tableSize = computeTableSize(m_tableMask);
   reallocData(maxElms, tableSize);
   Elm* elms = data2Elms(m_data);
@@ -974,6 +1032,40 @@ void HphpArray::delinearize() {
   memcpy((void*)m_hash, (void*)oldHash, tableSize * sizeof(ElmInd));
 }
 
+void HphpArray::unpack() {
+  ASSERT(m_packed && !m_linear);
+  size_t tableSize = computeTableSize(m_tableMask);
+  size_t maxElms = computeMaxElms(m_tableMask);
+  reallocBlock((maxElms * sizeof(Elm)) + (tableSize * sizeof(ElmInd)),
+               (m_lastE+1) * sizeof(TypedValue));
+  // Widen the values into elements in place. An element is bigger than a
+  // value, so working from the last one down never overwrites a value that
+  // has not been moved yet.
+  TypedValue* tvs = (TypedValue*)m_data;
+  Elm* elms = data2Elms(m_data);
+  for (ssize_t pos = m_lastE; pos >= 0; --pos) {
+    TypedValue tv;
+    memcpy(&tv, &tvs[pos], sizeof(TypedValue));
+    Elm* e = &elms[pos];
+    memcpy(&e->data, &tv, sizeof(TypedValue));
+    e->h = pos;
+    e->key = NULL;
+  }
+  m_packed = false;
+  m_hash = elms2Hash(elms, maxElms);
+  initHash(m_hash, tableSize);
+  for (ElmInd pos = 0; pos <= m_lastE; ++pos) {
+    *findForNewInsert(pos) = pos;
+  }
+  m_hLoad = m_nElms;
+}
+
+void HphpArray::growPacked() {
+  ASSERT(m_packed && m_tableMask <= 0x7fffffffU);
+  m_tableMask = (uint)(size_t(m_tableMask) + size_t(m_tableMask) + size_t(1));
+  reallocPacked(computeMaxElms(m_tableMask));
+}
+
 inline void HphpArray::resizeIfNeeded() {
   uint32 maxElms = computeMaxElms(m_tableMask);
   ASSERT(m_lastE == ElmIndEmpty || uint32(m_lastE)+1 <= maxElms);
@@ -1011,7 +1103,7 @@ void HphpArray::resize() {
 }
 
 void HphpArray::grow() {
-  ASSERT(m_tableMask <= 0x7fffffffU);
+  ASSERT(!m_packed && m_tableMask <= 0x7fffffffU);
   m_tableMask = (uint)(size_t(m_tableMask) + size_t(m_tableMask) + size_t(1));
   size_t tableSize = computeTableSize(m_tableMask);
   size_t maxElms = computeMaxElms(m_tableMask);
@@ -1047,6 +1139,7 @@ void HphpArray::grow() {
 }
 
 void HphpArray::compact(bool renumber /* = false */) {
+  ASSERT(!m_packed);
   struct ElmKey {
     int64       h;
     StringData* key;
@@ -1190,6 +1283,11 @@ bool HphpArray::nextInsert(CVarRef data) {
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    tvAsVariant(allocPacked()).constructValHelper(data);
+    ++m_nextKI;
+    return true;
+  }
   resizeIfNeeded();
   int64 ki = m_nextKI;
   // The check above enforces an invariant that allows us to always
@@ -1219,6 +1317,11 @@ bool HphpArray::nextInsertRef(CVarRef data) {
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    tvAsVariant(allocPacked()).constructRefHelper(data);
+    ++m_nextKI;
+    return true;
+  }
   resizeIfNeeded();
   int64 ki = m_nextKI;
   // The check above enforces an invariant that allows us to always
@@ -1243,6 +1346,14 @@ bool HphpArray::nextInsertWithRef(CVarRef data) {
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    TypedValue* tv = allocPacked();
+    tv->_count = 0;
+    tv->m_type = KindOfNull;
+    tvAsVariant(tv).setWithRef(data);
+    ++m_nextKI;
+    return true;
+  }
   resizeIfNeeded();
   int64 ki = m_nextKI;
   ElmInd* ei = findForInsert(ki);
@@ -1267,6 +1378,21 @@ bool HphpArray::addLvalImpl(int64 ki, Variant** pDest,
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    if (size_t(ki) < size_t(m_lastE+1)) {
+      *pDest = &tvAsVariant(&packedData()[ki]);
+      return false;
+    }
+    if (ki == m_nextKI) {
+      TypedValue* tv = allocPacked();
+      tv->_count = 0;
+      tv->m_type = KindOfNull;
+      *pDest = &tvAsVariant(tv);
+      ++m_nextKI;
+      return true;
+    }
+    unpack();
+  }
   ElmInd* ei = findForInsert(ki);
   if (validElmInd(*ei)) {
     Elm* elms = data2Elms(m_data);
@@ -1305,6 +1431,9 @@ bool HphpArray::addLvalImpl(StringData* key, int64 h, Variant** pDest,
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    unpack();
+  }
   ElmInd* ei = findForInsert(key->data(), key->size(), h);
   if (validElmInd(*ei)) {
     Elm* elms = data2Elms(m_data);
@@ -1344,6 +1473,19 @@ inline bool HphpArray::addVal(int64 ki, CVarRef data,
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    if (ki == m_nextKI) {
+      TypedValue* fr = (TypedValue*)(&data);
+      TypedValue* to = allocPacked();
+      ELEMENT_CONSTRUCT(fr, to);
+      ++m_nextKI;
+      return true;
+    }
+    if (checkExists && size_t(ki) < size_t(m_lastE+1)) {
+      return false;
+    }
+    unpack();
+  }
   ElmInd* ei = findForInsert(ki);
   if (checkExists && validElmInd(*ei)) {
     return false;
@@ -1375,6 +1517,9 @@ inline bool HphpArray::addVal(StringData* key, CVarRef data,
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    unpack();
+  }
   int64 h = key->hash();
   ElmInd* ei = findForInsert(key->data(), key->size(), h);
   Elm* elms = data2Elms(m_data);
@@ -1419,6 +1564,20 @@ inline bool HphpArray::addValWithRef(int64 ki, CVarRef data,
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    if (ki == m_nextKI) {
+      TypedValue* tv = allocPacked();
+      tv->_count = 0;
+      tv->m_type = KindOfNull;
+      tvAsVariant(tv).setWithRef(data);
+      ++m_nextKI;
+      return true;
+    }
+    if (checkExists && size_t(ki) < size_t(m_lastE+1)) {
+      return false;
+    }
+    unpack();
+  }
   resizeIfNeeded();
   ElmInd* ei = findForInsert(ki);
   if (checkExists && validElmInd(*ei)) {
@@ -1448,6 +1607,9 @@ inline bool HphpArray::addValWithRef(StringData* key, CVarRef data,
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    unpack();
+  }
   resizeIfNeeded();
   int64 h = key->hash();
   ElmInd* ei = findForInsert(key->data(), key->size(), h);
@@ -1474,6 +1636,18 @@ bool HphpArray::update(int64 ki, CVarRef data) {
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    if (size_t(ki) < size_t(m_lastE+1)) {
+      tvAsVariant(&packedData()[ki]).assignValHelper(data);
+      return true;
+    }
+    if (ki == m_nextKI) {
+      tvAsVariant(allocPacked()).constructValHelper(data);
+      ++m_nextKI;
+      return true;
+    }
+    unpack();
+  }
   ElmInd* ei = findForInsert(ki);
   if (validElmInd(*ei)) {
     Elm* elms = data2Elms(m_data);
@@ -1506,6 +1680,9 @@ bool HphpArray::update(StringData* key, CVarRef data) {
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    unpack();
+  }
   int64 h = key->hash();
   ElmInd* ei = findForInsert(key->data(), key->size(), h);
   if (validElmInd(*ei)) {
@@ -1541,6 +1718,18 @@ bool HphpArray::updateRef(int64 ki, CVarRef data) {
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    if (size_t(ki) < size_t(m_lastE+1)) {
+      tvAsVariant(&packedData()[ki]).assignRefHelper(data);
+      return true;
+    }
+    if (ki == m_nextKI) {
+      tvAsVariant(allocPacked()).constructRefHelper(data);
+      ++m_nextKI;
+      return true;
+    }
+    unpack();
+  }
   ElmInd* ei = findForInsert(ki);
   if (validElmInd(*ei)) {
     Elm* elms = data2Elms(m_data);
@@ -1573,6 +1762,9 @@ bool HphpArray::updateRef(StringData* key, CVarRef data) {
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    unpack();
+  }
   int64 h = key->hash();
   ElmInd* ei = findForInsert(key->data(), key->size(), h);
   if (validElmInd(*ei)) {
@@ -1609,6 +1801,13 @@ bool HphpArray::updateRef(StringData* key, CVarRef data) {
 // for this.
 
 TypedValue* HphpArray::migrate(StringData* k, TypedValue* tv) {
+  if (m_packed) {
+    if (tv == NULL) {
+      // Packed arrays have no string keys, so there is nothing to unpin
+      return NULL;
+    }
+    unpack();
+  }
   int64 h = k->hash();
   ElmInd* ei = findForInsert(k->data(), k->size(), h);
   if (validElmInd(*ei)) {
@@ -1679,6 +1878,9 @@ TypedValue* HphpArray::migrate(StringData* k, TypedValue* tv) {
 
 TypedValue* HphpArray::migrateAndSet(StringData* k, TypedValue* tv) {
   ASSERT(tv != NULL);
+  if (m_packed) {
+    unpack();
+  }
   int64 h = k->hash();
   ElmInd* ei = findForInsert(k->data(), k->size(), h);
   if (validElmInd(*ei)) {
@@ -1737,13 +1939,11 @@ ArrayData* HphpArray::lval(int64 k, Variant*& ret, bool copy,
   }
   ssize_t /*ElmInd*/ pos = find(k);
   if (pos != (ssize_t)ElmIndEmpty) {
-    Elm* elms = data2Elms(m_data);
-    Elm* e = &elms[pos];
     // Integer keys do not support KindOfIndirect
-    ASSERT(e->data.m_type != KindOfIndirect);
-    if (tvAsVariant(&e->data).isReferenced() ||
-        tvAsVariant(&e->data).isObject()) {
-      ret = &(tvAsVariant(&e->data));
+    TypedValue* tv = valueAt(pos);
+    if (tvAsVariant(tv).isReferenced() ||
+        tvAsVariant(tv).isObject()) {
+      ret = &(tvAsVariant(tv));
       return NULL;
     }
   }
@@ -1845,9 +2045,7 @@ ArrayData *HphpArray::lvalPtr(int64 k, Variant*& ret, bool copy,
   } else {
     ElmInd pos = t->find(k);
     if (pos != ElmIndEmpty) {
-      Elm* elms = data2Elms(m_data);
-      Elm* e = &elms[pos];
-      ret = &(tvAsVariant(&e->data));
+      ret = &(tvAsVariant(t->valueAt(pos)));
     } else {
       ret = NULL;
     }
@@ -1863,9 +2061,7 @@ ArrayData* HphpArray::lvalNew(Variant*& ret, bool copy) {
       return a;
     }
     ASSERT(a->m_lastE != ElmIndEmpty);
-    ssize_t lastE = (ssize_t)a->m_lastE;
-    Elm* aElms = data2Elms(a->m_data);
-    ret = &tvAsVariant(&aElms[lastE].data);
+    ret = &tvAsVariant(a->valueAt(a->m_lastE));
     return a;
   }
   if (UNLIKELY(!nextInsert(null))) {
@@ -1873,9 +2069,7 @@ ArrayData* HphpArray::lvalNew(Variant*& ret, bool copy) {
     return NULL;
   }
   ASSERT(m_lastE != ElmIndEmpty);
-  ssize_t lastE = (ssize_t)m_lastE;
-  Elm* elms = data2Elms(m_data);
-  ret = &(tvAsVariant(&elms[lastE].data));
+  ret = &(tvAsVariant(valueAt(m_lastE)));
   return NULL;
 }
 
@@ -2036,7 +2230,7 @@ ArrayData* HphpArray::addLval(CVarRef k, Variant*& ret, bool copy) {
 // Delete.
 
 void HphpArray::erase(ElmInd* ei, bool updateNext /* = false */) {
-  ASSERT(!m_linear);
+  ASSERT(!m_linear && !m_packed);
   ElmInd pos = *ei;
   if (!validElmInd(pos)) {
     return;
@@ -2133,16 +2327,34 @@ void HphpArray::erase(ElmInd* ei, bool updateNext /* = false */) {
   }
 }
 
+void HphpArray::eraseKey(int64 ki) {
+  if (m_packed) {
+    if (size_t(ki) >= size_t(m_lastE+1)) {
+      return;
+    }
+    unpack();
+  }
+  erase(findForInsert(ki));
+}
+
+void HphpArray::eraseKey(const char* k, int len, int64 prehash) {
+  // Packed arrays have no string keys
+  if (m_packed) {
+    return;
+  }
+  erase(findForInsert(k, len, prehash));
+}
+
 ArrayData* HphpArray::remove(int64 k, bool copy) {
   if (copy) {
     HphpArray* a = copyImpl();
-    a->erase(a->findForInsert(k));
+    a->eraseKey(k);
     return a;
   }
   if (m_linear) {
     delinearize();
   }
-  erase(findForInsert(k));
+  eraseKey(k);
   return NULL;
 }
 
@@ -2150,13 +2362,13 @@ ArrayData* HphpArray::remove(CStrRef k, bool copy) {
   int64 prehash = k->hash();
   if (copy) {
     HphpArray* a = copyImpl();
-    a->erase(a->findForInsert(k.data(), k.size(), prehash));
+    a->eraseKey(k.data(), k.size(), prehash);
     return a;
   }
   if (m_linear) {
     delinearize();
   }
-  erase(findForInsert(k.data(), k.size(), prehash));
+  eraseKey(k.data(), k.size(), prehash);
   return NULL;
 }
 
@@ -2164,26 +2376,26 @@ ArrayData* HphpArray::remove(CVarRef k, bool copy) {
   if (isIntegerKey(k)) {
     if (copy) {
       HphpArray* a = copyImpl();
-      a->erase(a->findForInsert(k.toInt64()));
+      a->eraseKey(k.toInt64());
       return a;
     }
     if (m_linear) {
       delinearize();
     }
-    erase(findForInsert(k.toInt64()));
+    eraseKey(k.toInt64());
     return NULL;
   } else {
     StringData* key = k.getStringData();
     int64 prehash = key->hash();
     if (copy) {
       HphpArray* a = copyImpl();
-      a->erase(a->findForInsert(key->data(), key->size(), prehash));
+      a->eraseKey(key->data(), key->size(), prehash);
       return a;
     }
     if (m_linear) {
       delinearize();
     }
-    erase(findForInsert(key->data(), key->size(), prehash));
+    eraseKey(key->data(), key->size(), prehash);
     return NULL;
   }
 }
@@ -2203,12 +2415,26 @@ HphpArray* HphpArray::copyImpl() const {
   target->m_lastE = m_lastE;
   target->m_linear = false;
   target->m_siPastEnd = false;
+  target->m_packed = m_packed;
 #ifndef USE_JEMALLOC
   target->m_dataPad = 0;
 #endif
   target->m_nIndirectElms = 0;
   size_t tableSize = computeTableSize(m_tableMask);
   size_t maxElms = computeMaxElms(m_tableMask);
+  if (m_packed) {
+    target->m_hash = NULL;
+    target->reallocPacked(maxElms);
+    TypedValue* tvs = packedData();
+    TypedValue* targetTvs = target->packedData();
+    ssize_t lastE = (ssize_t)m_lastE;
+    for (ssize_t pos = 0; pos <= lastE; ++pos) {
+      TypedValue* fr = &tvs[pos];
+      TypedValue* to = &targetTvs[pos];
+      ELEMENT_CLONE(fr, to, this);
+    }
+    return target;
+  }
   target->reallocData(maxElms, tableSize);
   Elm* targetElms = data2Elms(target->m_data);
   target->m_hash = elms2Hash(targetElms, maxElms);
@@ -2358,10 +2584,29 @@ ArrayData* HphpArray::pop(Variant& value) {
     a->pop(value);
     return a;
   }
-  Elm* elms = data2Elms(m_data);
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    if (m_strongIterators.empty()) {
+      if (m_lastE != ElmIndEmpty) {
+        TypedValue* tv = &packedData()[m_lastE];
+        value = tvAsCVarRef(tv);
+        tvRefcountedDecRef(tv);
+        --m_lastE;
+        --m_nElms;
+        --m_nextKI;
+      } else {
+        value = null;
+      }
+      // To match PHP-like semantics, the pop operation resets the array's
+      // internal iterator.
+      m_pos = (m_lastE != ElmIndEmpty) ? 0 : ArrayData::invalid_index;
+      return NULL;
+    }
+    unpack();
+  }
+  Elm* elms = data2Elms(m_data);
   ElmInd pos = iter_end();
   if (validElmInd(pos)) {
     Elm* e = &elms[pos];
@@ -2399,10 +2644,28 @@ ArrayData* HphpArray::dequeue(Variant& value) {
   if (!m_strongIterators.empty()) {
     freeStrongIterators();
   }
-  Elm* elms = data2Elms(m_data);
   if (m_linear) {
     delinearize();
   }
+  if (m_packed) {
+    if (m_lastE != ElmIndEmpty) {
+      TypedValue* tvs = packedData();
+      value = tvAsCVarRef(&tvs[0]);
+      tvRefcountedDecRef(&tvs[0]);
+      // Shifting the rest down renumbers them as well.
+      memmove(&tvs[0], &tvs[1], m_lastE * sizeof(TypedValue));
+      --m_lastE;
+      --m_nElms;
+      m_nextKI = m_nElms;
+    } else {
+      value = null;
+    }
+    // To match PHP-like semantics, the dequeue operation resets the array's
+    // internal iterator
+    m_pos = (m_lastE != ElmIndEmpty) ? 0 : ArrayData::invalid_index;
+    return NULL;
+  }
+  Elm* elms = data2Elms(m_data);
   ElmInd pos = nextElm(elms, ElmIndEmpty);
   if (validElmInd(pos)) {
     Elm* e = &elms[pos];
@@ -2444,6 +2707,24 @@ ArrayData* HphpArray::prepend(CVarRef v, bool copy) {
     delinearize();
   }
 
+  if (m_packed) {
+    if (uint32(m_lastE)+1 == computeMaxElms(m_tableMask)) {
+      growPacked();
+    }
+    TypedValue* tvs = packedData();
+    memmove(&tvs[1], &tvs[0], (m_lastE+1) * sizeof(TypedValue));
+    TypedValue* fr = (TypedValue*)(&v);
+    TypedValue* to = &tvs[0];
+    ELEMENT_CONSTRUCT(fr, to);
+    ++m_lastE;
+    ++m_nElms;
+    m_nextKI = m_nElms;
+    // To match PHP-like semantics, the prepend operation resets the array's
+    // internal iterator
+    m_pos = 0;
+    return NULL;
+  }
+
   Elm* elms = data2Elms(m_data);
   if (elms[0].data.m_type != KindOfTombstone) {
     // Make sure there is room to insert an element.
@@ -2473,10 +2754,21 @@ ArrayData* HphpArray::prepend(CVarRef v, bool copy) {
 }
 
 void HphpArray::renumber() {
+  // Packed arrays are always numbered 0..n-1 already.
+  if (m_packed) {
+    return;
+  }
   compact(true);
 }
 
 void HphpArray::onSetStatic() {
+  if (m_packed) {
+    TypedValue* tvs = packedData();
+    for (ElmInd pos = 0; pos <= m_lastE; ++pos) {
+      tvAsVariant(&tvs[pos]).setStatic();
+    }
+    return;
+  }
   Elm* elms = data2Elms(m_data);
   for (ElmInd pos = 0; pos <= m_lastE; ++pos) {
     Elm* e = &elms[pos];
@@ -2515,32 +2807,23 @@ bool HphpArray::setFullPos(const FullPos& fp) {
 
 CVarRef HphpArray::currentRef() {
   ASSERT(m_pos != ArrayData::invalid_index);
-  Elm* elms = data2Elms(m_data);
-  Elm* e = &elms[(ElmInd)m_pos];
-  ASSERT(e->data.m_type != KindOfTombstone);
-  if (LIKELY(e->data.m_type != KindOfIndirect)) {
-    return tvAsCVarRef(&e->data);
-  } else {
-    return tvAsCVarRef(e->data.m_data.ptv);
-  }
+  return tvAsCVarRef(valueAt(m_pos));
 }
 
 CVarRef HphpArray::endRef() {
   ASSERT(m_lastE != ElmIndEmpty);
-  Elm* elms = data2Elms(m_data);
-  ElmInd pos = m_lastE;
-  Elm* e = &elms[pos];
-  if (LIKELY(e->data.m_type != KindOfIndirect)) {
-    return tvAsCVarRef(&e->data);
-  } else {
-    return tvAsCVarRef(e->data.m_data.ptv);
-  }
+  return tvAsCVarRef(valueAt(m_lastE));
 }
 
 //=============================================================================
 // Memory allocator methods.
 
 bool HphpArray::calculate(int& size) {
+  if (m_packed) {
+    size += computeMaxElms(m_tableMask) * sizeof(TypedValue); // Values.
+    size += ElmAlignment; // Padding to allow for alignment in restore().
+    return true;
+  }
   size += computeMaxElms(m_tableMask) * sizeof(Elm); // Array elements.
   size += computeTableSize(m_tableMask) * sizeof(ElmInd); // Hash table.
   size += ElmAlignment; // Padding to allow for alignment in restore().
@@ -2561,7 +2844,10 @@ void HphpArray::backup(LinearAllocator& allocator) {
   }
 
   Elm* elms = data2Elms(m_data);
-  if (m_nIndirectElms == 0) {
+  if (m_packed) {
+    allocator.backup((const char*)m_data,
+                     computeMaxElms(m_tableMask) * sizeof(TypedValue));
+  } else if (m_nIndirectElms == 0) {
     allocator.backup((const char*)elms,
                      computeMaxElms(m_tableMask) * sizeof(Elm));
   } else {
@@ -2599,8 +2885,10 @@ void HphpArray::backup(LinearAllocator& allocator) {
     allocator.backup((const char*)elms + ((m_lastE+1) * sizeof(Elm)),
                      (computeMaxElms(m_tableMask) - (m_lastE+1)) * sizeof(Elm));
   }
-  allocator.backup((const char*)m_hash,
-                   computeTableSize(m_tableMask) * sizeof(ElmInd));
+  if (!m_packed) {
+    allocator.backup((const char*)m_hash,
+                     computeTableSize(m_tableMask) * sizeof(ElmInd));
+  }
   ASSERT(m_strongIterators.empty());
   // Trailing pad space is [1..ElmAlignment] bytes.
   char pad[padRem];
@@ -2623,11 +2911,15 @@ void HphpArray::restore(const char*& buffer) {
 #ifndef USE_JEMALLOC
   m_dataPad = 0;
 #endif
-  Elm* elms = data2Elms(m_data);
-  m_hash = elms2Hash(elms, maxElms);
-
-  buffer += maxElms * sizeof(Elm);
-  buffer += tableSize * sizeof(ElmInd);
+  if (m_packed) {
+    m_hash = NULL;
+    buffer += maxElms * sizeof(TypedValue);
+  } else {
+    Elm* elms = data2Elms(m_data);
+    m_hash = elms2Hash(elms, maxElms);
+    buffer += maxElms * sizeof(Elm);
+    buffer += tableSize * sizeof(ElmInd);
+  }
   buffer += ElmAlignment;
   m_linear = true;
   m_strongIterators.m_data = NULL;
@@ -2636,7 +2928,7 @@ void HphpArray::restore(const char*& buffer) {
 void HphpArray::sweep() {
   if (m_data != NULL) {
     if (!m_linear) {
-      free(getBlock());
+      smart_free(getBlock());
     }
     m_data = NULL;
 #ifndef USE_JEMALLOC
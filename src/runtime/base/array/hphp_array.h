@@ -40,6 +40,11 @@ public:
 
   virtual ssize_t size() const;
 
+  /**
+   * Whether the array still has the packed layout described below.
+   */
+  bool isPacked() const { return m_packed; }
+
   virtual Variant getKey(ssize_t pos) const;
   virtual Variant getValue(ssize_t pos) const;
   virtual CVarRef getValueRef(ssize_t pos) const;
@@ -207,6 +212,12 @@ private:
   //            +--------------------+
   //            | alignment padding? |
   //            +--------------------+
+  //
+  // Arrays start out packed: as long as the keys are exactly 0..m_lastE,
+  // m_data only holds 0.75 * 2^K TypedValues, the value of key i at slot i,
+  // and there is no hash table (m_hash == NULL). Inserting any other key, or
+  // removing any element other than by pop() or dequeue(), converts the array
+  // to the layout above with unpack(), and it stays that way.
   void*   m_data;        // Contains elements and hash table.
   ElmInd* m_hash;        // Hash table.
   int64   m_nextKI;      // Next integer key to use for append.
@@ -216,6 +227,7 @@ private:
   ElmInd  m_lastE;       // Index of last used element.
   char    m_linear;      // (true) ? m_data came from linear allocator.
   char    m_siPastEnd;   // (true) ? strong iterators possibly past end.
+  char    m_packed;      // (true) ? m_data only has values for keys 0..n-1.
 #ifndef USE_JEMALLOC
   uchar   m_dataPad;     // Number of bytes that m_data was advanced to
                          //   achieve the required alignment
@@ -231,6 +243,12 @@ private:
             ));
   }
 
+  TypedValue* packedData() const {
+    ASSERT(m_packed);
+    return (TypedValue*)m_data;
+  }
+  inline TypedValue* valueAt(ssize_t pos) const;
+
   void dumpDebugInfo() const;
 
   ssize_t /*ElmInd*/ nextElm(Elm* elms, ssize_t /*ElmInd*/ ei) const;
@@ -264,12 +282,25 @@ private:
   bool updateRef(StringData* key, CVarRef data);
 
   void erase(ElmInd* ei, bool updateNext = false);
+  void eraseKey(int64 ki);
+  void eraseKey(const char* k, int len, int64 prehash);
   HphpArray* copyImpl() const;
 
   inline Elm* ALWAYS_INLINE allocElm(ElmInd* ei);
+  inline TypedValue* ALWAYS_INLINE allocPacked();
+  void updateStrongIteratorsPastEnd(ElmInd ei) ATTRIBUTE_COLD;
+  void reallocBlock(size_t allocSize, size_t liveSize);
   void reallocData(size_t maxElms, size_t tableSize);
+  void reallocPacked(size_t maxElms);
   void delinearize() ATTRIBUTE_COLD;
 
+  /**
+   * unpack() converts a packed array to the hashed layout, keeping the same
+   * capacity. growPacked() doubles the capacity of a packed array.
+   */
+  void unpack() ATTRIBUTE_COLD;
+  void growPacked() ATTRIBUTE_COLD;
+
   /**
    * grow() increases the hash table size and the number of slots for
    * elements by a factor of 2. grow() rebuilds the hash table, but it
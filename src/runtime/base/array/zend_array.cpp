@@ -1473,6 +1473,50 @@ rehashNeeded:
   rehash();
 }
 
+bool ZendArray::reorder(const std::vector<ssize_t> &order, bool renumber) {
+  ASSERT(order.size() == m_nNumOfElements);
+  // as in prepend(), strong iterators can't follow elements that moved
+  if (!m_strongIterators.empty()) {
+    freeStrongIterators();
+  }
+
+  Bucket *last = NULL;
+  for (unsigned int i = 0; i < order.size(); i++) {
+    Bucket *p = reinterpret_cast<Bucket *>(order[i]);
+    p->pListLast = last;
+    if (last) {
+      last->pListNext = p;
+    } else {
+      m_pListHead = p;
+    }
+    last = p;
+  }
+  if (last) {
+    last->pListNext = NULL;
+  } else {
+    m_pListHead = NULL;
+  }
+  m_pListTail = last;
+
+  if (renumber) {
+    int64 i = 0;
+    for (Bucket *p = m_pListHead; p; p = p->pListNext) {
+      if (p->key) {
+        if (p->key->decRefCount() == 0) {
+          DELETE(StringData)(p->key);
+        }
+        p->key = NULL;
+      }
+      p->h = i++;
+    }
+    m_nNextFreeElement = i;
+    prepareBucketHeadsForWrite();
+    rehash();
+  }
+  m_pos = (ssize_t)m_pListHead;
+  return true;
+}
+
 void ZendArray::onSetStatic() {
   for (Bucket *p = m_pListHead; p; p = p->pListNext) {
     if (p->key) {
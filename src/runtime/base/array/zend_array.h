@@ -125,6 +125,7 @@ public:
   virtual ArrayData *dequeue(Variant &value);
   virtual ArrayData *prepend(CVarRef v, bool copy);
   virtual void renumber();
+  virtual bool reorder(const std::vector<ssize_t> &order, bool renumber);
   virtual void onSetStatic();
   virtual void onSetEvalScalar();
 
@@ -220,6 +220,36 @@ void MemoryManager::sweepAll() {
   Sweepable::SweepAll();
 }
 
+void MemoryManager::beginArena() {
+  if (RuntimeOption::EnableRequestArena && afterCheckpoint()) {
+    m_arena.activate(&m_stats);
+  }
+}
+
+void MemoryManager::endArena() {
+  // every object holding arena memory has been swept by now
+  m_arena.reset();
+}
+
+void *smart_realloc_helper(MemoryManager *mm, void *ptr, size_t nbytes) {
+  RequestArena &arena = mm->getArena();
+  if (ptr == NULL) return smart_malloc(nbytes);
+  if (!arena.owns(ptr)) {
+    // malloc-ed memory stays in malloc
+    return realloc(ptr, nbytes);
+  }
+  void *p = arena.realloc(ptr, nbytes);
+  if (p) return p;
+  // arena exhausted
+  p = malloc(nbytes);
+  if (p) {
+    size_t size = arena.blockSize(ptr);
+    memcpy(p, ptr, size < nbytes ? size : nbytes);
+    arena.free(ptr);
+  }
+  return p;
+}
+
 void MemoryManager::rollback() {
   m_linearAllocator.beginRestore();
   for (unsigned int i = 0; i < m_smartAllocators.size(); i++) {
@@ -252,6 +282,7 @@ void MemoryManager::checkMemory(bool detailed) {
     m_smartAllocators[i]->checkMemory(detailed);
   }
   m_linearAllocator.checkMemory(detailed);
+  m_arena.checkMemory(detailed);
   printf("Unsafe pointers: %d\n", (int)m_unsafePointers.size());
 }
 
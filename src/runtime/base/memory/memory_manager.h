@@ -19,6 +19,7 @@
 
 #include <runtime/base/memory/smart_allocator.h>
 #include <runtime/base/memory/linear_allocator.h>
+#include <runtime/base/memory/request_arena.h>
 #include <runtime/base/memory/unsafe_pointer.h>
 
 namespace HPHP {
@@ -32,7 +33,9 @@ namespace HPHP {
  *     exactly the same size.
  *  2. Interally malloc-ed and variable sized memory held by fixed size
  *     objects, for example, StringData's m_data. These memory can be backed up
- *     and restored by LinearAllocator.
+ *     and restored by LinearAllocator. After checkpoint, these can come from
+ *     the RequestArena instead of malloc(), through smart_malloc() and
+ *     friends, and then they are dropped all at once after sweeping.
  *  3. Unsafe pointers held by fixed size objects, for example, ObjectData*
  *     held by Object. These pointers point to some external memory that's out
  *     of the control of MemoryManager, and therefore they are only interfaced
@@ -91,6 +94,34 @@ public:
   void sweepAll();
   void rollback();
 
+  /**
+   * Request arena for variable sized memory, only used between
+   * beginArena() and endArena() and only when a checkpoint has been taken,
+   * because everything allocated from it is gone after endArena().
+   */
+  void beginArena();
+  void endArena();
+  RequestArena &getArena() { return m_arena;}
+
+  /**
+   * Allocating persistent StringData or arrays in the middle of a request
+   * has to mask the arena, so their memory will outlive the request.
+   */
+  class MaskArena {
+    MemoryManager *m_mm;
+    bool m_active;
+  public:
+    MaskArena() : m_mm(TheMemoryManager().getNoCheck()), m_active(false) {
+      if (m_mm) {
+        m_active = m_mm->m_arena.active();
+        m_mm->m_arena.deactivate();
+      }
+    }
+    ~MaskArena() {
+      if (m_active) m_mm->m_arena.activate(&m_mm->m_stats);
+    }
+  };
+
   /**
    * For any objects that need to do extra work during thread shutdown time.
    */
@@ -211,6 +242,7 @@ private:
 
   std::vector<SmartAllocatorImpl*> m_smartAllocators;
   LinearAllocator m_linearAllocator;
+  RequestArena m_arena;
   std::set<UnsafePointer*> m_unsafePointers;
 
   MemoryUsageStats m_stats;
@@ -229,6 +261,46 @@ public:
 #endif
 };
 
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * malloc(), realloc() and free() for memory held by request-local objects.
+ * They use the request arena when it's on, and smart_realloc() and
+ * smart_free() take either arena or malloc-ed memory, so objects can keep
+ * attaching buffers that were malloc-ed elsewhere.
+ */
+inline void *smart_malloc(size_t nbytes) {
+  MemoryManager *mm = MemoryManager::TheMemoryManager().getNoCheck();
+  if (mm) {
+    RequestArena &arena = mm->getArena();
+    if (arena.active()) {
+      void *p = arena.alloc(nbytes);
+      if (p) return p;
+    }
+  }
+  return malloc(nbytes);
+}
+
+void *smart_realloc_helper(MemoryManager *mm, void *ptr, size_t nbytes);
+
+inline void *smart_realloc(void *ptr, size_t nbytes) {
+  MemoryManager *mm = MemoryManager::TheMemoryManager().getNoCheck();
+  if (mm) return smart_realloc_helper(mm, ptr, nbytes);
+  return realloc(ptr, nbytes);
+}
+
+inline void smart_free(void *ptr) {
+  MemoryManager *mm = MemoryManager::TheMemoryManager().getNoCheck();
+  if (mm) {
+    RequestArena &arena = mm->getArena();
+    if (arena.owns(ptr)) {
+      arena.free(ptr);
+      return;
+    }
+  }
+  free(ptr);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
 
@@ -0,0 +1,177 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <runtime/base/memory/request_arena.h>
+#include <runtime/base/runtime_option.h>
+#include <util/logger.h>
+#include <sys/mman.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+RequestArena::RequestArena()
+  : m_active(false), m_base(NULL), m_frontier(NULL), m_limit(NULL),
+    m_highWater(NULL), m_pageClass(NULL), m_pageRun(NULL), m_lastRun(0),
+    m_stats(NULL) {
+  for (unsigned int i = 0; i < ClassCount; i++) {
+    m_freelists[i] = NULL;
+    m_bumps[i] = m_bumpEnds[i] = NULL;
+  }
+}
+
+RequestArena::~RequestArena() {
+  if (m_base) {
+    munmap(m_base, m_limit - m_base);
+    ::free(m_pageClass);
+    ::free(m_pageRun);
+  }
+}
+
+bool RequestArena::reserve() {
+  size_t size = RuntimeOption::RequestArenaMaxBytes & ~(PageSize - 1);
+  if (size == 0) return false;
+  void *base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (base == MAP_FAILED) {
+    Logger::Warning("Unable to reserve %lld bytes for request arena",
+                    (long long)size);
+    RuntimeOption::RequestArenaMaxBytes = 0;
+    return false;
+  }
+  size_t pages = size >> PageShift;
+  m_pageClass = (uint8 *)calloc(pages, sizeof(uint8));
+  m_pageRun = (uint32 *)calloc(pages, sizeof(uint32));
+  m_base = m_frontier = m_highWater = (char *)base;
+  m_limit = m_base + size;
+  return true;
+}
+
+void RequestArena::activate(MemoryUsageStats *stats) {
+  if (!m_base && !reserve()) return;
+  m_stats = stats;
+  m_active = true;
+}
+
+char *RequestArena::grabPages(size_t count) {
+  if ((size_t)(m_limit - m_frontier) < (count << PageShift)) return NULL;
+  char *p = m_frontier;
+  m_frontier += (count << PageShift);
+  if (m_frontier > m_highWater) m_highWater = m_frontier;
+  return p;
+}
+
+void *RequestArena::allocSmall(int cls) {
+  size_t size = (1 << (cls + MinClassShift));
+  char *p = m_bumps[cls];
+  if (p == m_bumpEnds[cls]) {
+    p = grabPages(1);
+    if (p == NULL) return NULL;
+    m_pageClass[pageIndex(p)] = cls;
+    m_bumpEnds[cls] = p + PageSize;
+  }
+  m_bumps[cls] = p + size;
+  m_stats->usage += size;
+  return p;
+}
+
+void *RequestArena::allocLarge(size_t size) {
+  size_t count = (size + PageSize - 1) >> PageShift;
+  char *p = grabPages(count);
+  if (p == NULL) return NULL;
+  size_t page = pageIndex(p);
+  m_pageClass[page] = LargeClass;
+  for (size_t i = 1; i < count; i++) {
+    m_pageClass[page + i] = ContinuedClass;
+  }
+  m_pageRun[page] = count;
+  m_lastRun = page;
+  m_stats->usage += (count << PageShift);
+  return p;
+}
+
+void RequestArena::freeLarge(size_t page) {
+  size_t count = m_pageRun[page];
+  m_stats->usage -= (count << PageShift);
+  char *start = m_base + (page << PageShift);
+  if (start + (count << PageShift) == m_frontier) {
+    // Last run handed out, so simply give its pages back. Runs freed
+    // anywhere else are reclaimed by reset().
+    m_frontier = start;
+  }
+}
+
+size_t RequestArena::blockSize(const void *p) const {
+  size_t page = pageIndex(p);
+  int cls = m_pageClass[page];
+  if (cls == LargeClass) {
+    return m_pageRun[page] << PageShift;
+  }
+  ASSERT(cls != ContinuedClass);
+  return (1 << (cls + MinClassShift));
+}
+
+void *RequestArena::realloc(void *p, size_t size) {
+  ASSERT(owns(p));
+  size_t old = blockSize(p);
+  if (size <= old) return p;
+
+  size_t page = pageIndex(p);
+  if (m_pageClass[page] == LargeClass && page == m_lastRun &&
+      (char *)p + old == m_frontier) {
+    // A string or array that keeps growing at the frontier extends in place.
+    size_t more = ((size - old) + PageSize - 1) >> PageShift;
+    char *extra = grabPages(more);
+    if (extra) {
+      size_t next = pageIndex(extra);
+      for (size_t i = 0; i < more; i++) {
+        m_pageClass[next + i] = ContinuedClass;
+      }
+      m_pageRun[page] += more;
+      m_stats->usage += (more << PageShift);
+      return p;
+    }
+  }
+
+  void *q = alloc(size);
+  if (q == NULL) return NULL;
+  memcpy(q, p, old);
+  free(p);
+  return q;
+}
+
+void RequestArena::reset() {
+  m_active = false;
+  for (unsigned int i = 0; i < ClassCount; i++) {
+    m_freelists[i] = NULL;
+    m_bumps[i] = m_bumpEnds[i] = NULL;
+  }
+  if (m_base == NULL) return;
+
+  m_frontier = m_base;
+  size_t retain = RuntimeOption::RequestArenaRetainBytes & ~(PageSize - 1);
+  if (m_highWater > m_base + retain) {
+    madvise(m_base + retain, m_highWater - (m_base + retain), MADV_DONTNEED);
+    m_highWater = m_base + retain;
+  }
+}
+
+void RequestArena::checkMemory(bool detailed) {
+  printf("Request arena: %lld bytes in pages, %lld bytes resident at most\n",
+         (long long)(m_frontier - m_base), (long long)(m_highWater - m_base));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,142 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_REQUEST_ARENA_H__
+#define __HPHP_REQUEST_ARENA_H__
+
+#include <runtime/base/memory/smart_allocator.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A RequestArena hands out the variable sized memory held by request-local
+ * objects, for example StringData's m_data and HphpArray's element tables,
+ * so that it does not go through malloc() and free().
+ *
+ * Memory comes from one range of address space reserved per thread, carved
+ * into pages. Small blocks are bump allocated from pages dedicated to one
+ * power-of-two size class, and freed blocks go to a per-class free list.
+ * Large blocks take a run of whole pages, and the run at the frontier can
+ * grow in place. At the end of a request, reset() drops everything at once
+ * without visiting any block.
+ *
+ * Because the range is contiguous, owns() is just a bounds check, so free
+ * and realloc paths can tell arena memory from malloc-ed memory.
+ */
+class RequestArena {
+public:
+  static const size_t PageShift = 16;
+  static const size_t PageSize = (1 << PageShift);
+  static const size_t MinClassShift = 4;  // 16 bytes
+  static const size_t MaxClassShift = 15; // 32KB
+  static const size_t ClassCount = MaxClassShift - MinClassShift + 1;
+  static const size_t MaxSmallSize = (1 << MaxClassShift);
+
+  RequestArena();
+  ~RequestArena();
+
+  /**
+   * Only objects that are swept at the end of a request may allocate from the
+   * arena, so allocation is turned on just for the request's lifetime.
+   */
+  void activate(MemoryUsageStats *stats);
+  void deactivate() { m_active = false;}
+  bool active() const { return m_active;}
+
+  bool owns(const void *p) const {
+    return (const char *)p >= m_base && (const char *)p < m_frontier;
+  }
+
+  /**
+   * Returns NULL when arena is exhausted, and callers fall back to malloc().
+   */
+  void *alloc(size_t size) {
+    if (size <= MaxSmallSize) {
+      int cls = sizeClass(size);
+      void *p = m_freelists[cls];
+      if (p) {
+        m_freelists[cls] = *(void **)p;
+        m_stats->usage += (1 << (cls + MinClassShift));
+        return p;
+      }
+      return allocSmall(cls);
+    }
+    return allocLarge(size);
+  }
+  void *realloc(void *p, size_t size);
+  void free(void *p) {
+    ASSERT(owns(p));
+    size_t page = pageIndex(p);
+    int cls = m_pageClass[page];
+    if (cls == LargeClass) {
+      freeLarge(page);
+      return;
+    }
+    *(void **)p = m_freelists[cls];
+    m_freelists[cls] = p;
+    m_stats->usage -= (1 << (cls + MinClassShift));
+  }
+
+  /**
+   * How many bytes of a block are usable, which can be more than requested.
+   */
+  size_t blockSize(const void *p) const;
+
+  /**
+   * Drop all blocks. Pages beyond the retained size are returned to the OS.
+   */
+  void reset();
+
+  void checkMemory(bool detailed);
+
+private:
+  static const uint8 LargeClass = 0xff;
+  static const uint8 ContinuedClass = 0xfe; // inside a large run
+
+  bool m_active;
+  char *m_base;
+  char *m_frontier;
+  char *m_limit;
+  char *m_highWater;      // largest frontier since the last trim
+  uint8 *m_pageClass;     // size class of each page
+  uint32 *m_pageRun;      // for a large run's first page, its page count
+  size_t m_lastRun;       // first page of the large run at the frontier
+  MemoryUsageStats *m_stats;
+
+  void *m_freelists[ClassCount];
+  char *m_bumps[ClassCount];     // bump pointer inside current page
+  char *m_bumpEnds[ClassCount];
+
+  static int sizeClass(size_t size) {
+    if (size <= (1 << MinClassShift)) return 0;
+    return (sizeof(long) * 8 - __builtin_clzl(size - 1)) - MinClassShift;
+  }
+  size_t pageIndex(const void *p) const {
+    return ((const char *)p - m_base) >> PageShift;
+  }
+
+  bool reserve();
+  char *grabPages(size_t count);
+  void *allocSmall(int cls) NEVER_INLINE;
+  void *allocLarge(size_t size) NEVER_INLINE;
+  void freeLarge(size_t page);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_REQUEST_ARENA_H__
@@ -1306,10 +1306,7 @@ StaticString s_zero("\0", 1);
 void ObjectData::serialize(VariableSerializer *serializer) const {
   if (serializer->incNestedLevel((void*)this, true)) {
     serializer->writeOverflow((void*)this, true);
-  } else if ((serializer->getType() == VariableSerializer::Serialize ||
-              serializer->getType() == VariableSerializer::APCSerialize ||
-              serializer->getType() == VariableSerializer::DebuggerSerialize) &&
-             o_instanceof("Serializable")) {
+  } else if (serializer->isSerialize() && o_instanceof("Serializable")) {
     Variant ret =
       const_cast<ObjectData*>(this)->o_invoke(s_serialize, Array(), -1);
     if (ret.isString()) {
@@ -1322,9 +1319,7 @@ void ObjectData::serialize(VariableSerializer *serializer) const {
     }
   } else {
     Variant ret;
-    if ((serializer->getType() == VariableSerializer::Serialize ||
-         serializer->getType() == VariableSerializer::APCSerialize ||
-         serializer->getType() == VariableSerializer::DebuggerSerialize) &&
+    if (serializer->isSerialize() &&
         const_cast<ObjectData*>(this)->php_sleep(ret)) {
       if (ret.isArray()) {
         const ClassInfo *cls = ClassInfo::FindClass(o_getClassName());
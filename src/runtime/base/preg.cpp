@@ -13,10 +13,12 @@
    | license@php.net so we can mail you a copy immediately.               |
    +----------------------------------------------------------------------+
 */
+#include <runtime/base/preg.h>
 #include <runtime/base/string_util.h>
 #include <runtime/base/util/request_local.h>
 #include <util/lock.h>
 #include <util/logger.h>
+#include <util/atomic.h>
 #include <pcre.h>
 #include <onigposix.h>
 #include <runtime/base/runtime_option.h>
@@ -24,6 +26,9 @@
 #include <runtime/base/zend/zend_functions.h>
 #include <runtime/base/array/array_iterator.h>
 #include <runtime/base/taint/taint_observer.h>
+#include <runtime/base/server/server_stats.h>
+#include <tbb/concurrent_hash_map.h>
+#include <deque>
 
 #define PREG_PATTERN_ORDER          1
 #define PREG_SET_ORDER              2
@@ -37,8 +42,6 @@
 
 #define PREG_GREP_INVERT            (1<<0)
 
-#define PCRE_CACHE_SIZE 4096
-
 enum {
   PHP_PCRE_NO_ERROR = 0,
   PHP_PCRE_INTERNAL_ERROR,
@@ -56,87 +59,230 @@ namespace HPHP {
 
 class pcre_cache_entry {
 public:
+  pcre_cache_entry() : re(NULL), extra(NULL), study_extra(NULL),
+                       preg_options(0), compile_options(0),
+                       size(0), hits(0), referenced(true) {}
   ~pcre_cache_entry() {
     free(re);
-    if (extra) free(extra);
+    if (study_extra && study_extra != extra) free_extra(study_extra);
+    if (extra) free_extra(extra);
 #if HAVE_SETLOCALE
     free(locale);
     if (tables) free(tables);
 #endif
   }
 
+  static void free_extra(pcre_extra *e) {
+#ifdef PCRE_STUDY_JIT_COMPILE
+    pcre_free_study(e);
+#else
+    free(e);
+#endif
+  }
+
   pcre *re;
-  pcre_extra *extra; // Holds results of studying
+  pcre_extra *extra; // Holds results of studying, JIT code once hot
+  pcre_extra *study_extra; // non-JIT study data, kept alive for readers
   int preg_options;
 #if HAVE_SETLOCALE
   char *locale;
   unsigned const char *tables;
 #endif
   int compile_options;
-};
 
-typedef hphp_hash_map<StringData *, pcre_cache_entry*,
-                      string_data_hash, string_data_same> PCREStringMap;
+  int size;        // bytes of compiled code, for the cache's memory limit
+  int hits;        // lookups since compilation, to find hot patterns
+  bool referenced; // CLOCK bit, cleared by the eviction sweep
+};
 
-// TODO LRU cache
+typedef boost::shared_ptr<pcre_cache_entry> pcre_cache_entry_ptr;
+
+/**
+ * Process-wide cache of compiled patterns, shared by all threads. Lookups
+ * only take tbb's per-bucket read lock; entries are reference counted so an
+ * entry evicted by one thread stays valid for others still matching with it.
+ * Eviction is CLOCK-based (approximate LRU): each hit sets the entry's
+ * referenced bit, and once over capacity the sweep gives referenced entries a
+ * second chance and drops the others, oldest first. Patterns that reach
+ * RuntimeOption::PregJitHitThreshold hits are re-studied with the PCRE JIT.
+ */
 class PCRECache {
 public:
-  ~PCRECache() { }
+  PCRECache() : m_bytes(0), m_misses(0), m_evictions(0), m_jits(0) {}
 
-  void cleanup() {
+  pcre_cache_entry_ptr find(CStrRef regex) {
     TAINT_OBSERVER_CAP_STACK();
-    for (PCREStringMap::iterator it = m_cache.begin(); it != m_cache.end();
-         ++it) {
-      delete it->second;
-      if (!it->first->isStatic()) {
-        delete it->first;
-      }
+    Map::const_accessor acc;
+    if (!m_cache.find(acc, regex.get())) {
+      atomic_inc(m_misses);
+      ServerStats::Log(StatsMiss, 1);
+      return pcre_cache_entry_ptr();
+    }
+    pcre_cache_entry_ptr pce = acc->second;
+    acc.release();
+
+    ServerStats::Log(StatsHit, 1);
+    pce->referenced = true;
+    if (atomic_inc(pce->hits) == RuntimeOption::PregJitHitThreshold &&
+        jitCompile(pce.get())) {
+      atomic_inc(m_jits);
     }
+    return pce;
   }
 
-  pcre_cache_entry *find(CStrRef regex) {
+  void set(CStrRef regex, pcre_cache_entry_ptr pce) {
     TAINT_OBSERVER_CAP_STACK();
-    PCREStringMap::const_iterator it = m_cache.find(regex.get());
-    if (it != m_cache.end()) return it->second;
-    return NULL;
+    Lock lock(m_mutex);
+    Map::accessor acc;
+    StringData *key = regex->copy(true);
+    if (m_cache.insert(acc, key)) {
+      m_clock.push_back(key);
+    } else {
+      if (!key->isStatic()) delete key;
+      m_bytes -= acc->second->size;
+    }
+    acc->second = pce;
+    m_bytes += pce->size;
+    acc.release();
+    evict();
   }
 
-  void set(CStrRef regex, pcre_cache_entry *pce) {
-    TAINT_OBSERVER_CAP_STACK();
-    PCREStringMap::iterator it = m_cache.find(regex.get());
-    if (it != m_cache.end()) {
-      delete it->second;
-      it->second = pce;
-    } else {
-      m_cache[regex->copy(true)] = pce;
+  void clear() {
+    Lock lock(m_mutex);
+    while (!m_clock.empty()) {
+      erase(m_clock.front());
+      m_clock.pop_front();
     }
+    m_bytes = 0;
   }
 
-  int error_code;
-  pcre_extra extra_data;
+  void getStats(PCRECacheStats &stats) {
+    Lock lock(m_mutex);
+    stats.size = m_clock.size();
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.jits = m_jits;
+  }
 
 private:
-  PCREStringMap m_cache;
+  static int StatsHit;
+  static int StatsMiss;
+  static int StatsEvict;
+  static int StatsJit;
+
+  typedef tbb::concurrent_hash_map<StringData *, pcre_cache_entry_ptr,
+                                   StringDataHashCompare> Map;
+
+  Map m_cache;
+  Mutex m_mutex; // serializes inserts, eviction and m_clock
+  std::deque<StringData *> m_clock;
+  int64 m_bytes;
+  int m_misses;
+  int m_evictions;
+  int m_jits;
+
+  bool overCapacity() const {
+    return (RuntimeOption::PregCacheSize > 0 &&
+            (int64)m_clock.size() > RuntimeOption::PregCacheSize) ||
+      (RuntimeOption::PregCacheMemoryLimit > 0 &&
+       m_bytes > RuntimeOption::PregCacheMemoryLimit);
+  }
+
+  // Must be called with m_mutex held.
+  void evict() {
+    // every entry gets at most one second chance per sweep
+    size_t budget = m_clock.size();
+    while (overCapacity() && !m_clock.empty()) {
+      StringData *key = m_clock.front();
+      m_clock.pop_front();
+      if (budget > 0) {
+        --budget;
+        Map::const_accessor acc;
+        if (m_cache.find(acc, key) && acc->second->referenced) {
+          acc->second->referenced = false;
+          m_clock.push_back(key);
+          continue;
+        }
+      }
+      erase(key);
+      m_evictions++;
+      ServerStats::Log(StatsEvict, 1);
+    }
+  }
+
+  // Must be called with m_mutex held.
+  void erase(StringData *key) {
+    Map::accessor acc;
+    if (m_cache.find(acc, key)) {
+      m_bytes -= acc->second->size;
+      m_cache.erase(acc);
+    }
+    if (!key->isStatic()) delete key;
+  }
+
+  static bool jitCompile(pcre_cache_entry *pce) {
+#ifdef PCRE_STUDY_JIT_COMPILE
+    int jit = 0;
+    if (pcre_config(PCRE_CONFIG_JIT, &jit) != 0 || !jit) return false;
+    const char *error = NULL;
+    pcre_extra *extra = pcre_study(pce->re, PCRE_STUDY_JIT_COMPILE, &error);
+    if (extra == NULL) return false;
+    extra->flags |= PCRE_EXTRA_MATCH_LIMIT | PCRE_EXTRA_MATCH_LIMIT_RECURSION;
+    extra->match_limit = RuntimeOption::PregBacktraceLimit;
+    extra->match_limit_recursion = RuntimeOption::PregRecursionLimit;
+    // Only the thread whose hit reached the threshold gets here, so the
+    // non-JIT extra is parked for readers that already loaded it.
+    pce->study_extra = pce->extra;
+    __sync_synchronize();
+    pce->extra = extra;
+    ServerStats::Log(StatsJit, 1);
+    return true;
+#else
+    return false;
+#endif
+  }
+};
+
+int PCRECache::StatsHit = ServerStats::Intern("pcre.hit");
+int PCRECache::StatsMiss = ServerStats::Intern("pcre.miss");
+int PCRECache::StatsEvict = ServerStats::Intern("pcre.evict");
+int PCRECache::StatsJit = ServerStats::Intern("pcre.jit");
+
+static PCRECache s_pcre_cache;
+
+void preg_get_pcre_cache_stats(PCRECacheStats &stats) {
+  s_pcre_cache.getStats(stats);
+  stats.jitSupported = false;
+#ifdef PCRE_STUDY_JIT_COMPILE
+  int jit = 0;
+  stats.jitSupported = pcre_config(PCRE_CONFIG_JIT, &jit) == 0 && jit;
+#endif
+}
+
+class PCREGlobals {
+public:
+  int error_code;
+  pcre_extra extra_data;
 };
-IMPLEMENT_THREAD_LOCAL_NO_CHECK(PCRECache, s_pcre_cache);
+IMPLEMENT_THREAD_LOCAL_NO_CHECK(PCREGlobals, s_pcre_globals);
 
 void preg_get_pcre_cache() {
-  s_pcre_cache.getCheck();
+  s_pcre_globals.getCheck();
 }
 
-static pcre_cache_entry *pcre_get_compiled_regex_cache(CStrRef regex) {
-  PCRECache &pcre_cache = *s_pcre_cache;
+static pcre_cache_entry_ptr pcre_get_compiled_regex_cache(CStrRef regex) {
+  PCRECache &pcre_cache = s_pcre_cache;
 
   /* Try to lookup the cached regex entry, and if successful, just pass
      back the compiled pattern, otherwise go on and compile it. */
-  pcre_cache_entry *pce = pcre_cache.find(regex);
+  pcre_cache_entry_ptr pce = pcre_cache.find(regex);
   if (pce) {
     /**
      * We use a quick pcre_info() check to see whether cache is corrupted,
      * and if it is, we flush it and compile the pattern from scratch.
      */
     if (pcre_info(pce->re, NULL, NULL) == PCRE_ERROR_BADMAGIC) {
-      pcre_cache.cleanup();
+      pcre_cache.clear();
     } else {
 #if HAVE_SETLOCALE
       if (!strcmp(pce->locale, locale)) {
@@ -154,7 +300,7 @@ static pcre_cache_entry *pcre_get_compiled_regex_cache(CStrRef regex) {
   while (isspace((int)*(unsigned char *)p)) p++;
   if (*p == 0) {
     raise_warning("Empty regular expression");
-    return NULL;
+    return pcre_cache_entry_ptr();
   }
 
   /* Get the delimiter and display a warning if it is alphanumeric
@@ -162,7 +308,7 @@ static pcre_cache_entry *pcre_get_compiled_regex_cache(CStrRef regex) {
   char delimiter = *p++;
   if (isalnum((int)*(unsigned char *)&delimiter) || delimiter == '\\') {
     raise_warning("Delimiter must not be alphanumeric or backslash");
-    return NULL;
+    return pcre_cache_entry_ptr();
   }
 
   char start_delimiter = delimiter;
@@ -186,7 +332,7 @@ static pcre_cache_entry *pcre_get_compiled_regex_cache(CStrRef regex) {
     if (*pp == 0) {
       raise_warning("No ending delimiter '%c' found: [%s]", delimiter,
                       regex.data());
-      return NULL;
+      return pcre_cache_entry_ptr();
     }
   } else {
     /* We iterate through the pattern, searching for the matching ending
@@ -207,7 +353,7 @@ static pcre_cache_entry *pcre_get_compiled_regex_cache(CStrRef regex) {
     if (*pp == 0) {
       raise_warning("No ending matching delimiter '%c' found: [%s]",
                       end_delimiter, regex.data());
-      return NULL;
+      return pcre_cache_entry_ptr();
     }
   }
 
@@ -248,7 +394,7 @@ static pcre_cache_entry *pcre_get_compiled_regex_cache(CStrRef regex) {
 
     default:
       raise_warning("Unknown modifier '%c': [%s]", pp[-1], regex.data());
-      return NULL;
+      return pcre_cache_entry_ptr();
     }
   }
 
@@ -268,7 +414,7 @@ static pcre_cache_entry *pcre_get_compiled_regex_cache(CStrRef regex) {
     if (tables) {
       free((void*)tables);
     }
-    return NULL;
+    return pcre_cache_entry_ptr();
   }
 
   /* If study option was specified, study the pattern and
@@ -278,8 +424,11 @@ static pcre_cache_entry *pcre_get_compiled_regex_cache(CStrRef regex) {
     int soptions = 0;
     extra = pcre_study(re, soptions, &error);
     if (extra) {
+      // the entry is shared by all threads, so set its limits only once
       extra->flags |= PCRE_EXTRA_MATCH_LIMIT |
         PCRE_EXTRA_MATCH_LIMIT_RECURSION;
+      extra->match_limit = RuntimeOption::PregBacktraceLimit;
+      extra->match_limit_recursion = RuntimeOption::PregRecursionLimit;
     }
     if (error != NULL) {
       raise_warning("Error while studying pattern");
@@ -287,11 +436,15 @@ static pcre_cache_entry *pcre_get_compiled_regex_cache(CStrRef regex) {
   }
 
   /* Store the compiled pattern and extra info in the cache. */
-  pcre_cache_entry *new_entry = new pcre_cache_entry();
+  pcre_cache_entry_ptr new_entry(new pcre_cache_entry());
   new_entry->re = re;
   new_entry->extra = extra;
   new_entry->preg_options = poptions;
   new_entry->compile_options = coptions;
+  size_t size;
+  if (pcre_fullinfo(re, NULL, PCRE_INFO_SIZE, &size) == 0) {
+    new_entry->size = size;
+  }
 #if HAVE_SETLOCALE
   char *locale = setlocale(LC_CTYPE, NULL);
   new_entry->locale = strdup(locale);
@@ -302,17 +455,19 @@ static pcre_cache_entry *pcre_get_compiled_regex_cache(CStrRef regex) {
 }
 
 static void set_extra_limits(pcre_extra *&extra) {
+  // a cached entry's own extra already carries the limits
   if (extra == NULL) {
-    pcre_extra &extra_data = s_pcre_cache->extra_data;
+    pcre_extra &extra_data = s_pcre_globals->extra_data;
     extra_data.flags = PCRE_EXTRA_MATCH_LIMIT |
       PCRE_EXTRA_MATCH_LIMIT_RECURSION;
+    extra_data.match_limit = RuntimeOption::PregBacktraceLimit;
+    extra_data.match_limit_recursion = RuntimeOption::PregRecursionLimit;
     extra = &extra_data;
   }
-  extra->match_limit = RuntimeOption::PregBacktraceLimit;
-  extra->match_limit_recursion = RuntimeOption::PregRecursionLimit;
 }
 
-static int *create_offset_array(pcre_cache_entry *pce, int &size_offsets) {
+static int *create_offset_array(const pcre_cache_entry_ptr &pce,
+                                int &size_offsets) {
   pcre_extra *extra = pce->extra;
   set_extra_limits(extra);
 
@@ -328,18 +483,6 @@ static int *create_offset_array(pcre_cache_entry *pce, int &size_offsets) {
   return (int *)malloc(size_offsets * sizeof(int));
 }
 
-static pcre* pcre_get_compiled_regex(CStrRef regex, pcre_extra **extra,
-                                     int *preg_options) {
-  pcre_cache_entry *pce = pcre_get_compiled_regex_cache(regex);
-  if (extra) {
-    *extra = pce ? pce->extra : NULL;
-  }
-  if (preg_options) {
-    *preg_options = pce ? pce->preg_options : 0;
-  }
-  return pce ? pce->re : NULL;
-}
-
 static inline void add_offset_pair(Variant &result, CStrRef str, int offset,
                                    const char *name) {
   Array match_pair;
@@ -408,14 +551,14 @@ static void pcre_handle_exec_error(int pcre_code) {
     preg_code = PHP_PCRE_INTERNAL_ERROR;
     break;
   }
-  s_pcre_cache->error_code = preg_code;
+  s_pcre_globals->error_code = preg_code;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 Variant preg_grep(CStrRef pattern, CArrRef input, int flags /* = 0 */) {
-  pcre_cache_entry *pce = pcre_get_compiled_regex_cache(pattern);
-  if (pce == NULL) {
+  pcre_cache_entry_ptr pce = pcre_get_compiled_regex_cache(pattern);
+  if (!pce) {
     return false;
   }
 
@@ -427,7 +570,7 @@ Variant preg_grep(CStrRef pattern, CArrRef input, int flags /* = 0 */) {
 
   /* Initialize return array */
   Array ret = Array::Create();
-  s_pcre_cache->error_code = PHP_PCRE_NO_ERROR;
+  s_pcre_globals->error_code = PHP_PCRE_NO_ERROR;
 
   /* Go through the input array */
   bool invert = (flags & PREG_GREP_INVERT);
@@ -476,8 +619,8 @@ Variant preg_grep(CStrRef pattern, CArrRef input, int flags /* = 0 */) {
 static Variant preg_match_impl(CStrRef pattern, CStrRef subject,
                                Variant *subpats, int flags, int start_offset,
                                bool global) {
-  pcre_cache_entry *pce = pcre_get_compiled_regex_cache(pattern);
-  if (pce == NULL) {
+  pcre_cache_entry_ptr pce = pcre_get_compiled_regex_cache(pattern);
+  if (!pce) {
     return false;
   }
 
@@ -580,7 +723,7 @@ static Variant preg_match_impl(CStrRef pattern, CStrRef subject,
   }
 
   int matched = 0;
-  s_pcre_cache->error_code = PHP_PCRE_NO_ERROR;
+  s_pcre_globals->error_code = PHP_PCRE_NO_ERROR;
 
   Variant result_set; // Holds a set of subpatterns after a global match
   int g_notempty = 0; // If the match should not be empty
@@ -803,8 +946,8 @@ static bool preg_get_backref(const char **str, int *backref) {
 static String php_pcre_replace(CStrRef pattern, CStrRef subject,
                                CVarRef replace_var, bool callable,
                                int limit, int *replace_count) {
-  pcre_cache_entry *pce = pcre_get_compiled_regex_cache(pattern);
-  if (pce == NULL) {
+  pcre_cache_entry_ptr pce = pcre_get_compiled_regex_cache(pattern);
+  if (!pce) {
     return false;
   }
   bool eval = false;
@@ -858,7 +1001,7 @@ static String php_pcre_replace(CStrRef pattern, CStrRef subject,
   /* Initialize */
   const char *match = NULL;
   int start_offset = 0;
-  s_pcre_cache->error_code = PHP_PCRE_NO_ERROR;
+  s_pcre_globals->error_code = PHP_PCRE_NO_ERROR;
   pcre_extra *extra = pce->extra;
   set_extra_limits(extra);
 
@@ -1146,8 +1289,9 @@ int preg_replace_callback(Variant &result, CVarRef pattern, CVarRef callback,
 
 Variant preg_split(CVarRef pattern, CVarRef subject, int limit /* = -1 */,
                    int flags /* = 0 */) {
-  pcre_cache_entry *pce = pcre_get_compiled_regex_cache(pattern.toString());
-  if (pce == NULL) {
+  pcre_cache_entry_ptr pce =
+    pcre_get_compiled_regex_cache(pattern.toString());
+  if (!pce) {
     return false;
   }
 
@@ -1171,14 +1315,13 @@ Variant preg_split(CVarRef pattern, CVarRef subject, int limit /* = -1 */,
   int start_offset = 0;
   int next_offset = 0;
   const char *last_match = ssubject.data();
-  s_pcre_cache->error_code = PHP_PCRE_NO_ERROR;
+  s_pcre_globals->error_code = PHP_PCRE_NO_ERROR;
   pcre_extra *extra = pce->extra;
 
   // Get next piece if no limit or limit not yet reached and something matched
   Variant return_value = Array::Create();
   int g_notempty = 0;   /* If the match should not be empty */
-  pcre *re_bump = NULL; /* Regex instance for empty matches */
-  pcre_extra *extra_bump = NULL; /* Almost dummy */
+  pcre_cache_entry_ptr bump_pce; /* Regex instance for empty matches */
   while ((limit == -1 || limit > 1)) {
     int count = pcre_exec(pce->re, extra, ssubject.data(), ssubject.size(),
                           start_offset, g_notempty, offsets, size_offsets);
@@ -1239,14 +1382,13 @@ Variant preg_split(CVarRef pattern, CVarRef subject, int limit /* = -1 */,
          to achieve this, unless we're already at the end of the string. */
       if (g_notempty != 0 && start_offset < ssubject.size()) {
         if (pce->compile_options & PCRE_UTF8) {
-          if (re_bump == NULL) {
-            int dummy;
-            if ((re_bump = pcre_get_compiled_regex("/./us", &extra_bump,
-                                                   &dummy)) == NULL) {
+          if (!bump_pce) {
+            bump_pce = pcre_get_compiled_regex_cache("/./us");
+            if (!bump_pce) {
               return false;
             }
           }
-          count = pcre_exec(re_bump, extra_bump, ssubject.data(),
+          count = pcre_exec(bump_pce->re, bump_pce->extra, ssubject.data(),
                             ssubject.size(), start_offset,
                             0, offsets, size_offsets);
           if (count < 1) {
@@ -1367,7 +1509,7 @@ String preg_quote(CStrRef str, CStrRef delimiter /* = null_string */) {
 }
 
 int preg_last_error() {
-  return s_pcre_cache->error_code;
+  return s_pcre_globals->error_code;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -53,6 +53,18 @@ Variant php_split(CStrRef spliton, CStrRef str, int count, bool icase);
 int preg_last_error();
 
 void preg_get_pcre_cache() ATTRIBUTE_COLD;
+
+/**
+ * Counts kept by the compiled pattern cache since the process started.
+ */
+struct PCRECacheStats {
+  int size;
+  int misses;
+  int evictions;
+  int jits;
+  bool jitSupported;  // by the PCRE library in use
+};
+void preg_get_pcre_cache_stats(PCRECacheStats &stats);
 ///////////////////////////////////////////////////////////////////////////////
 }
 
@@ -33,12 +33,15 @@
 #include <runtime/base/server/admin_request_handler.h>
 #include <runtime/base/server/server_stats.h>
 #include <runtime/base/server/server_note.h>
+#include <runtime/base/server/request_sampler.h>
 #include <runtime/base/memory/memory_manager.h>
 #include <util/process.h>
 #include <util/capability.h>
 #include <util/timer.h>
 #include <util/stack_trace.h>
 #include <util/light_process.h>
+#include <util/stat_cache.h>
+#include <util/pgo_profile.h>
 #include <runtime/base/source_info.h>
 #include <runtime/base/rtti_info.h>
 #include <runtime/base/frame_injection.h>
@@ -489,6 +492,12 @@ static void pagein_self(void) {
   free(buf);
 }
 
+static int s_logErrorDropped = ServerStats::Intern("log.error.dropped");
+
+static void on_log_line_dropped() {
+  ServerStats::Log(s_logErrorDropped, 1);
+}
+
 static int start_server(const std::string &username) {
   // Before we start the webserver, make sure the entire
   // binary is paged into memory.
@@ -530,8 +539,26 @@ static int start_server(const std::string &username) {
   }
 #endif
 
+  if (!RuntimeOption::EvalPreparseFileList.empty()) {
+    Eval::FileRepository::Preparse(RuntimeOption::EvalPreparseFileList,
+                                   RuntimeOption::EvalPreparseThreadCount);
+  }
+
+  if (Logger::UseAsyncWriter) {
+    Logger::SetDroppedHook(on_log_line_dropped);
+    Logger::StartAsyncWriter();
+  }
+
   HttpServer::Server = HttpServerPtr(new HttpServer(sslCTX));
   HttpServer::Server->run();
+
+  if (Logger::UseAsyncWriter) {
+    Logger::StopAsyncWriter();
+  }
+
+  if (!RuntimeOption::EvalPreparseFileList.empty()) {
+    Eval::FileRepository::SaveFileList(RuntimeOption::EvalPreparseFileList);
+  }
   return 0;
 }
 
@@ -1013,6 +1040,9 @@ void hphp_process_init() {
   Extension::InitModules();
   apc_load(RuntimeOption::ApcLoadThread);
   StaticString::FinishInit();
+  if (RuntimeOption::ServerStatCache) {
+    StatCache::Start(RuntimeOption::ServerStatCacheRevalidateSeconds);
+  }
 
   // Reset the preloaded g_context
   ExecutionContext *context = g_context.getNoCheck();
@@ -1078,6 +1108,8 @@ void hphp_session_init(bool blank_warmup /* = false */) {
   init_thread_locals();
   ThreadInfo::s_threadInfo->onSessionInit();
   MemoryManager::TheMemoryManager()->resetStats();
+  MemoryManager::TheMemoryManager()->beginArena();
+  RequestSampler::OnRequestStart();
   if (!s_warmup_state->done) {
     free_global_variables(); // just to be safe
     init_global_variables();
@@ -1220,6 +1252,7 @@ void hphp_thread_exit() {
 }
 
 void hphp_session_exit() {
+  RequestSampler::OnRequestEnd();
   FiberAsyncFunc::OnRequestExit();
   Eval::RequestEvalState::Reset();
   // Server note has to live long enough for the access log to fire.
@@ -1252,6 +1285,7 @@ void hphp_session_exit() {
     g_context.destroy();
 
     mm->rollback();
+    mm->endArena();
     s_warmup_state->atCheckpoint = true;
     g_context.getCheck();
   } else {
@@ -1264,7 +1298,17 @@ void hphp_session_exit() {
 }
 
 void hphp_process_exit() {
+  if (!RuntimeOption::StatsSamplerProfileFile.empty()) {
+    PgoProfile profile;
+    RequestSampler::Profile(profile, false);
+    if (!profile.empty() &&
+        !profile.save(RuntimeOption::StatsSamplerProfileFile.c_str())) {
+      Logger::Error("Unable to save sampled profile to %s",
+                    RuntimeOption::StatsSamplerProfileFile.c_str());
+    }
+  }
   FiberAsyncFunc::Stop();
+  StatCache::Stop();
   Eval::Debugger::Stop();
   Extension::ShutdownModules();
   LightProcess::Close();
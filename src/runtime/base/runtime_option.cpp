@@ -26,6 +26,8 @@
 #include <util/util.h>
 #include <util/network.h>
 #include <util/logger.h>
+#include <util/async_log_writer.h>
+#include <util/db_conn.h>
 #include <util/stack_trace.h>
 #include <util/process.h>
 #include <util/file_cache.h>
@@ -98,11 +100,14 @@ bool RuntimeOption::ServerThreadRoundRobin = false;
 int RuntimeOption::ServerThreadDropCacheTimeoutSeconds = 0;
 bool RuntimeOption::ServerThreadJobLIFO = false;
 bool RuntimeOption::ServerThreadDropStack = false;
+bool RuntimeOption::ServerThreadWorkStealing = false;
+int RuntimeOption::ServerEventLoopCount = 1;
 int RuntimeOption::PageletServerThreadCount = 0;
 bool RuntimeOption::PageletServerThreadRoundRobin = false;
 int RuntimeOption::PageletServerThreadDropCacheTimeoutSeconds = 0;
 int RuntimeOption::PageletServerQueueLimit = 0;
 bool RuntimeOption::PageletServerThreadDropStack = false;
+bool RuntimeOption::PageletServerThreadWorkStealing = false;
 int RuntimeOption::FiberCount = 1;
 int RuntimeOption::RequestTimeoutSeconds = 0;
 size_t RuntimeOption::ServerMemoryHeadRoom = 0;
@@ -173,6 +178,8 @@ std::set<std::string> RuntimeOption::XboxPasswords;
 std::string RuntimeOption::SourceRoot;
 std::vector<std::string> RuntimeOption::IncludeSearchPaths;
 std::string RuntimeOption::FileCache;
+bool RuntimeOption::ServerStatCache = false;
+int RuntimeOption::ServerStatCacheRevalidateSeconds = 2;
 std::string RuntimeOption::DefaultDocument;
 std::string RuntimeOption::ErrorDocument404;
 bool RuntimeOption::ForbiddenAs404 = false;
@@ -232,10 +239,16 @@ int RuntimeOption::MySQLSlowQueryThreshold = 1000; // ms
 bool RuntimeOption::MySQLKillOnTimeout = false;
 int RuntimeOption::MySQLMaxRetryOpenOnFail = 1;
 int RuntimeOption::MySQLMaxRetryQueryOnFail = 1;
+bool RuntimeOption::MySQLParallelEventLoop = true;
 
 int RuntimeOption::HttpDefaultTimeout = 30;
 int RuntimeOption::HttpSlowQueryThreshold = 5000; // ms
 
+int RuntimeOption::MemcachePoolSize = 0;
+bool RuntimeOption::MemcacheCoalesceGets = true;
+
+int RuntimeOption::SessionSweepInterval = 60;
+
 bool RuntimeOption::TranslateLeakStackTrace = false;
 bool RuntimeOption::NativeStackTrace = false;
 bool RuntimeOption::FullBacktrace = false;
@@ -275,6 +288,11 @@ std::vector<std::string> RuntimeOption::APCSizeMiddleReplace;
 std::vector<std::string> RuntimeOption::APCSizeSkipPrefix;
 bool RuntimeOption::EnableAPCSizeDetail = false;
 bool RuntimeOption::EnableAPCFetchStats = false;
+int RuntimeOption::StatsSamplerRate = 0;
+int RuntimeOption::StatsSamplerInterval = 10000;
+int RuntimeOption::StatsSamplerNativeDepth = 8;
+int RuntimeOption::StatsSamplerMaxStacks = 16384;
+std::string RuntimeOption::StatsSamplerProfileFile;
 bool RuntimeOption::APCSizeCountPrime = false;
 
 int64 RuntimeOption::MaxRSS = 0;
@@ -285,6 +303,9 @@ int64 RuntimeOption::MaxMemcacheKeyCount = 0;
 int RuntimeOption::SocketDefaultTimeout = 5;
 bool RuntimeOption::LockCodeMemory = false;
 bool RuntimeOption::EnableMemoryManager = true;
+bool RuntimeOption::EnableRequestArena = false;
+int64 RuntimeOption::RequestArenaMaxBytes = 1LL << 30;
+int64 RuntimeOption::RequestArenaRetainBytes = 16LL << 20;
 bool RuntimeOption::CheckMemory = false;
 bool RuntimeOption::UseHphpArray = false;
 bool RuntimeOption::UseSmallArray = false;
@@ -295,15 +316,19 @@ bool RuntimeOption::EnableConstLoad = false;
 bool RuntimeOption::ForceConstLoadToAPC = true;
 std::string RuntimeOption::ApcPrimeLibrary;
 int RuntimeOption::ApcLoadThread = 1;
+std::string RuntimeOption::ApcSnapshotFile;
 std::set<std::string> RuntimeOption::ApcCompletionKeys;
 RuntimeOption::ApcTableTypes RuntimeOption::ApcTableType = ApcConcurrentTable;
 RuntimeOption::ApcTableLockTypes RuntimeOption::ApcTableLockType =
   ApcReadWriteLock;
+RuntimeOption::ApcSerializers RuntimeOption::ApcSerializer = ApcPhpSerializer;
 time_t RuntimeOption::ApcKeyMaturityThreshold = 20;
 size_t RuntimeOption::ApcMaximumCapacity = 0;
 int RuntimeOption::ApcKeyFrequencyUpdatePeriod = 1000;
 bool RuntimeOption::ApcExpireOnSets = false;
 int RuntimeOption::ApcPurgeFrequency = 4096;
+int RuntimeOption::ApcShardCount = 16;
+int RuntimeOption::ApcPurgeInterval = 1;
 bool RuntimeOption::ApcAllowObj = false;
 int RuntimeOption::ApcTTLLimit = -1;
 
@@ -327,6 +352,8 @@ bool RuntimeOption::EnableXHP = true;
 bool RuntimeOption::EnableObjDestructCall = false;
 bool RuntimeOption::EnableEvalOptimization = true;
 int RuntimeOption::EvalScalarValueExprLimit = 64;
+std::string RuntimeOption::EvalPreparseFileList;
+int RuntimeOption::EvalPreparseThreadCount = 0;
 bool RuntimeOption::CheckSymLink = false;
 bool RuntimeOption::NativeXHP = true;
 int RuntimeOption::ScannerType = 0;
@@ -369,6 +396,9 @@ std::string RuntimeOption::MailForceExtraParameters;
 
 int RuntimeOption::PregBacktraceLimit = 100000;
 int RuntimeOption::PregRecursionLimit = 100000;
+int RuntimeOption::PregCacheSize = 4096;
+int64 RuntimeOption::PregCacheMemoryLimit = 0;
+int RuntimeOption::PregJitHitThreshold = 100;
 bool RuntimeOption::EnablePregErrorLog = true;
 
 bool RuntimeOption::EnableHotProfiler = true;
@@ -518,6 +548,11 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
     LogAggregatorDatabase = aggregator["Database"].getString();
     LogAggregatorSleepSeconds = aggregator["SleepSeconds"].getInt16(10);
 
+    Hdf asyncWriter = logger["AsyncWriter"];
+    Logger::UseAsyncWriter = asyncWriter.getBool();
+    AsyncLogWriter::QueueSize = asyncWriter["QueueSize"].getInt32(4096);
+    AsyncLogWriter::FlushInterval = asyncWriter["FlushInterval"].getInt32(10);
+
     AlwaysLogUnhandledExceptions =
       logger["AlwaysLogUnhandledExceptions"].getBool(true);
     NoSilencer = logger["NoSilencer"].getBool();
@@ -598,6 +633,8 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
       server["ThreadDropCacheTimeoutSeconds"].getInt32(0);
     ServerThreadJobLIFO = server["ThreadJobLIFO"].getBool();
     ServerThreadDropStack = server["ThreadDropStack"].getBool();
+    ServerThreadWorkStealing = server["ThreadWorkStealing"].getBool();
+    ServerEventLoopCount = server["EventLoopCount"].getInt32(1);
     RequestTimeoutSeconds = server["RequestTimeoutSeconds"].getInt32(0);
     ServerMemoryHeadRoom = server["MemoryHeadRoom"].getInt64(0);
     RequestMemoryMaxBytes = server["RequestMemoryMaxBytes"].getInt64(-1);
@@ -659,6 +696,9 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
     IncludeSearchPaths.insert(IncludeSearchPaths.begin(), "./");
 
     FileCache = server["FileCache"].getString();
+    ServerStatCache = server["StatCache"].getBool(false);
+    ServerStatCacheRevalidateSeconds =
+      server["StatCacheRevalidateSeconds"].getInt32(2);
     DefaultDocument = server["DefaultDocument"].getString();
     ErrorDocument404 = server["ErrorDocument404"].getString();
     normalizePath(ErrorDocument404);
@@ -721,6 +761,11 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
     if (!EnableMemoryManager) {
       MemoryManager::TheMemoryManager()->disable();
     }
+    EnableRequestArena = server["EnableRequestArena"].getBool(false);
+    RequestArenaMaxBytes =
+      server["RequestArenaMaxBytes"].getInt64(1LL << 30);
+    RequestArenaRetainBytes =
+      server["RequestArenaRetainBytes"].getInt64(16LL << 20);
     CheckMemory = server["CheckMemory"].getBool();
     UseHphpArray = server["UseHphpArray"].getBool(false);
     UseSmallArray = server["UseSmallArray"].getBool(false);
@@ -735,6 +780,7 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
     ForceConstLoadToAPC = apc["ForceConstLoadToAPC"].getBool(true);
     ApcPrimeLibrary = apc["PrimeLibrary"].getString();
     ApcLoadThread = apc["LoadThread"].getInt16(2);
+    ApcSnapshotFile = apc["SnapshotFile"].getString();
     apc["CompletionKeys"].get(ApcCompletionKeys);
 
     string apcTableType = apc["TableType"].getString("concurrent");
@@ -742,6 +788,10 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
       ApcTableType = ApcHashTable;
     } else if (strcasecmp(apcTableType.c_str(), "concurrent") == 0) {
       ApcTableType = ApcConcurrentTable;
+    } else if (strcasecmp(apcTableType.c_str(), "sharded") == 0) {
+      ApcTableType = ApcShardedTable;
+    } else if (strcasecmp(apcTableType.c_str(), "tinylfu") == 0) {
+      ApcTableType = ApcTinyLfuTable;
     } else {
       throw InvalidArgumentException("apc table type",
                                      "Invalid table type");
@@ -755,9 +805,20 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
       throw InvalidArgumentException("apc lock type",
                                      "Invalid lock type");
     }
+    string apcSerializer = apc["Serializer"].getString("php");
+    if (strcasecmp(apcSerializer.c_str(), "php") == 0) {
+      ApcSerializer = ApcPhpSerializer;
+    } else if (strcasecmp(apcSerializer.c_str(), "binary") == 0) {
+      ApcSerializer = ApcBinarySerializer;
+    } else {
+      throw InvalidArgumentException("apc serializer",
+                                     "Invalid serializer");
+    }
 
     ApcExpireOnSets = apc["ExpireOnSets"].getBool();
     ApcPurgeFrequency = apc["PurgeFrequency"].getInt32(4096);
+    ApcShardCount = apc["ShardCount"].getInt32(16);
+    ApcPurgeInterval = apc["PurgeInterval"].getInt32(1);
 
     ApcAllowObj = apc["AllowObject"].getBool();
     ApcTTLLimit = apc["TTLLimit"].getInt32(-1);
@@ -867,6 +928,8 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
     PageletServerThreadCount = pagelet["ThreadCount"].getInt32(0);
     PageletServerThreadRoundRobin = pagelet["ThreadRoundRobin"].getBool();
     PageletServerThreadDropStack = pagelet["ThreadDropStack"].getBool();
+    PageletServerThreadWorkStealing =
+      pagelet["ThreadWorkStealing"].getBool();
     PageletServerThreadDropCacheTimeoutSeconds =
       pagelet["ThreadDropCacheTimeoutSeconds"].getInt32(0);
     PageletServerQueueLimit = pagelet["QueueLimit"].getInt32(0);
@@ -915,12 +978,23 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
     MySQLKillOnTimeout = mysql["KillOnTimeout"].getBool();
     MySQLMaxRetryOpenOnFail = mysql["MaxRetryOpenOnFail"].getInt32(1);
     MySQLMaxRetryQueryOnFail = mysql["MaxRetryQueryOnFail"].getInt32(1);
+    MySQLParallelEventLoop = mysql["ParallelEventLoop"].getBool(true);
+    DBConn::UseEventLoop = MySQLParallelEventLoop;
   }
   {
     Hdf http = config["Http"];
     HttpDefaultTimeout = http["DefaultTimeout"].getInt32(30);
     HttpSlowQueryThreshold = http["SlowQueryThreshold"].getInt32(5000);
   }
+  {
+    Hdf memcache = config["Memcache"];
+    MemcachePoolSize = memcache["PoolSize"].getInt32(0);
+    MemcacheCoalesceGets = memcache["CoalesceGets"].getBool(true);
+  }
+  {
+    Hdf session = config["Session"];
+    SessionSweepInterval = session["SweepInterval"].getInt32(60);
+  }
   {
     Hdf debug = config["Debug"];
     NativeStackTrace = debug["NativeStackTrace"].getBool();
@@ -981,6 +1055,16 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
     StatsSlotDuration = stats["SlotDuration"].getInt32(10 * 60); // 10 minutes
     StatsMaxSlot = stats["MaxSlot"].getInt32(12 * 6); // 12 hours
 
+    {
+      Hdf sampler = stats["Sampler"];
+      StatsSamplerRate = sampler["Rate"].getInt32(0);
+      StatsSamplerInterval = sampler["Interval"].getInt32(10000);
+      if (StatsSamplerInterval <= 0) StatsSamplerInterval = 10000;
+      StatsSamplerNativeDepth = sampler["NativeDepth"].getInt32(8);
+      StatsSamplerMaxStacks = sampler["MaxStacks"].getInt32(16384);
+      StatsSamplerProfileFile = sampler["ProfileFile"].getString();
+    }
+
     {
       Hdf apcSize = stats["APCSize"];
       EnableAPCSizeStats = apcSize["Enable"].getBool();
@@ -1031,6 +1115,8 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
     EnableObjDestructCall = eval["EnableObjDestructCall"].getBool(false);
     EnableEvalOptimization = eval["EnableEvalOptimization"].getBool(true);
     EvalScalarValueExprLimit = eval["EvalScalarValueExprLimit"].getInt32(64);
+    EvalPreparseFileList = eval["PreparseFileList"].getString();
+    EvalPreparseThreadCount = eval["PreparseThreadCount"].getInt32(0);
     MaxUserFunctionId = eval["MaxUserFunctionId"].getInt32(2 * 65536);
     CheckSymLink = eval["CheckSymLink"].getBool(false);
     NativeXHP = eval["NativeXHP"].getBool(true);
@@ -1086,6 +1172,9 @@ void RuntimeOption::Load(Hdf &config, StringVec *overwrites /* = NULL */) {
     Hdf preg = config["Preg"];
     PregBacktraceLimit = preg["BacktraceLimit"].getInt32(100000);
     PregRecursionLimit = preg["RecursionLimit"].getInt32(100000);
+    PregCacheSize = preg["CacheSize"].getInt32(4096);
+    PregCacheMemoryLimit = preg["CacheMemoryLimit"].getInt64(0);
+    PregJitHitThreshold = preg["JitHitThreshold"].getInt32(100);
     EnablePregErrorLog = preg["ErrorLog"].getBool(true);
   }
 
@@ -92,11 +92,14 @@ public:
   static int ServerThreadDropCacheTimeoutSeconds;
   static bool ServerThreadJobLIFO;
   static bool ServerThreadDropStack;
+  static bool ServerThreadWorkStealing;
+  static int ServerEventLoopCount;
   static int PageletServerThreadCount;
   static bool PageletServerThreadRoundRobin;
   static int PageletServerThreadDropCacheTimeoutSeconds;
   static int PageletServerQueueLimit;
   static bool PageletServerThreadDropStack;
+  static bool PageletServerThreadWorkStealing;
   static int FiberCount;
   static int RequestTimeoutSeconds;
   static size_t ServerMemoryHeadRoom;
@@ -168,6 +171,8 @@ public:
   static std::string SourceRoot;
   static std::vector<std::string> IncludeSearchPaths;
   static std::string FileCache;
+  static bool ServerStatCache;
+  static int ServerStatCacheRevalidateSeconds;
   static std::string DefaultDocument;
   static std::string ErrorDocument404;
   static bool ForbiddenAs404;
@@ -227,10 +232,16 @@ public:
   static bool MySQLKillOnTimeout;
   static int  MySQLMaxRetryOpenOnFail;
   static int  MySQLMaxRetryQueryOnFail;
+  static bool MySQLParallelEventLoop;
 
   static int  HttpDefaultTimeout;
   static int  HttpSlowQueryThreshold;
 
+  static int  MemcachePoolSize;
+  static bool MemcacheCoalesceGets;
+
+  static int  SessionSweepInterval;
+
   static bool TranslateLeakStackTrace;
   static bool NativeStackTrace;
   static bool FullBacktrace;
@@ -260,6 +271,11 @@ public:
   static std::string StatsXSLProxy;
   static int StatsSlotDuration;
   static int StatsMaxSlot;
+  static int StatsSamplerRate;
+  static int StatsSamplerInterval;
+  static int StatsSamplerNativeDepth;
+  static int StatsSamplerMaxStacks;
+  static std::string StatsSamplerProfileFile;
 
   static bool EnableAPCSizeStats;
   static bool EnableAPCSizeGroup;
@@ -284,6 +300,9 @@ public:
   static int  SocketDefaultTimeout;
   static bool LockCodeMemory;
   static bool EnableMemoryManager;
+  static bool EnableRequestArena;
+  static int64 RequestArenaMaxBytes;
+  static int64 RequestArenaRetainBytes;
   static bool CheckMemory;
   static bool UseHphpArray;
   static bool UseSmallArray;
@@ -294,11 +313,14 @@ public:
   static bool ForceConstLoadToAPC;
   static std::string ApcPrimeLibrary;
   static int ApcLoadThread;
+  static std::string ApcSnapshotFile;
   static std::set<std::string> ApcCompletionKeys;
   enum ApcTableTypes {
     ApcHashTable,
     ApcLfuTable,
-    ApcConcurrentTable
+    ApcConcurrentTable,
+    ApcShardedTable,
+    ApcTinyLfuTable
   };
   static ApcTableTypes ApcTableType;
   enum ApcTableLockTypes {
@@ -306,11 +328,18 @@ public:
     ApcReadWriteLock
   };
   static ApcTableLockTypes ApcTableLockType;
+  enum ApcSerializers {
+    ApcPhpSerializer,
+    ApcBinarySerializer
+  };
+  static ApcSerializers ApcSerializer;
   static time_t ApcKeyMaturityThreshold;
   static size_t ApcMaximumCapacity;
   static int ApcKeyFrequencyUpdatePeriod;
   static bool ApcExpireOnSets;
   static int ApcPurgeFrequency;
+  static int ApcShardCount;
+  static int ApcPurgeInterval;
   static bool ApcAllowObj;
   static int ApcTTLLimit;
 
@@ -338,6 +367,8 @@ public:
   static bool EnableObjDestructCall;
   static bool EnableEvalOptimization;
   static int  EvalScalarValueExprLimit;
+  static std::string EvalPreparseFileList;
+  static int EvalPreparseThreadCount;
   static bool CheckSymLink;
   static bool NativeXHP;
   static int ScannerType;
@@ -384,6 +415,9 @@ public:
   // preg stack depth and debug support options
   static int PregBacktraceLimit;
   static int PregRecursionLimit;
+  static int PregCacheSize;
+  static int64 PregCacheMemoryLimit;
+  static int PregJitHitThreshold;
   static bool EnablePregErrorLog;
 };
 
@@ -25,11 +25,14 @@
 #include <util/atomic.h>
 #include <util/compatibility.h>
 #include <util/util.h>
+#include <util/async_log_writer.h>
 
 namespace HPHP {
 using namespace std;
 ///////////////////////////////////////////////////////////////////////////////
 
+static int s_statsDropped = ServerStats::Intern("log.access.dropped");
+
 AccessLog::~AccessLog() {
   signal(SIGCHLD, SIG_DFL);
   for (uint i = 0; i < m_output.size(); ++i) {
@@ -70,12 +73,17 @@ void AccessLog::init(const string &format,
 
 void AccessLog::openFiles(const string &username) {
   ASSERT(m_output.empty() && m_cronOutput.empty());
+  compileFormat(m_defaultFormat.c_str(), m_defaultFields);
   if (m_files.empty()) return;
   for (vector<AccessLogFileData>::const_iterator it = m_files.begin();
        it != m_files.end(); ++it) {
     const string &file = it->file;
     const string &symLink = it->symLink;
     ASSERT(!file.empty());
+    m_fileFields.push_back(LogFormat());
+    compileFormat(it->format.c_str(), m_fileFields.back());
+
+    int target = -1;
     FILE *fp = NULL;
     if (Logger::UseCronolog) {
       CronologPtr cl(new Cronolog);
@@ -88,6 +96,9 @@ void AccessLog::openFiles(const string &username) {
         cl->m_file = fopen(file.c_str(), "a");
       }
       m_cronOutput.push_back(cl);
+      if (Logger::UseAsyncWriter) {
+        target = AsyncLogWriter::TheWriter.addTarget(cl.get());
+      }
     } else {
       if (file[0] == '|') {
         string plog = file.substr(1);
@@ -99,7 +110,11 @@ void AccessLog::openFiles(const string &username) {
         Logger::Error("Could not open access log file %s", file.c_str());
       }
       m_output.push_back(LogFileData(fp));
+      if (fp && Logger::UseAsyncWriter) {
+        target = AsyncLogWriter::TheWriter.addTarget(fp, file[0] == '|');
+      }
     }
+    m_asyncTargets.push_back(target);
   }
 }
 
@@ -107,22 +122,36 @@ void AccessLog::log(Transport *transport, const VirtualHost *vhost) {
   ASSERT(transport);
   if (!m_initialized) return;
 
+  string line;
   AccessLog::ThreadData *threadData = m_fGetThreadData();
   FILE *threadLog = threadData->log;
   if (threadLog) {
-    threadData->bytesWritten +=
-      writeLog(transport, vhost, threadLog, m_defaultFormat.c_str());
+    formatLine(line, m_defaultFields, transport, vhost);
+    threadData->bytesWritten += writeLine(threadLog, line);
     Logger::checkDropCache(threadData->bytesWritten,
                            threadData->prevBytesWritten,
                            threadLog);
   }
+
+  AsyncLogWriter &writer = AsyncLogWriter::TheWriter;
+  if (writer.isRunning()) {
+    for (uint i = 0; i < m_asyncTargets.size(); ++i) {
+      if (m_asyncTargets[i] < 0) continue;
+      formatLine(line, m_fileFields[i], transport, vhost);
+      if (!writer.write(m_asyncTargets[i], line)) {
+        ServerStats::Log(s_statsDropped, 1);
+      }
+    }
+    return;
+  }
+
   if (Logger::UseCronolog) {
     for (uint i = 0; i < m_cronOutput.size(); ++i) {
       Cronolog &cronOutput = *m_cronOutput[i];
       FILE *outFile = cronOutput.getOutputFile();
       if (!outFile) continue;
-      const char *format = m_files[i].format.c_str();
-      int bytes = writeLog(transport, vhost, outFile, format);
+      formatLine(line, m_fileFields[i], transport, vhost);
+      int bytes = writeLine(outFile, line);
       atomic_add(cronOutput.m_bytesWritten, bytes);
       Logger::checkDropCache(cronOutput.m_bytesWritten,
                              cronOutput.m_prevBytesWritten,
@@ -133,8 +162,8 @@ void AccessLog::log(Transport *transport, const VirtualHost *vhost) {
       LogFileData &output = m_output[i];
       FILE *outFile = output.log;
       if (!outFile) continue;
-      const char *format = m_files[i].format.c_str();
-      int bytes = writeLog(transport, vhost, outFile, format);
+      formatLine(line, m_fileFields[i], transport, vhost);
+      int bytes = writeLine(outFile, line);
       atomic_add(output.bytesWritten, bytes);
       if (m_files[i].file[0] != '|') {
         Logger::checkDropCache(output.bytesWritten,
@@ -145,126 +174,129 @@ void AccessLog::log(Transport *transport, const VirtualHost *vhost) {
   }
 }
 
-int AccessLog::writeLog(Transport *transport, const VirtualHost *vhost,
-                        FILE *outFile, const char *format) {
-   char c;
-   ostringstream out;
-   while (c = *format++) {
-     if (c != '%') {
-       out << c;
-       continue;
-     }
-
-     if (parseConditions(format, transport->getResponseCode())) {
-       string arg = parseArgument(format);
-       if (!genField(out, format, transport, vhost, arg)) {
-         out << "-";
-       }
-     } else {
-       skipField(format);
-       out << "-";
-     }
-   }
-   out << endl;
-   string output = out.str();
-   int nbytes = fprintf(outFile, "%s", output.c_str());
-   fflush(outFile);
-   return nbytes;
+int AccessLog::writeLine(FILE *outFile, const string &line) {
+  int nbytes = fwrite(line.data(), 1, line.size(), outFile);
+  fflush(outFile);
+  return nbytes;
 }
 
-bool AccessLog::parseConditions(const char* &format, int code) {
-  bool wantMatch = true;
-  if (*format == '!') {
-    wantMatch = false;
-    format++;
-  } else if (!isdigit(*format)) {
-    // No conditions
-    return true;
+void AccessLog::formatLine(string &out, const LogFormat &fields,
+                           Transport *transport, const VirtualHost *vhost) {
+  out.clear();
+  int code = transport->getResponseCode();
+  for (uint i = 0; i < fields.size(); i++) {
+    const LogField &field = fields[i];
+    if (field.type == '\0') {
+      out += field.text;
+      continue;
+    }
+    if (!field.codes.empty() || !field.wantMatch) {
+      bool matched = false;
+      for (uint j = 0; j < field.codes.size(); j++) {
+        if (field.codes[j] == code) {
+          matched = true;
+          break;
+        }
+      }
+      if (matched != field.wantMatch) {
+        out += '-';
+        continue;
+      }
+    }
+    if (!genField(out, field, transport, vhost)) {
+      out += '-';
+    }
   }
-  char buf[4];
-  buf[3] = '\0';
+  out += '\n';
+}
 
-  bool matched = false;
-  while(isdigit(*format)) {
-    buf[0] = format[0];
-    buf[1] = format[1];
-    buf[2] = format[2];
-    int c = atoi(buf);
-    if (c == code) {
-      matched = true;
-      break;
+/**
+ * Apache style directives: "%" [conditions] ["{" argument "}"] letter, where
+ * conditions are an optional "!" followed by comma separated response codes,
+ * e.g. "%!200,304{Referer}i". Other characters before the letter, like the
+ * ">" in "%>s", are ignored.
+ */
+void AccessLog::compileFormat(const char *format, LogFormat &fields) {
+  fields.clear();
+  while (*format) {
+    LogField field;
+    if (*format != '%') {
+      const char *start = format;
+      while (*format && *format != '%') format++;
+      field.text.assign(start, format - start);
+      fields.push_back(field);
+      continue;
     }
-    format+=4;
-  }
-  while (!(*format == '{' || isalpha(*format))) {
     format++;
-  }
-  return wantMatch == matched;
-}
 
-string AccessLog::parseArgument(const char* &format) {
-  if (*format != '{') return string();
-  format++;
-  const char *start = format;
-  while (*format != '}') { format++; }
-  string res(start, format - start);
-  format++;
-  return res;
+    if (*format == '!') {
+      field.wantMatch = false;
+      format++;
+    }
+    while (isdigit(*format)) {
+      field.codes.push_back(atoi(format));
+      while (isdigit(*format)) format++;
+      if (*format == ',') format++;
+    }
+    while (*format && *format != '{' && !isalpha(*format)) format++;
+    if (*format == '{') {
+      const char *start = ++format;
+      while (*format && *format != '}') format++;
+      field.text.assign(start, format - start);
+      if (*format) format++;
+    }
+    while (*format && !isalpha(*format)) format++;
+    if (!*format) break;
+    field.type = *format++;
+    fields.push_back(field);
+  }
 }
 
-void AccessLog::skipField(const char* &format) {
-  // Skip argument
-  if (*format == '{') {
-    while (*format != '}') { format++; }
-    format++;
-  }
-  // Find control letter
-  while (!isalpha(*format)) { format++; }
-  // Skip it
-  format++;
+static void append_int(string &out, int64 n) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%lld", (long long)n);
+  out += buf;
 }
 
-static void escape_data(ostringstream &out, const char *s, int len)
+static void escape_data(string &out, const char *s, int len)
 {
   static const char digits[] = "0123456789abcdef";
 
   for (int i = 0; i < len; i++) {
     unsigned char uc = *s++;
     switch (uc) {
-      case '"':  out << "\\\""; break;
-      case '\\': out << "\\\\"; break;
-      case '\b': out << "\\b";  break;
-      case '\f': out << "\\f";  break;
-      case '\n': out << "\\n";  break;
-      case '\r': out << "\\r";  break;
-      case '\t': out << "\\t";  break;
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\b': out += "\\b";  break;
+      case '\f': out += "\\f";  break;
+      case '\n': out += "\\n";  break;
+      case '\r': out += "\\r";  break;
+      case '\t': out += "\\t";  break;
       default:
         if (uc >= ' ' && (uc & 127) == uc) {
-          out << (char)uc;
+          out += (char)uc;
         } else {
-          out << "\\x" << digits[(uc >> 4) & 15] << digits[(uc >> 0) & 15];
+          out += "\\x";
+          out += digits[(uc >> 4) & 15];
+          out += digits[(uc >> 0) & 15];
         }
         break;
     }
   }
 }
 
-bool AccessLog::genField(ostringstream &out, const char* &format,
-                         Transport *transport, const VirtualHost *vhost,
-                         const string &arg) {
+bool AccessLog::genField(string &out, const LogField &field,
+                         Transport *transport, const VirtualHost *vhost) {
   int responseSize = transport->getResponseSize();
   int code = transport->getResponseCode();
+  const string &arg = field.text;
 
-  while (!isalpha(*format)) { format++; }
-  char type = *format;
-  format++;
-
-  switch (type) {
+  switch (field.type) {
   case 'b':
     if (responseSize == 0) return false;
     // Fall through
   case 'B':
-    out << responseSize;
+    append_int(out, responseSize);
     break;
   case 'C':
     if (arg.empty()) {
@@ -279,18 +311,22 @@ bool AccessLog::genField(ostringstream &out, const char* &format,
     {
       struct timespec now;
       gettime(CLOCK_MONOTONIC, &now);
-      out << gettime_diff_us(transport->getWallTime(), now);
+      append_int(out, gettime_diff_us(transport->getWallTime(), now));
     }
     break;
   case 'd':
     {
       struct timespec now;
       gettime(CLOCK_THREAD_CPUTIME_ID, &now);
-      out << gettime_diff_us(transport->getCpuTime(), now);
+      append_int(out, gettime_diff_us(transport->getCpuTime(), now));
     }
     break;
   case 'h':
-    out << transport->getRemoteHost();
+    {
+      const char *host = transport->getRemoteHost();
+      if (!host) return false;
+      out += host;
+    }
     break;
   case 'i':
     if (arg.empty()) return false;
@@ -300,9 +336,9 @@ bool AccessLog::genField(ostringstream &out, const char* &format,
 
       if (vhost && vhost->hasLogFilter() &&
           strcasecmp(arg.c_str(), "Referer") == 0) {
-        out << vhost->filterUrl(header);
+        out += vhost->filterUrl(header);
       } else {
-        out << header;
+        out += header;
       }
     }
     break;
@@ -311,7 +347,7 @@ bool AccessLog::genField(ostringstream &out, const char* &format,
     {
       String note = ServerNote::Get(arg);
       if (note.isNull()) return false;
-      out << note.c_str();
+      out += note.c_str();
     }
     break;
   case 'r':
@@ -324,28 +360,29 @@ bool AccessLog::genField(ostringstream &out, const char* &format,
       default: break;
       }
       if (!method) return false;
-      out << method << " ";
+      out += method;
+      out += ' ';
 
       const char *url = transport->getUrl();
       if (vhost && vhost->hasLogFilter()) {
-        out << vhost->filterUrl(url);
+        out += vhost->filterUrl(url);
       } else {
-        out << url;
+        out += url;
       }
 
-      string httpVersion = transport->getHTTPVersion();
-      out << " HTTP/" << httpVersion;
+      out += " HTTP/";
+      out += transport->getHTTPVersion();
     }
     break;
   case 's':
-    out << code;
+    append_int(out, code);
     break;
   case 'S':
     // %S is not defined in Apache, we grab it here
     {
       const std::string &info (transport->getResponseInfo());
       if (info.empty()) return false;
-      out << info;
+      out += info;
     }
     break;
   case 't':
@@ -358,21 +395,21 @@ bool AccessLog::genField(ostringstream &out, const char* &format,
       }
       char buf[256];
       time_t rawtime;
-      struct tm * timeinfo;
+      struct tm timeinfo;
       time(&rawtime);
-      timeinfo = localtime(&rawtime);
-      strftime(buf, 256, format, timeinfo);
-      out << buf;
+      localtime_r(&rawtime, &timeinfo);
+      strftime(buf, 256, format, &timeinfo);
+      out += buf;
     }
     break;
   case 'T':
-    out << TimeStamp::Current() - m_fGetThreadData()->startTime;
+    append_int(out, TimeStamp::Current() - m_fGetThreadData()->startTime);
     break;
   case 'U':
     {
       String b, q;
       RequestURI::splitURL(transport->getUrl(), b, q);
-      out << b;
+      out.append(b.data(), b.size());
     }
     break;
   case 'v':
@@ -380,18 +417,18 @@ bool AccessLog::genField(ostringstream &out, const char* &format,
       string host = transport->getHeader("Host");
       const string &sname = VirtualHost::GetCurrent()->serverName(host);
       if (sname.empty() || RuntimeOption::ForceServerNameToHeader) {
-        out << host;
+        out += host;
       } else {
-        out << sname;
+        out += sname;
       }
     }
     break;
   case 'Z':
-     out << ServerStats::Get("page.wall.psp");
-     break;
+    append_int(out, ServerStats::Get("page.wall.psp"));
+    break;
   case 'z':
-     out << ServerStats::Get("page.cpu.psp");
-     break;
+    append_int(out, ServerStats::Get("page.cpu.psp"));
+    break;
   default:
     return false;
   }
@@ -62,21 +62,36 @@ public:
   std::string &defaultFormat() { return m_defaultFormat; }
   std::vector<AccessLogFileData> &files() { return m_files; }
 private:
-  bool parseConditions(const char* &format, int code);
-  std::string parseArgument(const char* &format);
-  bool genField(std::ostringstream &out, const char* &format,
-                Transport *transport, const VirtualHost *vhost,
-                const std::string &arg);
-  void skipField(const char* &format);
-  int writeLog(Transport *transport, const VirtualHost *vhost,
-               FILE *outFile, const char *format);
+  /**
+   * One piece of a format string, either literal text or a %-directive,
+   * parsed once by compileFormat() so logging a request only walks fields.
+   */
+  class LogField {
+  public:
+    LogField() : type('\0'), wantMatch(true) {}
+    char type;               // '\0' for literal text
+    std::string text;        // the literal text or the {argument}
+    std::vector<int> codes;  // response codes the directive is limited to
+    bool wantMatch;          // false when codes are negated with '!'
+  };
+  typedef std::vector<LogField> LogFormat;
+
+  static void compileFormat(const char *format, LogFormat &fields);
+  bool genField(std::string &out, const LogField &field,
+                Transport *transport, const VirtualHost *vhost);
+  void formatLine(std::string &out, const LogFormat &fields,
+                  Transport *transport, const VirtualHost *vhost);
+  static int writeLine(FILE *outFile, const std::string &line);
 
   std::vector<LogFileData> m_output;
   std::vector<CronologPtr> m_cronOutput;
+  std::vector<int> m_asyncTargets; // AsyncLogWriter targets, -1 if not open
   bool m_initialized;
   GetThreadDataFunc m_fGetThreadData;
   std::string m_defaultFormat;
   std::vector<AccessLogFileData> m_files;
+  LogFormat m_defaultFields;
+  std::vector<LogFormat> m_fileFields;
 
   void openFiles(const std::string &username);
   Mutex m_lock;
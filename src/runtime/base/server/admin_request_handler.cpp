@@ -17,13 +17,16 @@
 #include <runtime/base/server/admin_request_handler.h>
 #include <runtime/base/server/http_server.h>
 #include <runtime/base/server/pagelet_server.h>
+#include <runtime/base/server/libevent_multi_server.h>
 #include <runtime/base/util/http_client.h>
 #include <runtime/base/server/server_stats.h>
+#include <runtime/base/server/request_sampler.h>
 #include <runtime/base/runtime_option.h>
 #include <util/process.h>
 #include <util/logger.h>
 #include <util/util.h>
 #include <util/mutex.h>
+#include <util/pgo_profile.h>
 #include <runtime/base/time/datetime.h>
 #include <runtime/base/memory/memory_manager.h>
 #include <runtime/base/program_functions.h>
@@ -124,6 +127,7 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
         "/check-load:      how many threads are actively handling requests\n"
         "/check-queued:    how many http requests are queued waiting to be\n"
         "                  handled\n"
+        "/check-loops:     load and queued requests of each event loop\n"
         "/check-pl-load:   how many pagelet threads are actively handling\n"
         "                  requests\n"
         "/check-pl-queued: how many pagelet requests are queued waiting to\n"
@@ -175,6 +179,8 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
         "                  group as <keysample>\n"
         "/const-ss:        get const_map_size\n"
         "/dump-apc:        dump all current value in APC to /tmp/apc_dump\n"
+        "/dump-apc-snapshot: write APC to Server.APC.SnapshotFile to load at\n"
+        "                  the next start\n"
         "/dump-const:      dump all constant value in constant map to\n"
         "                  /tmp/const_map_dump\n"
         "/dump-file-repo:  dump file repository to /tmp/file_repo_dump\n"
@@ -196,6 +202,13 @@ void AdminRequestHandler::handleRequest(Transport *transport) {
 #ifdef EXECUTION_PROFILER
         "/prof-exe:        returns sampled execution profile\n"
 #endif
+        "/prof-sample:     stacks sampled from requests, in folded form\n"
+        "    rate          optional, sample 1 in <rate> requests from now on,\n"
+        "                  0 to stop sampling\n"
+        "    reset         optional, start counting over after reporting\n"
+        "/prof-pgo:        the same samples as a profile for hphp's\n"
+        "                  --pgo-profile\n"
+        "    reset         optional, start counting over after reporting\n"
       ;
 #ifndef NO_TCMALLOC
         if (MallocExtensionInstance) {
@@ -495,6 +508,20 @@ bool AdminRequestHandler::handleCheckRequest(const std::string &cmd,
     transport->sendString(lexical_cast<string>(count));
     return true;
   }
+  if (cmd == "check-loops") {
+    ServerPtr server = HttpServer::Server->getPageServer();
+    LibEventMultiServer *multi =
+      dynamic_cast<LibEventMultiServer*>(server.get());
+    ostringstream out;
+    int count = multi ? multi->getLoopCount() : 1;
+    for (int i = 0; i < count; i++) {
+      ServerPtr loop = multi ? multi->getLoop(i) : server;
+      out << i << ": load " << loop->getActiveWorker()
+          << ", queued " << loop->getQueuedJobs() << "\n";
+    }
+    transport->sendString(out.str());
+    return true;
+  }
   if (cmd == "check-pl-load") {
     int count = PageletServer::GetActiveWorker();
     transport->sendString(lexical_cast<string>(count));
@@ -638,6 +665,27 @@ bool AdminRequestHandler::handleStatsRequest(const std::string &cmd,
 
 bool AdminRequestHandler::handleProfileRequest(const std::string &cmd,
                                                Transport *transport) {
+  if (cmd == "prof-sample") {
+    string rate = transport->getParam("rate");
+    if (!rate.empty()) {
+      RuntimeOption::StatsSamplerRate = atoi(rate.c_str());
+    }
+    string out;
+    RequestSampler::Report(out, transport->getIntParam("reset"));
+    transport->addHeader("X-Sampler-Dropped",
+                         lexical_cast<string>(RequestSampler::GetDropped())
+                         .c_str());
+    transport->sendString(out);
+    return true;
+  }
+  if (cmd == "prof-pgo") {
+    PgoProfile profile;
+    RequestSampler::Profile(profile, transport->getIntParam("reset"));
+    string out;
+    profile.write(out);
+    transport->sendString(out);
+    return true;
+  }
   if (cmd == "prof-exe") {
     std::map<ThreadInfo::Executing, int> counts;
     ThreadInfo::GetExecutionSamples(counts);
@@ -903,6 +951,21 @@ bool AdminRequestHandler::handleDumpCacheRequest(const std::string &cmd,
     transport->sendString("Done");
     return true;
   }
+  if (cmd == "dump-apc-snapshot") {
+    if (!RuntimeOption::EnableApc || RuntimeOption::ApcSnapshotFile.empty()) {
+      transport->sendString("No APC snapshot file\n");
+      return true;
+    }
+    int count = apc_dump_snapshot(RuntimeOption::ApcSnapshotFile.c_str());
+    if (count < 0) {
+      transport->sendString("Unable to write " +
+                            RuntimeOption::ApcSnapshotFile + "\n");
+    } else {
+      transport->sendString("Done: " + lexical_cast<string>(count) +
+                            " entries\n");
+    }
+    return true;
+  }
   if (cmd == "dump-file-repo") {
     if (file_dump) {
       (*file_dump)("/tmp/file_repo_dump");
@@ -510,6 +510,48 @@ void HttpProtocol::DecodeRfc1867(Transport *transport,
                      data, size, boundary);
 }
 
+static bool parse_range_number(const char *&p, int64 &n) {
+  if (*p < '0' || *p > '9') return false;
+  n = 0;
+  while (*p >= '0' && *p <= '9') {
+    if (n > (1LL << 40)) return false; // beyond any size we could serve
+    n = n * 10 + (*p++ - '0');
+  }
+  return true;
+}
+
+int HttpProtocol::ParseByteRange(const std::string &header, int size,
+                                 int &start, int &end) {
+  const char *p = header.c_str();
+  if (strncasecmp(p, "bytes=", 6) != 0) return 0;
+  p += 6;
+  while (*p == ' ') p++;
+
+  int64 first = -1, last = -1;
+  if (*p == '-') {
+    // suffix range: the last n bytes
+    int64 n;
+    ++p;
+    if (!parse_range_number(p, n)) return 0;
+    while (*p == ' ') p++;
+    if (*p) return 0;
+    if (n == 0 || size == 0) return -1;
+    first = n < size ? size - n : 0;
+    last = size - 1;
+  } else {
+    if (!parse_range_number(p, first) || *p++ != '-') return 0;
+    if (*p >= '0' && *p <= '9' && !parse_range_number(p, last)) return 0;
+    while (*p == ' ') p++;
+    if (*p) return 0; // includes multiple ranges
+    if (last >= 0 && last < first) return 0;
+    if (first >= size) return -1;
+    if (last < 0 || last >= size) last = size - 1;
+  }
+  start = first;
+  end = last;
+  return 1;
+}
+
 const char *HttpProtocol::GetReasonString(int code) {
   switch (code) {
   case 100: return "Continue";
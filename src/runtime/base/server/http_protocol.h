@@ -52,6 +52,16 @@ public:
 
   static const char *GetReasonString(int code);
 
+  /**
+   * Parses the Range header of a request for a resource of the given size.
+   * Only a single byte range is supported. Returns 1 and sets the inclusive
+   * [start, end] when it's satisfiable, -1 when it isn't (respond with 416),
+   * and 0 when the header should be ignored, i.e. when it's malformed or
+   * asks for more than one range (respond with the whole resource).
+   */
+  static int ParseByteRange(const std::string &header, int size,
+                            int &start, int &end);
+
 private:
   static void CopyParams(Variant &dest, Variant &src);
 };
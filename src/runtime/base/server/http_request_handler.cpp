@@ -23,6 +23,8 @@
 #include <runtime/base/server/dynamic_content_cache.h>
 #include <runtime/base/server/server_stats.h>
 #include <util/network.h>
+#include <util/util.h>
+#include <util/hash.h>
 #include <runtime/base/preg.h>
 #include <runtime/ext/ext_function.h>
 #include <runtime/base/server/access_log.h>
@@ -47,12 +49,39 @@ HttpRequestHandler::HttpRequestHandler()
   : m_pathTranslation(true) {
 }
 
-void HttpRequestHandler::sendStaticContent(Transport *transport,
-                                           const char *data, int len,
-                                           time_t mtime,
-                                           bool compressed,
-                                           const std::string &cmd,
-                                           const char *ext) {
+/**
+ * Whether the client's copy, named by If-None-Match or If-Modified-Since, is
+ * still current. Like most servers, If-Modified-Since only matches the exact
+ * Last-Modified date we sent.
+ */
+static bool not_modified(Transport *transport, const string &etag,
+                         const string &lastModified) {
+  string match = transport->getHeader("If-None-Match");
+  if (!match.empty()) {
+    if (etag.empty()) return false;
+    vector<string> tags;
+    Util::split(',', match.c_str(), tags, true);
+    for (unsigned int i = 0; i < tags.size(); i++) {
+      string &tag = tags[i];
+      size_t first = tag.find_first_not_of(' ');
+      if (first == string::npos) continue;
+      tag = tag.substr(first, tag.find_last_not_of(' ') - first + 1);
+      if (strncmp(tag.c_str(), "W/", 2) == 0) tag = tag.substr(2);
+      if (tag == "*" || tag == etag) return true;
+    }
+    return false;
+  }
+  return !lastModified.empty() &&
+    transport->getHeader("If-Modified-Since") == lastModified;
+}
+
+int HttpRequestHandler::sendStaticContent(Transport *transport,
+                                          const char *data, int len,
+                                          time_t mtime,
+                                          bool compressed,
+                                          const std::string &cmd,
+                                          const char *ext,
+                                          const std::string &etag /* = "" */) {
   ASSERT(ext);
   ASSERT(cmd.rfind('.') != string::npos);
   ASSERT(strcmp(ext, cmd.c_str() + cmd.rfind('.') + 1) == 0);
@@ -85,11 +114,23 @@ void HttpRequestHandler::sendStaticContent(Transport *transport,
       ("Expires", DateTime(expires, true).toString(DateTime::HttpHeader));
   }
 
+  string lastModified;
   if (mtime) {
-    transport->addHeader
-      ("Last-Modified", DateTime(mtime, true).toString(DateTime::HttpHeader));
+    lastModified =
+      DateTime(mtime, true).toString(DateTime::HttpHeader).data();
+    transport->addHeader("Last-Modified", lastModified.c_str());
+  }
+  // each encoding is a different representation, so it needs its own tag
+  string tag;
+  if (!etag.empty()) {
+    tag = "\"" + etag + (compressed ? "-gzip\"" : "\"");
+    transport->addHeader("ETag", tag.c_str());
+  }
+  if (compressed) {
+    transport->addHeader("Vary", "Accept-Encoding");
+  } else {
+    transport->addHeader("Accept-Ranges", "bytes");
   }
-  transport->addHeader("Accept-Ranges", "bytes");
 
   for (unsigned int i = 0; i < RuntimeOption::FilesMatches.size(); i++) {
     FilesMatch &rule = *RuntimeOption::FilesMatches[i];
@@ -105,7 +146,36 @@ void HttpRequestHandler::sendStaticContent(Transport *transport,
   // should not attempt to compress it.
   transport->disableCompression();
 
+  if (not_modified(transport, tag, lastModified)) {
+    transport->sendRaw((void*)"", 0, 304);
+    return 304;
+  }
+
+  // ranges are of the identity encoding, which callers pick when there is
+  // a Range header
+  string range = compressed ? "" : transport->getHeader("Range");
+  if (!range.empty()) {
+    string ifRange = transport->getHeader("If-Range");
+    if (ifRange.empty() || ifRange == tag || ifRange == lastModified) {
+      int start, end;
+      char buf[64];
+      switch (HttpProtocol::ParseByteRange(range, len, start, end)) {
+      case 1:
+        snprintf(buf, sizeof(buf), "bytes %d-%d/%d", start, end, len);
+        transport->addHeader("Content-Range", buf);
+        transport->sendRaw((void*)(data + start), end - start + 1, 206);
+        return 206;
+      case -1:
+        snprintf(buf, sizeof(buf), "bytes */%d", len);
+        transport->addHeader("Content-Range", buf);
+        transport->sendRaw((void*)"", 0, 416);
+        return 416;
+      }
+    }
+  }
+
   transport->sendRaw((void*)data, len, 200, compressed);
+  return 200;
 }
 
 void HttpRequestHandler::handleRequest(Transport *transport) {
@@ -171,10 +241,15 @@ void HttpRequestHandler::handleRequest(Transport *transport) {
 
   // If this is not a php file, check the static and dynamic content caches
   if (ext && strcasecmp(ext, "php") != 0) {
+    if (compressed && !transport->getHeader("Range").empty()) {
+      compressed = false; // ranges are served from the identity encoding
+    }
     if (RuntimeOption::EnableStaticContentCache) {
       bool original = compressed;
+      string etag;
       // check against static content cache
-      if (StaticContentCache::TheCache.find(path, data, len, compressed)) {
+      if (StaticContentCache::TheCache.find(path, data, len, compressed,
+                                            &etag)) {
         String str;
         // (qigao) not calling stat at this point because the timestamp of
         // local cache file is not valuable, maybe misleading. This way
@@ -188,9 +263,12 @@ void HttpRequestHandler::handleRequest(Transport *transport) {
           compressed = false;
           str = NEW(StringData)(data, len, AttachString);
         }
-        sendStaticContent(transport, data, len, 0, compressed, path, ext);
-        StaticContentCache::TheFileCache->adviseOutMemory();
-        ServerStats::LogPage(path, 200);
+        int code = sendStaticContent(transport, data, len, 0, compressed,
+                                     path, ext, etag);
+        if (StaticContentCache::TheFileCache) {
+          StaticContentCache::TheFileCache->adviseOutMemory();
+        }
+        ServerStats::LogPage(path, code);
         GetAccessLog().log(transport, vhost);
         return;
       }
@@ -202,11 +280,15 @@ void HttpRequestHandler::handleRequest(Transport *transport) {
         StringBuffer sb(translated.data());
         if (sb.valid()) {
           struct stat st;
+          string etag;
           st.st_mtime = 0;
-          stat(translated.data(), &st);
-          sendStaticContent(transport, sb.data(), sb.size(), st.st_mtime,
-                            false, path, ext);
-          ServerStats::LogPage(path, 200);
+          if (stat(translated.data(), &st) == 0) {
+            etag = StaticContentCache::MakeETag(hash_int64(st.st_size) ^
+                                                st.st_mtime);
+          }
+          int code = sendStaticContent(transport, sb.data(), sb.size(),
+                                       st.st_mtime, false, path, ext, etag);
+          ServerStats::LogPage(path, code);
           GetAccessLog().log(transport, vhost);
           return;
         }
@@ -219,8 +301,9 @@ void HttpRequestHandler::handleRequest(Transport *transport) {
       ASSERT(transport->getUrl());
       string key = path + transport->getUrl();
       if (DynamicContentCache::TheCache.find(key, data, len, compressed)) {
-        sendStaticContent(transport, data, len, 0, compressed, path, ext);
-        ServerStats::LogPage(path, 200);
+        int code = sendStaticContent(transport, data, len, 0, compressed,
+                                     path, ext);
+        ServerStats::LogPage(path, code);
         GetAccessLog().log(transport, vhost);
         return;
       }
@@ -45,10 +45,11 @@ private:
   bool m_pathTranslation;
 
   bool handleProxyRequest(Transport *transport, bool force);
-  void sendStaticContent(Transport *transport, const char *data, int len,
-                         time_t mtime, bool compressed,
-                         const std::string &cmd,
-                         const char *ext);
+  int sendStaticContent(Transport *transport, const char *data, int len,
+                        time_t mtime, bool compressed,
+                        const std::string &cmd,
+                        const char *ext,
+                        const std::string &etag = "");
   bool executePHPRequest(Transport *transport, RequestURI &reqURI,
                          SourceRootInfo &sourceRootInfo,
                          bool cachableDynamicContent);
@@ -18,6 +18,7 @@
 #include <runtime/base/server/libevent_server.h>
 #include <runtime/base/server/libevent_server_with_fd.h>
 #include <runtime/base/server/libevent_server_with_takeover.h>
+#include <runtime/base/server/libevent_multi_server.h>
 #include <runtime/base/server/http_request_handler.h>
 #include <runtime/base/server/admin_request_handler.h>
 #include <runtime/base/server/server_stats.h>
@@ -29,6 +30,7 @@
 #include <runtime/base/rtti_info.h>
 #include <runtime/base/memory/memory_manager.h>
 #include <util/logger.h>
+#include <util/async_log_writer.h>
 #include <runtime/base/externals.h>
 #include <runtime/base/util/http_client.h>
 #include <runtime/base/server/replay_transport.h>
@@ -70,6 +72,21 @@ HttpServer::HttpServer(void *sslCTX /* = NULL */)
     server->setServerSocketFd(RuntimeOption::ServerPortFd);
     server->setSSLSocketFd(RuntimeOption::SSLPortFd);
     m_pageServer = ServerPtr(server);
+  } else if (RuntimeOption::TakeoverFilename.empty() &&
+             RuntimeOption::ServerEventLoopCount > 1) {
+    int loops = RuntimeOption::ServerEventLoopCount;
+    int threads = RuntimeOption::ServerThreadCount / loops;
+    if (threads < 1) threads = 1;
+    LibEventMultiServer* server =
+      new LibEventMultiServer(RuntimeOption::ServerIP,
+                              RuntimeOption::ServerPort, threads * loops);
+    for (int i = 0; i < loops; i++) {
+      server->addLoop(ServerPtr
+        (new TypedServer<LibEventServerWithReusePort, HttpRequestHandler>
+         (RuntimeOption::ServerIP, RuntimeOption::ServerPort, threads,
+          RuntimeOption::RequestTimeoutSeconds)));
+    }
+    m_pageServer = ServerPtr(server);
   } else if (RuntimeOption::TakeoverFilename.empty()) {
     m_pageServer = ServerPtr
       (new TypedServer<LibEventServer, HttpRequestHandler>
@@ -307,6 +324,7 @@ void HttpServer::run() {
 
 static void exit_on_timeout(int sig) {
   signal(sig, SIG_DFL);
+  AsyncLogWriter::TheWriter.tryDrain(1000);
   kill(getpid(), SIGKILL);
   exit(0);
 }
@@ -0,0 +1,218 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <runtime/base/server/libevent_multi_server.h>
+#include <runtime/base/runtime_option.h>
+#include <util/logger.h>
+#include <util/util.h>
+#include <netdb.h>
+
+#ifndef SO_REUSEPORT
+#define SO_REUSEPORT 15
+#endif
+
+using namespace std;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Creates a non-blocking listening socket, one that other sockets with
+ * SO_REUSEPORT may share the port with if reusePort is set. Returns -1 with
+ * errno set on errors.
+ */
+static int listen_port(const string &address, int port, bool reusePort) {
+  struct addrinfo hints, *ai = NULL;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+
+  char service[16];
+  snprintf(service, sizeof(service), "%d", port);
+  int ret = getaddrinfo(address.empty() ? NULL : address.c_str(), service,
+                        &hints, &ai);
+  if (ret != 0) {
+    Logger::Error("getaddrinfo: %s", gai_strerror(ret));
+    errno = EINVAL;
+    return -1;
+  }
+
+  int on = 1;
+  int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+  if (fd < 0 ||
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0 ||
+      (reusePort &&
+       setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0) ||
+      fcntl(fd, F_SETFL, O_NONBLOCK) < 0 ||
+      fcntl(fd, F_SETFD, FD_CLOEXEC) < 0 ||
+      bind(fd, ai->ai_addr, ai->ai_addrlen) < 0 ||
+      listen(fd, RuntimeOption::ServerBacklog) < 0) {
+    int errno_save = errno;
+    if (fd >= 0) close(fd);
+    freeaddrinfo(ai);
+    errno = errno_save;
+    return -1;
+  }
+  freeaddrinfo(ai);
+  return fd;
+}
+
+static int listen_reuse_port(const string &address, int port) {
+  return listen_port(address, port, true);
+}
+
+/**
+ * Whether a socket without SO_REUSEPORT can listen on the port, i.e. no
+ * other server, including one with SO_REUSEPORT sockets, is listening there.
+ * Leaves errno set if not.
+ */
+static bool port_available(const string &address, int port) {
+  int fd = listen_port(address, port, false);
+  if (fd < 0) return false;
+  close(fd);
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LibEventServerWithReusePort
+
+LibEventServerWithReusePort::LibEventServerWithReusePort
+(const std::string &address, int port, int thread, int timeoutSeconds)
+  : LibEventServer(address, port, thread, timeoutSeconds) {
+}
+
+int LibEventServerWithReusePort::getAcceptSocket() {
+  int fd = listen_reuse_port(m_address, m_port);
+  if (fd < 0) {
+    Logger::Error("Fail to bind port %d with SO_REUSEPORT: %s", m_port,
+                  Util::safe_strerror(errno).c_str());
+    return -1;
+  }
+  if (evhttp_accept_socket(m_server, fd) < 0) {
+    Logger::Error("evhttp_accept_socket: %s",
+                  Util::safe_strerror(errno).c_str());
+    int errno_save = errno;
+    close(fd);
+    errno = errno_save;
+    return -1;
+  }
+  m_accept_sock = fd;
+  return 0;
+}
+
+int LibEventServerWithReusePort::getAcceptSocketSSL() {
+  int fd = listen_reuse_port(m_address, m_port_ssl);
+  if (fd < 0) {
+    Logger::Error("Failed to bind port %d for SSL with SO_REUSEPORT: %s",
+                  m_port_ssl, Util::safe_strerror(errno).c_str());
+    return -1;
+  }
+  if (evhttp_accept_socket(m_server_ssl, fd) < 0) {
+    Logger::Error("evhttp_accept_socket: (ssl) %s",
+                  Util::safe_strerror(errno).c_str());
+    int errno_save = errno;
+    close(fd);
+    errno = errno_save;
+    return -1;
+  }
+  Logger::Info("SSL enabled");
+  m_accept_sock_ssl = fd;
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LibEventMultiServer
+
+LibEventMultiServer::LibEventMultiServer(const std::string &address,
+                                         int port, int thread)
+  : Server(address, port, thread), m_portSSL(0) {
+}
+
+void LibEventMultiServer::addLoop(ServerPtr loop) {
+  ASSERT(getStatus() != RUNNING);
+  m_loops.push_back(loop);
+}
+
+void LibEventMultiServer::start() {
+  if (getStatus() == RUNNING) return;
+
+  // The loops' SO_REUSEPORT sockets would bind right next to an old server
+  // that still listens on the port, if it used SO_REUSEPORT as well. Make
+  // sure the port is free first, so callers see FailedToListenException and
+  // can shut the old server down, just like with a single loop.
+  if (!port_available(m_address, m_port)) {
+    int errno_save = errno;
+    Logger::Error("Port %d is in use: %s", m_port,
+                  Util::safe_strerror(errno).c_str());
+    errno = errno_save;
+    throw FailedToListenException(m_address, m_port);
+  }
+  if (m_portSSL > 0 && !port_available(m_address, m_portSSL)) {
+    int errno_save = errno;
+    Logger::Error("SSL port %d is in use: %s", m_portSSL,
+                  Util::safe_strerror(errno).c_str());
+    errno = errno_save;
+    throw FailedToListenException(m_address, m_portSSL);
+  }
+  for (unsigned int i = 0; i < m_loops.size(); i++) {
+    m_loops[i]->start();
+  }
+  setStatus(RUNNING);
+}
+
+void LibEventMultiServer::waitForEnd() {
+  for (unsigned int i = 0; i < m_loops.size(); i++) {
+    m_loops[i]->waitForEnd();
+  }
+}
+
+void LibEventMultiServer::stop() {
+  Lock lock(m_mutex);
+  if (getStatus() != RUNNING) return;
+  setStatus(STOPPING);
+  for (unsigned int i = 0; i < m_loops.size(); i++) {
+    m_loops[i]->stop();
+  }
+  setStatus(STOPPED);
+}
+
+int LibEventMultiServer::getActiveWorker() {
+  int count = 0;
+  for (unsigned int i = 0; i < m_loops.size(); i++) {
+    count += m_loops[i]->getActiveWorker();
+  }
+  return count;
+}
+
+int LibEventMultiServer::getQueuedJobs() {
+  int count = 0;
+  for (unsigned int i = 0; i < m_loops.size(); i++) {
+    count += m_loops[i]->getQueuedJobs();
+  }
+  return count;
+}
+
+bool LibEventMultiServer::enableSSL(void *sslCTX, int port) {
+  m_portSSL = port;
+  for (unsigned int i = 0; i < m_loops.size(); i++) {
+    if (!m_loops[i]->enableSSL(sslCTX, port)) return false;
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
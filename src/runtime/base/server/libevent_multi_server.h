@@ -0,0 +1,82 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HTTP_SERVER_LIB_EVENT_MULTI_SERVER_H__
+#define __HTTP_SERVER_LIB_EVENT_MULTI_SERVER_H__
+
+#include <runtime/base/server/libevent_server.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * LibEventServer that binds its accept sockets with SO_REUSEPORT, so several
+ * of them can listen on the same port and the kernel spreads connections.
+ */
+class LibEventServerWithReusePort : public LibEventServer {
+public:
+  LibEventServerWithReusePort(const std::string &address, int port,
+                              int thread, int timeoutSeconds);
+
+protected:
+  virtual int getAcceptSocket();
+  virtual int getAcceptSocketSSL();
+};
+
+/*
+ * Runs a number of event loops as one server. Each loop is a server of its
+ * own, with its own event base, accept socket, worker threads and response
+ * queues; this class only starts, stops and sums them up.
+ *
+ * start() throws FailedToListenException if anything else listens on the
+ * port, even a server whose sockets have SO_REUSEPORT.
+ */
+DECLARE_BOOST_TYPES(LibEventMultiServer);
+class LibEventMultiServer : public Server {
+public:
+  LibEventMultiServer(const std::string &address, int port, int thread);
+
+  /**
+   * Loops have to be added before the server starts.
+   */
+  void addLoop(ServerPtr loop);
+  int getLoopCount() const { return m_loops.size();}
+  ServerPtr getLoop(int index) const { return m_loops[index];}
+
+  // implementing Server
+  virtual void start();
+  virtual void waitForEnd();
+  virtual void stop();
+  virtual int getActiveWorker();
+  virtual int getQueuedJobs();
+  virtual bool enableSSL(void *sslCTX, int port);
+
+  /**
+   * Requests are handled by each loop's own request handlers.
+   */
+  virtual RequestHandler *createRequestHandler() { return NULL;}
+  virtual void releaseRequestHandler(RequestHandler *handler) {}
+  virtual void onThreadExit(RequestHandler *handler) {}
+
+private:
+  ServerPtrVec m_loops;
+  int m_portSSL;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HTTP_SERVER_LIB_EVENT_MULTI_SERVER_H__
@@ -47,6 +47,10 @@ namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 // LibEventJob
 
+static int s_statsQueuing = ServerStats::Intern("page.wall.queuing");
+static int s_statsReadTime =
+  ServerStats::Intern("page.wall.request_read_time");
+
 LibEventJob::LibEventJob(evhttp_request *req) : request(req) {
   gettime(CLOCK_MONOTONIC, &start);
 }
@@ -58,7 +62,7 @@ void LibEventJob::stopTimer() {
     time_t dsec = end.tv_sec - start.tv_sec;
     long dnsec = end.tv_nsec - start.tv_nsec;
     int64 dusec = dsec * 1000000 + dnsec / 1000;
-    ServerStats::Log("page.wall.queuing", dusec);
+    ServerStats::Log(s_statsQueuing, dusec);
 
 #ifdef EVHTTP_CONNECTION_GET_START
     struct timespec evstart;
@@ -66,7 +70,7 @@ void LibEventJob::stopTimer() {
     dsec = start.tv_sec - evstart.tv_sec;
     dnsec = start.tv_nsec - evstart.tv_nsec;
     dusec = dsec * 1000000 + dnsec / 1000;
-    ServerStats::Log("page.wall.request_read_time", dusec);
+    ServerStats::Log(s_statsReadTime, dusec);
 #endif
   }
 }
@@ -157,7 +161,8 @@ LibEventServer::LibEventServer(const std::string &address, int port,
     m_dispatcher(thread, RuntimeOption::ServerThreadRoundRobin,
                  RuntimeOption::ServerThreadDropCacheTimeoutSeconds,
                  RuntimeOption::ServerThreadDropStack,
-                 this, RuntimeOption::ServerThreadJobLIFO),
+                 this, RuntimeOption::ServerThreadJobLIFO,
+                 RuntimeOption::ServerThreadWorkStealing),
     m_dispatcherThread(this, &LibEventServer::dispatch) {
   m_eventBase = event_base_new();
   m_server = evhttp_new(m_eventBase);
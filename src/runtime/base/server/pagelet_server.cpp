@@ -284,7 +284,8 @@ void PageletServer::Restart() {
        RuntimeOption::PageletServerThreadRoundRobin,
        RuntimeOption::PageletServerThreadDropCacheTimeoutSeconds,
        RuntimeOption::PageletServerThreadDropStack,
-       NULL);
+       NULL, false,
+       RuntimeOption::PageletServerThreadWorkStealing);
     Logger::Info("pagelet server started");
     s_dispatcher->start();
   }
@@ -0,0 +1,338 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <runtime/base/server/request_sampler.h>
+#include <runtime/base/frame_injection.h>
+#include <runtime/base/runtime_option.h>
+#include <util/thread_local.h>
+#include <util/stack_trace.h>
+#include <util/process.h>
+#include <util/logger.h>
+#include <util/alloc.h>
+#include <util/hash.h>
+#include <util/pgo_profile.h>
+#include <util/util.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <time.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+using namespace std;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+#define SAMPLER_SIGNAL SIGPROF
+
+static const int MaxSamples = 256;     // per request
+static const int MaxPHPDepth = 64;
+static const int MaxNativeDepth = 32;
+static const int NativeSkip = 2;       // signal handler and its trampoline
+
+namespace {
+
+struct Sample {
+  int phpDepth;
+  int nativeDepth;
+  const char *php[MaxPHPDepth];   // innermost first
+  void *native[MaxNativeDepth];   // innermost first
+};
+
+/**
+ * Everything the signal handler touches. It only ever writes the next free
+ * sample, and only while active is set, so the request thread can fold the
+ * buffer after clearing active without any synchronization.
+ */
+struct ThreadSamples {
+  ThreadSamples() : info(NULL), hasTimer(false), active(0), count(0) {}
+  ~ThreadSamples() {
+    if (hasTimer) timer_delete(timer);
+  }
+
+  ThreadInfo *info;
+  timer_t timer;
+  bool hasTimer;
+  volatile sig_atomic_t active;
+  volatile int count;
+  Sample samples[MaxSamples];
+};
+
+/**
+ * One distinct stack in the process-wide table. A slot is claimed by
+ * CAS-ing its hash from 0; the folded frames are published after that, so
+ * readers skip slots whose stack isn't set yet.
+ */
+struct StackEntry {
+  volatile uint64 hash;
+  volatile int64 count;
+  struct Stack {
+    std::string php;             // "outer;...;inner"
+    std::vector<void*> native;   // outer first
+  } * volatile stack;
+};
+
+}
+
+static IMPLEMENT_THREAD_LOCAL_NO_CHECK(ThreadSamples, s_samples);
+
+static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+static StackEntry *s_table;
+static int s_tableMask;
+static int64 s_requests;
+static int64 s_dropped;
+
+///////////////////////////////////////////////////////////////////////////////
+// signal handler
+
+static void on_sample(int sig, siginfo_t *si, void *context) {
+  if (s_samples.isNull()) return;
+  ThreadSamples *ts = s_samples.getNoCheck();
+  if (!ts->active) return;
+  int count = ts->count;
+  if (count >= MaxSamples) {
+    __sync_fetch_and_add(&s_dropped, 1);
+    return;
+  }
+
+  int savedErrno = errno;
+  Sample &s = ts->samples[count];
+
+  // Frames live on this stack, each one above the one it called. Anything
+  // else means a frame is half pushed or popped, so stop there. The handler
+  // runs on the interrupted stack, below the innermost frame.
+  char marker;
+  char *low = &marker;
+  char *high = Util::s_stackSize ?
+    (char *)(Util::s_stackLimit + Util::s_stackSize) : (char *)-1;
+  s.phpDepth = 0;
+  for (FrameInjection *fi = ts->info->m_top;
+       fi && s.phpDepth < MaxPHPDepth; fi = fi->getPrev()) {
+    if ((char *)fi <= low || (char *)fi >= high) break;
+    s.php[s.phpDepth++] = fi->getFunction();
+    low = (char *)fi;
+  }
+
+  s.nativeDepth = 0;
+  int nativeDepth = RuntimeOption::StatsSamplerNativeDepth;
+  if (nativeDepth > 0) {
+    if (nativeDepth > MaxNativeDepth - NativeSkip) {
+      nativeDepth = MaxNativeDepth - NativeSkip;
+    }
+    s.nativeDepth = backtrace(s.native, nativeDepth + NativeSkip);
+  }
+
+  ts->count = count + 1;
+  errno = savedErrno;
+}
+
+static void install() {
+  int size = 1;
+  while (size < RuntimeOption::StatsSamplerMaxStacks) size <<= 1;
+  s_table = (StackEntry *)calloc(size, sizeof(StackEntry));
+  s_tableMask = size - 1;
+
+  // backtrace() loads libgcc_s the first time, which isn't safe to do from
+  // a signal handler
+  void *bt[1];
+  backtrace(bt, 1);
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_sigaction = on_sample;
+  sa.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&sa.sa_mask);
+  if (sigaction(SAMPLER_SIGNAL, &sa, NULL) != 0) {
+    Logger::Error("RequestSampler: unable to install signal handler");
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// aggregation
+
+static void record(const Sample &s) {
+  StackEntry::Stack stack;
+  for (int i = s.phpDepth - 1; i >= 0; i--) {
+    if (!stack.php.empty()) stack.php += ';';
+    stack.php += s.php[i] ? s.php[i] : "?";
+  }
+  for (int i = s.nativeDepth - 1; i >= NativeSkip; i--) {
+    stack.native.push_back(s.native[i]);
+  }
+  if (stack.php.empty() && stack.native.empty()) return;
+
+  uint64 hash = hash_string_cs(stack.php.data(), stack.php.size());
+  for (unsigned int i = 0; i < stack.native.size(); i++) {
+    hash = hash_int64(hash ^ (uint64)stack.native[i]);
+  }
+  if (hash == 0) hash = 1;
+
+  for (int i = 0, slot = hash & s_tableMask; i <= s_tableMask;
+       i++, slot = (slot + 1) & s_tableMask) {
+    StackEntry &e = s_table[slot];
+    uint64 h = e.hash;
+    if (h == 0) {
+      if (__sync_bool_compare_and_swap(&e.hash, 0, hash)) {
+        StackEntry::Stack *copy = new StackEntry::Stack(stack);
+        __sync_synchronize();
+        e.stack = copy;
+        __sync_fetch_and_add(&e.count, 1);
+        return;
+      }
+      h = e.hash;
+    }
+    if (h == hash) {
+      __sync_fetch_and_add(&e.count, 1);
+      return;
+    }
+  }
+  __sync_fetch_and_add(&s_dropped, 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RequestSampler::OnRequestStart() {
+  int rate = RuntimeOption::StatsSamplerRate;
+  if (rate <= 0 ||
+      __sync_fetch_and_add(&s_requests, 1) % rate != 0) {
+    return;
+  }
+  pthread_once(&s_once, install);
+
+  ThreadSamples *ts = s_samples.getCheck();
+  if (!ts->hasTimer) {
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SAMPLER_SIGNAL;
+    sev.sigev_notify_thread_id = Process::GetThreadPid();
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &ts->timer) != 0) {
+      Logger::Error("RequestSampler: unable to create timer");
+      return;
+    }
+    ts->hasTimer = true;
+  }
+
+  ts->info = ThreadInfo::s_threadInfo.getNoCheck();
+  ts->count = 0;
+  ts->active = 1;
+
+  int interval = RuntimeOption::StatsSamplerInterval;
+  struct itimerspec its;
+  its.it_interval.tv_sec = interval / 1000000;
+  its.it_interval.tv_nsec = (interval % 1000000) * 1000;
+  its.it_value = its.it_interval;
+  timer_settime(ts->timer, 0, &its, NULL);
+}
+
+void RequestSampler::OnRequestEnd() {
+  if (s_samples.isNull()) return;
+  ThreadSamples *ts = s_samples.getNoCheck();
+  if (!ts->active) return;
+
+  ts->active = 0;
+  struct itimerspec its;
+  memset(&its, 0, sizeof(its));
+  timer_settime(ts->timer, 0, &its, NULL);
+
+  for (int i = 0; i < ts->count; i++) {
+    record(ts->samples[i]);
+  }
+  ts->count = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// reporting
+
+static bool by_count(const pair<int64, StackEntry::Stack*> &a,
+                     const pair<int64, StackEntry::Stack*> &b) {
+  return a.first > b.first;
+}
+
+static const std::string &symbolize(void *addr,
+                                    hphp_hash_map<void*, std::string,
+                                    pointer_hash<void> > &names) {
+  std::string &name = names[addr];
+  if (name.empty()) {
+    StackTrace::FramePtr frame = StackTrace::Translate(addr);
+    name = frame->funcname.substr(0, frame->funcname.find('('));
+    if (name.empty()) {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "%p", addr);
+      name = buf;
+    }
+    // keep folded lines parsable
+    for (unsigned int i = 0; i < name.size(); i++) {
+      if (name[i] == ';' || name[i] == ' ') name[i] = '_';
+    }
+  }
+  return name;
+}
+
+void RequestSampler::Report(std::string &out, bool reset) {
+  if (!s_table) return;
+
+  std::vector<pair<int64, StackEntry::Stack*> > stacks;
+  for (int i = 0; i <= s_tableMask; i++) {
+    StackEntry &e = s_table[i];
+    StackEntry::Stack *stack = e.stack;
+    if (!stack) continue;
+    int64 count = reset ? __sync_lock_test_and_set(&e.count, 0) : e.count;
+    if (count > 0) {
+      stacks.push_back(pair<int64, StackEntry::Stack*>(count, stack));
+    }
+  }
+  sort(stacks.begin(), stacks.end(), by_count);
+
+  hphp_hash_map<void*, std::string, pointer_hash<void> > names;
+  char buf[32];
+  for (unsigned int i = 0; i < stacks.size(); i++) {
+    const StackEntry::Stack &stack = *stacks[i].second;
+    out += stack.php;
+    for (unsigned int j = 0; j < stack.native.size(); j++) {
+      if (j > 0 || !stack.php.empty()) out += ';';
+      out += symbolize(stack.native[j], names);
+    }
+    snprintf(buf, sizeof(buf), " %lld\n", stacks[i].first);
+    out += buf;
+  }
+}
+
+void RequestSampler::Profile(PgoProfile &profile, bool reset) {
+  if (!s_table) return;
+
+  vector<string> frames;
+  for (int i = 0; i <= s_tableMask; i++) {
+    StackEntry &e = s_table[i];
+    StackEntry::Stack *stack = e.stack;
+    if (!stack || stack->php.empty()) continue;
+    int64 count = reset ? __sync_lock_test_and_set(&e.count, 0) : e.count;
+    if (count > 0) {
+      frames.clear();
+      Util::split(';', stack->php.c_str(), frames);
+      profile.addStack(frames, count);
+    }
+  }
+}
+
+int64 RequestSampler::GetDropped() {
+  return s_dropped;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,69 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_REQUEST_SAMPLER_H__
+#define __HPHP_REQUEST_SAMPLER_H__
+
+#include <util/base.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+class PgoProfile;
+
+/**
+ * Always-on sampling profiler. One in every Stats.Sampler.Rate requests gets
+ * a per-thread CPU time timer that raises SIGPROF every
+ * Stats.Sampler.Interval microseconds. The signal handler only copies the
+ * PHP frame names and the innermost native return addresses into a
+ * preallocated per-thread buffer. At the end of the request the samples are
+ * folded into stack strings and counted in a process-wide table that
+ * threads update with atomic operations only, without taking any lock.
+ *
+ * Unlike the profilers in ext_hotprofiler, nothing is recorded for requests
+ * that are not sampled, and frame entry and exit don't do any extra work.
+ */
+class RequestSampler {
+public:
+  /**
+   * Called on the request thread around each request.
+   */
+  static void OnRequestStart();
+  static void OnRequestEnd();
+
+  /**
+   * Aggregated stacks in folded form, one "outer;...;inner count" line per
+   * distinct stack, most sampled first. This is what flamegraph.pl and
+   * similar tools take. With reset, counts start over from zero.
+   */
+  static void Report(std::string &out, bool reset);
+
+  /**
+   * Adds the PHP frames of the aggregated stacks to a profile for
+   * profile-guided compilation.
+   */
+  static void Profile(PgoProfile &profile, bool reset);
+
+  /**
+   * Samples lost because a request's buffer or the aggregate table was full.
+   */
+  static int64 GetDropped();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_REQUEST_SAMPLER_H__
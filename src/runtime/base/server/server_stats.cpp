@@ -599,15 +599,57 @@ vector<ServerStats*> ServerStats::s_loggers;
 bool ServerStats::s_profile_network = false;
 IMPLEMENT_THREAD_LOCAL_NO_CHECK(ServerStats, ServerStats::s_logger);
 
+/**
+ * Interned counter names. This is a function static, so that hot call sites
+ * can intern their keys during static initialization.
+ */
+class ServerStatsKeys {
+public:
+  Mutex m_lock;
+  hphp_string_map<int> m_ids;
+  std::vector<std::string> m_names;
+
+  static ServerStatsKeys &Get() {
+    static ServerStatsKeys keys;
+    return keys;
+  }
+};
+
+int ServerStats::Intern(const string &name) {
+  ServerStatsKeys &keys = ServerStatsKeys::Get();
+  Lock lock(keys.m_lock, false);
+  hphp_string_map<int>::const_iterator iter = keys.m_ids.find(name);
+  if (iter != keys.m_ids.end()) {
+    return iter->second;
+  }
+  int id = keys.m_names.size();
+  keys.m_names.push_back(name);
+  keys.m_ids[name] = id;
+  return id;
+}
+
+void ServerStats::GetKeyNames(vector<string> &names) {
+  ServerStatsKeys &keys = ServerStatsKeys::Get();
+  Lock lock(keys.m_lock, false);
+  names = keys.m_names;
+}
+
 void ServerStats::LogPage(const string &url, int code) {
   if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
     ServerStats::s_logger->logPage(url, code);
   }
 }
 
+void ServerStats::Log(int key, int64 value) {
+  if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
+    ServerStats::s_logger->log(key, value);
+  }
+}
+
 void ServerStats::Log(const string &name, int64 value) {
   if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
-    ServerStats::s_logger->log(name, value);
+    ServerStats *logger = ServerStats::s_logger.getNoCheck();
+    logger->log(logger->key(name), value);
   }
 }
 
@@ -666,9 +708,11 @@ void ServerStats::CollectSlots(list<TimeSlot*> &slots, int64 from, int64 to) {
   int tp1 = from / RuntimeOption::StatsSlotDuration;
   int tp2 = to / RuntimeOption::StatsSlotDuration;
 
+  vector<string> names;
+  GetKeyNames(names);
   Lock lock(s_lock, false);
   for (unsigned int i = 0; i < s_loggers.size(); i++) {
-    s_loggers[i]->collect(slots, tp1, tp2);
+    s_loggers[i]->collect(slots, tp1, tp2, names);
   }
 }
 
@@ -991,24 +1035,80 @@ ServerStats::~ServerStats() {
   }
 }
 
-void ServerStats::log(const string &name, int64 value) {
-  m_values[name] += value;
+int ServerStats::key(const string &name) {
+  hphp_string_map<int>::const_iterator iter = m_keys.find(name);
+  if (iter != m_keys.end()) {
+    return iter->second;
+  }
+  int id = Intern(name);
+  m_keys[name] = id;
+  return id;
+}
+
+void ServerStats::log(int key, int64 value) {
+  if (key >= (int)m_values.size()) {
+    m_values.resize(key + 64);
+  }
+  Counter &counter = m_values[key];
+  if (!counter.m_touched) {
+    counter.m_touched = true;
+    m_touched.push_back(key);
+  }
+  counter.m_value += value;
 }
 
 int64 ServerStats::get(const std::string &name) {
-  CounterMap::const_iterator iter = m_values.find(name);
-  if (iter != m_values.end()) {
-    return iter->second;
+  int id = key(name);
+  if (id < (int)m_values.size()) {
+    return m_values[id].m_value;
   }
   return 0;
 }
 
+void ServerStats::addPage(KeyPageStats &ps, const string &url, int code) {
+  ps.m_url = url;
+  ps.m_code = code;
+  ps.m_hit++;
+  for (unsigned int i = 0; i < m_touched.size(); i++) {
+    int key = m_touched[i];
+    ps.m_values[key] += m_values[key].m_value;
+  }
+}
+
+ServerStats::ThreadSlot *ServerStats::slotFor(int64 t) {
+  ThreadSlot &ts = m_slots[t % RuntimeOption::StatsMaxSlot];
+  if (ts.m_time != t) {
+    if (ts.m_time > t) {
+      return NULL; // already taken over by a later timepoint
+    }
+    if (ts.m_time && m_min <= ts.m_time) {
+      m_min = ts.m_time + 1;
+    }
+    ts.m_time = t;
+    ts.m_pages.clear();
+  }
+  if (m_min == 0) {
+    m_min = t;
+  }
+  if (m_max < t) {
+    m_max = t;
+  }
+  return &ts;
+}
+
 void ServerStats::logPage(const string &url, int code) {
   int64 now = time(NULL) / RuntimeOption::StatsSlotDuration;
-  int slot = now % RuntimeOption::StatsMaxSlot;
-
-  {
-    Lock lock(m_lock, false);
+  string key = url + lexical_cast<string>(code);
+
+  if (!m_lock.tryLock()) {
+    // A report is copying our slots. Rather than making this request wait,
+    // keep its page until the next one gets the lock.
+    m_deferred.resize(m_deferred.size() + 1);
+    DeferredPage &page = m_deferred.back();
+    page.m_time = now;
+    page.m_key = key;
+    addPage(page.m_stats, url, code);
+  } else {
     int count = 0;
     for (int64 t = m_last + 1; t < now; t++) {
       m_slots[t % RuntimeOption::StatsMaxSlot].m_time = 0;
@@ -1016,27 +1116,28 @@ void ServerStats::logPage(const string &url, int code) {
         break; // we have cleared all slots, good enough
       }
     }
-    TimeSlot &ts = m_slots[slot];
-    if (ts.m_time != now) {
-      if (ts.m_time && m_min <= ts.m_time) {
-        m_min = ts.m_time + 1;
+    for (unsigned int i = 0; i < m_deferred.size(); i++) {
+      DeferredPage &page = m_deferred[i];
+      ThreadSlot *ts = slotFor(page.m_time);
+      if (ts) {
+        KeyPageStats &ps = ts->m_pages[page.m_key];
+        ps.m_url = page.m_stats.m_url;
+        ps.m_code = page.m_stats.m_code;
+        ps.m_hit += page.m_stats.m_hit;
+        for (KeyCounterMap::const_iterator iter =
+               page.m_stats.m_values.begin();
+             iter != page.m_stats.m_values.end(); ++iter) {
+          ps.m_values[iter->first] += iter->second;
+        }
       }
-      ts.m_time = now;
-      ts.m_pages.clear();
     }
-    PageStats &ps = ts.m_pages[url + lexical_cast<string>(code)];
-    ps.m_url = url;
-    ps.m_code = code;
-    ps.m_hit++;
-    Merge(ps.m_values, m_values);
-  }
-
-  m_last = now;
-  if (m_min == 0) {
-    m_min = now;
-  }
-  if (m_max < now) {
-    m_max = now;
+    m_deferred.clear();
+    ThreadSlot *ts = slotFor(now);
+    if (ts) {
+      addPage(ts->m_pages[key], url, code);
+    }
+    m_lock.unlock();
+    m_last = now;
   }
 
   m_threadStatus.m_mode = Idling;
@@ -1044,7 +1145,12 @@ void ServerStats::logPage(const string &url, int code) {
 }
 
 void ServerStats::reset() {
-  m_values.clear();
+  for (unsigned int i = 0; i < m_touched.size(); i++) {
+    Counter &counter = m_values[m_touched[i]];
+    counter.m_value = 0;
+    counter.m_touched = false;
+  }
+  m_touched.clear();
 }
 
 void ServerStats::clear() {
@@ -1054,7 +1160,8 @@ void ServerStats::clear() {
   }
 }
 
-void ServerStats::collect(std::list<TimeSlot*> &slots, int64 from, int64 to) {
+void ServerStats::collect(std::list<TimeSlot*> &slots, int64 from, int64 to,
+                          const vector<string> &names) {
   if (from > to) {
     int64 tmp = from;
     from = to;
@@ -1063,15 +1170,41 @@ void ServerStats::collect(std::list<TimeSlot*> &slots, int64 from, int64 to) {
   if (from < m_min) from = m_min;
   if (to > m_max) to = m_max;
 
-  Lock lock(m_lock, false);
+  // Only copy under the lock, as the owning thread may be trying for it.
+  vector<ThreadSlot> copied;
+  {
+    Lock lock(m_lock, false);
+    for (int64 t = from; t <= to; t++) {
+      int slot = t % RuntimeOption::StatsMaxSlot;
+      if (m_slots[slot].m_time == t) {
+        copied.push_back(m_slots[slot]);
+      }
+    }
+  }
+
   list<TimeSlot*> collected;
-  for (int64 t = from; t <= to; t++) {
-    int slot = t % RuntimeOption::StatsMaxSlot;
-    if (m_slots[slot].m_time == t) {
-      collected.push_back(&m_slots[slot]);
+  for (unsigned int i = 0; i < copied.size(); i++) {
+    const ThreadSlot &ts = copied[i];
+    TimeSlot *c = new TimeSlot();
+    c->m_time = ts.m_time;
+    for (KeyPageStatsMap::const_iterator piter = ts.m_pages.begin();
+         piter != ts.m_pages.end(); ++piter) {
+      const KeyPageStats &kps = piter->second;
+      PageStats &ps = c->m_pages[piter->first];
+      ps.m_url = kps.m_url;
+      ps.m_code = kps.m_code;
+      ps.m_hit = kps.m_hit;
+      for (KeyCounterMap::const_iterator viter = kps.m_values.begin();
+           viter != kps.m_values.end(); ++viter) {
+        if (viter->first < (int)names.size()) {
+          ps.m_values[names[viter->first]] += viter->second;
+        }
+      }
     }
+    collected.push_back(c);
   }
   Merge(slots, collected);
+  FreeSlots(collected);
 }
 
 void ServerStats::logBytes(int64 bytes) {
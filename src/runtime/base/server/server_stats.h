@@ -24,6 +24,8 @@
 #include <runtime/base/shared/shared_string.h>
 #include <runtime/base/types.h>
 
+class TestCppBase;
+
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -44,6 +46,13 @@ public:
   };
 
 public:
+  /**
+   * Counter names are interned into ids once, so logging by id is only an
+   * array update. Ids stay valid for the life of the process, and hot call
+   * sites can keep them in statics.
+   */
+  static int Intern(const std::string &name);
+  static void Log(int key, int64 value);
   static void Log(const std::string &name, int64 value);
   static int64 Get(const std::string &name);
   static void LogPage(const std::string &url, int code);
@@ -78,6 +87,8 @@ public:
 
   static void GetLogger() ATTRIBUTE_COLD;
 private:
+  friend class ::TestCppBase; // holds m_lock to see pages get deferred
+
   enum UDF {
     UDF_NONE = 1, // count
     UDF_HIT  = 2, // count per hit
@@ -114,6 +125,38 @@ private:
   static void Aggregate(std::list<TimeSlot*> &slots, const std::string &agg,
                         std::map<std::string, int> &wantedKeys);
 
+  /**
+   * A thread's own record of its pages, with counters by interned key id.
+   * Keys only get names when slots are collected for a report.
+   */
+  typedef hphp_hash_map<int, int64, int64_hash> KeyCounterMap;
+  struct KeyPageStats {
+    KeyPageStats() : m_code(0), m_hit(0) {}
+    std::string m_url;
+    int m_code;
+    int m_hit;
+    KeyCounterMap m_values;
+  };
+  typedef hphp_string_map<KeyPageStats> KeyPageStatsMap;
+  struct ThreadSlot {
+    ThreadSlot() : m_time(0) {}
+    int64 m_time;
+    KeyPageStatsMap m_pages;
+  };
+  // a page logged while a report was copying this thread's slots
+  struct DeferredPage {
+    int64 m_time;
+    std::string m_key;
+    KeyPageStats m_stats;
+  };
+  // current page's counter of a key id
+  struct Counter {
+    Counter() : m_value(0), m_touched(false) {}
+    int64 m_value;
+    bool m_touched;
+  };
+
+  static void GetKeyNames(std::vector<std::string> &names);
   static void CollectSlots(std::list<TimeSlot*> &slots, int64 from, int64 to);
   static void FreeSlots(std::list<TimeSlot*> &slots);
 
@@ -123,19 +166,30 @@ private:
                      const std::list<TimeSlot*> &slots,
                      const std::string &prefix);
 
+  // Only reports take m_lock while their owning thread writes, and a thread
+  // that finds it taken defers its page rather than waiting.
   Mutex m_lock;
-  std::vector<TimeSlot> m_slots;
+  std::vector<ThreadSlot> m_slots;
+  std::vector<DeferredPage> m_deferred;
   int64 m_last; // previous timepoint
   int64 m_min;  // earliest timepoint
   int64 m_max;  // latest timepoint
-  CounterMap m_values;  // current page's name value pairs
 
-  void log(const std::string &name, int64 value);
+  // current page's counters, only ever touched by the owning thread
+  std::vector<Counter> m_values;
+  std::vector<int> m_touched;
+  hphp_string_map<int> m_keys; // names already interned by this thread
+
+  int key(const std::string &name);
+  void log(int key, int64 value);
   int64 get(const std::string &name);
   void logPage(const std::string &url, int code);
+  void addPage(KeyPageStats &ps, const std::string &url, int code);
+  ThreadSlot *slotFor(int64 t);
   void reset();
   void clear();
-  void collect(std::list<TimeSlot*> &slots, int64 from, int64 to);
+  void collect(std::list<TimeSlot*> &slots, int64 from, int64 to,
+               const std::vector<std::string> &names);
 
   /**
    * Live status, instead of historical statistics.
@@ -21,6 +21,7 @@
 #include <util/process.h>
 #include <util/util.h>
 #include <util/compression.h>
+#include <util/hash.h>
 
 using namespace std;
 
@@ -92,6 +93,8 @@ void StaticContentCache::load() {
       if (sb->valid() && sb->size() > 0) {
         string url = out[i].substr(rootSize + 1);
         f->file = sb;
+        f->etag = MakeETag(hash_string_cs(sb->data(), sb->size()) ^
+                           hash_int64(sb->size()));
         m_files[url] = f;
 
         // prepare gzipped content, skipping image and swf files
@@ -116,14 +119,27 @@ void StaticContentCache::load() {
   Logger::Info("loaded %d bytes of static content in total", m_totalSize);
 }
 
+std::string StaticContentCache::MakeETag(int64 hash) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%llx", hash);
+  return buf;
+}
+
 bool StaticContentCache::find(const std::string &name, const char *&data,
-                              int &len, bool &compressed) const {
+                              int &len, bool &compressed,
+                              std::string *etag /* = NULL */) const {
   if (TheFileCache) {
-    return data = TheFileCache->read(name.c_str(), len, compressed);
+    int64 hash = 0;
+    data = TheFileCache->read(name.c_str(), len, compressed, &hash);
+    if (data && etag) {
+      *etag = MakeETag(hash);
+    }
+    return data;
   }
 
   StringToResourceFilePtrMap::const_iterator iter = m_files.find(name);
   if (iter != m_files.end()) {
+    if (etag) *etag = iter->second->etag;
     if (compressed && iter->second->compressed) {
       data = iter->second->compressed->data();
       len = iter->second->compressed->size();
@@ -37,10 +37,13 @@ public:
   void load();
 
   /**
-   * Find a file from cache.
+   * Find a file from cache. The ETag, when asked for, is a fingerprint of the
+   * file computed at load time, the same for both of its encodings.
    */
   bool find(const std::string &name, const char *&data, int &len,
-            bool &compressed) const;
+            bool &compressed, std::string *etag = NULL) const;
+
+  static std::string MakeETag(int64 hash);
 
 private:
   int m_totalSize;
@@ -49,6 +52,7 @@ private:
   struct ResourceFile {
     StringBufferPtr file;
     StringBufferPtr compressed;
+    std::string etag;
   };
 
   StringToResourceFilePtrMap m_files;
@@ -34,6 +34,9 @@ using namespace std;
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
+static int s_statsUncompressed = ServerStats::Intern("network.uncompressed");
+static int s_statsCompressed = ServerStats::Intern("network.compressed");
+
 Transport::Transport()
   : m_url(NULL), m_postData(NULL), m_postDataParsed(false),
     m_chunkedEncoding(false), m_headerSent(false),
@@ -744,8 +747,8 @@ void Transport::sendRawLocked(void *data, int size, int code /* = 200 */,
 
   ServerStats::LogBytes(size);
   if (RuntimeOption::EnableStats && RuntimeOption::EnableWebStats) {
-    ServerStats::Log("network.uncompressed", size);
-    ServerStats::Log("network.compressed", response.size());
+    ServerStats::Log(s_statsUncompressed, size);
+    ServerStats::Log(s_statsCompressed, response.size());
   }
 }
 
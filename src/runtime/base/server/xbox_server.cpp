@@ -199,7 +199,8 @@ void XboxServer::Restart() {
        RuntimeOption::ServerThreadRoundRobin,
        RuntimeOption::ServerThreadDropCacheTimeoutSeconds,
        RuntimeOption::ServerThreadDropStack,
-       NULL);
+       NULL, false,
+       RuntimeOption::ServerThreadWorkStealing);
     if (RuntimeOption::XboxServerLogInfo) {
       Logger::Info("xbox server started");
     }
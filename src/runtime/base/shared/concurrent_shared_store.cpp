@@ -64,16 +64,24 @@ void ConcurrentTableSharedStore::clear() {
  */
 bool ConcurrentTableSharedStore::eraseImpl(CStrRef key, bool expired) {
   if (key.isNull()) return false;
+  return eraseImpl(key.data(), key.size(), expired);
+}
+
+// Also called from purge threads, which have no request memory, so this
+// must not create Strings.
+bool ConcurrentTableSharedStore::eraseImpl(const char *key, int len,
+                                           bool expired) {
   ReadLock l(m_lock);
   Map::accessor acc;
-  if (m_vars.find(acc, key.data())) {
+  if (m_vars.find(acc, key)) {
     if (expired && !acc->second.expired()) {
       return false;
     }
     if (RuntimeOption::EnableAPCSizeStats) {
-      SharedStoreStats::removeDirect(key.size(), acc->second.size);
+      SharedStoreStats::removeDirect(len, acc->second.size);
       if (RuntimeOption::EnableAPCSizeGroup) {
-        SharedStoreStats::onDelete(key.get(), acc->second.var, false,
+        StringData sd(key, len, AttachLiteral);
+        SharedStoreStats::onDelete(&sd, acc->second.var, false,
                                    acc->second.expiry == 0);
       }
     }
@@ -87,7 +95,10 @@ bool ConcurrentTableSharedStore::eraseImpl(CStrRef key, bool expired) {
 void ConcurrentTableSharedStore::purgeExpired() {
   if ((atomic_add(m_purgeCounter, (uint64)1) %
        RuntimeOption::ApcPurgeFrequency) != 0) return;
-  time_t now = time(NULL);
+  purgeExpired(time(NULL));
+}
+
+void ConcurrentTableSharedStore::purgeExpired(time_t now) {
   {
     // Check if there's work to do
     ReadLock lock(m_expirationQueueLock);
@@ -112,7 +123,7 @@ void ConcurrentTableSharedStore::purgeExpired() {
       }
     }
     for (int j = 0; j < i; ++j) {
-      eraseImpl(s[j], true);
+      eraseImpl(s[j], strlen(s[j]), true);
       free((void *)s[j]);
     }
     if (i < PURGE_RATE) {
@@ -133,7 +144,7 @@ bool ConcurrentTableSharedStore::get(CStrRef key, Variant &value) {
   {
     Map::const_accessor acc;
     if (!m_vars.find(acc, key.data())) {
-      if (stats) ServerStats::Log("apc.miss", 1);
+      if (stats) ServerStats::Log(StatsMiss, 1);
       return false;
     } else {
       val = &acc->second;
@@ -156,13 +167,13 @@ bool ConcurrentTableSharedStore::get(CStrRef key, Variant &value) {
   }
   if (expired) {
     if (stats) {
-      ServerStats::Log("apc.miss", 1);
+      ServerStats::Log(StatsMiss, 1);
     }
     eraseImpl(key, true);
     return false;
   }
   if (stats) {
-    ServerStats::Log("apc.hit", 1);
+    ServerStats::Log(StatsHit, 1);
   }
 
   if (RuntimeOption::ApcAllowObj)  {
@@ -233,7 +244,7 @@ int64 ConcurrentTableSharedStore::inc(CStrRef key, int64 step, bool &found) {
   }
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.inc", 1);
+    ServerStats::Log(StatsInc, 1);
   }
   return ret;
 }
@@ -249,7 +260,7 @@ bool ConcurrentTableSharedStore::exists(CStrRef key) {
  {
    Map::const_accessor acc;
    if (!m_vars.find(acc, key.data())) {
-     if (stats) ServerStats::Log("apc.miss", 1);
+     if (stats) ServerStats::Log(StatsMiss, 1);
      return false;
    } else {
      val = &acc->second;
@@ -267,13 +278,13 @@ bool ConcurrentTableSharedStore::exists(CStrRef key) {
  }
  if (expired) {
    if (stats) {
-     ServerStats::Log("apc.miss", 1);
+     ServerStats::Log(StatsMiss, 1);
    }
    eraseImpl(key, true);
    return false;
  }
  if (stats) {
-   ServerStats::Log("apc.hit", 1);
+   ServerStats::Log(StatsHit, 1);
  }
  return true;
 }
@@ -345,17 +356,17 @@ bool ConcurrentTableSharedStore::store(CStrRef key, CVarRef val, int64 ttl,
       SharedStoreStats::onStore(key.get(), var, ttl, false);
     }
   }
-  if (RuntimeOption::ApcExpireOnSets) {
+  if (m_backgroundPurge || RuntimeOption::ApcExpireOnSets) {
     if (ttl) {
       addToExpirationQueue(key.data(), expiry);
     }
-    purgeExpired();
+    if (!m_backgroundPurge) purgeExpired();
   }
   if (stats) {
     if (present) {
-      ServerStats::Log("apc.update", 1);
+      ServerStats::Log(StatsUpdate, 1);
     } else {
-      ServerStats::Log("apc.new", 1);
+      ServerStats::Log(StatsNew, 1);
       if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCKeyStats) {
         string prefix = "apc.new.";
         prefix += GetSkeleton(key);
@@ -376,7 +387,10 @@ void ConcurrentTableSharedStore::prime
     Map::accessor acc;
     const char *copy = strdup(item.key);
     m_vars.insert(acc, copy);
-    acc->second.set(item.value, 0);
+    acc->second.set(item.value, item.ttl);
+    if (item.ttl && (m_backgroundPurge || RuntimeOption::ApcExpireOnSets)) {
+      addToExpirationQueue(copy, acc->second.expiry);
+    }
     if (RuntimeOption::EnableAPCSizeStats &&
         RuntimeOption::APCSizeCountPrime) {
       int32 size = item.value->getSpaceUsage();
@@ -410,7 +424,7 @@ bool ConcurrentTableSharedStore::cas(CStrRef key, int64 old, int64 val) {
   }
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.cas", 1);
+    ServerStats::Log(StatsCas, 1);
   }
   return success;
 }
@@ -418,6 +432,24 @@ bool ConcurrentTableSharedStore::cas(CStrRef key, int64 old, int64 val) {
 ///////////////////////////////////////////////////////////////////////////////
 // debugging support
 
+bool ConcurrentTableSharedStore::getEntries(std::vector<Entry> &entries) {
+  // Iterating isn't safe against concurrent erases, so this blocks requests
+  // only for as long as it takes to copy out keys and pointers.
+  WriteLock l(m_lock);
+  entries.reserve(m_vars.size());
+  for (Map::iterator iter = m_vars.begin(); iter != m_vars.end(); ++iter) {
+    const StoreValue &val = iter->second;
+    if (val.expired()) continue;
+    Entry entry;
+    entry.key = iter->first;
+    entry.value = val.var;
+    entry.value->incRef();
+    entry.expiry = val.expiry;
+    entries.push_back(entry);
+  }
+  return true;
+}
+
 void ConcurrentTableSharedStore::dump(std::ostream & out) {
   int i = 0;
   ReadLock l(m_lock);
@@ -36,7 +36,14 @@ namespace HPHP {
 
 class ConcurrentTableSharedStore : public SharedStore {
 public:
-  ConcurrentTableSharedStore(int id) : SharedStore(id), m_purgeCounter(0) {}
+  /**
+   * With backgroundPurge, expiring keys are always queued, but never purged
+   * on the request path. The owner calls purgeExpired(now) from its own
+   * thread instead.
+   */
+  ConcurrentTableSharedStore(int id, bool backgroundPurge = false)
+    : SharedStore(id), m_purgeCounter(0),
+      m_backgroundPurge(backgroundPurge) {}
 
   virtual int size() {
     return m_vars.size();
@@ -50,10 +57,15 @@ public:
   virtual bool exists(CStrRef key);
 
   virtual void prime(const std::vector<SharedStore::KeyValuePair> &vars);
+  virtual bool getEntries(std::vector<Entry> &entries);
 
   // debug support
   virtual void dump(std::ostream & out);
 
+  // Purges expired keys in the expiration queue. Should be called outside
+  // m_lock.
+  void purgeExpired(time_t now);
+
   virtual SharedVariant* construct(litstr str, int len, CStrRef v,
                                    bool serialized) {
     return SharedVariant::Create(v, serialized);
@@ -63,6 +75,8 @@ public:
   }
 
 protected:
+  friend class ShardedTableSharedStore;
+
   virtual SharedVariant* construct(CStrRef key, CVarRef v) {
     return SharedVariant::Create(v, false);
   }
@@ -84,6 +98,7 @@ protected:
   virtual void clear();
 
   virtual bool eraseImpl(CStrRef key, bool expired);
+  bool eraseImpl(const char *key, int len, bool expired);
 
   void eraseAcc(Map::accessor &acc) {
     acc->second.var->decRef();
@@ -115,6 +130,7 @@ protected:
                       ExpirationCompare> m_expirationQueue;
   ReadWriteMutex m_expirationQueueLock;
   uint64 m_purgeCounter;
+  bool m_backgroundPurge;
 
   // Should be called outside m_lock
   void purgeExpired();
@@ -0,0 +1,129 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <runtime/base/shared/sharded_shared_store.h>
+
+using namespace std;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+ShardedTableSharedStore::ShardedTableSharedStore(int id, int shardCount)
+  : SharedStore(id),
+    m_purgeThread(this, &ShardedTableSharedStore::purgeThread),
+    m_stopped(false) {
+  if (shardCount < 1) shardCount = 1;
+  m_shards.resize(shardCount);
+  for (int i = 0; i < shardCount; i++) {
+    m_shards[i] = new ConcurrentTableSharedStore(id, true);
+  }
+  if (RuntimeOption::ApcPurgeInterval > 0) {
+    m_purgeThread.start();
+  }
+}
+
+ShardedTableSharedStore::~ShardedTableSharedStore() {
+  {
+    Lock lock(getMutex());
+    m_stopped = true;
+    notify();
+  }
+  m_purgeThread.waitForEnd();
+  for (unsigned int i = 0; i < m_shards.size(); i++) {
+    delete m_shards[i];
+  }
+}
+
+void ShardedTableSharedStore::purgeThread() {
+  Lock lock(getMutex());
+  while (!m_stopped) {
+    wait(RuntimeOption::ApcPurgeInterval);
+    if (m_stopped) break;
+    purgeExpired();
+  }
+}
+
+void ShardedTableSharedStore::purgeExpired() {
+  time_t now = time(NULL);
+  for (unsigned int i = 0; i < m_shards.size(); i++) {
+    m_shards[i]->purgeExpired(now);
+  }
+}
+
+int ShardedTableSharedStore::size() {
+  int total = 0;
+  for (unsigned int i = 0; i < m_shards.size(); i++) {
+    total += m_shards[i]->size();
+  }
+  return total;
+}
+
+void ShardedTableSharedStore::count(int &reachable, int &expired,
+                                    int &persistent) {
+  reachable = expired = persistent = 0;
+  for (unsigned int i = 0; i < m_shards.size(); i++) {
+    int r, e, p;
+    m_shards[i]->count(r, e, p);
+    reachable += r;
+    expired += e;
+    persistent += p;
+  }
+}
+
+void ShardedTableSharedStore::clear() {
+  for (unsigned int i = 0; i < m_shards.size(); i++) {
+    m_shards[i]->clear();
+  }
+}
+
+bool ShardedTableSharedStore::eraseImpl(CStrRef key, bool expired) {
+  if (key.isNull()) return false;
+  return shardFor(key).eraseImpl(key, expired);
+}
+
+void ShardedTableSharedStore::prime
+(const std::vector<SharedStore::KeyValuePair> &vars) {
+  vector<vector<SharedStore::KeyValuePair> > split(m_shards.size());
+  for (unsigned int i = 0; i < vars.size(); i++) {
+    const SharedStore::KeyValuePair &item = vars[i];
+    split[shardIndex(hash_string_inline(item.key, item.len))].push_back(item);
+  }
+  for (unsigned int i = 0; i < m_shards.size(); i++) {
+    if (!split[i].empty()) {
+      m_shards[i]->prime(split[i]);
+    }
+  }
+}
+
+bool ShardedTableSharedStore::getEntries(std::vector<Entry> &entries) {
+  for (unsigned int i = 0; i < m_shards.size(); i++) {
+    m_shards[i]->getEntries(entries);
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// debugging support
+
+void ShardedTableSharedStore::dump(std::ostream & out) {
+  for (unsigned int i = 0; i < m_shards.size(); i++) {
+    out << "Shard " << i << endl;
+    m_shards[i]->dump(out);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
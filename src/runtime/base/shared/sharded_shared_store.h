@@ -0,0 +1,107 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_SHARDED_SHARED_STORE_H__
+#define __HPHP_SHARDED_SHARED_STORE_H__
+
+#include <runtime/base/shared/concurrent_shared_store.h>
+#include <util/async_func.h>
+#include <util/synchronizable.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+// ShardedTableSharedStore
+
+/**
+ * Splits keys across a number of ConcurrentTableSharedStores by their hash,
+ * so whole table locks and expiration queues are per shard. Expired keys are
+ * purged by a thread of its own every ApcPurgeInterval seconds, instead of by
+ * requests storing values.
+ */
+class ShardedTableSharedStore : public SharedStore, public Synchronizable {
+public:
+  ShardedTableSharedStore(int id, int shardCount);
+  virtual ~ShardedTableSharedStore();
+
+  virtual int size();
+  virtual void count(int &reachable, int &expired, int &persistent);
+  virtual bool get(CStrRef key, Variant &value) {
+    return shardFor(key).get(key, value);
+  }
+  virtual bool store(CStrRef key, CVarRef val, int64 ttl,
+                     bool overwrite = true) {
+    return shardFor(key).store(key, val, ttl, overwrite);
+  }
+  virtual int64 inc(CStrRef key, int64 step, bool &found) {
+    return shardFor(key).inc(key, step, found);
+  }
+  virtual bool cas(CStrRef key, int64 old, int64 val) {
+    return shardFor(key).cas(key, old, val);
+  }
+  virtual bool exists(CStrRef key) {
+    return shardFor(key).exists(key);
+  }
+
+  virtual void prime(const std::vector<SharedStore::KeyValuePair> &vars);
+  virtual bool getEntries(std::vector<Entry> &entries);
+
+  // debug support
+  virtual void dump(std::ostream & out);
+
+  virtual SharedVariant* construct(litstr str, int len, CStrRef v,
+                                   bool serialized) {
+    return SharedVariant::Create(v, serialized);
+  }
+  virtual SharedVariant* construct(litstr str, int len, CVarRef v) {
+    return SharedVariant::Create(v, false);
+  }
+
+  /**
+   * Purges expired keys from all shards right away.
+   */
+  void purgeExpired();
+
+protected:
+  virtual SharedVariant* construct(CStrRef key, CVarRef v) {
+    return SharedVariant::Create(v, false);
+  }
+
+  virtual void clear();
+  virtual bool eraseImpl(CStrRef key, bool expired);
+
+private:
+  std::vector<ConcurrentTableSharedStore*> m_shards;
+  AsyncFunc<ShardedTableSharedStore> m_purgeThread;
+  bool m_stopped;
+
+  void purgeThread();
+
+  // Each shard's hash map buckets by the low bits of the same hash, so
+  // picking shards by them would leave most buckets of a shard empty. The
+  // sign bit is left out, as StringData may or may not have it set.
+  int shardIndex(int64 h) const {
+    return (int)((((uint64)h >> 32) & 0x7fffffff) % m_shards.size());
+  }
+  ConcurrentTableSharedStore &shardFor(CStrRef key) {
+    if (key.isNull()) return *m_shards[0];
+    return *m_shards[shardIndex(key->hash())];
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif /* __HPHP_SHARDED_SHARED_STORE_H__ */
@@ -18,27 +18,48 @@
 #include <runtime/base/shared/shared_map.h>
 #include <runtime/base/array/array_iterator.h>
 #include <runtime/base/array/array_init.h>
+#include <runtime/base/array/zend_array.h>
 #include <runtime/base/runtime_option.h>
 #include <runtime/base/runtime_error.h>
+#include <runtime/base/server/server_stats.h>
 
 namespace HPHP {
 
 IMPLEMENT_SMART_ALLOCATION(SharedMap, SmartAllocatorImpl::NeedRestore);
 ///////////////////////////////////////////////////////////////////////////////
 
+static int s_statsEscalate = ServerStats::Intern("apc.escalate");
+static int s_statsEscalateIter = ServerStats::Intern("apc.escalate.iter");
+
 SharedMap::SharedMap(SharedVariant* source) : m_arr(source) {
   source->incRef();
 }
 
+SharedMap::SharedMap(const SharedMap *src)
+  : ArrayData(src), m_arr(src->m_arr), m_localCache(src->localCache()) {
+  m_arr->incRef();
+}
+
+ArrayData *SharedMap::localCache() const {
+  if (m_localCache.isNull()) {
+    // a ZendArray, since it grows in place when written without copying
+    m_localCache = NEW(ZendArray)(size());
+  }
+  return m_localCache.get();
+}
+
 CVarRef SharedMap::getValueRef(ssize_t pos) const {
   SharedVariant *sv = m_arr->getValue(pos);
   DataType t = sv->getType();
   if (!IS_REFCOUNTED_TYPE(t)) return sv->asCVarRef();
   Variant *pv = m_localCache.lvalPtr((int64)pos, false, false);
   if (pv) return *pv;
-  Variant &r = m_localCache.addLval((int64)pos);
-  r = sv->toLocal();
-  return r;
+  // written in place, so that views sharing the cache see the same value
+  Variant *r = NULL;
+  ArrayData *escalated = localCache()->lval((int64)pos, r, false);
+  ASSERT(!escalated);
+  *r = sv->toLocal();
+  return *r;
 }
 
 Variant SharedMap::getValueUncached(ssize_t pos) const {
@@ -254,7 +275,7 @@ ArrayData *SharedMap::remove(CVarRef k, bool copy) {
 }
 
 ArrayData *SharedMap::copy() const {
-  return escalate();
+  return NEW(SharedMap)(this);
 }
 
 ArrayData *SharedMap::fiberCopy() const {
@@ -316,6 +337,10 @@ ArrayData *SharedMap::prepend(CVarRef v, bool copy) {
 }
 
 ArrayData *SharedMap::escalate(bool mutableIteration /* = false */) const {
+  if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
+    ServerStats::Log(mutableIteration ? s_statsEscalateIter : s_statsEscalate,
+                     1);
+  }
   ArrayData *ret = NULL;
   m_arr->loadElems(ret, *this, mutableIteration);
   ASSERT(!ret->isStatic());
@@ -32,6 +32,7 @@ namespace HPHP {
 class SharedMap : public ArrayData {
 public:
   SharedMap(SharedVariant* source);
+  SharedMap(const SharedMap *src);
 
   ~SharedMap() {
     m_arr->decRef();
@@ -95,6 +96,12 @@ public:
   ArrayData *remove(CStrRef k, bool copy);
   ArrayData *remove(CVarRef k, bool copy);
 
+  /**
+   * Another view of the same shared array, so that only actual writes, but
+   * not copy-on-write splits, escalate to a local array. All views of one
+   * SharedVariant made this way share one local value cache, so an object
+   * in it is unserialized once and is the same object in every view.
+   */
   ArrayData *copy() const;
   /**
    * Copy (escalate) the SharedMap without triggering local cache.
@@ -123,8 +130,10 @@ public:
 
 private:
   SharedVariant *m_arr;
+  // shared with copies, and only ever written in place, never split
   mutable Array m_localCache;
 
+  ArrayData *localCache() const;
   Variant getValueUncached(ssize_t pos) const;
 };
 
@@ -41,13 +41,13 @@ bool LockedSharedStore::get(CStrRef key, Variant &value) {
     }
     value = false;
     if (stats) {
-      ServerStats::Log("apc.miss", 1);
+      ServerStats::Log(StatsMiss, 1);
     }
     return false;
   }
   value = getVar(val->var)->toLocal();
   readUnlockMap();
-  if (stats) ServerStats::Log("apc.hit", 1);
+  if (stats) ServerStats::Log(StatsHit, 1);
   return true;
 }
 
@@ -69,10 +69,10 @@ bool LfuTableSharedStore::get(CStrRef key, Variant &value) {
       erase(key, true);
     }
     value = false;
-    if (stats) ServerStats::Log("apc.miss", 1);
+    if (stats) ServerStats::Log(StatsMiss, 1);
     return false;
   }
-  if (stats) ServerStats::Log("apc.hit", 1);
+  if (stats) ServerStats::Log(StatsHit, 1);
   return true;
 }
 
@@ -89,14 +89,14 @@ bool LockedSharedStore::store(CStrRef key, CVarRef val, int64 ttl,
     if (overwrite || expired) {
       getVar(sval->var)->decRef();
       sval->set(putVar(var), ttl);
-      if (stats) ServerStats::Log("apc.update", 1);
+      if (stats) ServerStats::Log(StatsUpdate, 1);
       added = true;
     }
   } else {
     set(key, var, ttl);
     added = true;
     if (stats) {
-      ServerStats::Log("apc.new", 1);
+      ServerStats::Log(StatsNew, 1);
       if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCKeyStats) {
         string prefix = "apc.new.";
         prefix += GetSkeleton(key);
@@ -126,14 +126,14 @@ bool LfuTableSharedStore::store(CStrRef key, CVarRef val, int64 ttl,
           val.var->decRef();
           val.set(var, ttl);
           added = true;
-          if (stats) ServerStats::Log("apc.update", 1);
+          if (stats) ServerStats::Log(StatsUpdate, 1);
         }
         newkey->destruct();
       } else {
         val.set(var, ttl);
         added = true;
         if (stats) {
-          ServerStats::Log("apc.new", 1);
+          ServerStats::Log(StatsNew, 1);
           if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCKeyStats) {
             string prefix = "apc.new.";
             prefix += GetSkeleton(key);
@@ -166,7 +166,7 @@ void LockedSharedStore::prime(const std::vector<KeyValuePair> &vars) {
   // we are priming, so we are not checking existence or expiration
   for (unsigned int i = 0; i < vars.size(); i++) {
     const KeyValuePair &item = vars[i];
-    set(String(item.key, item.len, CopyString), item.value, 0);
+    set(String(item.key, item.len, CopyString), item.value, item.ttl);
   }
   unlockMap();
 }
@@ -209,7 +209,7 @@ int64 LockedSharedStore::inc(CStrRef key, int64 step, bool &found) {
   }
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.inc", 1);
+    ServerStats::Log(StatsInc, 1);
   }
   return ret;
 }
@@ -246,7 +246,7 @@ int64 LfuTableSharedStore::inc(CStrRef key, int64 step, bool &found) {
   m_vars.atomicUpdate(key.get(), updater, false);
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.inc", 1);
+    ServerStats::Log(StatsInc, 1);
   }
   return updater.ret;
 }
@@ -272,7 +272,7 @@ bool LockedSharedStore::cas(CStrRef key, int64 old, int64 val) {
   }
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.cas", 1);
+    ServerStats::Log(StatsCas, 1);
   }
   return success;
 }
@@ -307,7 +307,7 @@ bool LfuTableSharedStore::cas(CStrRef key, int64 old, int64 val) {
   m_vars.atomicUpdate(key.get(), updater, false);
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log("apc.cas", 1);
+    ServerStats::Log(StatsCas, 1);
   }
   return updater.success;
 }
@@ -203,6 +203,22 @@ public:
     }
     unlockMap();
   }
+  virtual bool getEntries(std::vector<Entry> &entries) {
+    readLockMap();
+    entries.reserve(m_vars.size());
+    for (StringMap::const_iterator iter = m_vars.begin();
+         iter != m_vars.end(); ++iter) {
+      if (iter->second.expired()) continue;
+      Entry entry;
+      entry.key.assign(iter->first->data(), iter->first->size());
+      entry.value = iter->second.var;
+      entry.value->incRef();
+      entry.expiry = iter->second.expiry;
+      entries.push_back(entry);
+    }
+    readUnlockMap();
+    return true;
+  }
   virtual void lockMap() {
     m_mlock.acquireWrite();
   }
@@ -23,6 +23,8 @@
 #include <runtime/base/server/server_stats.h>
 #include <runtime/base/shared/shared_store.h>
 #include <runtime/base/shared/concurrent_shared_store.h>
+#include <runtime/base/shared/sharded_shared_store.h>
+#include <runtime/base/shared/tiny_lfu_shared_store.h>
 
 using namespace std;
 using namespace boost;
@@ -32,6 +34,15 @@ namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 // SharedStore
 
+int SharedStore::StatsHit = ServerStats::Intern("apc.hit");
+int SharedStore::StatsMiss = ServerStats::Intern("apc.miss");
+int SharedStore::StatsNew = ServerStats::Intern("apc.new");
+int SharedStore::StatsUpdate = ServerStats::Intern("apc.update");
+int SharedStore::StatsErase = ServerStats::Intern("apc.erase");
+int SharedStore::StatsErased = ServerStats::Intern("apc.erased");
+int SharedStore::StatsInc = ServerStats::Intern("apc.inc");
+int SharedStore::StatsCas = ServerStats::Intern("apc.cas");
+
 SharedStore::SharedStore(int id) : m_id(id) {
 }
 
@@ -62,7 +73,7 @@ bool SharedStore::erase(CStrRef key, bool expired /* = false */) {
   bool success = eraseImpl(key, expired);
 
   if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
-    ServerStats::Log(success ? "apc.erased" : "apc.erase", 1);
+    ServerStats::Log(success ? StatsErased : StatsErase, 1);
   }
   return success;
 }
@@ -137,6 +148,15 @@ void SharedStores::create() {
       case RuntimeOption::ApcConcurrentTable:
         m_stores[i] = new ConcurrentTableSharedStore(i);
         break;
+      case RuntimeOption::ApcShardedTable:
+        m_stores[i] = new ShardedTableSharedStore(i,
+                                                  RuntimeOption::ApcShardCount);
+        break;
+      case RuntimeOption::ApcTinyLfuTable:
+        m_stores[i] = new TinyLfuTableSharedStore(i,
+          i == SHARED_STORE_DNS_CACHE ? RuntimeOption::DnsCacheMaximumCapacity
+                                      : RuntimeOption::ApcMaximumCapacity);
+        break;
       default:
         ASSERT(false);
     }
@@ -71,14 +71,37 @@ public:
     int len;
     SharedVariant *value;
     int32 size;
+    int64 ttl; // 0 for never expiring
   };
   virtual void prime(const std::vector<KeyValuePair> &vars) = 0;
 
+  // for snapshots only
+  struct Entry {
+    std::string key;
+    SharedVariant *value; // incRef-ed for the caller
+    int64 expiry;
+  };
+  /**
+   * Copies out all entries that have not expired. Returns false if the store
+   * does not support it.
+   */
+  virtual bool getEntries(std::vector<Entry> &entries) { return false; }
+
   virtual std::string reportStats(int &reachable, int indent);
   virtual bool check() { return true; }
   static size_t s_lockCount;
   static std::string GetSkeleton(CStrRef key);
 
+  // interned ServerStats keys
+  static int StatsHit;
+  static int StatsMiss;
+  static int StatsNew;
+  static int StatsUpdate;
+  static int StatsErase;
+  static int StatsErased;
+  static int StatsInc;
+  static int StatsCas;
+
   // debug support
   virtual void dump(std::ostream & out) { /* Default does nothing*/ }
 
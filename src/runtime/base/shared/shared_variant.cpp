@@ -75,6 +75,7 @@ SharedVariant::SharedVariant(CVarRef source, bool serialized,
           setSerializedArray();
           m_shouldCache = true;
           String s = apc_serialize(source);
+          MemoryManager::MaskArena mask;
           m_data.str = new StringData(s.data(), s.size(), CopyString);
           break;
         }
@@ -120,6 +121,7 @@ SharedVariant::SharedVariant(CVarRef source, bool serialized,
         setIsObj();
       } else {
         String s = apc_serialize(source);
+        MemoryManager::MaskArena mask;
         m_data.str = new StringData(s.data(), s.size(), CopyString);
       }
       break;
@@ -482,5 +484,189 @@ void SharedVariant::getStats(SharedVariantStats *stats) {
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// snapshot support
+
+template<class T>
+static void encode_raw(std::string &out, T value) {
+  out.append((const char *)&value, sizeof(T));
+}
+
+template<class T>
+static bool decode_raw(const char *&p, const char *end, T &value) {
+  if ((size_t)(end - p) < sizeof(T)) return false;
+  memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+  return true;
+}
+
+static void encode_string(std::string &out, char tag, const StringData *sd) {
+  out += tag;
+  encode_raw(out, (uint32)sd->size());
+  out.append(sd->data(), sd->size());
+}
+
+static StringData *decode_string(const char *&p, const char *end) {
+  uint32 len;
+  if (!decode_raw(p, end, len) || (size_t)(end - p) < len) return NULL;
+  MemoryManager::MaskArena mask;
+  StringData *sd = new StringData(p, len, CopyString);
+  p += len;
+  return sd;
+}
+
+void SharedVariant::encode(std::string &out) {
+  switch (m_type) {
+  case KindOfBoolean:
+    out += m_data.num ? 'T' : 'F';
+    break;
+  case KindOfInt64:
+    out += 'I';
+    encode_raw(out, m_data.num);
+    break;
+  case KindOfDouble:
+    out += 'D';
+    encode_raw(out, m_data.dbl);
+    break;
+  case KindOfStaticString:
+  case KindOfString:
+    encode_string(out, 'S', m_data.str);
+    break;
+  case KindOfArray:
+    if (getSerializedArray()) {
+      encode_string(out, 'R', m_data.str);
+    } else if (getIsVector()) {
+      out += 'V';
+      encode_raw(out, (uint32)m_data.vec->size);
+      for (size_t i = 0; i < m_data.vec->size; i++) {
+        m_data.vec->vals[i]->encode(out);
+      }
+    } else {
+      ImmutableMap *map = m_data.map;
+      out += 'M';
+      encode_raw(out, (uint32)map->size());
+      for (int i = 0; i < map->size(); i++) {
+        map->getKeyIndex(i)->encode(out);
+        map->getValIndex(i)->encode(out);
+      }
+    }
+    break;
+  case KindOfUninit:
+  case KindOfNull:
+    out += 'N';
+    break;
+  default:
+    ASSERT(m_type == KindOfObject);
+    if (getIsObj()) {
+      String s = apc_serialize(m_data.obj->getObject());
+      encode_string(out, 'O', s.get());
+    } else {
+      encode_string(out, 'O', m_data.str);
+    }
+    break;
+  }
+}
+
+SharedVariant *SharedVariant::Decode(const char *&p, const char *end) {
+  if (p >= end) return NULL;
+  char tag = *p++;
+  SharedVariant *sv = new SharedVariant();
+  bool ok = true;
+  switch (tag) {
+  case 'N':
+    break;
+  case 'T':
+  case 'F':
+    sv->m_type = KindOfBoolean;
+    sv->m_data.num = (tag == 'T');
+    break;
+  case 'I':
+    ok = decode_raw(p, end, sv->m_data.num);
+    sv->m_type = KindOfInt64;
+    break;
+  case 'D':
+    ok = decode_raw(p, end, sv->m_data.dbl);
+    sv->m_type = KindOfDouble;
+    break;
+  case 'S':
+  case 'O':
+  case 'R':
+    {
+      StringData *sd = decode_string(p, end);
+      if (sd == NULL) {
+        ok = false;
+        break;
+      }
+      sv->m_data.str = sd;
+      if (tag == 'S') {
+        sv->m_type = KindOfString;
+      } else if (tag == 'O') {
+        sv->m_type = KindOfObject;
+        sv->m_shouldCache = true;
+      } else {
+        sv->m_type = KindOfArray;
+        sv->setSerializedArray();
+        sv->m_shouldCache = true;
+      }
+    }
+    break;
+  case 'V':
+    {
+      uint32 size;
+      if (!decode_raw(p, end, size) || size > (size_t)(end - p)) {
+        ok = false;
+        break;
+      }
+      VectorData *vec = new VectorData(size);
+      sv->m_type = KindOfArray;
+      sv->setIsVector();
+      sv->m_data.vec = vec;
+      for (uint32 i = 0; i < size; i++) {
+        SharedVariant *val = Decode(p, end);
+        if (val == NULL) {
+          vec->size = i; // only these get decRef-ed
+          ok = false;
+          break;
+        }
+        if (val->m_shouldCache) sv->m_shouldCache = true;
+        vec->vals[i] = val;
+      }
+    }
+    break;
+  case 'M':
+    {
+      uint32 size;
+      if (!decode_raw(p, end, size) || size > (size_t)(end - p)) {
+        ok = false;
+        break;
+      }
+      sv->m_type = KindOfArray;
+      sv->m_data.map = new ImmutableMap(size);
+      for (uint32 i = 0; i < size; i++) {
+        SharedVariant *key = Decode(p, end);
+        SharedVariant *val = key ? Decode(p, end) : NULL;
+        if (val == NULL ||
+            !(key->is(KindOfInt64) || key->is(KindOfString))) {
+          if (key) key->decRef();
+          if (val) val->decRef();
+          ok = false;
+          break;
+        }
+        if (val->m_shouldCache) sv->m_shouldCache = true;
+        sv->m_data.map->add(key, val);
+      }
+    }
+    break;
+  default:
+    ok = false;
+    break;
+  }
+  if (!ok) {
+    sv->decRef();
+    return NULL;
+  }
+  return sv;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
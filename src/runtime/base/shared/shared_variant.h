@@ -128,7 +128,20 @@ public:
 
   int countReachable() const;
 
+  /**
+   * A compact binary form of the tree, for APC snapshots. Objects and arrays
+   * with internal references are kept in serialized form, as they are in
+   * memory, so decoding never needs class definitions. Decode() returns NULL
+   * on malformed data.
+   */
+  void encode(std::string &out);
+  static SharedVariant *Decode(const char *&p, const char *end);
+
 private:
+  SharedVariant() : m_count(1), m_shouldCache(false), m_flags(0) {
+    m_type = KindOfNull;
+  }
+
   class VectorData {
   public:
     size_t size;
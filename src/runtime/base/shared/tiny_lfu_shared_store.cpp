@@ -0,0 +1,312 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <runtime/base/shared/tiny_lfu_shared_store.h>
+
+using namespace std;
+using namespace boost;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+void TinyLfuTableSharedStore::set(CStrRef key, SharedVariant* v, int64 ttl,
+                                  bool immortal) {
+  class SetUpdater : public Map::AtomicUpdater {
+  public:
+    SetUpdater(SharedVariant *v, int64 t, CStrRef key)
+      : var(v), ttl(t), newkey(key.get()->copy(true)) {}
+    bool update(StringData* const &k, StoreValue &val, bool newlyCreated) {
+      if (!newlyCreated) {
+        // priming over an existing key
+        val.var->decRef();
+        newkey->destruct();
+      }
+      val.set(var, ttl);
+      return false;
+    }
+    StringData *newKey() { return newkey; }
+  private:
+    SharedVariant *var;
+    int64 ttl;
+    StringData *newkey;
+  };
+  if (key.isNull()) return;
+  SetUpdater updater(v, ttl, key);
+  m_vars.atomicUpdate(updater.newKey(), updater, true, immortal);
+}
+
+bool TinyLfuTableSharedStore::eraseImpl(CStrRef key, bool expired) {
+  class EraseUpdater : public Map::AtomicUpdater {
+  public:
+    EraseUpdater(bool exp) : res(false), expired(exp) {}
+    bool update(StringData* const &k, StoreValue &val, bool newlyCreated) {
+      if (expired && !val.expired()) {
+        return false;
+      }
+      res = true;
+      return true;
+    }
+    bool res;
+  private:
+    bool expired;
+  };
+
+  if (key.isNull()) return false;
+  EraseUpdater updater(expired);
+  m_vars.atomicUpdate(key.get(), updater, false);
+  return updater.res;
+}
+
+void TinyLfuTableSharedStore::count(int &reachable, int &expired,
+                                    int &persistent) {
+  class CountBody : public Map::AtomicReader {
+  public:
+    CountBody(int &r, int &e, int &p)
+      : now(time(NULL)), reachable(r), expired(e), persistent(p) {}
+    void read(StringData* const &k, const StoreValue &val) {
+      reachable += val.var->countReachable();
+      int64 expiration = val.expiry;
+      if (expiration == 0) {
+        persistent++;
+      } else if (expiration <= now) {
+        expired++;
+      }
+    }
+  private:
+    time_t now;
+    int &reachable;
+    int &expired;
+    int &persistent;
+  };
+  reachable = expired = persistent = 0;
+  CountBody body(reachable, expired, persistent);
+  m_vars.atomicForeach(body);
+}
+
+bool TinyLfuTableSharedStore::get(CStrRef key, Variant &value) {
+  class GetReader : public Map::AtomicReader {
+  public:
+    GetReader(Variant &v) : expired(false), value(v) {}
+    void read(StringData* const &k, const StoreValue &val) {
+      expired = val.expired();
+      if (!expired) value = val.var->toLocal();
+    }
+    bool expired;
+    Variant &value;
+  };
+  bool stats = RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats;
+  GetReader reader(value);
+  if (key.isNull() || !m_vars.atomicRead(key.get(), reader) ||
+      reader.expired) {
+    if (reader.expired) {
+      erase(key, true);
+    }
+    value = false;
+    if (stats) ServerStats::Log(StatsMiss, 1);
+    return false;
+  }
+  if (stats) ServerStats::Log(StatsHit, 1);
+  return true;
+}
+
+bool TinyLfuTableSharedStore::store(CStrRef key, CVarRef val, int64 ttl,
+                                    bool overwrite /* = true */) {
+  class StoreUpdater : public Map::AtomicUpdater {
+  public:
+    StoreUpdater(int64 t, SharedVariant *v, CStrRef k, bool ovr)
+      : added(false), overwrite(ovr), ttl(t), var(v), key(k),
+        newkey(key.get()->copy(true)) {}
+    bool update(StringData* const &k, StoreValue &val, bool newlyCreated) {
+      bool stats = RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats;
+      if (!newlyCreated) {
+        if (overwrite || val.expired()) {
+          val.var->decRef();
+          val.set(var, ttl);
+          added = true;
+          if (stats) ServerStats::Log(StatsUpdate, 1);
+        }
+        newkey->destruct();
+      } else {
+        val.set(var, ttl);
+        added = true;
+        if (stats) {
+          ServerStats::Log(StatsNew, 1);
+          if (RuntimeOption::EnableAPCKeyStats) {
+            string prefix = "apc.new.";
+            prefix += GetSkeleton(key);
+            ServerStats::Log(prefix, 1);
+          }
+        }
+      }
+      return false;
+    }
+    StringData *newKey() { return newkey; }
+    bool added;
+  private:
+    bool overwrite;
+    int64 ttl;
+    SharedVariant *var;
+    CStrRef key;
+    StringData *newkey;
+  };
+  if (key.isNull()) return false;
+  SharedVariant* var = construct(key, val);
+  StoreUpdater updater(ttl, var, key, overwrite);
+  m_vars.atomicUpdate(updater.newKey(), updater, true);
+  if (!updater.added) {
+    var->decRef();
+  }
+  return updater.added;
+}
+
+int64 TinyLfuTableSharedStore::inc(CStrRef key, int64 step, bool &found) {
+  class IncUpdater : public Map::AtomicUpdater {
+  public:
+    IncUpdater(int64 s, bool &f, CStrRef k, TinyLfuTableSharedStore *str)
+      : ret(0), step(s), found(f), key(k), store(str) {}
+    bool update(StringData* const &k, StoreValue &val, bool newlyCreated) {
+      if (val.expired()) {
+        return true;
+      }
+      Variant v = val.var->toLocal();
+      ret = v.toInt64() + step;
+      v = ret;
+      SharedVariant *var = store->construct(key, v);
+      val.var->decRef();
+      val.var = var;
+      found = true;
+      return false;
+    }
+    int64 ret;
+  private:
+    int64 step;
+    bool &found;
+    CStrRef key;
+    TinyLfuTableSharedStore *store;
+  };
+  found = false;
+  if (key.isNull()) return 0;
+  IncUpdater updater(step, found, key, this);
+  m_vars.atomicUpdate(key.get(), updater, false);
+  if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
+    ServerStats::Log(StatsInc, 1);
+  }
+  return updater.ret;
+}
+
+bool TinyLfuTableSharedStore::cas(CStrRef key, int64 old, int64 val) {
+  class CasUpdater : public Map::AtomicUpdater {
+  public:
+    CasUpdater(TinyLfuTableSharedStore *s, CStrRef k, int64 o, int64 v)
+      : success(false), store(s), key(k), old(o), val(v) {}
+    bool update(StringData* const &k, StoreValue &sval, bool newlyCreated) {
+      if (sval.expired()) {
+        return true;
+      }
+      Variant v = sval.var->toLocal();
+      if (v.toInt64() == old) {
+        v = val;
+        SharedVariant *var = store->construct(key, v);
+        sval.var->decRef();
+        sval.var = var;
+        success = true;
+      }
+      return false;
+    }
+    bool success;
+  private:
+    TinyLfuTableSharedStore *store;
+    CStrRef key;
+    int64 old;
+    int64 val;
+  };
+  if (key.isNull()) return false;
+  CasUpdater updater(this, key, old, val);
+  m_vars.atomicUpdate(key.get(), updater, false);
+  if (RuntimeOption::EnableStats && RuntimeOption::EnableAPCStats) {
+    ServerStats::Log(StatsCas, 1);
+  }
+  return updater.success;
+}
+
+void TinyLfuTableSharedStore::prime
+(const std::vector<SharedStore::KeyValuePair> &vars) {
+  // we are priming, so we are not checking expiration
+  for (unsigned int i = 0; i < vars.size(); i++) {
+    const SharedStore::KeyValuePair &item = vars[i];
+    // Primed values are immortal
+    set(String(item.key, item.len, CopyString), item.value, item.ttl, true);
+  }
+}
+
+bool TinyLfuTableSharedStore::getEntries(std::vector<Entry> &entries) {
+  class EntryReader : public Map::AtomicReader {
+  public:
+    EntryReader(std::vector<Entry> &e) : entries(e) {}
+    void read(StringData* const &k, const StoreValue &val) {
+      if (val.expired()) return;
+      Entry entry;
+      entry.key = std::string(k->data(), k->size());
+      entry.value = val.var;
+      entry.value->incRef();
+      entry.expiry = val.expiry;
+      entries.push_back(entry);
+    }
+  private:
+    std::vector<Entry> &entries;
+  };
+  entries.reserve(m_vars.size());
+  EntryReader reader(entries);
+  m_vars.atomicForeach(reader);
+  return true;
+}
+
+static std::string appendElement(int indent, const char *name,
+                                 const std::string &value) {
+  string ret;
+  for (int i = 0; i < indent; i++) {
+    ret += "  ";
+  }
+  ret += "<"; ret += name; ret += ">";
+  ret += value;
+  ret += "</"; ret += name; ret += ">\n";
+  return ret;
+}
+
+std::string TinyLfuTableSharedStore::reportStats(int &reachable,
+                                                 int indent) {
+  int64 hits = m_vars.hits();
+  int64 lookups = hits + m_vars.misses();
+  char ratio[16];
+  snprintf(ratio, sizeof(ratio), "%.4f",
+           lookups ? (double)hits / lookups : 0.0);
+
+  string ret = SharedStore::reportStats(reachable, indent);
+  ret += appendElement(indent, "Immortal",
+                       lexical_cast<string>(m_vars.immortalCount()));
+  ret += appendElement(indent, "Maximum Capacity",
+                       lexical_cast<string>(m_vars.maximumCapacity()));
+  ret += appendElement(indent, "Hits", lexical_cast<string>(hits));
+  ret += appendElement(indent, "Misses",
+                       lexical_cast<string>(m_vars.misses()));
+  ret += appendElement(indent, "Hit Ratio", ratio);
+  ret += appendElement(indent, "Evictions",
+                       lexical_cast<string>(m_vars.evictions()));
+  return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
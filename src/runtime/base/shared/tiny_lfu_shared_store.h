@@ -0,0 +1,112 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_TINY_LFU_SHARED_STORE_H__
+#define __HPHP_TINY_LFU_SHARED_STORE_H__
+
+#include <runtime/base/shared/shared_store.h>
+#include <util/tiny_lfu_table.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+// TinyLfuTableSharedStore
+
+/**
+ * Keeps at most maxCap keys in a TinyLFUTable, evicting the ones that are
+ * least likely to be fetched again. Primed keys are immortal and don't count
+ * towards the capacity. A maxCap of 0 means no limit.
+ */
+class TinyLfuTableSharedStore : public SharedStore,
+                                private SharedVariantFactory {
+public:
+  TinyLfuTableSharedStore(int id, size_t maxCap)
+    : SharedStore(id), m_vars(maxCap) {
+  }
+
+  virtual void clear() {
+    m_vars.clear();
+  }
+  virtual int size() {
+    return m_vars.size();
+  }
+  virtual void count(int &reachable, int &expired, int &persistent);
+
+  virtual bool get(CStrRef key, Variant &value);
+  virtual bool store(CStrRef key, CVarRef val, int64 ttl,
+                     bool overwrite = true);
+  virtual int64 inc(CStrRef key, int64 step, bool &found);
+  virtual bool cas(CStrRef key, int64 old, int64 val);
+
+  virtual void prime(const std::vector<SharedStore::KeyValuePair> &vars);
+  virtual bool getEntries(std::vector<Entry> &entries);
+
+  virtual bool check() {
+    return m_vars.check();
+  }
+  virtual std::string reportStats(int &reachable, int indent);
+
+  virtual SharedVariant* construct(litstr str, int len, CStrRef v,
+                                   bool serialized) {
+    return create(str, len, v, serialized);
+  }
+  virtual SharedVariant* construct(litstr str, int len, CVarRef v) {
+    return create(str, len, v);
+  }
+
+  int64 hits() const { return m_vars.hits(); }
+  int64 misses() const { return m_vars.misses(); }
+  int64 evictions() const { return m_vars.evictions(); }
+
+protected:
+  virtual SharedVariant* construct(CStrRef key, CVarRef v) {
+    return create(key, v);
+  }
+  virtual bool eraseImpl(CStrRef key, bool expired);
+
+private:
+  struct StringHash {
+    size_t operator()(StringData *s) const {
+      ASSERT(s);
+      return hash_string(s->data(), s->size());
+    }
+  };
+
+  struct StringEqual {
+    bool operator()(StringData *s1, StringData *s2) const {
+      ASSERT(s1 && s2);
+      return s1->compare(s2) == 0;
+    }
+  };
+
+  class NodeDestructor {
+  public:
+    void operator()(const StringData *k, StoreValue &val) {
+      k->destruct();
+      if (val.var) val.var->decRef();
+    }
+  };
+
+  typedef TinyLFUTable<StringData*, StoreValue, StringHash, StringEqual,
+                       NodeDestructor> Map;
+  Map m_vars;
+
+  void set(CStrRef key, SharedVariant* v, int64 ttl, bool immortal);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif /* __HPHP_TINY_LFU_SHARED_STORE_H__ */
@@ -43,6 +43,7 @@ StringData *StringData::GetStaticString(const std::string &stringData) {
   StringDataMap::accessor acc;
   if (!s_stringDataMap) s_stringDataMap = new StringDataMap();
   if (s_stringDataMap->insert(acc, stringData)) {
+    MemoryManager::MaskArena mask;
     StringData *sd =
       new StringData(stringData.data(), stringData.size(), CopyString);
     sd->setStatic();
@@ -102,7 +103,7 @@ void StringData::releaseData() {
     if (isShared()) {
       m_shared->decRef();
     } else if (m_data) {
-      free((void*)m_data);
+      smart_free((void*)m_data);
       m_data = NULL;
     }
   }
@@ -115,7 +116,7 @@ void StringData::assignHelper(const char *data, int len, StringDataMode mode) {
     switch (mode) {
     case CopyString:
       {
-        char *buf = (char*)malloc(len + 1);
+        char *buf = (char*)smart_malloc(len + 1);
         buf[len] = '\0';
         memcpy(buf, data, len);
         m_data = buf;
@@ -136,7 +137,8 @@ void StringData::assignHelper(const char *data, int len, StringDataMode mode) {
     }
   } else {
     if (mode == AttachString) {
-      free((void*)data); // we don't really need a malloc-ed empty string
+      // we don't really need a malloc-ed empty string
+      smart_free((void*)data);
     }
     m_len |= IsLiteral;
     m_data = "";
@@ -182,7 +184,7 @@ void StringData::append(const char *s, int len) {
     ASSERT((m_data > s && m_data - s > len) ||
            (m_data < s && s - m_data > dataLen)); // no overlapping
     m_len = len + dataLen;
-    m_data = (const char*)realloc((void*)m_data, m_len + 1);
+    m_data = (const char*)smart_realloc((void*)m_data, m_len + 1);
     memcpy((void*)(m_data + dataLen), s, len);
     ((char*)m_data)[m_len] = '\0';
     m_hash = 0;
@@ -209,6 +211,7 @@ StringData *StringData::copy(bool sharedMemory /* = false */) const {
     // Even if it's literal, it might come from hphpi's class info
     // which will be freed at the end of the request, and so must be
     // copied.
+    MemoryManager::MaskArena mask;
     return new StringData(data(), size(), CopyString);
   } else {
     if (isLiteral()) {
@@ -224,7 +227,7 @@ void StringData::escalate() {
   int len = size();
   ASSERT(len);
 
-  char *buf = (char*)malloc(len+1);
+  char *buf = (char*)smart_malloc(len+1);
   memcpy(buf, m_data, len);
   buf[len] = '\0';
   m_len = len;
@@ -272,7 +275,7 @@ void StringData::dump() const {
 
 StringData *StringData::getChar(int offset) const {
   if (offset >= 0 && offset < size()) {
-    char *buf = (char *)malloc(2);
+    char *buf = (char *)smart_malloc(2);
     buf[0] = m_data[offset];
     buf[1] = 0;
     return NEW(StringData)(buf, 1, AttachString);
@@ -326,7 +329,7 @@ void StringData::removeChar(int offset) {
   ASSERT(!isStatic());
   int len = size();
   if (isImmutable()) {
-    char *data = (char*)malloc(len);
+    char *data = (char*)smart_malloc(len + 1);
     if (offset) {
       // We are mutating, so we don't need to repropagate our own taint
       memcpy(data, m_data, offset);
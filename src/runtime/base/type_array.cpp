@@ -31,6 +31,7 @@
 #include <runtime/ext/ext_iconv.h>
 #include <unicode/coll.h> // icu
 #include <util/parser/hphp.tab.hpp>
+#include <algorithm>
 
 using namespace std;
 
@@ -1118,15 +1119,183 @@ void Array::SortImpl(vector<int> &indices, CArrRef source,
   zend_qsort(&indices[0], count, sizeof(int), array_compare_func, &opaque);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// sorting arrays of all ints or all strings
+
+/**
+ * When every value (or key) being sorted is an int, or every one is a
+ * string, and the comparator is one of the built-in ones below, the sort
+ * keys are pulled out into a flat vector once and sorted with std::sort on
+ * an inlined comparison, instead of calling the comparator through Variants
+ * and two levels of indirection for every comparison.
+ */
+template <typename T>
+struct SortEntry {
+  T key;
+  ssize_t pos;
+};
+
+struct IntCompare {
+  int operator()(int64 i1, int64 i2) const {
+    return i1 < i2 ? -1 : (i1 == i2 ? 0 : 1);
+  }
+};
+
+// SORT_REGULAR, when no string is numeric: what StringData::compare() ends
+// up doing anyway. Numeric strings are left to zend_qsort(), since comparing
+// them with other strings isn't transitive, and std::sort() relies on that.
+struct BinaryStringCompare {
+  int operator()(const StringData *s1, const StringData *s2) const {
+    int len1 = s1->size();
+    int len2 = s2->size();
+    int ret = memcmp(s1->data(), s2->data(), len1 < len2 ? len1 : len2);
+    if (ret) return ret;
+    return len1 < len2 ? -1 : (len1 == len2 ? 0 : 1);
+  }
+};
+
+// SORT_STRING
+struct CStringCompare {
+  int operator()(const StringData *s1, const StringData *s2) const {
+    return strcmp(s1->data(), s2->data());
+  }
+};
+
+template <typename T, typename Compare, bool ascending>
+struct SortEntryLess {
+  bool operator()(const SortEntry<T> &e1, const SortEntry<T> &e2) const {
+    int ret = Compare()(e1.key, e2.key);
+    return ascending ? ret < 0 : ret > 0;
+  }
+};
+
+template <typename T, typename Compare>
+static void sort_entries(vector<SortEntry<T> > &entries, bool ascending,
+                         vector<ssize_t> &order) {
+  if (ascending) {
+    std::sort(entries.begin(), entries.end(),
+              SortEntryLess<T, Compare, true>());
+  } else {
+    std::sort(entries.begin(), entries.end(),
+              SortEntryLess<T, Compare, false>());
+  }
+  order.reserve(entries.size());
+  for (unsigned int i = 0; i < entries.size(); i++) {
+    order.push_back(entries[i].pos);
+  }
+}
+
+/**
+ * Fills in order with the array's positions in sorted order, or returns
+ * false if cmp_func or the element types aren't ones handled here.
+ */
+static bool sort_homogeneous(CArrRef arr, Array::PFUNC_CMP cmp_func,
+                             bool by_key, vector<ssize_t> &order) {
+  bool ascending;
+  bool ints, strings;
+  if (cmp_func == Array::SortRegularAscending ||
+      cmp_func == Array::SortRegularDescending) {
+    ascending = cmp_func == Array::SortRegularAscending;
+    ints = strings = true;
+  } else if (cmp_func == Array::SortNumericAscending ||
+             cmp_func == Array::SortNumericDescending) {
+    ascending = cmp_func == Array::SortNumericAscending;
+    ints = true;
+    strings = false;
+  } else if (cmp_func == Array::SortStringAscending ||
+             cmp_func == Array::SortStringDescending) {
+    ascending = cmp_func == Array::SortStringAscending;
+    ints = false;
+    strings = true;
+  } else {
+    return false;
+  }
+
+  bool regular = ints && strings;
+  ArrayData *data = arr.get();
+  ssize_t pos = data->iter_begin();
+  if (pos == ArrayData::invalid_index) return true;
+  int count = data->size();
+
+  if (ints) {
+    vector<SortEntry<int64> > entries;
+    entries.reserve(count);
+    for (; pos != ArrayData::invalid_index; pos = data->iter_advance(pos)) {
+      SortEntry<int64> entry;
+      if (by_key) {
+        Variant key = data->getKey(pos);
+        if (!key.isInteger()) break;
+        entry.key = key.getInt64();
+      } else {
+        CVarRef value = data->getValueRef(pos);
+        if (!value.isInteger()) break;
+        entry.key = value.getInt64();
+      }
+      entry.pos = pos;
+      entries.push_back(entry);
+    }
+    if (pos == ArrayData::invalid_index) {
+      sort_entries<int64, IntCompare>(entries, ascending, order);
+      return true;
+    }
+    if (!entries.empty()) return false;
+  }
+
+  if (strings) {
+    vector<SortEntry<StringData*> > entries;
+    entries.reserve(count);
+    // not every kind of array returns the key strings it holds
+    vector<String> keys;
+    if (by_key) keys.reserve(count);
+    for (; pos != ArrayData::invalid_index; pos = data->iter_advance(pos)) {
+      SortEntry<StringData*> entry;
+      if (by_key) {
+        Variant key = data->getKey(pos);
+        if (!key.isString()) break;
+        keys.push_back(key.getStringData());
+        entry.key = key.getStringData();
+      } else {
+        CVarRef value = data->getValueRef(pos);
+        if (!value.isString()) break;
+        entry.key = value.getStringData();
+      }
+      if (regular && entry.key->isNumeric()) return false;
+      entry.pos = pos;
+      entries.push_back(entry);
+    }
+    if (pos == ArrayData::invalid_index) {
+      if (!regular) {
+        sort_entries<StringData*, CStringCompare>(entries, ascending, order);
+      } else {
+        sort_entries<StringData*, BinaryStringCompare>(entries, ascending,
+                                                       order);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
 void Array::sort(PFUNC_CMP cmp_func, bool by_key, bool renumber,
                  const void *data /* = NULL */) {
+  vector<ssize_t> order;
+  if (!m_px || !sort_homogeneous(*this, cmp_func, by_key, order)) {
+    SortData opaque;
+    vector<int> indices;
+    SortImpl(indices, *this, opaque, cmp_func, by_key, data);
+    order.reserve(indices.size());
+    for (unsigned int i = 0; i < indices.size(); i++) {
+      order.push_back(opaque.positions[indices[i]]);
+    }
+  }
+
+  if (m_px && m_px->getCount() == 1 && !m_px->isStatic() &&
+      m_px->reorder(order, renumber)) {
+    return;
+  }
   Array sorted = Array::Create();
-  SortData opaque;
-  vector<int> indices;
-  SortImpl(indices, *this, opaque, cmp_func, by_key, data);
-  int count = size();
-  for (int i = 0; i < count; i++) {
-    ssize_t pos = opaque.positions[indices[i]];
+  for (unsigned int i = 0; i < order.size(); i++) {
+    ssize_t pos = order[i];
     if (renumber) {
       sorted.append(m_px->getValueRef(pos));
     } else {
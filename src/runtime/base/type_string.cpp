@@ -59,7 +59,7 @@ String::String(int n) {
   tmpbuf[11] = '\0';
   p = conv_10(n, &is_negative, &tmpbuf[11], &len);
 
-  buf = (char*)malloc(len + 1);
+  buf = (char*)smart_malloc(len + 1);
   memcpy(buf, p, len + 1); // including the null terminator.
   m_px = NEW(StringData)(buf, len, AttachString);
   m_px->setRefCount(1);
@@ -77,7 +77,7 @@ String::String(int64 n) {
   tmpbuf[20] = '\0';
   p = conv_10(n, &is_negative, &tmpbuf[20], &len);
 
-  buf = (char*)malloc(len + 1);
+  buf = (char*)smart_malloc(len + 1);
   memcpy(buf, p, len + 1); // including the null terminator.
   m_px = NEW(StringData)(buf, len, AttachString);
   m_px->setRefCount(1);
@@ -643,7 +643,7 @@ void String::unserialize(VariableUnserializer *uns,
     throw Exception("Expected '%c' but got '%c'", delimiter0, ch);
   }
 
-  char *buf = (char*)malloc(size + 1);
+  char *buf = (char*)smart_malloc(size + 1);
   uns->read(buf, size);
   buf[size] = '\0';
   if (m_px && m_px->decRefCount() == 0) {
@@ -805,6 +805,7 @@ static StaticStringUninitializer s_static_string_uninitializer;
 AtomicString::AtomicString(const char *s,
                            StringDataMode mode /* = AttachLiteral */) {
   TAINT_OBSERVER(TAINT_BIT_NONE, TAINT_BIT_NONE);
+  MemoryManager::MaskArena mask;
   m_px = s ? (new StringData(s, mode)) : NULL;
   if (m_px) {
     m_px->setAtomic();
@@ -815,6 +816,7 @@ AtomicString::AtomicString(const char *s,
 
 AtomicString::AtomicString(const std::string &s) {
   TAINT_OBSERVER(TAINT_BIT_NONE, TAINT_BIT_NONE);
+  MemoryManager::MaskArena mask;
   m_px = new StringData(s.c_str(), s.size(), CopyString);
   if (m_px) {
     m_px->setAtomic();
@@ -827,6 +829,7 @@ AtomicString::AtomicString(StringData *str) {
   if (str) {
     TAINT_OBSERVER(TAINT_BIT_NONE, TAINT_BIT_NONE);
     if (str->isRefCounted()) {
+      MemoryManager::MaskArena mask;
       str = new StringData(str->data(), str->size(), CopyString);
     }
     AtomicSmartPtr<StringData>::operator=(str);
@@ -843,6 +846,7 @@ AtomicString &AtomicString::operator=(const AtomicString &s) {
 
 AtomicString &AtomicString::operator=(const std::string &s) {
   TAINT_OBSERVER(TAINT_BIT_NONE, TAINT_BIT_NONE);
+  MemoryManager::MaskArena mask;
   AtomicSmartPtr<StringData>::operator=(new StringData(s.c_str(), s.size(),
                                                        CopyString));
   return *this;
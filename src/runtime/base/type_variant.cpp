@@ -3611,9 +3611,7 @@ void Variant::serialize(VariableSerializer *serializer,
                         bool skipNestCheck /* = false */) const {
   if (m_type == KindOfVariant) {
     // Ugly, but behavior is different for serialize
-    if (serializer->getType() == VariableSerializer::Serialize ||
-        serializer->getType() == VariableSerializer::APCSerialize ||
-        serializer->getType() == VariableSerializer::DebuggerSerialize) {
+    if (serializer->isSerialize()) {
       if (serializer->incNestedLevel(m_data.pvar)) {
         serializer->writeOverflow(m_data.pvar);
       } else {
@@ -3658,6 +3656,61 @@ void Variant::serialize(VariableSerializer *serializer,
   }
 }
 
+static Object unserialize_object(CStrRef clsName) {
+  Object obj;
+  try {
+    obj = create_object_only(clsName);
+  } catch (ClassNotFoundException &e) {
+    obj = create_object_only(s_PHP_Incomplete_Class);
+    obj->o_set(s_PHP_Incomplete_Class_Name, clsName);
+  }
+  return obj;
+}
+
+/**
+ * The property to unserialize a value into, given its possibly mangled name.
+ */
+static Variant &unserialize_prop(CObjRef obj, CStrRef clsName, CStrRef key,
+                                 Variant &tmp) {
+  int subLen = 0;
+  if (key.size() > 0 && key.charAt(0) == '\00') {
+    if (key.charAt(1) == '*') {
+      subLen = 3; // protected
+    } else {
+      subLen = key.find('\00', 1) + 1; // private, skipping class name
+      if (subLen == String::npos) {
+        throw Exception("Mangled private object property");
+      }
+    }
+  }
+  return subLen != 0 ?
+    (key.charAt(1) == '*' ?
+     obj->o_lval(key.substr(subLen), tmp, clsName) :
+     obj->o_lval(key.substr(subLen), tmp,
+                 String(key.data() + 1, subLen - 2, AttachLiteral)))
+    : obj->o_lval(key, tmp);
+}
+
+static Object unserialize_serializable(VariableUnserializer *uns,
+                                       CStrRef clsName, CStrRef serialized) {
+  Object obj;
+  try {
+    obj = create_object_only(clsName);
+    if (!obj->o_instanceof("Serializable")) {
+      raise_error("%s didn't implement Serializable", clsName.data());
+    }
+    obj->o_invoke(s_unserialize, CREATE_VECTOR1(serialized), -1);
+  } catch (ClassNotFoundException &e) {
+    if (!uns->allowUnknownSerializableClass()) {
+      throw;
+    }
+    obj = create_object_only(s_PHP_Incomplete_Class);
+    obj->o_set(s_PHP_Incomplete_Class_Name, clsName);
+    obj->o_set("serialized", serialized);
+  }
+  return obj;
+}
+
 void Variant::unserialize(VariableUnserializer *uns) {
   char type, sep;
   type = uns->readChar();
@@ -3803,13 +3856,7 @@ void Variant::unserialize(VariableUnserializer *uns) {
         throw Exception("Expected ':' but got '%c'", sep);
       }
 
-      Object obj;
-      try {
-        obj = create_object_only(clsName);
-      } catch (ClassNotFoundException &e) {
-        obj = create_object_only(s_PHP_Incomplete_Class);
-        obj->o_set(s_PHP_Incomplete_Class_Name, clsName);
-      }
+      Object obj = unserialize_object(clsName);
       operator=(obj);
       int64 size = uns->readInt();
       char sep = uns->readChar();
@@ -3823,24 +3870,8 @@ void Variant::unserialize(VariableUnserializer *uns) {
       if (size > 0) {
         for (int64 i = 0; i < size; i++) {
           String key = uns->unserializeKey().toString();
-          int subLen = 0;
-          if (key.size() > 0 && key.charAt(0) == '\00') {
-            if (key.charAt(1) == '*') {
-              subLen = 3; // protected
-            } else {
-              subLen = key.find('\00', 1) + 1; // private, skipping class name
-              if (subLen == String::npos) {
-                throw Exception("Mangled private object property");
-              }
-            }
-          }
           Variant tmp;
-          Variant &value = subLen != 0 ?
-            (key.charAt(1) == '*' ?
-             obj->o_lval(key.substr(subLen), tmp, clsName) :
-             obj->o_lval(key.substr(subLen), tmp,
-                         String(key.data() + 1, subLen - 2, AttachLiteral)))
-            : obj->o_lval(key, tmp);
+          Variant &value = unserialize_prop(obj, clsName, key, tmp);
           value.unserialize(uns);
         }
       }
@@ -3865,22 +3896,7 @@ void Variant::unserialize(VariableUnserializer *uns) {
       String serialized;
       serialized.unserialize(uns, '{', '}');
 
-      Object obj;
-      try {
-        obj = create_object_only(clsName);
-        if (!obj->o_instanceof("Serializable")) {
-          raise_error("%s didn't implement Serializable", clsName.data());
-        }
-        obj->o_invoke(s_unserialize, CREATE_VECTOR1(serialized), -1);
-      } catch (ClassNotFoundException &e) {
-        if (!uns->allowUnknownSerializableClass()) {
-          throw;
-        }
-        obj = create_object_only(s_PHP_Incomplete_Class);
-        obj->o_set(s_PHP_Incomplete_Class_Name, clsName);
-        obj->o_set("serialized", serialized);
-      }
-      operator=(obj);
+      operator=(unserialize_serializable(uns, clsName, serialized));
       return; // object has '}' terminating
     }
     break;
@@ -3893,6 +3909,161 @@ void Variant::unserialize(VariableUnserializer *uns) {
   }
 }
 
+namespace {
+/**
+ * Reader for VariableSerializer::BinarySerialize. Values register with the
+ * VariableUnserializer for back-references in the same order as in the
+ * text format.
+ */
+class BinaryUnserializer {
+public:
+  BinaryUnserializer(VariableUnserializer *uns) : m_uns(uns) {}
+
+  void read(Variant &self) {
+    char type = m_uns->readChar();
+    if (type != 'R') {
+      m_uns->add(&self);
+    }
+
+    switch (type) {
+    case 'N': self.setNull();        break;
+    case 'T': self = true;           break;
+    case 'F': self = false;          break;
+    case 'I': self = readInt();      break;
+    case 'D': self = readDouble();   break;
+    case 's': self = readString();   break;
+    case 'r':
+    case 'R':
+      {
+        int64 id = m_uns->readVarInt();
+        Variant *v = m_uns->get(id);
+        if (v == NULL) {
+          throw Exception("Id %ld out of range", id);
+        }
+        if (type == 'r') {
+          self = *v;
+        } else {
+          self.assignRef(*v);
+        }
+      }
+      break;
+    case 'A':
+      {
+        int64 size = readCount();
+        if (size == 0) {
+          self = Array::Create();
+          break;
+        }
+        // Pre-allocate so that references to elements stay valid.
+        Array arr(ArrayInit(size).create());
+        for (int64 i = 0; i < size; i++) {
+          Variant key = readArrayKey();
+          read(arr.lvalAt(key, AccessFlags::Key));
+        }
+        self = arr;
+      }
+      break;
+    case 'O':
+      {
+        String clsName = readKey();
+        Object obj = unserialize_object(clsName);
+        self = obj;
+        int64 size = readCount();
+        for (int64 i = 0; i < size; i++) {
+          String key = readKey();
+          Variant tmp;
+          read(unserialize_prop(obj, clsName, key, tmp));
+        }
+        obj->t___wakeup();
+      }
+      break;
+    case 'C':
+      {
+        String clsName = readKey();
+        String serialized = readString();
+        self = unserialize_serializable(m_uns, clsName, serialized);
+      }
+      break;
+    default:
+      throw Exception("Unknown type '%c'", type);
+    }
+  }
+
+private:
+  VariableUnserializer *m_uns;
+  std::vector<String> m_keys; // strings sent with 'k', by 'K' index
+
+  int64 readInt() {
+    uint64 n = m_uns->readVarInt();
+    return (int64)(n >> 1) ^ -(int64)(n & 1);
+  }
+
+  double readDouble() {
+    uint64 n;
+    memcpy(&n, m_uns->readBytes(sizeof(n)), sizeof(n));
+#if __BYTE_ORDER == __BIG_ENDIAN
+    n = __builtin_bswap64(n);
+#endif
+    double d;
+    memcpy(&d, &n, sizeof(d));
+    return d;
+  }
+
+  String readString() {
+    uint64 size = m_uns->readVarInt();
+    if (size >= (uint64)RuntimeOption::MaxSerializedStringSize) {
+      throw Exception("Size of serialized string (%d) exceeds max",
+                      int(size));
+    }
+    return String(m_uns->readBytes(size), size, CopyString);
+  }
+
+  // every element takes at least 2 bytes
+  int64 readCount() {
+    uint64 size = m_uns->readVarInt();
+    if (size > (uint64)m_uns->remaining()) {
+      throw Exception("Unexpected end of buffer during unserialization");
+    }
+    return size;
+  }
+
+  String readKey() {
+    char type = m_uns->readChar();
+    if (type == 'k') {
+      m_keys.push_back(readString());
+      return m_keys.back();
+    }
+    if (type != 'K') {
+      throw Exception("Expected a key but got '%c'", type);
+    }
+    uint64 id = m_uns->readVarInt();
+    if (id >= m_keys.size()) {
+      throw Exception("Key id %ld out of range", (int64)id);
+    }
+    return m_keys[id];
+  }
+
+  Variant readArrayKey() {
+    if (m_uns->peek() == 'I') {
+      m_uns->readChar();
+      return readInt();
+    }
+    return readKey();
+  }
+};
+}
+
+Variant unserialize_binary(VariableUnserializer *uns) {
+  const char *header = uns->readBytes(2);
+  if (header[0] != BINARY_SERIALIZE_MAGIC ||
+      header[1] != BINARY_SERIALIZE_VERSION) {
+    throw Exception("Unsupported binary serialization format");
+  }
+  Variant v;
+  BinaryUnserializer(uns).read(v);
+  return v;
+}
+
 Variant Variant::share(bool save) const {
   if (m_type == KindOfVariant) {
     return m_data.pvar->share(save);
@@ -24,6 +24,7 @@
 #define IMPLEMENT_LOGLEVEL(LOGLEVEL, err)                              \
   void ExtendedLogger::LOGLEVEL(const char *fmt, ...) {                \
     if (LogLevel < Log ## LOGLEVEL) return;                            \
+    SyncScope sync(Log ## LOGLEVEL == LogError);                       \
     if (RuntimeOption::InjectedStackTrace &&                           \
         !ExtendedLogger::EnabledByDefault) {                           \
       Array bt = FrameInjection::GetBacktrace();                       \
@@ -41,6 +42,7 @@
   }                                                                    \
   void ExtendedLogger::LOGLEVEL(const std::string &msg) {              \
     if (LogLevel < Log ## LOGLEVEL) return;                            \
+    SyncScope sync(Log ## LOGLEVEL == LogError);                       \
     if (RuntimeOption::InjectedStackTrace &&                           \
         !ExtendedLogger::EnabledByDefault) {                           \
       Array bt = FrameInjection::GetBacktrace();                       \
@@ -54,6 +56,7 @@
   }                                                                    \
   void ExtendedLogger::Raw ## LOGLEVEL(const std::string &msg) {       \
     if (LogLevel < Log ## LOGLEVEL) return;                            \
+    SyncScope sync(Log ## LOGLEVEL == LogError);                       \
     Logger::Log(err, msg, NULL, false);                                \
     if (RuntimeOption::InjectedStackTrace &&                           \
         !ExtendedLogger::EnabledByDefault) {                           \
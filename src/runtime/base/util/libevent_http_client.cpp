@@ -59,6 +59,10 @@ static std::string get_hash(const std::string &address, int port) {
   return hash;
 }
 
+static int s_statsSkip = ServerStats::Intern("evhttp.skip");
+static int s_statsHit = ServerStats::Intern("evhttp.hit");
+static int s_statsMiss = ServerStats::Intern("evhttp.miss");
+
 ReadWriteMutex LibEventHttpClient::ConnectionPoolMutex;
 std::map<std::string, int> LibEventHttpClient::ConnectionPoolConfig;
 std::map<std::string, LibEventHttpClientPtrVec>
@@ -86,7 +90,7 @@ LibEventHttpClientPtr LibEventHttpClient::Get(const std::string &address,
     map<string, int>::const_iterator iter = ConnectionPoolConfig.find(hash);
     if (iter == ConnectionPoolConfig.end()) {
       // not configured to cache
-      ServerStats::Log("evhttp.skip", 1);
+      ServerStats::Log(s_statsSkip, 1);
       ServerStats::Log("evhttp.skip." + hash, 1);
       return LibEventHttpClientPtr(new LibEventHttpClient(address, port));
     }
@@ -99,7 +103,7 @@ LibEventHttpClientPtr LibEventHttpClient::Get(const std::string &address,
     LibEventHttpClientPtr client = pool[i];
     if (!client->m_busy) {
       client->m_busy = true;
-      ServerStats::Log("evhttp.hit", 1);
+      ServerStats::Log(s_statsHit, 1);
       ServerStats::Log("evhttp.hit." + hash, 1);
       return client;
     }
@@ -112,7 +116,7 @@ LibEventHttpClientPtr LibEventHttpClient::Get(const std::string &address,
     }
     pool.push_back(ret);
   }
-  ServerStats::Log("evhttp.miss", 1);
+  ServerStats::Log(s_statsMiss, 1);
   ServerStats::Log("evhttp.miss." + hash, 1);
   return ret;
 }
@@ -20,6 +20,7 @@
 
 #include <runtime/base/util/string_buffer.h>
 #include <util/alloc.h>
+#include <util/byte_set.h>
 #include <runtime/base/file/file.h>
 #include <runtime/base/zend/zend_functions.h>
 #include <runtime/base/zend/utf8_decode.h>
@@ -259,11 +260,22 @@ void StringBuffer::appendJsonEscape(const char *s, int len, int options) {
   } else {
     static const char digits[] = "0123456789abcdef";
 
+    // plain ASCII that is never escaped is copied in runs
+    static const ByteSet special("\"\\/<>&'", 7, true, true);
+
     int start = size();
     append('"');
 
     UTF8To16Decoder decoder(s, len, options & k_JSON_FB_LOOSE);
     for (;;) {
+      if (decoder.between()) {
+        const char *p = decoder.pos();
+        int n = special.find(p, decoder.end()) - p;
+        if (n > 0) {
+          append(p, n);
+          decoder.skip(n);
+        }
+      }
       int c = decoder.decode();
       if (c == UTF8_END) {
         append('"');
@@ -15,6 +15,7 @@
 */
 
 #include <runtime/base/variable_serializer.h>
+#include <runtime/base/variable_unserializer.h>
 #include <runtime/base/execution_context.h>
 #include <runtime/base/complex_types.h>
 #include <util/exception.h>
@@ -39,7 +40,7 @@ VariableSerializer::VariableSerializer(Type type, int option /* = 0 */,
     m_valueCount(0), m_referenced(false), m_refCount(1), m_maxCount(maxRecur),
     m_levelDebugger(0) {
   m_maxLevelDebugger = g_context->getDebuggerPrintLevel();
-  if (type == Serialize || type == APCSerialize || type == DebuggerSerialize) {
+  if (isSerialize()) {
     m_arrayIds = new PointerCounterMap();
   } else {
     m_arrayIds = NULL;
@@ -68,6 +69,10 @@ String VariableSerializer::serialize(CVarRef v, bool ret) {
     buf.setOutputLimit(RuntimeOption::SerializationSizeLimit);
   }
   m_valueCount = 1;
+  if (m_type == BinarySerialize) {
+    m_buf->append(BINARY_SERIALIZE_MAGIC);
+    m_buf->append((char)BINARY_SERIALIZE_VERSION);
+  }
   write(v);
   if (ret) {
     return m_buf->detach();
@@ -79,8 +84,7 @@ String VariableSerializer::serialize(CVarRef v, bool ret) {
 }
 
 String VariableSerializer::serializeWithLimit(CVarRef v, int limit) {
-  if (m_type == Serialize || m_type == JSON || m_type == APCSerialize ||
-      m_type == DebuggerSerialize) {
+  if (isSerialize() || m_type == JSON) {
     ASSERT(false);
     return null_string;
   }
@@ -124,6 +128,9 @@ void VariableSerializer::write(bool v) {
   case DebuggerSerialize:
     m_buf->append(v ? "b:1;" : "b:0;");
     break;
+  case BinarySerialize:
+    m_buf->append(v ? 'T' : 'F');
+    break;
   default:
     ASSERT(false);
     break;
@@ -159,6 +166,11 @@ void VariableSerializer::write(int64 v) {
     m_buf->append(v);
     m_buf->append(';');
     break;
+  case BinarySerialize:
+    // zigzag, so that small negative numbers are short too
+    m_buf->append('I');
+    writeVarInt(((uint64)v << 1) ^ (uint64)(v >> 63));
+    break;
   default:
     ASSERT(false);
     break;
@@ -222,6 +234,17 @@ void VariableSerializer::write(double v) {
     }
     m_buf->append(';');
     break;
+  case BinarySerialize:
+    {
+      uint64 n;
+      memcpy(&n, &v, sizeof(n));
+#if __BYTE_ORDER == __BIG_ENDIAN
+      n = __builtin_bswap64(n);
+#endif
+      m_buf->append('D');
+      m_buf->append((const char *)&n, sizeof(n));
+    }
+    break;
   default:
     ASSERT(false);
     break;
@@ -279,6 +302,16 @@ void VariableSerializer::write(const char *v, int len /* = -1 */,
     m_buf->append(v, len);
     m_buf->append("\";");
     break;
+  case BinarySerialize:
+    if (len < 0) len = strlen(v);
+    if (isArrayKey) {
+      writeBinaryKey(String(v, len, AttachLiteral));
+    } else {
+      m_buf->append('s');
+      writeVarInt(len);
+      m_buf->append(v, len);
+    }
+    break;
   case JSON:
     {
       if (len < 0) len = strlen(v);
@@ -383,6 +416,9 @@ void VariableSerializer::writeNull() {
   case DebuggerSerialize:
     m_buf->append("N;");
     break;
+  case BinarySerialize:
+    m_buf->append('N');
+    break;
   case JSON:
   case DebuggerDump:
     m_buf->append("null");
@@ -441,6 +477,19 @@ void VariableSerializer::writeOverflow(void* ptr, bool isObject /* = false */) {
       }
     }
     break;
+  case BinarySerialize:
+    {
+      ASSERT(m_arrayIds);
+      PointerCounterMap::const_iterator iter = m_arrayIds->find(ptr);
+      ASSERT(iter != m_arrayIds->end());
+      if (isObject || wasRef) {
+        m_buf->append(isObject ? 'r' : 'R');
+        writeVarInt(iter->second);
+      } else {
+        m_buf->append('N');
+      }
+    }
+    break;
   case JSON:
     raise_warning("json_encode(): recursion detected");
     m_buf->append("null");
@@ -562,6 +611,15 @@ void VariableSerializer::writeArrayHeader(const ArrayData *arr, int size) {
       m_buf->append(":{");
     }
     break;
+  case BinarySerialize:
+    if (!m_objClass.empty()) {
+      m_buf->append('O');
+      writeBinaryKey(m_objClass);
+    } else {
+      m_buf->append('A');
+    }
+    writeVarInt(size);
+    break;
   case JSON:
   case DebuggerDump:
     info.is_vector = m_objClass.empty() && arr->isVectorData();
@@ -613,7 +671,8 @@ void VariableSerializer::writePropertyPrivacy(CStrRef prop,
 
 void VariableSerializer::writeSerializedProperty(CStrRef prop,
                                                  const ClassInfo *cls) {
-  ASSERT(m_type == Serialize || m_type == DebuggerSerialize);
+  ASSERT(m_type == Serialize || m_type == DebuggerSerialize ||
+         m_type == BinarySerialize);
   const ClassInfo *origCls = cls;
   if (cls) {
     ClassInfo::PropertyInfo *p = cls->getPropertyInfo(prop);
@@ -625,7 +684,17 @@ void VariableSerializer::writeSerializedProperty(CStrRef prop,
     if (p) {
       const ClassInfo *dcls = p->owner;
       ClassInfo::Attribute a = p->attribute;
-      if (a & ClassInfo::IsProtected) {
+      if (m_type == BinarySerialize) {
+        if (a & ClassInfo::IsProtected) {
+          writeBinaryKey(concat(String("\0*\0", 3, AttachLiteral), prop));
+          return;
+        } else if (a & ClassInfo::IsPrivate && cls == origCls) {
+          String clsname(dcls->getName(), AttachLiteral);
+          writeBinaryKey(concat4(String("\0", 1, AttachLiteral), clsname,
+                                 String("\0", 1, AttachLiteral), prop));
+          return;
+        }
+      } else if (a & ClassInfo::IsProtected) {
         m_buf->append("s:");
         m_buf->append(prop.size() + 3);
         m_buf->append(":\"");
@@ -648,7 +717,7 @@ void VariableSerializer::writeSerializedProperty(CStrRef prop,
       }
     }
   }
-  write(prop);
+  write(prop.data(), prop.size(), true);
 }
 
 void VariableSerializer::writeArrayKey(const ArrayData *arr, Variant key) {
@@ -662,8 +731,8 @@ void VariableSerializer::writeArrayKey(const ArrayData *arr, Variant key) {
     String ks(key.toString());
     if (ks.size() > 0 && ks.charAt(0) == '\0') {
       // fast path for serializing private properties
-      if (m_type == Serialize) {
-        write(ks);
+      if (m_type == Serialize || m_type == BinarySerialize) {
+        write(ks.data(), ks.size(), true);
         return;
       }
       int span = ks.find('\0', 1);
@@ -711,10 +780,11 @@ void VariableSerializer::writeArrayKey(const ArrayData *arr, Variant key) {
   case Serialize:
   case APCSerialize:
   case DebuggerSerialize:
+  case BinarySerialize:
     if (info.is_object) {
       writeSerializedProperty(key.toString(), cls);
     } else {
-      write(key);
+      write(key, true);
     }
     break;
   case JSON:
@@ -735,8 +805,7 @@ void VariableSerializer::writeArrayKey(const ArrayData *arr, Variant key) {
 
 void VariableSerializer::writeArrayValue(const ArrayData *arr, CVarRef value) {
   // Do not count referenced values after the first
-  if ((m_type == Serialize || m_type == APCSerialize ||
-       m_type == DebuggerSerialize) &&
+  if (isSerialize() &&
       !(value.isReferenced() &&
         m_arrayIds->find(value.getVariantData()) != m_arrayIds->end())) {
     m_valueCount++;
@@ -792,6 +861,8 @@ void VariableSerializer::writeArrayFooter(const ArrayData *arr) {
   case DebuggerSerialize:
     m_buf->append('}');
     break;
+  case BinarySerialize:
+    break;
   case JSON:
   case DebuggerDump:
     if (info.is_vector) {
@@ -810,6 +881,13 @@ void VariableSerializer::writeArrayFooter(const ArrayData *arr) {
 
 void VariableSerializer::writeSerializableObject(CStrRef clsname,
                                                  CStrRef serialized) {
+  if (m_type == BinarySerialize) {
+    m_buf->append('C');
+    writeBinaryKey(clsname);
+    writeVarInt(serialized.size());
+    m_buf->append(serialized.data(), serialized.size());
+    return;
+  }
   m_buf->append("C:");
   m_buf->append(clsname.size());
   m_buf->append(":\"");
@@ -821,6 +899,37 @@ void VariableSerializer::writeSerializableObject(CStrRef clsname,
   m_buf->append('}');
 }
 
+void VariableSerializer::writeVarInt(uint64 v) {
+  char buf[10];
+  int len = 0;
+  while (v >= 0x80) {
+    buf[len++] = (char)(v | 0x80);
+    v >>= 7;
+  }
+  buf[len++] = (char)v;
+  m_buf->append(buf, len);
+}
+
+/**
+ * First occurrence: 'k' and the string, which gets the next id. After that:
+ * 'K' and the id.
+ */
+void VariableSerializer::writeBinaryKey(CStrRef key) {
+  StringIdMap::const_iterator iter = m_stringIds.find(key.get());
+  if (iter != m_stringIds.end()) {
+    m_buf->append('K');
+    writeVarInt(iter->second);
+    return;
+  }
+  // own a copy: key may be a temporary or point into a literal
+  String copy(key.data(), key.size(), CopyString);
+  m_stringIds[copy.get()] = m_strings.size();
+  m_strings.push_back(copy);
+  m_buf->append('k');
+  writeVarInt(key.size());
+  m_buf->append(key.data(), key.size());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void VariableSerializer::indent() {
@@ -850,6 +959,7 @@ bool VariableSerializer::incNestedLevel(void *ptr,
     // fall through
   case Serialize:
   case APCSerialize:
+  case BinarySerialize:
     {
       ASSERT(m_arrayIds);
       int ct = ++m_counts[ptr];
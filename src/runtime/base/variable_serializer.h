@@ -45,6 +45,7 @@ public:
     JSON,
     APCSerialize,
     DebuggerSerialize,
+    BinarySerialize,
   };
 
   /**
@@ -102,6 +103,10 @@ public:
   void setResourceInfo(CStrRef rsrcName, int rsrcId);
   void getResourceInfo(String &rsrcName, int &rsrcId);
   Type getType() const { return m_type; }
+  bool isSerialize() const {
+    return m_type == Serialize || m_type == APCSerialize ||
+      m_type == DebuggerSerialize || m_type == BinarySerialize;
+  }
 private:
   Type m_type;
   int m_option;                  // type specific extra options
@@ -129,6 +134,16 @@ private:
   };
   std::vector<ArrayInfo> m_arrayInfos;
 
+  // BinarySerialize: ids of array keys, property and class names written so
+  // far, so repeats only take an id
+  typedef hphp_hash_map<StringData *, int, string_data_hash,
+                        string_data_same> StringIdMap;
+  StringIdMap m_stringIds;
+  std::vector<String> m_strings;
+
+  void writeVarInt(uint64 v);
+  void writeBinaryKey(CStrRef key);
+
   void writePropertyPrivacy(CStrRef prop, const ClassInfo *cls);
   void writeSerializedProperty(CStrRef prop, const ClassInfo *cls);
 };
@@ -25,6 +25,9 @@ namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
 Variant VariableUnserializer::unserialize() {
+  if (m_type == BinarySerialize) {
+    return unserialize_binary(this);
+  }
   Variant v;
   v.unserialize(this);
   return v;
@@ -67,5 +70,25 @@ void VariableUnserializer::read(char *buf, uint n) {
   m_buf += BUFFER_LIMIT;
 }
 
+uint64 VariableUnserializer::readVarInt() {
+  uint64 r = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    check();
+    unsigned char c = *(m_buf++);
+    r |= (uint64)(c & 0x7f) << shift;
+    if (!(c & 0x80)) return r;
+  }
+  throw Exception("Malformed varint during unserialization");
+}
+
+const char *VariableUnserializer::readBytes(int64 n) {
+  if (n < 0 || n > m_end - m_buf) {
+    throw Exception("Unexpected end of buffer during unserialization");
+  }
+  const char *p = m_buf;
+  m_buf += n;
+  return p;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 }
@@ -22,6 +22,13 @@
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * VariableSerializer::BinarySerialize output starts with a byte that can't
+ * start the text format, followed by the format version.
+ */
+#define BINARY_SERIALIZE_MAGIC   '\xfb'
+#define BINARY_SERIALIZE_VERSION 1
+
 class VariableUnserializer {
 public:
   /**
@@ -30,8 +37,13 @@ public:
   enum Type {
     Serialize,
     APCSerialize,
+    BinarySerialize,
   };
 
+  static bool IsBinary(const char *str, size_t len) {
+    return len >= 2 && str[0] == BINARY_SERIALIZE_MAGIC;
+  }
+
 public:
   VariableUnserializer(const char *str, size_t len, Type type,
                        bool allowUnknownSerializableClass = false)
@@ -63,11 +75,17 @@ public:
     return *(m_buf++);
   }
   void read(char *buf, uint n);
+  /**
+   * For BinarySerialize: a varint, and n raw bytes in place.
+   */
+  uint64 readVarInt();
+  const char *readBytes(int64 n);
   char peek() {
     check();
     return *m_buf;
   }
   const char *head() { return m_buf; }
+  int64 remaining() const { return m_end - m_buf; }
 
  private:
   Type m_type;
@@ -84,6 +102,11 @@ public:
   }
 };
 
+/**
+ * Reads VariableSerializer::BinarySerialize output, header included.
+ */
+Variant unserialize_binary(VariableUnserializer *uns);
+
 ///////////////////////////////////////////////////////////////////////////////
 }
 
@@ -38,6 +38,20 @@ public:
   UTF8To16Decoder(const char *utf8, int length, bool loose);
   int decode();
 
+  /**
+   * Bytes not decoded yet, so callers can copy plain ASCII runs themselves
+   * and skip() over them. Only valid when between() returns true, i.e. no
+   * half of a surrogate pair is pending.
+   */
+  bool between() const { return m_low_surrogate == 0;}
+  const char *pos() const {
+    return m_decode.the_input + m_decode.the_index;
+  }
+  const char *end() const {
+    return m_decode.the_input + m_decode.the_length;
+  }
+  void skip(int n) { m_decode.the_index += n;}
+
 private:
   json_utf8_decode m_decode;
   int m_loose; // Faceook: json_utf8_loose
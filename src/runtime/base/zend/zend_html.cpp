@@ -18,6 +18,7 @@
 #include <runtime/base/zend/zend_html.h>
 #include <runtime/base/complex_types.h>
 #include <util/lock.h>
+#include <util/byte_set.h>
 
 namespace HPHP {
 
@@ -521,8 +522,20 @@ char *string_html_encode(const char *input, int &len, bool encode_double_quote,
   if (!ret) {
     return NULL;
   }
+  // bytes to stop at; the input ends at its first NUL
+  static const ByteSet special("\0\"'<>&", 6);
+  static const ByteSet specialNbsp("\0\"'<>&\xc2\xa0", 8);
+  const ByteSet &stops = nbsp ? specialNbsp : special;
+
   char *q = ret;
-  for (const char *p = input; *p; p++) {
+  const char *end = input + len;
+  for (const char *p = input; ; p++) {
+    const char *run = stops.find(p, end);
+    memcpy(q, p, run - p);
+    q += run - p;
+    p = run;
+    if (p == end || !*p) break;
+
     char c = *p;
     switch (c) {
     case '"':
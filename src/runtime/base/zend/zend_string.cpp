@@ -20,6 +20,7 @@
 #include <runtime/base/zend/zend_math.h>
 
 #include <util/lock.h>
+#include <util/byte_set.h>
 #include <math.h>
 #include <monetary.h>
 
@@ -1412,27 +1413,22 @@ char *string_addslashes(const char *str, int &length) {
     return NULL;
   }
 
+  static const ByteSet special("\0'\"\\", 4);
+
   char *new_str = (char *)malloc((length << 1) + 1);
   const char *source = str;
   const char *end = source + length;
   char *target = new_str;
 
   while (source < end) {
-    switch (*source) {
-    case '\0':
-      *target++ = '\\';
-      *target++ = '0';
-      break;
-    case '\'':
-    case '\"':
-    case '\\':
-      *target++ = '\\';
-      /* break is missing *intentionally* */
-    default:
-      *target++ = *source;
-      break;
-    }
-
+    const char *run = special.find(source, end);
+    memcpy(target, source, run - source);
+    target += run - source;
+    source = run;
+    if (source == end) break;
+
+    *target++ = '\\';
+    *target++ = *source ? *source : '0';
     source++;
   }
 
@@ -25,6 +25,7 @@
 #include <runtime/base/runtime_option.h>
 #include <runtime/eval/ext/ext.h>
 #include <util/util.h>
+#include <util/stat_cache.h>
 #include <runtime/base/source_info.h>
 #include <runtime/eval/parser/parser.h>
 #include <runtime/eval/runtime/eval_object_data.h>
@@ -371,7 +372,7 @@ bool RequestEvalState::includeFile(Variant &res, CStrRef path, bool once,
     char rpath[PATH_MAX];
     bool alreadyResolved = !RuntimeOption::CheckSymLink && (spath[0] == '/');
     string checkoutPath(spath);
-    if (alreadyResolved || realpath(spath.c_str(), rpath)) {
+    if (alreadyResolved || StatCache::Realpath(spath.c_str(), rpath)) {
       it = self->m_evaledFiles.find(alreadyResolved ? spath.c_str() : rpath);
       if (it != self->m_evaledFiles.end()) {
         self->m_evaledFiles[spath] = efile = it->second;
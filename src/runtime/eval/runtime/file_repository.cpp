@@ -22,7 +22,11 @@
 #include <runtime/eval/parser/parser.h>
 #include <runtime/eval/ast/static_statement.h>
 #include <runtime/base/runtime_option.h>
+#include <runtime/base/program_functions.h>
 #include <util/process.h>
+#include <util/job_queue.h>
+#include <util/logger.h>
+#include <util/stat_cache.h>
 #include <runtime/eval/runtime/eval_state.h>
 #include <runtime/base/server/source_root_info.h>
 #include <runtime/eval/ast/scalar_value_expression.h>
@@ -306,8 +310,72 @@ PhpFile *FileRepository::parseFile(const std::string &name,
   return NULL;
 }
 
+bool FileRepository::SaveFileList(const string &listFile) {
+  string tmp = listFile + ".tmp";
+  {
+    std::ofstream out(tmp.c_str());
+    if (out.fail()) {
+      Logger::Error("Unable to write %s", tmp.c_str());
+      return false;
+    }
+    ReadLock lock(s_lock);
+    for (hphp_hash_map<string, PhpFileWrapper*, string_hash>::const_iterator
+           it = s_files.begin(); it != s_files.end(); it++) {
+      out << it->first << endl;
+    }
+    if (out.fail()) return false;
+  }
+  return rename(tmp.c_str(), listFile.c_str()) == 0;
+}
+
+class PreparseWorker : public JobQueueWorker<string> {
+public:
+  virtual void onThreadEnter() {
+    hphp_session_init();
+  }
+  virtual void doJob(string name) {
+    struct stat s;
+    if (!FileRepository::findFile(name, &s)) return;
+    try {
+      PhpFile *f = FileRepository::checkoutFile(name, s);
+      if (f && f->decRef() == 0) {
+        FileRepository::onZeroRef(f);
+      }
+    } catch (Exception &e) {
+      Logger::Warning("Unable to preparse %s: %s", name.c_str(),
+                      e.getMessage().c_str());
+    }
+  }
+  virtual void onThreadExit() {
+    hphp_session_exit();
+  }
+};
+
+void FileRepository::Preparse(const string &listFile, int threadCount) {
+  std::ifstream in(listFile.c_str());
+  if (in.fail()) return;
+  vector<string> names;
+  string name;
+  while (getline(in, name)) {
+    if (!name.empty()) names.push_back(name);
+  }
+  if (names.empty()) return;
+
+  if (threadCount <= 0) threadCount = Process::GetCPUCount();
+  if (threadCount > (int)names.size()) threadCount = names.size();
+  Logger::Info("preparsing %d files with %d threads...",
+               (int)names.size(), threadCount);
+
+  JobQueueDispatcher<string, PreparseWorker>
+    dispatcher(threadCount, true, 0, false, NULL);
+  for (unsigned int i = 0; i < names.size(); i++) {
+    dispatcher.enqueue(names[i]);
+  }
+  dispatcher.run();
+}
+
 bool FileRepository::fileStat(const string &name, struct stat *s) {
-  return stat(name.c_str(), s) == 0;
+  return StatCache::Stat(name.c_str(), s) == 0;
 }
 
 const char* FileRepository::canonicalize(const string &name) {
@@ -108,6 +108,14 @@ public:
   static PhpFile *parseFile(const std::string &name, const FileInfo &fileInfo);
   static String translateFileName(const std::string &file);
   static void onZeroRef(PhpFile *f);
+
+  /**
+   * Parsing files as a server starts, instead of in the first requests that
+   * need them. SaveFileList() writes names of all files currently parsed;
+   * Preparse() checks out files named in such a list with a pool of threads.
+   */
+  static bool SaveFileList(const std::string &listFile);
+  static void Preparse(const std::string &listFile, int threadCount);
 private:
   static ReadWriteMutex s_lock;
   static hphp_hash_map<std::string, PhpFileWrapper*, string_hash> s_files;
@@ -400,7 +400,7 @@ static void json_create_zval(Variant &z, StringBuffer &buf, int type) {
   }
 }
 
-static void utf16_to_utf8(StringBuffer &buf, unsigned short utf16) {
+void utf16_to_utf8(StringBuffer &buf, unsigned short utf16) {
   if (utf16 < 0x80) {
     buf += (char)utf16;
   } else if (utf16 < 0x800) {
@@ -17,6 +17,13 @@
 /* JSON_checker.h */
 
 #include <runtime/base/complex_types.h>
+#include <runtime/base/util/string_buffer.h>
 
 bool JSON_parser(HPHP::Variant &z, const char *p, int length,
                  bool assoc/*<fb>*/, bool loose/*</fb>*/);
+
+/**
+ * Appends a UTF-16 code unit as UTF-8, combining it with a high surrogate
+ * at the end of buf into one 4-byte character.
+ */
+void utf16_to_utf8(HPHP::StringBuffer &buf, unsigned short utf16);
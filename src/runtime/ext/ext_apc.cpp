@@ -21,7 +21,11 @@
 #include <runtime/base/runtime_option.h>
 #include <util/async_job.h>
 #include <util/timer.h>
+#include <util/logger.h>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <runtime/base/program_functions.h>
 #include <runtime/base/builtin_functions.h>
 #include <runtime/base/variable_serializer.h>
@@ -217,6 +221,344 @@ Variant f_apc_cache_info(int64 cache_id /* = 0 */, bool limited /* = false */) {
   return CREATE_MAP1("start_time", start_time());
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// snapshots
+
+/**
+ * A snapshot is a header followed by its entries, with numbers in native byte
+ * order:
+ *
+ *   "HPHPAPC1" | uint32 cache id | uint32 entry count
+ *   uint32 key length | key | int64 expiry | uint32 value length | value
+ *
+ * Values are in SharedVariant::encode() form. Their lengths let a loader cut
+ * a snapshot into pieces for its threads without decoding anything.
+ */
+static const char s_snapshot_magic[] = "HPHPAPC1";
+static const size_t s_snapshot_magic_size = sizeof(s_snapshot_magic) - 1;
+static const size_t s_snapshot_flush_size = 1 << 20;
+
+template<class T>
+static void snapshot_put(string &out, T value) {
+  out.append((const char *)&value, sizeof(T));
+}
+
+template<class T>
+static bool snapshot_get(const char *&p, const char *end, T &value) {
+  if ((size_t)(end - p) < sizeof(T)) return false;
+  memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+  return true;
+}
+
+/**
+ * Encodes entries whose names are in filter, or all entries when filter is
+ * null. With f, bytes are written out every s_snapshot_flush_size, otherwise
+ * they are all left in out. Returns the number of bytes, or -1 on errors.
+ */
+static int64 snapshot_write(int cache_id, CVarRef filter, FILE *f,
+                            string &out, int &count) {
+  vector<SharedStore::Entry> entries;
+  if (!s_apc_store[cache_id].getEntries(entries)) return -1;
+
+  if (!filter.isNull()) {
+    hphp_string_set keys;
+    for (ArrayIter iter(filter.toArray()); iter; ++iter) {
+      String key = iter.second().toString();
+      keys.insert(string(key.data(), key.size()));
+    }
+    unsigned int kept = 0;
+    for (unsigned int i = 0; i < entries.size(); i++) {
+      if (keys.find(entries[i].key) != keys.end()) {
+        entries[kept++] = entries[i];
+      } else {
+        entries[i].value->decRef();
+      }
+    }
+    entries.resize(kept);
+  }
+
+  bool ok = true;
+  int64 bytes = 0;
+  out.append(s_snapshot_magic, s_snapshot_magic_size);
+  snapshot_put(out, (uint32)cache_id);
+  snapshot_put(out, (uint32)entries.size());
+  string value;
+  for (unsigned int i = 0; i < entries.size(); i++) {
+    SharedStore::Entry &entry = entries[i];
+    value.clear();
+    entry.value->encode(value);
+    entry.value->decRef();
+    snapshot_put(out, (uint32)entry.key.size());
+    out += entry.key;
+    snapshot_put(out, entry.expiry);
+    snapshot_put(out, (uint32)value.size());
+    out += value;
+    if (f && out.size() >= s_snapshot_flush_size) {
+      if (ok && fwrite(out.data(), 1, out.size(), f) != out.size()) {
+        ok = false;
+      }
+      bytes += out.size();
+      out.clear();
+    }
+  }
+  if (f && !out.empty()) {
+    if (ok && fwrite(out.data(), 1, out.size(), f) != out.size()) {
+      ok = false;
+    }
+    bytes += out.size();
+    out.clear();
+  }
+  count = entries.size();
+  return ok ? bytes + out.size() : -1;
+}
+
+/**
+ * Checks that entries fill up the snapshot exactly, and cuts them into about
+ * pieceCount pieces.
+ */
+static bool snapshot_split(const char *data, size_t size, int &cache_id,
+                           vector<pair<const char *, const char *> > &pieces,
+                           int pieceCount) {
+  const char *p = data;
+  const char *end = data + size;
+  if (size < s_snapshot_magic_size ||
+      memcmp(p, s_snapshot_magic, s_snapshot_magic_size)) {
+    return false;
+  }
+  p += s_snapshot_magic_size;
+
+  uint32 id, count;
+  if (!snapshot_get(p, end, id) || !snapshot_get(p, end, count) ||
+      id >= MAX_SHARED_STORE) {
+    return false;
+  }
+
+  size_t target = (end - p) / pieceCount + 1;
+  const char *start = p;
+  for (uint32 i = 0; i < count; i++) {
+    uint32 keyLen, valueLen;
+    int64 expiry;
+    if (!snapshot_get(p, end, keyLen) || (size_t)(end - p) < keyLen) {
+      return false;
+    }
+    p += keyLen;
+    if (!snapshot_get(p, end, expiry) || !snapshot_get(p, end, valueLen) ||
+        (size_t)(end - p) < valueLen) {
+      return false;
+    }
+    p += valueLen;
+    if ((size_t)(p - start) >= target) {
+      pieces.push_back(make_pair(start, p));
+      start = p;
+    }
+  }
+  if (p != end) return false;
+  if (p != start) pieces.push_back(make_pair(start, p));
+  cache_id = id;
+  return true;
+}
+
+/**
+ * Decodes and primes one piece from snapshot_split(), replacing keys already
+ * stored. Returns the number of entries primed, or -1 on a bad value.
+ */
+static int snapshot_prime(int cache_id, const char *p, const char *end) {
+  time_t now = time(NULL);
+  vector<string> keys;
+  vector<SharedStore::KeyValuePair> vars;
+  bool ok = true;
+  while (p < end) {
+    uint32 keyLen, valueLen;
+    int64 expiry;
+    snapshot_get(p, end, keyLen);
+    const char *key = p;
+    p += keyLen;
+    snapshot_get(p, end, expiry);
+    snapshot_get(p, end, valueLen);
+    const char *value = p;
+    p += valueLen;
+    if (expiry && expiry <= now) continue;
+
+    SharedVariant *sv = SharedVariant::Decode(value, p);
+    if (sv == NULL || value != p) {
+      if (sv) sv->decRef();
+      ok = false;
+      break;
+    }
+    SharedStore::KeyValuePair item;
+    item.len = keyLen;
+    item.value = sv;
+    item.size = 0;
+    item.ttl = expiry ? expiry - now : 0;
+    keys.push_back(string(key, keyLen));
+    vars.push_back(item);
+  }
+  if (!ok) {
+    for (unsigned int i = 0; i < vars.size(); i++) {
+      vars[i].value->decRef();
+    }
+    return -1;
+  }
+
+  SharedStore &store = s_apc_store[cache_id];
+  for (unsigned int i = 0; i < vars.size(); i++) {
+    vars[i].key = keys[i].c_str();
+    store.erase(String(keys[i].data(), keys[i].size(), AttachLiteral));
+  }
+  store.prime(vars);
+  return vars.size();
+}
+
+DECLARE_BOOST_TYPES(ApcSnapshotLoadJob);
+class ApcSnapshotLoadJob {
+public:
+  ApcSnapshotLoadJob(int cacheId, const char *begin, const char *end)
+    : m_cacheId(cacheId), m_begin(begin), m_end(end), m_count(0) {}
+  int m_cacheId;
+  const char *m_begin;
+  const char *m_end;
+  int m_count;
+};
+
+class ApcSnapshotLoadWorker {
+public:
+  void onThreadEnter() {}
+  void doJob(ApcSnapshotLoadJobPtr job) {
+    job->m_count = snapshot_prime(job->m_cacheId, job->m_begin, job->m_end);
+  }
+  void onThreadExit() {}
+};
+
+/**
+ * Loads a snapshot into cache_id, or into the store it was taken from when
+ * cache_id is negative. Returns the number of entries loaded, or -1 if data
+ * is not a valid snapshot.
+ */
+static int snapshot_load(const char *data, size_t size, int cache_id,
+                         int thread) {
+  if (thread < 1) thread = 1;
+  int id;
+  vector<pair<const char *, const char *> > pieces;
+  if (!snapshot_split(data, size, id, pieces, thread * 4)) return -1;
+  if (cache_id >= 0) id = cache_id;
+
+  int total = 0;
+  if (thread <= 1 || pieces.size() <= 1) {
+    for (unsigned int i = 0; i < pieces.size(); i++) {
+      int count = snapshot_prime(id, pieces[i].first, pieces[i].second);
+      if (count < 0) return -1;
+      total += count;
+    }
+    return total;
+  }
+
+  ApcSnapshotLoadJobPtrVec jobs;
+  jobs.reserve(pieces.size());
+  for (unsigned int i = 0; i < pieces.size(); i++) {
+    jobs.push_back(ApcSnapshotLoadJobPtr
+                   (new ApcSnapshotLoadJob(id, pieces[i].first,
+                                           pieces[i].second)));
+  }
+  JobDispatcher<ApcSnapshotLoadJob, ApcSnapshotLoadWorker>(jobs, thread).run();
+  for (unsigned int i = 0; i < jobs.size(); i++) {
+    if (jobs[i]->m_count < 0) return -1;
+    total += jobs[i]->m_count;
+  }
+  return total;
+}
+
+static int snapshot_load_file(const char *filename, int cache_id,
+                              int thread) {
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) return -1;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return -1;
+  }
+  void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) return -1;
+  madvise(data, st.st_size, MADV_WILLNEED);
+  int count = snapshot_load((const char *)data, st.st_size, cache_id, thread);
+  munmap(data, st.st_size);
+  return count;
+}
+
+int apc_dump_snapshot(const char *filename, int cache_id /* = 0 */) {
+  string tmp = string(filename) + ".tmp";
+  FILE *f = fopen(tmp.c_str(), "w");
+  if (f == NULL) return -1;
+  string out;
+  int count = 0;
+  bool ok = snapshot_write(cache_id, null_variant, f, out, count) >= 0;
+  if (fclose(f) != 0) ok = false;
+  if (!ok || rename(tmp.c_str(), filename) != 0) {
+    unlink(tmp.c_str());
+    return -1;
+  }
+  return count;
+}
+
+int apc_load_snapshot(const char *filename, int thread) {
+  return snapshot_load_file(filename, -1, thread);
+}
+
+Variant f_apc_bin_dump(int64 cache_id /* = 0 */,
+                       CVarRef filter /* = null_variant */) {
+  if (!RuntimeOption::EnableApc) return false;
+
+  if (cache_id < 0 || cache_id >= MAX_SHARED_STORE) {
+    throw_invalid_argument("cache_id: %d", cache_id);
+    return false;
+  }
+  string out;
+  int count;
+  if (snapshot_write(cache_id, filter, NULL, out, count) < 0) return null;
+  return String(out.data(), out.size(), CopyString);
+}
+
+bool f_apc_bin_load(CStrRef data, int64 flags /* = 0 */,
+                    int64 cache_id /* = 0 */) {
+  if (!RuntimeOption::EnableApc) return false;
+
+  if (cache_id < 0 || cache_id >= MAX_SHARED_STORE) {
+    throw_invalid_argument("cache_id: %d", cache_id);
+    return false;
+  }
+  return snapshot_load(data.data(), data.size(), cache_id, 1) >= 0;
+}
+
+Variant f_apc_bin_dumpfile(int64 cache_id, CVarRef filter,
+                           CStrRef filename, int64 flags /* = 0 */,
+                           CObjRef context /* = null */) {
+  if (!RuntimeOption::EnableApc) return false;
+
+  if (cache_id < 0 || cache_id >= MAX_SHARED_STORE) {
+    throw_invalid_argument("cache_id: %d", cache_id);
+    return false;
+  }
+  FILE *f = fopen(filename.data(), "w");
+  if (f == NULL) return false;
+  string out;
+  int count;
+  int64 bytes = snapshot_write(cache_id, filter, f, out, count);
+  if (fclose(f) != 0 || bytes < 0) return false;
+  return bytes;
+}
+
+bool f_apc_bin_loadfile(CStrRef filename, CObjRef context /* = null */,
+                        int64 flags /* = 0 */, int64 cache_id /* = 0 */) {
+  if (!RuntimeOption::EnableApc) return false;
+
+  if (cache_id < 0 || cache_id >= MAX_SHARED_STORE) {
+    throw_invalid_argument("cache_id: %d", cache_id);
+    return false;
+  }
+  return snapshot_load_file(filename.data(), cache_id, 1) >= 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // loading APC from archive files
 
@@ -263,7 +605,7 @@ public:
 
 static size_t s_const_map_size = 0;
 
-void apc_load(int thread) {
+static void apc_load_library(int thread) {
   static void *handle = NULL;
   if (handle ||
       RuntimeOption::ApcPrimeLibrary.empty() ||
@@ -329,6 +671,29 @@ void apc_load(int thread) {
   dlclose(handle);
 }
 
+void apc_load(int thread) {
+  apc_load_library(thread);
+
+  static bool snapshotLoaded = false;
+  if (snapshotLoaded ||
+      RuntimeOption::ApcSnapshotFile.empty() ||
+      !RuntimeOption::EnableApc) {
+    return;
+  }
+  snapshotLoaded = true;
+
+  const char *filename = RuntimeOption::ApcSnapshotFile.c_str();
+  if (access(filename, R_OK) != 0) return; // nothing dumped yet
+
+  Timer timer(Timer::WallTime, "loading APC snapshot");
+  int count = apc_load_snapshot(filename, thread);
+  if (count < 0) {
+    Logger::Error("Unable to load APC snapshot %s", filename);
+  } else {
+    Logger::Info("Loaded %d APC entries from %s", count, filename);
+  }
+}
+
 size_t get_const_map_size() {
   return s_const_map_size;
 }
@@ -1560,12 +1925,19 @@ int apc_rfc1867_progress(apc_rfc1867_data *rfc1867ApcData,
 // apc serialization
 
 String apc_serialize(CVarRef value) {
-  VariableSerializer vs(VariableSerializer::APCSerialize);
+  VariableSerializer vs(RuntimeOption::ApcSerializer ==
+                        RuntimeOption::ApcBinarySerializer ?
+                        VariableSerializer::BinarySerialize :
+                        VariableSerializer::APCSerialize);
   return vs.serialize(value, true);
 }
 
 Variant apc_unserialize(CStrRef str) {
-  return unserialize_ex(str, VariableUnserializer::APCSerialize);
+  // either format, so that items stored before Serializer changed still load
+  return unserialize_ex(str,
+                        VariableUnserializer::IsBinary(str.data(), str.size()) ?
+                        VariableUnserializer::BinarySerialize :
+                        VariableUnserializer::APCSerialize);
 }
 
 void reserialize(VariableUnserializer *uns, StringBuffer &buf) {
@@ -1709,7 +2081,9 @@ void reserialize(VariableUnserializer *uns, StringBuffer &buf) {
 }
 
 String apc_reserialize(CStrRef str) {
-  if (str.empty()) return str;
+  if (str.empty() || VariableUnserializer::IsBinary(str.data(), str.size())) {
+    return str;
+  }
 
   VariableUnserializer uns(str.data(), str.size(),
                            VariableUnserializer::APCSerialize);
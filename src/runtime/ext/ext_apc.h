@@ -60,21 +60,13 @@ inline Array f_apc_filehits() {
 inline Variant f_apc_delete_file(CVarRef keys, int64 cache_id = 0) {
   throw NotSupportedException(__func__, "feature not supported");
 }
-inline Variant f_apc_bin_dump(int64 cache_id = 0, CVarRef filter = null_variant) {
-  throw NotSupportedException(__func__, "feature not supported");
-}
-inline bool f_apc_bin_load(CStrRef data, int64 flags = 0, int64 cache_id = 0) {
-  throw NotSupportedException(__func__, "feature not supported");
-}
-inline Variant f_apc_bin_dumpfile(int64 cache_id, CVarRef filter,
-                                  CStrRef filename, int64 flags = 0,
-                                  CObjRef context = null) {
-  throw NotSupportedException(__func__, "feature not supported");
-}
-inline bool f_apc_bin_loadfile(CStrRef filename, CObjRef context = null,
-                               int64 flags = 0, int64 cache_id = 0) {
-  throw NotSupportedException(__func__, "feature not supported");
-}
+Variant f_apc_bin_dump(int64 cache_id = 0, CVarRef filter = null_variant);
+bool f_apc_bin_load(CStrRef data, int64 flags = 0, int64 cache_id = 0);
+Variant f_apc_bin_dumpfile(int64 cache_id, CVarRef filter,
+                           CStrRef filename, int64 flags = 0,
+                           CObjRef context = null);
+bool f_apc_bin_loadfile(CStrRef filename, CObjRef context = null,
+                        int64 flags = 0, int64 cache_id = 0);
 
 ///////////////////////////////////////////////////////////////////////////////
 // loading APC from archive files
@@ -124,6 +116,21 @@ void const_load_impl_compressed(struct cache_info *info,
                                 const char **strings, const char **objects,
                                 const char **thrifts, const char **others);
 
+///////////////////////////////////////////////////////////////////////////////
+// snapshots for warm restarts
+
+/**
+ * Writes unexpired entries of a store to filename, through a temporary file
+ * renamed over it. Returns the number of entries written, or -1 on errors.
+ */
+int apc_dump_snapshot(const char *filename, int cache_id = 0);
+
+/**
+ * Primes the store a snapshot was taken from, decoding it with up to thread
+ * threads. Returns the number of entries loaded, or -1 on errors.
+ */
+int apc_load_snapshot(const char *filename, int thread);
+
 ///////////////////////////////////////////////////////////////////////////////
 // apc serialization
 
@@ -1162,22 +1162,55 @@ bool f_krsort(VRefParam array, int sort_flags /* = 0 */) {
   return true;
 }
 
+static int usort_func(CVarRef v1, CVarRef v2, const void *data) {
+  MethodCallPackage *mcp = (MethodCallPackage *)data;
+  if (mcp->m_isFunc) {
+    if (CallInfo::FuncInvoker2Args invoker = mcp->ci->getFunc2Args()) {
+      return invoker(mcp->extra, 2, v1, v2).toInt32();
+    }
+    return (mcp->ci->getFunc())(mcp->extra, CREATE_VECTOR2(v1, v2)).toInt32();
+  } else {
+    if (CallInfo::MethInvoker2Args invoker = mcp->ci->getMeth2Args()) {
+      return invoker(*mcp, 2, v1, v2).toInt32();
+    }
+    return (mcp->ci->getMeth())(*mcp, CREATE_VECTOR2(v1, v2)).toInt32();
+  }
+}
+static bool usort(Array &arr, CVarRef cmp_function, bool by_key,
+                  bool renumber) {
+  // resolve the callback once, rather than on every comparison
+  MethodCallPackage mcp;
+  String classname, methodname;
+  bool doBind;
+  if (!get_user_func_handler(cmp_function, true,
+                             mcp, classname, methodname, doBind)) {
+    return false;
+  }
+  if (doBind) {
+    // If 'doBind' is true, we need to set the late bound class before
+    // calling the user callback
+    FrameInjection::StaticClassNameHelper scn(
+      ThreadInfo::s_threadInfo.getNoCheck(), classname);
+    arr.sort(usort_func, by_key, renumber, &mcp);
+  } else {
+    arr.sort(usort_func, by_key, renumber, &mcp);
+  }
+  return true;
+}
+
 bool f_usort(VRefParam array, CVarRef cmp_function) {
   getCheckedArrayRetType(array, false, Array &);
-  arr_array.sort(cmp_func, false, true, &cmp_function);
-  return true;
+  return usort(arr_array, cmp_function, false, true);
 }
 
 bool f_uasort(VRefParam array, CVarRef cmp_function) {
   getCheckedArrayRetType(array, false, Array &);
-  arr_array.sort(cmp_func, false, false, &cmp_function);
-  return true;
+  return usort(arr_array, cmp_function, false, false);
 }
 
 bool f_uksort(VRefParam array, CVarRef cmp_function) {
   getCheckedArrayRetType(array, false, Array &);
-  arr_array.sort(cmp_func, true, false, &cmp_function);
-  return true;
+  return usort(arr_array, cmp_function, true, false);
 }
 
 Variant f_natsort(VRefParam array) {
@@ -81,6 +81,7 @@ static DbgCltMap s_dbgCltMap;
 
 Variant f_hphpd_get_client(CStrRef name /* = null */) {
   DebuggerClient *client = NULL;
+  MemoryManager::MaskArena mask;
   StringData* sd = new StringData(name.data(), name.size(), CopyString);
   {
     DbgCltMap::accessor acc;
@@ -24,6 +24,7 @@
 #include <runtime/base/util/string_buffer.h>
 #include <runtime/eval/runtime/code_coverage.h>
 #include <runtime/base/runtime_option.h>
+#include <runtime/base/server/server_stats.h>
 #include <runtime/base/array/zend_array.h>
 #include <runtime/base/intercept.h>
 #include <runtime/base/taint/taint_data.h>
@@ -456,6 +457,24 @@ Variant f_fb_unserialize(CVarRef thing, VRefParam success,
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static void log_parallel_query_stats(const ServerData &server, int64 usec,
+                                     bool success) {
+  string host =
+    server.getIP() + ":" + boost::lexical_cast<string>(server.getPort());
+  ServerStats::Log("sql.parallel.query." + host, 1);
+  ServerStats::Log("sql.parallel.usec." + host, usec);
+  if (!success) {
+    ServerStats::Log("sql.parallel.error." + host, 1);
+  }
+}
+
+static class ParallelQueryStatsInstaller {
+public:
+  ParallelQueryStatsInstaller() {
+    DBConn::ParallelQueryStats = log_parallel_query_stats;
+  }
+} s_parallel_query_stats_installer;
+
 static void output_dataset(Array &ret, int affected, DBDataSet &ds,
                            const DBConn::ErrorInfoMap &errors) {
   ret.set("affected", affected);
@@ -17,6 +17,7 @@
 
 #include <runtime/ext/ext_json.h>
 #include <runtime/ext/JSON_parser.h>
+#include <runtime/ext/json_decoder.h>
 #include <runtime/base/zend/utf8_decode.h>
 #include <runtime/base/variable_serializer.h>
 
@@ -57,6 +58,10 @@ Variant f_json_decode(CStrRef json, bool assoc /* = false */,
   }
 
   Variant z;
+  if (!(json_options & k_JSON_FB_LOOSE) &&
+      JsonDecoder::Decode(z, json.data(), json.size(), assoc)) {
+    return z;
+  }
   if (JSON_parser(z, json.data(), json.size(), assoc, (json_options & k_JSON_FB_LOOSE))) {
     return z;
   }
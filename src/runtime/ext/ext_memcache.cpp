@@ -18,6 +18,7 @@
 #include <runtime/ext/ext_memcache.h>
 #include <runtime/base/util/request_local.h>
 #include <runtime/base/ini_setting.h>
+#include <runtime/ext/memcache_pool.h>
 
 #define MMC_SERIALIZED 1
 #define MMC_COMPRESSED 2
@@ -55,7 +56,7 @@ IMPLEMENT_STATIC_REQUEST_LOCAL(MEMCACHEGlobals, s_memcache_globals);
 bool ini_on_update_hash_strategy(CStrRef value, void *p) {
   if (!strncasecmp(value.data(), "standard", sizeof("standard"))) {
     MEMCACHEG(hash_strategy) = "standard";
-  } else if (!strncasecmp(value.data(), "standard", sizeof("consistent"))) {
+  } else if (!strncasecmp(value.data(), "consistent", sizeof("consistent"))) {
     MEMCACHEG(hash_strategy) = "consistent";
   } else {
     return false;
@@ -65,9 +66,9 @@ bool ini_on_update_hash_strategy(CStrRef value, void *p) {
 
 bool ini_on_update_hash_function(CStrRef value, void *p) {
   if (!strncasecmp(value.data(), "crc32", sizeof("crc32"))) {
-    MEMCACHEG(hash_strategy) = "crc32";
+    MEMCACHEG(hash_function) = "crc32";
   } else if (!strncasecmp(value.data(), "fnv", sizeof("fnv"))) {
-    MEMCACHEG(hash_strategy) = "fnv";
+    MEMCACHEG(hash_function) = "fnv";
   } else {
     return false;
   }
@@ -79,7 +80,7 @@ bool ini_on_update_hash_function(CStrRef value, void *p) {
 
 c_Memcache::c_Memcache(const ObjectStaticCallbacks *cb) :
     ExtObjectData(cb), m_memcache(), m_compress_threshold(0),
-    m_min_compress_savings(0.2) {
+    m_min_compress_savings(0.2), m_pool(NULL), m_conn(NULL) {
   memcached_create(&m_memcache);
 
   if (MEMCACHEG(hash_strategy) == "consistent") {
@@ -101,9 +102,29 @@ c_Memcache::c_Memcache(const ObjectStaticCallbacks *cb) :
 }
 
 c_Memcache::~c_Memcache() {
+  releaseConnection();
   memcached_free(&m_memcache);
 }
 
+memcached_st *c_Memcache::getConnection() {
+  if (m_conn) return m_conn;
+  if (RuntimeOption::MemcachePoolSize <= 0 ||
+      !memcached_server_count(&m_memcache)) {
+    return &m_memcache;
+  }
+  m_pool = MemcachePool::Get(&m_memcache);
+  m_conn = m_pool->checkout();
+  return m_conn;
+}
+
+void c_Memcache::releaseConnection() {
+  if (m_conn) {
+    m_pool->checkin(m_conn);
+    m_conn = NULL;
+    m_pool = NULL;
+  }
+}
+
 void c_Memcache::t___construct() {
   INSTANCE_METHOD_INJECTION_BUILTIN(Memcache, Memcache::__construct);
   return;
@@ -114,6 +135,7 @@ bool c_Memcache::t_connect(CStrRef host, int port /*= 0*/,
                            int timeoutms /*= 0*/) {
   INSTANCE_METHOD_INJECTION_BUILTIN(Memcache, Memcache::connect);
   memcached_return_t ret;
+  releaseConnection();
 
   if (!host.empty() && host[0] == '/') {
     ret = memcached_server_add_unix_socket(&m_memcache, host.c_str());
@@ -172,7 +194,7 @@ bool c_Memcache::t_add(CStrRef key, CVarRef var, int flag /*= 0*/,
 
   String serialized = memcache_prepare_for_storage(var, flag);
 
-  memcached_return_t ret = memcached_add(&m_memcache,
+  memcached_return_t ret = memcached_add(getConnection(),
                                         key.c_str(), key.length(),
                                         serialized.c_str(),
                                         serialized.length(),
@@ -191,7 +213,7 @@ bool c_Memcache::t_set(CStrRef key, CVarRef var, int flag /*= 0*/,
 
   String serialized = memcache_prepare_for_storage(var, flag);
 
-  memcached_return_t ret = memcached_set(&m_memcache,
+  memcached_return_t ret = memcached_set(getConnection(),
                                         key.c_str(), key.length(),
                                         serialized.c_str(),
                                         serialized.length(),
@@ -214,7 +236,7 @@ bool c_Memcache::t_replace(CStrRef key, CVarRef var, int flag /*= 0*/,
 
   String serialized = memcache_prepare_for_storage(var, flag);
 
-  memcached_return_t ret = memcached_replace(&m_memcache,
+  memcached_return_t ret = memcached_replace(getConnection(),
                                              key.c_str(), key.length(),
                                              serialized.c_str(),
                                              serialized.length(),
@@ -246,13 +268,14 @@ Variant c_Memcache::t_get(CVarRef key, VRefParam flags /*= null*/) {
       size_t res_key_len = 0;
 
       memcached_result_st result;
+      memcached_st *mc = getConnection();
 
-      memcached_return_t ret = memcached_mget(&m_memcache, &real_keys[0],
+      memcached_return_t ret = memcached_mget(mc, &real_keys[0],
                                               &key_len[0], real_keys.size());
-      memcached_result_create(&m_memcache, &result);
+      memcached_result_create(mc, &result);
       Array return_val;
 
-      while ((memcached_fetch_result(&m_memcache, &result, &ret)) != NULL) {
+      while ((memcached_fetch_result(mc, &result, &ret)) != NULL) {
         if (ret != MEMCACHED_SUCCESS) {
           // should probably notify about errors
           continue;
@@ -284,7 +307,16 @@ Variant c_Memcache::t_get(CVarRef key, VRefParam flags /*= null*/) {
       return false;
     }
 
-    payload = memcached_get(&m_memcache, skey.c_str(), skey.length(),
+    memcached_st *mc = getConnection();
+    if (m_conn && RuntimeOption::MemcacheCoalesceGets) {
+      std::string value;
+      if (!m_pool->get(mc, skey.c_str(), skey.length(), value, flags)) {
+        return false;
+      }
+      return memcache_fetch_from_storage(value.data(), value.size(), flags);
+    }
+
+    payload = memcached_get(mc, skey.c_str(), skey.length(),
                             &payload_len, &flags, &ret);
 
     /* This is for historical reasons from libmemcached*/
@@ -311,7 +343,7 @@ bool c_Memcache::t_delete(CStrRef key, int expire /*= 0*/) {
     return false;
   }
 
-  memcached_return_t ret = memcached_delete(&m_memcache,
+  memcached_return_t ret = memcached_delete(getConnection(),
                                             key.c_str(), key.length(),
                                             expire);
   return (ret == MEMCACHED_SUCCESS);
@@ -325,7 +357,7 @@ int64 c_Memcache::t_increment(CStrRef key, int offset /*= 1*/) {
   }
 
   uint64_t value;
-  memcached_return_t ret = memcached_increment(&m_memcache, key.c_str(),
+  memcached_return_t ret = memcached_increment(getConnection(), key.c_str(),
                                               key.length(), offset, &value);
 
   if (ret == MEMCACHED_SUCCESS) {
@@ -343,7 +375,7 @@ int64 c_Memcache::t_decrement(CStrRef key, int offset /*= 1*/) {
   }
 
   uint64_t value;
-  memcached_return_t ret = memcached_decrement(&m_memcache, key.c_str(),
+  memcached_return_t ret = memcached_decrement(getConnection(), key.c_str(),
                                               key.length(), offset, &value);
 
   if (ret == MEMCACHED_SUCCESS) {
@@ -355,7 +387,11 @@ int64 c_Memcache::t_decrement(CStrRef key, int offset /*= 1*/) {
 
 bool c_Memcache::t_close() {
   INSTANCE_METHOD_INJECTION_BUILTIN(Memcache, Memcache::close);
-  memcached_quit(&m_memcache);
+  if (m_conn) {
+    releaseConnection();
+  } else {
+    memcached_quit(&m_memcache);
+  }
   return true;
 }
 
@@ -388,7 +424,7 @@ Variant c_Memcache::t_getversion() {
 
 bool c_Memcache::t_flush(int expire /*= 0*/) {
   INSTANCE_METHOD_INJECTION_BUILTIN(Memcache, Memcache::flush);
-  return memcached_flush(&m_memcache, expire) == MEMCACHED_SUCCESS;
+  return memcached_flush(getConnection(), expire) == MEMCACHED_SUCCESS;
 }
 
 bool c_Memcache::t_setoptimeout(int64 timeoutms) {
@@ -546,6 +582,7 @@ bool c_Memcache::t_addserver(CStrRef host, int port /* = 11211 */,
                              int timeoutms /* = 0 */) {
   INSTANCE_METHOD_INJECTION_BUILTIN(Memcache, Memcache::addserver);
   memcached_return_t ret;
+  releaseConnection();
 
   if (!host.empty() && host[0] == '/') {
     ret = memcached_server_add_unix_socket_with_weight(&m_memcache,
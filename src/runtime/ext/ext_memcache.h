@@ -22,6 +22,9 @@
 
 #include <runtime/base/base_includes.h>
 #include <libmemcached/memcached.h>
+
+class TestExtMemcache;
+
 namespace HPHP {
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -49,6 +52,8 @@ bool f_memcache_add_server(CObjRef memcache, CStrRef host, int port = 11211, boo
 ///////////////////////////////////////////////////////////////////////////////
 // class Memcache
 
+class MemcachePool;
+
 FORWARD_DECLARE_CLASS_BUILTIN(Memcache);
 class c_Memcache : public ExtObjectData, public Sweepable {
  public:
@@ -105,9 +110,19 @@ class c_Memcache : public ExtObjectData, public Sweepable {
 
 
  private:
+  friend class ::TestExtMemcache;
+
   memcached_st m_memcache;
   int m_compress_threshold;
   double m_min_compress_savings;
+
+  // with Memcache.PoolSize, m_memcache only holds the servers and options,
+  // and commands go over a connection checked out of m_pool
+  MemcachePool *m_pool;
+  memcached_st *m_conn;
+
+  memcached_st *getConnection();
+  void releaseConnection();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -19,6 +19,8 @@
 #include <runtime/ext/ext_memcached.h>
 #include <runtime/base/builtin_functions.h>
 #include <runtime/ext/ext_json.h>
+#include <runtime/base/variable_serializer.h>
+#include <runtime/base/variable_unserializer.h>
 #include <zlib.h>
 
 using namespace std;
@@ -39,6 +41,7 @@ IMPLEMENT_THREAD_LOCAL(c_Memcached::ImplMap, c_Memcached::s_persistentMap);
 #define MEMC_VAL_IS_SERIALIZED 4
 #define MEMC_VAL_IS_IGBINARY   5
 #define MEMC_VAL_IS_JSON       6
+#define MEMC_VAL_IS_BINARY     8 // HipHop's binary serialization, not in pecl
 
 #define MEMC_VAL_COMPRESSED    (1<<4)
 
@@ -160,6 +163,9 @@ const int q_Memcached$$RES_PAYLOAD_FAILURE = -1001;
 const int q_Memcached$$SERIALIZER_PHP      = 1;
 const int q_Memcached$$SERIALIZER_IGBINARY = 2;
 const int q_Memcached$$SERIALIZER_JSON     = 3;
+// VariableSerializer::BinarySerialize, which pecl doesn't have; kept clear
+// of the values pecl uses for its own serializers
+const int q_Memcached$$SERIALIZER_BINARY   = 100;
 
 // Flags
 const int q_Memcached$$GET_PRESERVE_ORDER = 1;
@@ -848,6 +854,7 @@ bool c_Memcached::t_setoption(int option, CVarRef value) {
       switch (iValue) {
       case q_Memcached$$SERIALIZER_PHP:
       case q_Memcached$$SERIALIZER_JSON:
+      case q_Memcached$$SERIALIZER_BINARY:
         m_impl->serializer = iValue;
         break;
       default:
@@ -921,6 +928,13 @@ void c_Memcached::toPayload(CVarRef value, vector<char> &payload,
       encoded = f_json_encode(value);
       flags = MEMC_VAL_IS_JSON;
       break;
+    case q_Memcached$$SERIALIZER_BINARY:
+      {
+        VariableSerializer vs(VariableSerializer::BinarySerialize);
+        encoded = vs.serialize(value, true);
+        flags = MEMC_VAL_IS_BINARY;
+      }
+      break;
     default:
       encoded = f_serialize(value);
       flags = MEMC_VAL_IS_SERIALIZED;
@@ -991,6 +1005,9 @@ bool c_Memcached::toObject(Variant& value, const memcached_result_st &result) {
   case MEMC_VAL_IS_SERIALIZED:
     value = f_unserialize(decompPayload);
     break;
+  case MEMC_VAL_IS_BINARY:
+    value = unserialize_ex(decompPayload, VariableUnserializer::BinarySerialize);
+    break;
   case MEMC_VAL_IS_IGBINARY:
     raise_warning("could not unserialize value, no igbinary support");
     return false;
@@ -29,6 +29,7 @@ extern const int q_Memcached$$OPT_SERIALIZER;
 extern const int q_Memcached$$SERIALIZER_PHP;
 extern const int q_Memcached$$SERIALIZER_IGBINARY;
 extern const int q_Memcached$$SERIALIZER_JSON;
+extern const int q_Memcached$$SERIALIZER_BINARY;
 extern const int q_Memcached$$OPT_PREFIX_KEY;
 extern const int q_Memcached$$OPT_HASH;
 extern const int q_Memcached$$HASH_DEFAULT;
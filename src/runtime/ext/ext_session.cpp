@@ -19,6 +19,7 @@
 #include <runtime/ext/ext_options.h>
 #include <runtime/ext/ext_hash.h>
 #include <runtime/ext/ext_function.h>
+#include <runtime/ext/session_store.h>
 #include <runtime/base/builtin_functions.h>
 #include <runtime/base/zend/zend_math.h>
 #include <runtime/base/util/string_buffer.h>
@@ -88,6 +89,8 @@ public:
   std::string m_ps_gc;
 
   SessionSerializer *m_serializer;
+  bool m_serializer_set;  // session.serialize_handler was set, rather than
+                          // left to the module's choice
 
   bool m_auto_start;
   bool m_use_cookies;
@@ -108,8 +111,9 @@ public:
       m_cookie_httponly(false), m_mod(NULL), m_session_status(None),
       m_gc_probability(0), m_gc_divisor(0), m_gc_maxlifetime(0),
       m_module_number(0), m_cache_expire(0), m_serializer(NULL),
-      m_auto_start(false), m_use_cookies(false), m_use_only_cookies(false),
-      m_use_trans_sid(false), m_apply_trans_sid(false),
+      m_serializer_set(false), m_auto_start(false), m_use_cookies(false),
+      m_use_only_cookies(false), m_use_trans_sid(false),
+      m_apply_trans_sid(false),
       m_hash_bits_per_character(0), m_send_cookie(0), m_define_sid(0),
       m_invalid_session_id(false) {
   }
@@ -125,6 +129,7 @@ public:
       threadInit();
     }
     m_id.reset();
+    m_read_data.reset();
     m_session_status = Session::None;
   }
 
@@ -137,6 +142,7 @@ public:
 public:
   bool m_threadInited;
   String m_id;
+  Array m_read_data;  // $_SESSION as read, for modules with lazyWrite()
 
   void threadInit() {
     IniSetting::Bind("session.save_path",          "",
@@ -155,6 +161,7 @@ public:
                      ini_on_update_long,           &m_gc_maxlifetime);
     IniSetting::Bind("session.serialize_handler",  "php",
                      ini_on_update_serializer);
+    m_serializer_set = false;
     IniSetting::Bind("session.cookie_lifetime",    "0",
                      ini_on_update_long,           &m_cookie_lifetime);
     IniSetting::Bind("session.cookie_path",        "/",
@@ -216,6 +223,25 @@ public:
   virtual bool gc(int maxlifetime, int *nrdels) = 0;
   virtual String create_sid();
 
+  /**
+   * Serializer used unless session.serialize_handler is set.
+   */
+  virtual const char *getDefaultSerializer() { return "php"; }
+
+  /**
+   * Modules that return true get touch() instead of write() for sessions
+   * that were read and not modified. touch() returns false if a write is
+   * needed after all.
+   */
+  virtual bool lazyWrite() { return false; }
+  virtual bool touch(const char *key) { return false; }
+
+  /**
+   * True if the last write() failed because another request changed the
+   * session first, rather than because it couldn't be stored.
+   */
+  virtual bool writeConflict() { return false; }
+
 public:
   static SessionModule *Find(const char *name) {
     for (unsigned int i = 0; i < RegisteredModules.size(); i++) {
@@ -241,6 +267,7 @@ void SessionRequestData::requestShutdownImpl() {
     } catch (...) {}
   }
   m_id.reset();
+  m_read_data.reset();
 }
 
 /*
@@ -755,6 +782,95 @@ public:
 };
 static UserSessionModule s_user_session_module;
 
+///////////////////////////////////////////////////////////////////////////////
+// SharedSessionModule
+
+class SharedSessionData {
+public:
+  SharedSessionData() : m_version(0), m_conflict(false) {}
+
+  std::string m_key;  // session last read by this thread
+  int64 m_version;    // its version then, 0 if it wasn't there
+  bool m_conflict;    // last write lost to another request's
+};
+IMPLEMENT_THREAD_LOCAL(SharedSessionData, s_shared_session_data);
+
+/**
+ * Sessions kept in this process's SessionStore. A write fails if another
+ * request wrote or destroyed the session since this one read it.
+ */
+class SharedSessionModule : public SessionModule {
+public:
+  SharedSessionModule() : SessionModule("shm") {}
+
+  virtual const char *getDefaultSerializer() { return "php_binary"; }
+  virtual bool lazyWrite() { return true; }
+
+  virtual bool open(const char *save_path, const char *session_name) {
+    SessionStore::Get();
+    return true;
+  }
+
+  virtual bool close() {
+    SharedSessionData *data = s_shared_session_data.get();
+    data->m_key.clear();
+    data->m_version = 0;
+    data->m_conflict = false;
+    return true;
+  }
+
+  virtual bool read(const char *key, String &value) {
+    SharedSessionData *data = s_shared_session_data.get();
+    data->m_key = key;
+    if (!SessionStore::Get().read(key, value, data->m_version)) {
+      data->m_version = 0;
+      return false;
+    }
+    return true;
+  }
+
+  virtual bool write(const char *key, CStrRef value) {
+    SharedSessionData *data = s_shared_session_data.get();
+    int64 version = data->m_key == key ? data->m_version : 0;
+    data->m_conflict = !SessionStore::Get().write(key, value, version,
+                                                  PS(gc_maxlifetime));
+    if (data->m_conflict) return false;
+    data->m_key = key;
+    data->m_version = version;
+    return true;
+  }
+
+  virtual bool writeConflict() {
+    return s_shared_session_data.get()->m_conflict;
+  }
+
+  virtual bool touch(const char *key) {
+    SharedSessionData *data = s_shared_session_data.get();
+    if (data->m_key != key) return false;
+    // nothing to do if it wasn't there, or was destroyed since
+    if (data->m_version) {
+      SessionStore::Get().touch(key, PS(gc_maxlifetime));
+    }
+    return true;
+  }
+
+  virtual bool destroy(const char *key) {
+    SharedSessionData *data = s_shared_session_data.get();
+    if (data->m_key == key) data->m_version = 0;
+    SessionStore::Get().remove(key);
+    return true;
+  }
+
+  virtual bool gc(int maxlifetime, int *nrdels) {
+    // expired sessions are swept by SessionStore's own thread
+    if (RuntimeOption::SessionSweepInterval <= 0) {
+      *nrdels = SessionStore::Get().sweep(time(NULL));
+    }
+    return true;
+  }
+};
+static SharedSessionModule s_shared_session_module;
+
 ///////////////////////////////////////////////////////////////////////////////
 // session serializers
 
@@ -911,12 +1027,16 @@ static PhpSessionSerializer s_php_session_serializer;
 bool ini_on_update_save_handler(CStrRef value, void *p) {
   SESSION_CHECK_ACTIVE_STATE;
   PS(mod) = SessionModule::Find(value.data());
+  if (PS(mod) && !PS(serializer_set)) {
+    PS(serializer) = SessionSerializer::Find(PS(mod)->getDefaultSerializer());
+  }
   return true;
 }
 
 bool ini_on_update_serializer(CStrRef value, void *p) {
   SESSION_CHECK_ACTIVE_STATE;
   PS(serializer) = SessionSerializer::Find(value.data());
+  PS(serializer_set) = true;
   return true;
 }
 
@@ -984,6 +1104,27 @@ static void php_session_decode(CStrRef value) {
   }
 }
 
+static bool has_objects(CArrRef arr) {
+  for (ArrayIter iter(arr); iter; ++iter) {
+    CVarRef value = iter.secondRef();
+    if (value.isObject()) return true;
+    if (value.isArray() && has_objects(value.toArray())) return true;
+  }
+  return false;
+}
+
+/**
+ * Whether $_SESSION is still the array read. Writing to it or to anything
+ * in it copies the array first, since m_read_data shares it; objects in it
+ * can change in place, so sessions with objects always count as modified.
+ */
+static bool php_session_unchanged() {
+  if (PS(read_data).isNull()) return false;
+  SystemGlobals *g = (SystemGlobals*)get_global_variables();
+  return g->GV(_SESSION).isArray() &&
+    g->GV(_SESSION).getArrayData() == PS(read_data).get();
+}
+
 static void php_session_initialize() {
   /* check session name for invalid characters */
   if (strpbrk(PS(id).data(), "\r\n\t <>'\"\\")) {
@@ -1028,9 +1169,14 @@ new_session:
   g->GV(_SESSION) = Array::Create();
 
   PS(invalid_session_id) = false;
+  PS(read_data).reset();
   String value;
   if (PS(mod)->read(PS(id).data(), value)) {
     php_session_decode(value);
+    if (PS(mod)->lazyWrite() && g->GV(_SESSION).isArray() &&
+        !has_objects(g->GV(_SESSION).toArray())) {
+      PS(read_data) = g->GV(_SESSION).toArray();
+    }
   } else if (PS(invalid_session_id)) {
     /* address instances where the session read fails due to an invalid id */
     PS(invalid_session_id) = false;
@@ -1044,15 +1190,25 @@ new_session:
 static void php_session_save_current_state() {
   bool ret = false;
   if (PS(mod)) {
-    String value = php_session_encode();
-    if (!value.isNull()) {
-      ret = PS(mod)->write(PS(id).data(), value);
+    if (php_session_unchanged() && PS(mod)->touch(PS(id).data())) {
+      ret = true;
+    } else {
+      String value = php_session_encode();
+      if (!value.isNull()) {
+        ret = PS(mod)->write(PS(id).data(), value);
+      }
     }
   }
+  PS(read_data).reset();
   if (!ret) {
-    raise_warning("Failed to write session data (%s). Please verify that the "
-                  "current setting of session.save_path is correct (%s)",
-                  PS(mod)->getName(), PS(save_path).c_str());
+    if (PS(mod) && PS(mod)->writeConflict()) {
+      raise_notice("Session %s was modified by another request; changes "
+                   "made by this one were not saved", PS(id).data());
+    } else {
+      raise_warning("Failed to write session data (%s). Please verify that "
+                    "the current setting of session.save_path is correct "
+                    "(%s)", PS(mod)->getName(), PS(save_path).c_str());
+    }
   }
   if (PS(mod)) {
     PS(mod)->close();
@@ -0,0 +1,465 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <runtime/ext/json_decoder.h>
+#include <runtime/ext/JSON_parser.h>
+#include <runtime/base/array/array_init.h>
+#include <runtime/base/zend/utf8_decode.h>
+#include <system/lib/systemlib.h>
+#include <util/byte_set.h>
+#include <endian.h>
+
+using namespace std;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+// JSON_parser() has room for 512 modes, one of which is MODE_DONE
+#define JSON_DECODER_MAX_DEPTH 511
+#define MAX_LENGTH_OF_LONG 20
+
+static const char long_min_digits[] = "9223372036854775808";
+
+static const ByteSet s_string_special("\"\\", 2, true, true);
+
+static inline bool is_space(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static inline bool is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+static inline int dehexchar(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - ('A' - 10);
+  if (c >= 'a' && c <= 'f') return c - ('a' - 10);
+  return -1;
+}
+
+/**
+ * Number of digits at p, testing 8 bytes a time.
+ */
+static inline int digit_run(const char *p, const char *end) {
+  const char *q = p;
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+  while (end - q >= 8) {
+    uint64 w;
+    memcpy(&w, q, 8);
+    // each byte becomes 0x33 if it is a digit: high nibble of both the byte
+    // and the byte + 6 is 3
+    uint64 t = (w & 0xF0F0F0F0F0F0F0F0ULL) |
+      (((w + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4);
+    t ^= 0x3333333333333333ULL;
+    if (t) return q - p + (__builtin_ctzll(t) >> 3);
+    q += 8;
+  }
+#endif
+  while (q < end && is_digit(*q)) q++;
+  return q - p;
+}
+
+/**
+ * Value of up to 18 digits.
+ */
+static inline int64 digits_to_int64(const char *p, int len) {
+  int64 v = 0;
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+  for (; len >= 8; p += 8, len -= 8) {
+    uint64 w;
+    memcpy(&w, p, 8);
+    w -= 0x3030303030303030ULL;
+    w = w * 10 + (w >> 8);
+    w = (((w & 0x000000FF000000FFULL) * 0x000F424000000064ULL) +
+         (((w >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL)) >> 32;
+    v = v * 100000000 + (int64)w;
+  }
+#endif
+  for (; len > 0; p++, len--) {
+    v = v * 10 + (*p - '0');
+  }
+  return v;
+}
+
+static double to_double(const char *p, int len) {
+  char buf[64];
+  if (len < (int)sizeof(buf)) {
+    memcpy(buf, p, len);
+    buf[len] = '\0';
+    return strtod(buf, NULL);
+  }
+  return strtod(string(p, len).c_str(), NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool JsonDecoder::Decode(Variant &z, const char *data, int size,
+                         bool assoc) {
+  const char *p = data;
+  const char *end = data + size;
+  while (p < end && is_space(*p)) p++;
+  if (p == end || (*p != '{' && *p != '[')) {
+    return false;
+  }
+  JsonDecoder decoder(assoc);
+  return decoder.feed(p, end - p) && decoder.finish(z);
+}
+
+JsonDecoder::JsonDecoder(bool assoc)
+  : m_assoc(assoc), m_state(Start), m_buf(127) {
+}
+
+bool JsonDecoder::feed(const char *data, int size) {
+  if (m_state == Failed) return false;
+
+  Result r;
+  if (m_pending.empty()) {
+    const char *p = data;
+    r = parse(p, data + size);
+    if (r == Incomplete) {
+      m_pending.assign(p, data + size - p);
+    }
+  } else {
+    // a string can't end before its closing quote shows up
+    if (m_pending[0] == '"' && !memchr(data, '"', size)) {
+      m_pending.append(data, size);
+      return true;
+    }
+    m_pending.append(data, size);
+    const char *p = m_pending.data();
+    r = parse(p, m_pending.data() + m_pending.size());
+    m_pending.erase(0, p - m_pending.data());
+  }
+
+  if (r == Invalid) {
+    m_state = Failed;
+    m_frames.clear();
+    m_values.clear();
+    m_keys.clear();
+    m_pending.clear();
+    return false;
+  }
+  return true;
+}
+
+bool JsonDecoder::finish(Variant &z) {
+  if (m_state != Done || !m_pending.empty()) {
+    return false;
+  }
+  z = m_result;
+  return true;
+}
+
+JsonDecoder::Result JsonDecoder::parse(const char *&p, const char *end) {
+  while (p < end) {
+    char c = *p;
+    if (is_space(c)) {
+      p++;
+      continue;
+    }
+
+    switch (m_state) {
+    case Start:
+      if (c != '{' && c != '[') return Invalid;
+      if (!open(c == '{')) return Invalid;
+      p++;
+      break;
+    case ValueOrClose:
+      if (c == ']') {
+        close();
+        p++;
+        break;
+      }
+      // fall through
+    case Value:
+      switch (c) {
+      case '{':
+      case '[':
+        if (!open(c == '{')) return Invalid;
+        p++;
+        break;
+      case '"': {
+        String s;
+        Result r = parseString(p, end, s);
+        if (r != OK) return r;
+        addValue(s);
+        break;
+      }
+      case 't':
+      case 'f':
+      case 'n': {
+        Variant v;
+        Result r = parseLiteral(p, end, v);
+        if (r != OK) return r;
+        addValue(v);
+        break;
+      }
+      default: {
+        if (c != '-' && !is_digit(c)) return Invalid;
+        Variant v;
+        Result r = parseNumber(p, end, v);
+        if (r != OK) return r;
+        addValue(v);
+        break;
+      }
+      }
+      break;
+    case KeyOrClose:
+      if (c == '}') {
+        close();
+        p++;
+        break;
+      }
+      // fall through
+    case Key: {
+      if (c != '"') return Invalid;
+      String key;
+      Result r = parseString(p, end, key);
+      if (r != OK) return r;
+      m_keys.push_back(key);
+      m_state = Colon;
+      break;
+    }
+    case Colon:
+      if (c != ':') return Invalid;
+      m_state = Value;
+      p++;
+      break;
+    case CommaOrClose: {
+      bool object = m_frames.back().object;
+      if (c == ',') {
+        m_state = object ? Key : Value;
+      } else if (c == (object ? '}' : ']')) {
+        close();
+      } else {
+        return Invalid;
+      }
+      p++;
+      break;
+    }
+    default:
+      return Invalid;
+    }
+  }
+  return OK;
+}
+
+/**
+ * Only strings with escapes go through m_buf; everything else, including
+ * multi-byte characters, is copied from the input as is.
+ */
+JsonDecoder::Result JsonDecoder::parseString(const char *&p, const char *end,
+                                             String &s) {
+  ASSERT(*p == '"');
+  const char *start = p + 1;
+  const char *q = start;
+  const char *mark = NULL; // start of what's not in m_buf yet
+  for (;;) {
+    q = s_string_special.find(q, end);
+    if (q == end) return Incomplete;
+
+    unsigned char c = *q;
+    if (c == '"') {
+      if (mark) {
+        m_buf.append(mark, q - mark);
+        s = m_buf.detach();
+      } else {
+        s = String(start, q - start, CopyString);
+      }
+      p = q + 1;
+      return OK;
+    }
+
+    if (c >= 0x80) {
+      int len = (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 :
+        (c & 0xF8) == 0xF0 ? 4 : 0;
+      if (len == 0) return Invalid;
+      if (end - q < len) return Incomplete;
+      UTF8To16Decoder decoder(q, len, false);
+      if (decoder.decode() < 0) return Invalid;
+      q += len;
+      continue;
+    }
+
+    if (c != '\\') return Invalid; // control character
+
+    if (end - q < 2) return Incomplete;
+    if (mark) {
+      m_buf.append(mark, q - mark);
+    } else {
+      m_buf.reset();
+      m_buf.append(start, q - start);
+    }
+    switch (q[1]) {
+    case '"':
+    case '\\':
+    case '/': m_buf.append(q[1]); break;
+    case 'b': m_buf.append('\b'); break;
+    case 't': m_buf.append('\t'); break;
+    case 'n': m_buf.append('\n'); break;
+    case 'f': m_buf.append('\f'); break;
+    case 'r': m_buf.append('\r'); break;
+    case 'u': {
+      if (end - q < 6) return Incomplete;
+      unsigned short utf16 = 0;
+      for (int i = 2; i < 6; i++) {
+        int h = dehexchar(q[i]);
+        if (h < 0) return Invalid;
+        utf16 = (utf16 << 4) | h;
+      }
+      utf16_to_utf8(m_buf, utf16);
+      q += 4;
+      break;
+    }
+    default:
+      return Invalid;
+    }
+    q += 2;
+    mark = q;
+  }
+}
+
+/**
+ * Same grammar and conversions as JSON_parser(), including its quirks: "1."
+ * is a valid double, "0e1" is invalid, and integers that don't fit in int64
+ * become doubles.
+ */
+JsonDecoder::Result JsonDecoder::parseNumber(const char *&p, const char *end,
+                                             Variant &v) {
+  const char *q = p;
+  bool neg = (*q == '-');
+  if (neg) q++;
+  if (q == end) return Incomplete;
+
+  const char *digits = q;
+  if (*q == '0') {
+    q++;
+  } else if (is_digit(*q)) {
+    q += digit_run(q, end);
+  } else {
+    return Invalid;
+  }
+  int ndigits = q - digits;
+  if (q == end) return Incomplete;
+
+  bool isDouble = false;
+  if (*q == '.') {
+    isDouble = true;
+    q++;
+    q += digit_run(q, end);
+    if (q == end) return Incomplete;
+  }
+  if ((*q == 'e' || *q == 'E') && (isDouble || *digits != '0')) {
+    isDouble = true;
+    q++;
+    if (q < end && (*q == '+' || *q == '-')) q++;
+    if (q == end) return Incomplete;
+    if (!is_digit(*q)) return Invalid;
+    q += digit_run(q, end);
+    if (q == end) return Incomplete;
+  }
+
+  if (isDouble) {
+    v = to_double(p, q - p);
+  } else if (ndigits < MAX_LENGTH_OF_LONG - 1) {
+    int64 n = digits_to_int64(digits, ndigits);
+    v = neg ? -n : n;
+  } else if (ndigits == MAX_LENGTH_OF_LONG - 1 &&
+             (memcmp(digits, long_min_digits, ndigits) < 0 ||
+              (neg && memcmp(digits, long_min_digits, ndigits) == 0))) {
+    v = strtoll(string(p, q - p).c_str(), NULL, 10);
+  } else {
+    v = to_double(p, q - p);
+  }
+  p = q;
+  return OK;
+}
+
+JsonDecoder::Result JsonDecoder::parseLiteral(const char *&p, const char *end,
+                                              Variant &v) {
+  const char *literal;
+  int len;
+  switch (*p) {
+  case 't': literal = "true";  len = 4; v = true;  break;
+  case 'f': literal = "false"; len = 5; v = false; break;
+  default:  literal = "null";  len = 4; v = null;  break;
+  }
+  int avail = end - p < len ? end - p : len;
+  if (memcmp(p, literal, avail)) return Invalid;
+  if (avail < len) return Incomplete;
+  p += len;
+  return OK;
+}
+
+bool JsonDecoder::open(bool object) {
+  if (m_frames.size() >= JSON_DECODER_MAX_DEPTH) return false;
+  Frame frame;
+  frame.object = object;
+  frame.base = m_values.size();
+  frame.keyBase = m_keys.size();
+  m_frames.push_back(frame);
+  m_state = object ? KeyOrClose : ValueOrClose;
+  return true;
+}
+
+void JsonDecoder::close() {
+  Frame frame = m_frames.back();
+  m_frames.pop_back();
+  int n = m_values.size() - frame.base;
+
+  Variant v;
+  if (frame.object && !m_assoc) {
+    // We know it is stdClass, and everything is public (and dynamic).
+    Object obj(SystemLib::AllocStdClassObject());
+    for (int i = 0; i < n; i++) {
+      const String &key = m_keys[frame.keyBase + i];
+      if (key.empty()) {
+        obj->o_setPublic("_empty_", m_values[frame.base + i]);
+      } else {
+        obj->o_setPublic(key, m_values[frame.base + i]);
+      }
+    }
+    v = obj;
+  } else {
+    ArrayInit ai(n);
+    if (frame.object) {
+      for (int i = 0; i < n; i++) {
+        ai.set(m_keys[frame.keyBase + i], m_values[frame.base + i]);
+      }
+    } else {
+      for (int i = 0; i < n; i++) {
+        ai.set(m_values[frame.base + i]);
+      }
+    }
+    v = Array(ai.create());
+  }
+  m_values.resize(frame.base);
+  m_keys.resize(frame.keyBase);
+  addValue(v);
+}
+
+void JsonDecoder::addValue(CVarRef v) {
+  if (m_frames.empty()) {
+    m_result = v;
+    m_state = Done;
+  } else {
+    m_values.push_back(v);
+    m_state = CommaOrClose;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,108 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_JSON_DECODER_H__
+#define __HPHP_JSON_DECODER_H__
+
+#include <runtime/base/complex_types.h>
+#include <runtime/base/util/string_buffer.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Strict JSON decoder for documents whose top level is an object or an
+ * array. Unlike JSON_parser(), which walks a state machine one character at
+ * a time, it scans whole runs of string bytes and digits, collects each
+ * container's elements on a stack and then builds the array with its final
+ * size in one go.
+ *
+ * It accepts exactly the documents JSON_parser() accepts in strict mode and
+ * produces the same values. Anything else, including loose mode and scalar
+ * documents, is left to JSON_parser(): callers should fall back to it
+ * whenever decoding fails.
+ *
+ * Input can be given in chunks with feed(), e.g. a request body as it comes
+ * in from Transport::getMorePostData(), so that it never has to be copied
+ * into one buffer. Only a token cut in half by a chunk boundary is kept
+ * around until the next chunk.
+ */
+class JsonDecoder {
+public:
+  static bool Decode(Variant &z, const char *data, int size, bool assoc);
+
+public:
+  JsonDecoder(bool assoc);
+
+  /**
+   * Decodes as much of the next chunk as possible. Returns false as soon as
+   * the input is known to be invalid.
+   */
+  bool feed(const char *data, int size);
+
+  /**
+   * Called after the last chunk. Returns false if the document is invalid or
+   * incomplete.
+   */
+  bool finish(Variant &z);
+
+private:
+  enum State {
+    Start,          // before top level '{' or '['
+    ValueOrClose,   // after '['
+    Value,          // after ',' in array or ':' in object
+    KeyOrClose,     // after '{'
+    Key,            // after ',' in object
+    Colon,          // after a key
+    CommaOrClose,   // after a value
+    Done,           // after top level '}' or ']'
+    Failed
+  };
+
+  enum Result {
+    OK,
+    Incomplete,     // need more input to finish current token
+    Invalid
+  };
+
+  struct Frame {
+    bool object;
+    int base;       // first element in m_values
+    int keyBase;    // first key in m_keys
+  };
+
+  bool m_assoc;
+  State m_state;
+  std::vector<Frame> m_frames;
+  std::vector<Variant> m_values;
+  std::vector<String> m_keys;
+  Variant m_result;
+  std::string m_pending; // partial token from the previous chunk
+  StringBuffer m_buf;    // for strings with escapes
+
+  Result parse(const char *&p, const char *end);
+  Result parseString(const char *&p, const char *end, String &s);
+  Result parseNumber(const char *&p, const char *end, Variant &v);
+  Result parseLiteral(const char *&p, const char *end, Variant &v);
+  bool open(bool object);
+  void close();
+  void addValue(CVarRef v);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_JSON_DECODER_H__
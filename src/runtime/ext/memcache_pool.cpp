@@ -0,0 +1,254 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <runtime/ext/memcache_pool.h>
+#include <runtime/base/runtime_option.h>
+#include <runtime/base/server/server_stats.h>
+#include <algorithm>
+#include <util/compatibility.h>
+
+using namespace std;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+Mutex MemcachePool::s_poolsLock;
+std::map<std::string, MemcachePool*> MemcachePool::s_pools;
+
+// everything a pooled connection inherits from the object that asked for it
+static const memcached_behavior_t s_keyBehaviors[] = {
+  MEMCACHED_BEHAVIOR_DISTRIBUTION,
+  MEMCACHED_BEHAVIOR_HASH,
+  MEMCACHED_BEHAVIOR_CONNECT_TIMEOUT,
+  MEMCACHED_BEHAVIOR_POLL_TIMEOUT,
+  MEMCACHED_BEHAVIOR_SND_TIMEOUT,
+  MEMCACHED_BEHAVIOR_RCV_TIMEOUT,
+  MEMCACHED_BEHAVIOR_RETRY_TIMEOUT,
+  MEMCACHED_BEHAVIOR_SERVER_FAILURE_LIMIT,
+  MEMCACHED_BEHAVIOR_BINARY_PROTOCOL,
+  MEMCACHED_BEHAVIOR_BUFFER_REQUESTS,
+  MEMCACHED_BEHAVIOR_NO_BLOCK,
+  MEMCACHED_BEHAVIOR_TCP_NODELAY,
+};
+
+static std::string pool_key(memcached_st *mc) {
+  char buf[64];
+  string key;
+  for (unsigned int i = 0;
+       i < sizeof(s_keyBehaviors) / sizeof(s_keyBehaviors[0]); i++) {
+    snprintf(buf, sizeof(buf), "%llu:", (unsigned long long)
+             memcached_behavior_get(mc, s_keyBehaviors[i]));
+    key += buf;
+  }
+  int count = memcached_server_count(mc);
+  for (int i = 0; i < count; i++) {
+    memcached_server_instance_st server =
+      memcached_server_instance_by_position(mc, i);
+    snprintf(buf, sizeof(buf), ":%d:%u", (int)server->port,
+             (unsigned int)server->weight);
+    key += ';';
+    key += server->hostname;
+    key += buf;
+  }
+  return key;
+}
+
+MemcachePool *MemcachePool::Get(memcached_st *config) {
+  string key = pool_key(config);
+  Lock lock(s_poolsLock);
+  MemcachePool *&pool = s_pools[key];
+  if (!pool) {
+    pool = new MemcachePool(config);
+  }
+  return pool;
+}
+
+MemcachePool::MemcachePool(memcached_st *config)
+  : m_servers(memcached_server_count(config)) {
+  memcached_clone(&m_config, config);
+  memcached_behavior_set(&m_config, MEMCACHED_BEHAVIOR_NO_BLOCK, 1);
+  memcached_behavior_set(&m_config, MEMCACHED_BEHAVIOR_TCP_NODELAY, 1);
+
+  // a coalesced get waits for a slow server about as long as a get of its
+  // own would have
+  int64 timeout =
+    memcached_behavior_get(&m_config, MEMCACHED_BEHAVIOR_POLL_TIMEOUT);
+  m_waitTimeout = (timeout > 0 ? timeout : 1000) * 1000;
+}
+
+MemcachePool::~MemcachePool() {
+  for (unsigned int i = 0; i < m_idle.size(); i++) {
+    memcached_free(m_idle[i]);
+  }
+  memcached_free(&m_config);
+}
+
+memcached_st *MemcachePool::checkout() {
+  {
+    Lock lock(m_idleLock);
+    if (!m_idle.empty()) {
+      memcached_st *mc = m_idle.back();
+      m_idle.pop_back();
+      return mc;
+    }
+  }
+  return memcached_clone(NULL, &m_config);
+}
+
+void MemcachePool::checkin(memcached_st *mc) {
+  {
+    Lock lock(m_idleLock);
+    if ((int)m_idle.size() < RuntimeOption::MemcachePoolSize) {
+      m_idle.push_back(mc);
+      return;
+    }
+  }
+  memcached_free(mc);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// coalesced gets
+
+static bool direct_get(memcached_st *mc, const char *key, size_t len,
+                       std::string &value, uint32_t &flags) {
+  size_t payload_len = 0;
+  memcached_return_t ret;
+  char *payload = memcached_get(mc, key, len, &payload_len, &flags, &ret);
+  if (!payload) return false;
+  if (ret == MEMCACHED_SUCCESS) {
+    value.assign(payload, payload_len);
+  }
+  free(payload);
+  return ret == MEMCACHED_SUCCESS;
+}
+
+bool MemcachePool::get(memcached_st *mc, const char *key, size_t len,
+                       std::string &value, uint32_t &flags) {
+  unsigned int index = m_servers.size() > 1 ?
+    memcached_generate_hash(mc, key, len) : 0;
+  if (index >= m_servers.size()) {
+    return direct_get(mc, key, len, value, flags);
+  }
+  Server &server = m_servers[index];
+
+  GetOp op(key, len);
+  std::set<std::string> keys;
+  int batchSize = 0;
+  {
+    Lock lock(this);
+    server.pending.push_back(&op);
+    timespec start;
+    gettime(CLOCK_MONOTONIC, &start);
+    while (!op.done && server.fetching) {
+      timespec now;
+      gettime(CLOCK_MONOTONIC, &now);
+      int64 left = m_waitTimeout - gettime_diff_us(start, now);
+      if (left <= 0) break;
+      wait(left / 1000000, (left % 1000000) * 1000);
+    }
+    if (!op.done) {
+      if (server.fetching) {
+        // the server is slow to answer someone else's multi-get: stop
+        // waiting for it and ask ourselves
+        std::vector<GetOp*> &pending = server.pending;
+        std::vector<GetOp*> &inflight = server.inflight;
+        pending.erase(std::remove(pending.begin(), pending.end(), &op),
+                      pending.end());
+        inflight.erase(std::remove(inflight.begin(), inflight.end(), &op),
+                       inflight.end());
+      } else {
+        // nothing in flight: send everything queued so far, ours included
+        for (unsigned int i = 0; i < server.pending.size(); i++) {
+          keys.insert(server.pending[i]->key);
+        }
+        batchSize = server.pending.size();
+        server.inflight.swap(server.pending);
+        server.fetching = true;
+      }
+    }
+  }
+
+  if (!op.done && !batchSize) {
+    if (RuntimeOption::EnableStats) {
+      ServerStats::Log("memcache.batch_timeouts", 1);
+    }
+    return direct_get(mc, key, len, value, flags);
+  }
+
+  if (batchSize) {
+    // the same key asked for by several requests is only fetched once
+    ValueMap values;
+    fetch(mc, keys, values);
+    if (RuntimeOption::EnableStats) {
+      ServerStats::Log("memcache.batch", 1);
+      ServerStats::Log("memcache.batch_keys", batchSize);
+    }
+
+    // requests that gave up waiting have taken themselves out of inflight
+    Lock lock(this);
+    for (unsigned int i = 0; i < server.inflight.size(); i++) {
+      GetOp *waiter = server.inflight[i];
+      ValueMap::const_iterator iter = values.find(waiter->key);
+      if (iter != values.end()) {
+        waiter->value = iter->second.data;
+        waiter->flags = iter->second.flags;
+        waiter->found = true;
+      }
+      waiter->done = true;
+    }
+    server.inflight.clear();
+    server.fetching = false;
+    notifyAll();
+  }
+
+  if (op.found) {
+    value.swap(op.value);
+    flags = op.flags;
+  }
+  return op.found;
+}
+
+void MemcachePool::fetch(memcached_st *mc, const std::set<std::string> &keys,
+                         ValueMap &values) {
+  std::vector<const char *> keyPtrs;
+  std::vector<size_t> lens;
+  keyPtrs.reserve(keys.size());
+  lens.reserve(keys.size());
+  for (std::set<std::string>::const_iterator iter = keys.begin();
+       iter != keys.end(); ++iter) {
+    keyPtrs.push_back(iter->data());
+    lens.push_back(iter->size());
+  }
+
+  memcached_return_t ret = memcached_mget(mc, &keyPtrs[0], &lens[0],
+                                          keyPtrs.size());
+  if (ret != MEMCACHED_SUCCESS) return;
+
+  memcached_result_st result;
+  memcached_result_create(mc, &result);
+  while (memcached_fetch_result(mc, &result, &ret) != NULL) {
+    if (ret != MEMCACHED_SUCCESS) continue;
+    Value &v = values[string(memcached_result_key_value(&result),
+                             memcached_result_key_length(&result))];
+    v.data.assign(memcached_result_value(&result),
+                  memcached_result_length(&result));
+    v.flags = memcached_result_flags(&result);
+  }
+  memcached_result_free(&result);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
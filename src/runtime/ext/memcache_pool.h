@@ -0,0 +1,110 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_MEMCACHE_POOL_H__
+#define __HPHP_MEMCACHE_POOL_H__
+
+#include <util/base.h>
+#include <util/lock.h>
+#include <util/synchronizable.h>
+#include <libmemcached/memcached.h>
+
+class TestExtMemcache;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Process-wide pool of libmemcached connections to one set of servers with
+ * the same key distribution, hash, timeouts and other behaviors, so objects
+ * set up differently never share connections. Connections are nonblocking
+ * with TCP_NODELAY, and they stay open when checked back in, so requests
+ * don't have to connect to memcache servers each time. At most
+ * Memcache.PoolSize idle connections are kept per pool.
+ *
+ * With Memcache.CoalesceGets, single key gets from concurrent requests are
+ * batched per server: whichever request finds no multi-get in flight to the
+ * key's server sends one for all the keys queued for it since the last one,
+ * and hands out the values. Nobody waits for a batch to fill up; requests
+ * only wait when a round-trip to the same server was in flight anyway, and
+ * for no longer than the poll timeout before getting the key themselves.
+ */
+class MemcachePool : public Synchronizable {
+public:
+  /**
+   * The pool for the servers, distribution and hash set up in config.
+   * Pools are created on first use and never freed.
+   */
+  static MemcachePool *Get(memcached_st *config);
+
+  memcached_st *checkout();
+  void checkin(memcached_st *mc);
+
+  /**
+   * Like memcached_get() on mc, a connection checked out of this pool, but
+   * possibly answered by a multi-get sent on another request's connection.
+   */
+  bool get(memcached_st *mc, const char *key, size_t len,
+           std::string &value, uint32_t &flags);
+
+private:
+  friend class ::TestExtMemcache; // holds back a fetch to queue up gets
+
+  struct Value {
+    std::string data;
+    uint32_t flags;
+  };
+  typedef std::map<std::string, Value> ValueMap;
+
+  struct GetOp {
+    GetOp(const char *k, size_t len)
+      : key(k, len), flags(0), found(false), done(false) {}
+    std::string key;
+    std::string value;
+    uint32_t flags;
+    bool found;
+    bool done;
+  };
+
+  static Mutex s_poolsLock;
+  static std::map<std::string, MemcachePool*> s_pools;
+
+  memcached_st m_config;
+  Mutex m_idleLock;
+  std::vector<memcached_st*> m_idle;
+
+  struct Server {
+    Server() : fetching(false) {}
+    std::vector<GetOp*> pending;  // for the next multi-get
+    std::vector<GetOp*> inflight; // sent, still waiting for values
+    bool fetching;
+  };
+
+  // guarded by Synchronizable's mutex, indexed by server position
+  std::vector<Server> m_servers;
+  int64 m_waitTimeout; // in microseconds
+
+  MemcachePool(memcached_st *config);
+  ~MemcachePool();
+
+  static void fetch(memcached_st *mc, const std::set<std::string> &keys,
+                    ValueMap &values);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_MEMCACHE_POOL_H__
@@ -0,0 +1,242 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <runtime/ext/session_store.h>
+#include <runtime/base/runtime_option.h>
+#include <util/hash.h>
+#include <util/lock.h>
+
+using namespace std;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * One version of a session. Only expires and next change after the entry
+ * is linked in, both by writers holding its stripe's lock.
+ */
+struct SessionStore::Entry {
+  Entry(const char *k, CStrRef v, int64 ver, time_t exp, Entry *n)
+    : key(k), value(v.data(), v.size()), version(ver), expires(exp),
+      next(n) {}
+
+  const std::string key;
+  const std::string value;
+  const int64 version;
+  volatile time_t expires;  // 0 if never
+  Entry * volatile next;
+
+  bool alive(time_t now) const {
+    time_t exp = expires;
+    return !exp || now < exp;
+  }
+};
+
+static time_t expiry(time_t now, int ttl) {
+  return ttl > 0 ? now + ttl : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SessionStore *SessionStore::s_store = NULL;
+Mutex SessionStore::s_storeLock;
+
+SessionStore &SessionStore::Get() {
+  SessionStore *store = s_store;
+  if (store) return *store;
+
+  Lock lock(s_storeLock);
+  if (!s_store) {
+    store = new SessionStore();
+    store->m_thread.start();
+    __sync_synchronize();
+    s_store = store;
+  }
+  return *s_store;
+}
+
+SessionStore::SessionStore()
+  : m_count(0), m_lastVersion(0), m_epoch(0),
+    m_thread(this, &SessionStore::run), m_stopped(false) {
+  memset((void*)m_buckets, 0, sizeof(m_buckets));
+  m_readers[0] = m_readers[1] = 0;
+}
+
+SessionStore::~SessionStore() {
+  {
+    Lock lock(getMutex());
+    m_stopped = true;
+    notify();
+  }
+  m_thread.waitForEnd();
+  reclaim();
+  for (int i = 0; i < BucketCount; i++) {
+    Entry *next;
+    for (Entry *entry = m_buckets[i]; entry; entry = next) {
+      next = entry->next;
+      delete entry;
+    }
+  }
+}
+
+SessionStore::ReadGuard::ReadGuard(SessionStore &store) : m_store(store) {
+  while (true) {
+    m_epoch = m_store.m_epoch;
+    __sync_add_and_fetch(&m_store.m_readers[m_epoch & 1], 1);
+    // reclaim() moved the epoch on and may have seen no readers in it
+    // already; nothing has been read yet, so start over in the new one
+    if (m_store.m_epoch == m_epoch) break;
+    __sync_sub_and_fetch(&m_store.m_readers[m_epoch & 1], 1);
+  }
+}
+
+SessionStore::ReadGuard::~ReadGuard() {
+  __sync_sub_and_fetch(&m_store.m_readers[m_epoch & 1], 1);
+}
+
+SessionStore::Entry * volatile *
+SessionStore::find(Entry * volatile *link, const char *key) {
+  for (; *link; link = &(*link)->next) {
+    if ((*link)->key == key) break;
+  }
+  return link;
+}
+
+void SessionStore::retire(Entry *entry) {
+  Lock lock(m_retiredLock);
+  m_retired.push_back(entry);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SessionStore::read(const char *key, String &value, int64 &version) {
+  int64 hash = hash_string(key, strlen(key));
+  ReadGuard guard(*this);
+  Entry *entry = *find(&m_buckets[hash & (BucketCount - 1)], key);
+  if (!entry || !entry->alive(time(NULL))) return false;
+  value = String(entry->value.data(), entry->value.size(), CopyString);
+  version = entry->version;
+  return true;
+}
+
+bool SessionStore::write(const char *key, CStrRef value, int64 &version,
+                         int ttl) {
+  int64 hash = hash_string(key, strlen(key));
+  Entry * volatile &bucket = m_buckets[hash & (BucketCount - 1)];
+  Lock lock(m_locks[hash & (LockCount - 1)]);
+  time_t now = time(NULL);
+  Entry * volatile *link = find(&bucket, key);
+  Entry *old = *link;
+  if ((old && old->alive(now) ? old->version : 0) != version) {
+    return false;
+  }
+
+  version = __sync_add_and_fetch(&m_lastVersion, 1);
+  if (!old) link = &bucket;
+  Entry *entry = new Entry(key, value, version, expiry(now, ttl),
+                           old ? old->next : bucket);
+  // publish the entry only after it is fully constructed
+  __sync_synchronize();
+  *link = entry;
+  if (old) {
+    retire(old);
+  } else {
+    __sync_add_and_fetch(&m_count, 1);
+  }
+  return true;
+}
+
+bool SessionStore::touch(const char *key, int ttl) {
+  int64 hash = hash_string(key, strlen(key));
+  Lock lock(m_locks[hash & (LockCount - 1)]);
+  time_t now = time(NULL);
+  Entry *entry = *find(&m_buckets[hash & (BucketCount - 1)], key);
+  if (!entry || !entry->alive(now)) return false;
+  entry->expires = expiry(now, ttl);
+  return true;
+}
+
+bool SessionStore::remove(const char *key) {
+  int64 hash = hash_string(key, strlen(key));
+  Lock lock(m_locks[hash & (LockCount - 1)]);
+  Entry * volatile *link = find(&m_buckets[hash & (BucketCount - 1)], key);
+  Entry *entry = *link;
+  if (!entry) return false;
+  *link = entry->next;
+  retire(entry);
+  __sync_sub_and_fetch(&m_count, 1);
+  return true;
+}
+
+int SessionStore::sweep(time_t now) {
+  int removed = 0;
+  for (int i = 0; i < BucketCount; i++) {
+    if (!m_buckets[i]) continue;
+    Lock lock(m_locks[i & (LockCount - 1)]);
+    for (Entry * volatile *link = &m_buckets[i]; *link; ) {
+      Entry *entry = *link;
+      if (entry->alive(now)) {
+        link = &entry->next;
+        continue;
+      }
+      *link = entry->next;
+      retire(entry);
+      removed++;
+    }
+  }
+  if (removed) __sync_sub_and_fetch(&m_count, removed);
+  return removed;
+}
+
+void SessionStore::reclaim() {
+  Lock reclaimLock(m_reclaimLock);
+  vector<Entry*> retired;
+  {
+    Lock lock(m_retiredLock);
+    retired.swap(m_retired);
+  }
+  if (retired.empty()) return;
+
+  // Every entry in retired was unlinked before this, so readers that start
+  // in the next epoch can't reach them. Wait out the ones in this epoch.
+  int epoch = m_epoch;
+  __sync_add_and_fetch(&m_epoch, 1);
+  while (m_readers[epoch & 1]) {
+    usleep(100);
+  }
+  for (unsigned int i = 0; i < retired.size(); i++) {
+    delete retired[i];
+  }
+}
+
+void SessionStore::run() {
+  Lock lock(getMutex());
+  time_t lastSweep = time(NULL);
+  while (!m_stopped) {
+    wait(1);
+    if (m_stopped) break;
+    time_t now = time(NULL);
+    if (RuntimeOption::SessionSweepInterval > 0 &&
+        now - lastSweep >= RuntimeOption::SessionSweepInterval) {
+      sweep(now);
+      lastSweep = now;
+    }
+    reclaim();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,130 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_SESSION_STORE_H__
+#define __HPHP_SESSION_STORE_H__
+
+#include <runtime/base/complex_types.h>
+#include <util/async_func.h>
+#include <util/synchronizable.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * In-memory session data for session.save_handler = shm, shared by all
+ * worker threads of the process.
+ *
+ * Each write gives a session a new version. Writers say which version they
+ * read, and a write only goes through if the session is still at that
+ * version, so two requests for one session don't lock each other out the
+ * way flock()ed session files do: the one that writes last fails instead of
+ * overwriting changes it never saw.
+ *
+ * Reads take no locks. Entries don't change once they are in the table,
+ * except for their expiry time; a write links in a new entry and retires
+ * the old one, which is freed only after all reads that might still see it
+ * are done. Writes lock one of LockCount stripes of buckets.
+ *
+ * Sessions expire ttl seconds after they were last written or touched. A
+ * background thread drops expired ones every Session.SweepInterval seconds,
+ * and frees retired entries once a second.
+ */
+class SessionStore : public Synchronizable {
+public:
+  /**
+   * The process-wide store, created with its thread on first use.
+   */
+  static SessionStore &Get();
+
+  SessionStore();
+  ~SessionStore();
+
+  /**
+   * Data and version of a session that is there and not expired.
+   */
+  bool read(const char *key, String &value, int64 &version);
+
+  /**
+   * Stores value if the session is still at version, 0 for one that isn't
+   * there, and sets version to the new one. False if the session was
+   * written or removed since. ttl <= 0 never expires.
+   */
+  bool write(const char *key, CStrRef value, int64 &version, int ttl);
+
+  /**
+   * Restarts the ttl of a session without writing it.
+   */
+  bool touch(const char *key, int ttl);
+
+  bool remove(const char *key);
+
+  /**
+   * Drops sessions that expired before now, and returns how many.
+   */
+  int sweep(time_t now);
+
+  /**
+   * Frees entries nothing can read anymore.
+   */
+  void reclaim();
+
+  int size() const { return m_count; }
+
+  void run();
+
+private:
+  struct Entry;
+  static const int BucketCount = 65536;
+  static const int LockCount = 256;
+  static SessionStore *s_store;
+  static Mutex s_storeLock;
+
+  /**
+   * Marks a reader busy in the current epoch. Entries retired before the
+   * epoch moves on are freed only after readers in it are gone.
+   */
+  class ReadGuard {
+  public:
+    ReadGuard(SessionStore &store);
+    ~ReadGuard();
+  private:
+    SessionStore &m_store;
+    int m_epoch;
+  };
+
+  Entry * volatile m_buckets[BucketCount];
+  Mutex m_locks[LockCount];
+  volatile int m_count;
+  volatile int64 m_lastVersion;
+
+  volatile int m_epoch;
+  volatile int m_readers[2];
+  Mutex m_retiredLock;
+  std::vector<Entry*> m_retired;
+  Mutex m_reclaimLock;
+
+  AsyncFunc<SessionStore> m_thread;
+  bool m_stopped;
+
+  Entry * volatile *find(Entry * volatile *link, const char *key);
+  void retire(Entry *entry);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_SESSION_STORE_H__
@@ -16,6 +16,7 @@
 */
 
 #include <runtime/ext/thrift/transport.h>
+#include <runtime/ext/thrift/spec.h>
 #include <runtime/ext/ext_thrift.h>
 #include <runtime/base/base_includes.h>
 #include <util/logger.h>
@@ -40,7 +41,7 @@ const int BAD_VERSION = 4;
 
 void binary_deserialize_spec(CObjRef zthis, PHPInputTransport& transport, CArrRef spec);
 void binary_serialize_spec(CObjRef zthis, PHPOutputTransport& transport, CArrRef spec);
-void binary_serialize(int8_t thrift_typeID, PHPOutputTransport& transport, CVarRef value, CArrRef fieldspec);
+void binary_serialize(int8_t thrift_typeID, PHPOutputTransport& transport, CVarRef value, const FieldSpec& fieldspec);
 void skip_element(long thrift_typeID, PHPInputTransport& transport);
 
 // Create a PHP object given a typename and call the ctor, optionally passing up to 2 arguments
@@ -66,20 +67,19 @@ void throw_tprotocolexception(CStrRef what, long errorcode) {
 }
 
 Variant binary_deserialize(int8_t thrift_typeID, PHPInputTransport& transport,
-                           CArrRef fieldspec) {
+                           const FieldSpec& fieldspec) {
   Variant ret;
   switch (thrift_typeID) {
     case T_STOP:
     case T_VOID:
       return null;
     case T_STRUCT: {
-      Variant val;
-      if ((val = fieldspec.rvalAt(s_class)).isNull()) {
+      if (fieldspec.className.isNull()) {
         throw_tprotocolexception("no class type in spec", INVALID_DATA);
         skip_element(T_STRUCT, transport);
         return null;
       }
-      String structType = val.toString();
+      CStrRef structType = fieldspec.className;
       ret = createObject(structType);
       if (ret.isNull()) {
         // unable to create class entry
@@ -152,15 +152,12 @@ Variant binary_deserialize(int8_t thrift_typeID, PHPInputTransport& transport,
       transport.readBytes(types, 2);
       uint32_t size = transport.readU32();
 
-      Array keyspec = fieldspec.rvalAt(s_key,
-                                       AccessFlags::Error_Key).toArray();
-      Array valspec = fieldspec.rvalAt(s_val,
-                                       AccessFlags::Error_Key).toArray();
       ret = Array::Create();
 
       for (uint32_t s = 0; s < size; ++s) {
-        Variant key = binary_deserialize(types[0], transport, keyspec);
-        Variant value = binary_deserialize(types[1], transport, valspec);
+        Variant key = binary_deserialize(types[0], transport, *fieldspec.key);
+        Variant value = binary_deserialize(types[1], transport,
+                                           *fieldspec.val);
         ret.set(key, value);
       }
       return ret; // return_value already populated
@@ -168,12 +165,10 @@ Variant binary_deserialize(int8_t thrift_typeID, PHPInputTransport& transport,
     case T_LIST: { // array with autogenerated numeric keys
       int8_t type = transport.readI8();
       uint32_t size = transport.readU32();
-      Variant elemvar = fieldspec.rvalAt(s_elem, AccessFlags::Error_Key);
-      Array elemspec = elemvar.toArray();
       ret = Array::Create();
 
       for (uint32_t s = 0; s < size; ++s) {
-        Variant value = binary_deserialize(type, transport, elemspec);
+        Variant value = binary_deserialize(type, transport, *fieldspec.elem);
         ret.append(value);
       }
       return ret;
@@ -184,12 +179,10 @@ Variant binary_deserialize(int8_t thrift_typeID, PHPInputTransport& transport,
       transport.readBytes(&type, 1);
       transport.readBytes(&size, 4);
       size = ntohl(size);
-      Variant elemvar = fieldspec.rvalAt(s_elem, AccessFlags::Error_Key);
-      Array elemspec = elemvar.toArray();
       ret = Array::Create();
 
       for (uint32_t s = 0; s < size; ++s) {
-        Variant key = binary_deserialize(type, transport, elemspec);
+        Variant key = binary_deserialize(type, transport, *fieldspec.elem);
 
         if (key.isInteger()) {
           ret.set(key, true);
@@ -276,7 +269,7 @@ void binary_serialize_hashtable_key(int8_t keytype, PHPOutputTransport& transpor
   } else {
     key = key.toString();
   }
-  binary_serialize(keytype, transport, key, Array());
+  binary_serialize(keytype, transport, key, FieldSpec::Empty);
 }
 
 inline bool ttype_is_int(int8_t t) {
@@ -293,24 +286,16 @@ void binary_deserialize_spec(CObjRef zthis, PHPInputTransport& transport,
                              CArrRef spec) {
   // SET and LIST have 'elem' => array('type', [optional] 'class')
   // MAP has 'val' => array('type', [optiona] 'class')
+  StructSpecHolder holder;
+  const StructSpec &structspec = holder.get(spec, zthis->o_getClassName());
   while (true) {
-    Variant val;
-
     int8_t ttype = transport.readI8();
     if (ttype == T_STOP) return;
     int16_t fieldno = transport.readI16();
-    if (!(val = spec.rvalAt(fieldno)).isNull()) {
-      Array fieldspec = val.toArray();
-      // pull the field name
-      // zend hash tables use the null at the end in the length... so strlen(hash key) + 1.
-      String varname = fieldspec.rvalAt(s_var).toString();
-
-      // and the type
-      int8_t expected_ttype = fieldspec.rvalAt(s_type).toInt64();
-
-      if (ttypes_are_compatible(ttype, expected_ttype)) {
-        Variant rv = binary_deserialize(ttype, transport, fieldspec);
-        zthis->set(varname, rv);
+    if (const FieldSpec *fieldspec = structspec.field(fieldno)) {
+      if (ttypes_are_compatible(ttype, fieldspec->type)) {
+        Variant rv = binary_deserialize(ttype, transport, *fieldspec);
+        zthis->o_setPublic(fieldspec->name, rv);
       } else {
         skip_element(ttype, transport);
       }
@@ -321,7 +306,7 @@ void binary_deserialize_spec(CObjRef zthis, PHPInputTransport& transport,
 }
 
 void binary_serialize(int8_t thrift_typeID, PHPOutputTransport& transport,
-                      CVarRef value, CArrRef fieldspec) {
+                      CVarRef value, const FieldSpec& fieldspec) {
   // At this point the typeID (and field num, if applicable) should've already
   // been written to the output so all we need to do is write the payload.
   switch (thrift_typeID) {
@@ -371,41 +356,33 @@ void binary_serialize(int8_t thrift_typeID, PHPOutputTransport& transport,
     } return;
     case T_MAP: {
       Array ht = value.toArray();
-      uint8_t keytype = fieldspec.rvalAt(s_ktype,
-                                         AccessFlags::Error_Key).toByte();
+      uint8_t keytype = fieldspec.ktype;
       transport.writeI8(keytype);
-      uint8_t valtype = fieldspec.rvalAt(s_vtype,
-                                         AccessFlags::Error_Key).toByte();
+      uint8_t valtype = fieldspec.vtype;
       transport.writeI8(valtype);
 
-      Array valspec = fieldspec.rvalAt(s_val,
-                                       AccessFlags::Error_Key).toArray();
-
       transport.writeI32(ht.size());
       for (ArrayIter key_ptr = ht.begin(); !key_ptr.end(); ++key_ptr) {
         binary_serialize_hashtable_key(keytype, transport, key_ptr.first());
-        binary_serialize(valtype, transport, key_ptr.second(), valspec);
+        binary_serialize(valtype, transport, key_ptr.second(),
+                         *fieldspec.val);
       }
     } return;
     case T_LIST: {
       Array ht = value.toArray();
-      Variant val;
 
-      uint8_t valtype = fieldspec.rvalAt(s_etype,
-                                         AccessFlags::Error_Key).toInt64();
+      uint8_t valtype = fieldspec.etype;
       transport.writeI8(valtype);
-      Array valspec = fieldspec.rvalAt(s_elem,
-                                       AccessFlags::Error_Key).toArray();
       transport.writeI32(ht.size());
       for (ArrayIter key_ptr = ht.begin(); !key_ptr.end(); ++key_ptr) {
-        binary_serialize(valtype, transport, key_ptr.second(), valspec);
+        binary_serialize(valtype, transport, key_ptr.second(),
+                         *fieldspec.elem);
       }
     } return;
     case T_SET: {
       Array ht = value.toArray();
 
-      uint8_t keytype = fieldspec.rvalAt(s_etype,
-                                         AccessFlags::Error_Key).toByte();
+      uint8_t keytype = fieldspec.etype;
       transport.writeI8(keytype);
 
       transport.writeI32(ht.size());
@@ -422,30 +399,21 @@ void binary_serialize(int8_t thrift_typeID, PHPOutputTransport& transport,
 
 void binary_serialize_spec(CObjRef zthis, PHPOutputTransport& transport,
                            CArrRef spec) {
-  for (ArrayIter key_ptr = spec.begin(); !key_ptr.end(); ++key_ptr) {
-    Variant key = key_ptr.first();
-    if (!key.isInteger()) {
-      throw_tprotocolexception("Bad keytype in TSPEC (expected 'long')", INVALID_DATA);
-      return;
-    }
-    unsigned long fieldno = key.toInt64();
-    Array fieldspec = key_ptr.second().toArray();
-
-    // field name
-    String varname = fieldspec.rvalAt(s_var,
-                                      AccessFlags::Error_Key).toString();
-
-    // thrift type
-    int8_t ttype = fieldspec.rvalAt(s_type,
-                                    AccessFlags::Error_Key).toByte();
-
-    Variant prop = zthis->o_get(varname);
+  StructSpecHolder holder;
+  const StructSpec &structspec = holder.get(spec, zthis->o_getClassName());
+  for (unsigned int i = 0; i < structspec.writeCount(); i++) {
+    const FieldSpec &fieldspec = structspec.at(i);
+    Variant prop = zthis->o_getPublic(fieldspec.name);
     if (!prop.isNull()) {
-      transport.writeI8(ttype);
-      transport.writeI16(fieldno);
-      binary_serialize(ttype, transport, prop, fieldspec);
+      transport.writeI8(fieldspec.type);
+      transport.writeI16(fieldspec.fieldNum);
+      binary_serialize(fieldspec.type, transport, prop, fieldspec);
     }
   }
+  if (structspec.badKey()) {
+    throw_tprotocolexception("Bad keytype in TSPEC (expected 'long')", INVALID_DATA);
+    return;
+  }
   transport.writeI8(T_STOP); // struct end
 }
 
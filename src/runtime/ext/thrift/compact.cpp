@@ -16,6 +16,7 @@
 */
 
 #include <runtime/ext/thrift/transport.h>
+#include <runtime/ext/thrift/spec.h>
 #include <runtime/ext/ext_thrift.h>
 
 #include <stack>
@@ -180,33 +181,26 @@ class CompactWriter {
       lastFieldNum = 0;
 
       // Get field specification
-      CArrRef spec = get_static_property(obj->o_getClassName(), "_TSPEC")
-        .toArray();
+      StructSpecHolder holder;
+      CStrRef className = obj->o_getClassName();
+      const StructSpec &spec = holder.get(
+        get_static_property(className, "_TSPEC").toArray(), className);
 
       // Write each member
-      for (ArrayIter specIter = spec.begin(); !specIter.end(); ++specIter) {
-        Variant key = specIter.first();
-        if (!key.isInteger()) {
-          thrift_error("Bad keytype in TSPEC (expected 'long')",
-            ERR_INVALID_DATA);
-        }
-
-        uint16_t fieldNo = key.toInt16();
-        Array fieldSpec = specIter.second().toArray();
-
-        String fieldName = fieldSpec
-          .rvalAt(s_var, AccessFlags::Error_Key).toString();
-        TType fieldType = (TType)fieldSpec
-          .rvalAt(s_type, AccessFlags::Error_Key).toByte();
-
-        Variant fieldVal = obj->o_get(fieldName);
+      for (unsigned int i = 0; i < spec.writeCount(); i++) {
+        const FieldSpec &fieldSpec = spec.at(i);
+        Variant fieldVal = obj->o_getPublic(fieldSpec.name);
 
         if (!fieldVal.isNull()) {
-          writeFieldBegin(fieldNo, fieldType);
-          writeField(fieldVal, fieldSpec, fieldType);
+          writeFieldBegin(fieldSpec.fieldNum, fieldSpec.type);
+          writeField(fieldVal, fieldSpec, fieldSpec.type);
           writeFieldEnd();
         }
       }
+      if (spec.badKey()) {
+        thrift_error("Bad keytype in TSPEC (expected 'long')",
+          ERR_INVALID_DATA);
+      }
 
       // Write stop
       writeUByte(0);
@@ -247,7 +241,7 @@ class CompactWriter {
     }
 
     void writeField(CVarRef value,
-                    CArrRef valueSpec,
+                    const FieldSpec &valueSpec,
                     TType type) {
       switch (type) {
         case T_STOP:
@@ -327,14 +321,12 @@ class CompactWriter {
       }
     }
 
-    void writeMap(Array arr, CArrRef spec) {
-      TType keyType = (TType)spec
-        .rvalAt(s_ktype, AccessFlags::Error_Key).toByte();
-      TType valueType = (TType)spec
-        .rvalAt(s_vtype, AccessFlags::Error_Key).toByte();
+    void writeMap(Array arr, const FieldSpec &spec) {
+      TType keyType = spec.ktype;
+      TType valueType = spec.vtype;
 
-      Array keySpec = spec.rvalAt(s_key, AccessFlags::Error_Key).toArray();
-      Array valueSpec = spec.rvalAt(s_val, AccessFlags::Error_Key).toArray();
+      const FieldSpec &keySpec = *spec.key;
+      const FieldSpec &valueSpec = *spec.val;
 
       writeMapBegin(keyType, valueType, arr.size());
 
@@ -346,11 +338,9 @@ class CompactWriter {
       writeCollectionEnd();
     }
 
-    void writeList(Array arr, CArrRef spec, CListType listType) {
-      TType valueType = (TType)spec
-        .rvalAt(s_etype, AccessFlags::Error_Key).toByte();
-      Array valueSpec = spec
-        .rvalAt(s_elem, AccessFlags::Error_Key).toArray();
+    void writeList(Array arr, const FieldSpec &spec, CListType listType) {
+      TType valueType = spec.etype;
+      const FieldSpec &valueSpec = *spec.elem;
 
       writeListBegin(valueType, arr.size());
 
@@ -467,12 +457,12 @@ class CompactReader {
       if (type == T_REPLY) {
         Object ret = create_object(resultClassName, Array());
         Variant spec = get_static_property(resultClassName, "_TSPEC");
-        readStruct(ret, spec);
+        readStruct(ret, spec.toArray());
         return ret;
       } else if (type == T_EXCEPTION) {
         Object exn = create_object("TApplicationException", Array());
         Variant spec = get_static_property("TApplicationException", "_TSPEC");
-        readStruct(exn, spec);
+        readStruct(exn, spec.toArray());
         throw exn;
       } else {
         thrift_error("Invalid response type", ERR_INVALID_DATA);
@@ -487,9 +477,12 @@ class CompactReader {
     std::stack<std::pair<CState, uint16_t> > structHistory;
     std::stack<CState> containerHistory;
 
-    void readStruct(CObjRef dest, CArrRef spec) {
+    void readStruct(CObjRef dest, CArrRef tspec) {
       readStructBegin();
 
+      StructSpecHolder holder;
+      const StructSpec &spec = holder.get(tspec, dest->o_getClassName());
+
       while (true) {
         uint16_t fieldNum;
         TType fieldType;
@@ -501,17 +494,11 @@ class CompactReader {
 
         bool readComplete = false;
 
-        Variant fieldSpecVariant = spec.rvalAt(fieldNum);
-        if (!fieldSpecVariant.isNull()) {
-          Array fieldSpec = fieldSpecVariant.toArray();
-
-          String fieldName = fieldSpec.rvalAt(s_var).toString();
-          TType expectedType = (TType)fieldSpec.rvalAt(s_type).toInt64();
-
-          if (typesAreCompatible(fieldType, expectedType)) {
+        if (const FieldSpec *fieldSpec = spec.field(fieldNum)) {
+          if (typesAreCompatible(fieldType, fieldSpec->type)) {
             readComplete = true;
-            Variant fieldValue = readField(fieldSpec, fieldType);
-            dest->set(fieldName, fieldValue);
+            Variant fieldValue = readField(*fieldSpec, fieldType);
+            dest->o_setPublic(fieldSpec->name, fieldValue);
           }
         }
 
@@ -572,19 +559,18 @@ class CompactReader {
       state = STATE_FIELD_READ;
     }
 
-    Variant readField(CArrRef spec, TType type) {
+    Variant readField(const FieldSpec &spec, TType type) {
       switch (type) {
         case T_STOP:
         case T_VOID:
           return null;
 
         case T_STRUCT: {
-            Variant className = spec.rvalAt(s_class);
-            if (className.isNull()) {
+            if (spec.className.isNull()) {
               thrift_error("no class type in spec", ERR_INVALID_DATA);
             }
 
-            String classNameString = className.toString();
+            CStrRef classNameString = spec.className;
             Variant newStruct = create_object(classNameString, Array());
             if (newStruct.isNull()) {
               thrift_error("invalid class type in spec", ERR_INVALID_DATA);
@@ -597,7 +583,7 @@ class CompactReader {
               thrift_error("invalid type of spec", ERR_INVALID_DATA);
             }
 
-            readStruct(newStruct, newStructSpec);
+            readStruct(newStruct, newStructSpec.toArray());
             return newStruct;
           }
 
@@ -740,13 +726,13 @@ class CompactReader {
       }
     }
 
-    Variant readMap(CArrRef spec) {
+    Variant readMap(const FieldSpec &spec) {
       TType keyType, valueType;
       uint32_t size;
       readMapBegin(keyType, valueType, size);
 
-      Array keySpec = spec.rvalAt(s_key, AccessFlags::Error);
-      Array valueSpec = spec.rvalAt(s_val, AccessFlags::Error);
+      const FieldSpec &keySpec = *spec.key;
+      const FieldSpec &valueSpec = *spec.val;
       Variant ret = Array::Create();
 
       for (uint32_t i = 0; i < size; i++) {
@@ -759,12 +745,12 @@ class CompactReader {
       return ret;
     }
 
-    Variant readList(CArrRef spec, CListType listType) {
+    Variant readList(const FieldSpec &spec, CListType listType) {
       TType valueType;
       uint32_t size;
       readListBegin(valueType, size);
 
-      Array valueSpec = spec.rvalAt(s_elem, AccessFlags::Error_Key);
+      const FieldSpec &valueSpec = *spec.elem;
       Variant ret = Array::Create();
 
       for (uint32_t i = 0; i < size; i++) {
@@ -0,0 +1,189 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include <runtime/ext/thrift/spec.h>
+#include <runtime/base/util/request_local.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+// FieldSpec
+
+const FieldSpec FieldSpec::Empty;
+
+FieldSpec::FieldSpec()
+  : fieldNum(0), type(T_STOP), ktype(T_STOP), vtype(T_STOP), etype(T_STOP),
+    key(&Empty), val(&Empty), elem(&Empty) {
+}
+
+FieldSpec::~FieldSpec() {
+  if (key != &Empty) delete key;
+  if (val != &Empty) delete val;
+  if (elem != &Empty) delete elem;
+}
+
+static String spec_string(CArrRef spec, CStrRef name) {
+  Variant v = spec.rvalAt(name);
+  if (v.isNull()) return String();
+  String s = v.toString();
+  if (spec->isStatic() && !s.get()->isStatic()) {
+    // cached specs outlive the request that compiled them
+    s = StringData::GetStaticString(s.get());
+  }
+  return s;
+}
+
+static const FieldSpec *compile_nested(CArrRef spec, CStrRef name) {
+  Variant v = spec.rvalAt(name);
+  if (v.isNull()) return &FieldSpec::Empty;
+  FieldSpec *nested = new FieldSpec();
+  nested->compile(v.toArray());
+  return nested;
+}
+
+void FieldSpec::compile(CArrRef spec) {
+  if (spec.isNull()) return;
+  type = (TType)spec.rvalAt(s_type).toByte();
+  name = spec_string(spec, s_var);
+  className = spec_string(spec, s_class);
+  ktype = (TType)spec.rvalAt(s_ktype).toByte();
+  vtype = (TType)spec.rvalAt(s_vtype).toByte();
+  etype = (TType)spec.rvalAt(s_etype).toByte();
+  key = compile_nested(spec, s_key);
+  val = compile_nested(spec, s_val);
+  elem = compile_nested(spec, s_elem);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// StructSpec
+
+StructSpec::StructSpec(CArrRef spec) : m_writeCount(0), m_badKey(false) {
+  for (ArrayIter iter = spec.begin(); !iter.end(); ++iter) {
+    Variant key = iter.first();
+    if (!key.isInteger()) {
+      m_badKey = true;
+      continue;
+    }
+    if (!m_badKey) m_writeCount++;
+
+    int64 fieldNum = key.toInt64();
+    FieldSpec *field = new FieldSpec();
+    field->fieldNum = fieldNum;
+    field->compile(iter.second().toArray());
+    m_fields.push_back(field);
+
+    if (fieldNum >= 0 && fieldNum < MaxDenseId) {
+      if (fieldNum >= (int64)m_byId.size()) {
+        m_byId.resize(fieldNum + 1, NULL);
+      }
+      m_byId[fieldNum] = field;
+    } else {
+      m_sparse[fieldNum] = field;
+    }
+  }
+}
+
+StructSpec::~StructSpec() {
+  for (unsigned int i = 0; i < m_fields.size(); i++) {
+    delete m_fields[i];
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// StructSpecHolder
+
+ReadWriteMutex StructSpecHolder::s_lock;
+hphp_hash_map<const ArrayData*, const StructSpec*, pointer_hash<ArrayData> >
+  StructSpecHolder::s_specs;
+
+/**
+ * Specs of classes whose $_TSPEC isn't static, as when it is set up at run
+ * time or under hphpi, compiled once per request. Each one keeps the array
+ * it was compiled from, so it is only used again while the class still has
+ * that same array.
+ */
+class StructSpecCache : public RequestEventHandler {
+public:
+  virtual void requestInit() {}
+  virtual void requestShutdown() { clear(); }
+  ~StructSpecCache() { clear(); }
+
+  const StructSpec &get(CArrRef spec, CStrRef className) {
+    Entry &entry = m_specs[className];
+    if (entry.spec.get() != spec.get()) {
+      // $_TSPEC was replaced; a reader may still be using the old one
+      if (entry.compiled) m_replaced.push_back(entry.compiled);
+      entry.spec = spec;
+      entry.compiled = new StructSpec(spec);
+    }
+    return *entry.compiled;
+  }
+
+private:
+  struct Entry {
+    Entry() : compiled(NULL) {}
+    Array spec;
+    StructSpec *compiled;
+  };
+  StringIMap<Entry> m_specs;
+  std::vector<StructSpec*> m_replaced;
+
+  void clear() {
+    for (StringIMap<Entry>::iterator iter = m_specs.begin();
+         iter != m_specs.end(); ++iter) {
+      delete iter->second.compiled;
+    }
+    m_specs.clear();
+    for (unsigned int i = 0; i < m_replaced.size(); i++) {
+      delete m_replaced[i];
+    }
+    m_replaced.clear();
+  }
+};
+IMPLEMENT_STATIC_REQUEST_LOCAL(StructSpecCache, s_spec_cache);
+
+const StructSpec &StructSpecHolder::get(CArrRef spec, CStrRef className) {
+  ArrayData *arr = spec.get();
+  if (arr && !arr->isStatic() && !className.empty()) {
+    return s_spec_cache->get(spec, className);
+  }
+  if (!arr || !arr->isStatic()) {
+    delete m_temp;
+    m_temp = new StructSpec(spec);
+    return *m_temp;
+  }
+
+  {
+    ReadLock lock(s_lock);
+    hphp_hash_map<const ArrayData*, const StructSpec*,
+                  pointer_hash<ArrayData> >::const_iterator iter =
+      s_specs.find(arr);
+    if (iter != s_specs.end()) return *iter->second;
+  }
+
+  StructSpec *compiled = new StructSpec(spec);
+  WriteLock lock(s_lock);
+  const StructSpec *&cached = s_specs[arr];
+  if (cached) {
+    // another thread got here first
+    delete compiled;
+  } else {
+    cached = compiled;
+  }
+  return *cached;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,124 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __THRIFT_SPEC_H__
+#define __THRIFT_SPEC_H__
+
+#include <runtime/ext/thrift/transport.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * One field of a $_TSPEC array, or the 'key', 'val' or 'elem' spec of a
+ * container field, with everything the codecs look up already pulled out of
+ * the array. key, val and elem are never NULL: a missing spec compiles to an
+ * empty one.
+ */
+class FieldSpec {
+public:
+  static const FieldSpec Empty;
+
+  FieldSpec();
+  ~FieldSpec();
+
+  void compile(CArrRef spec);
+
+  int16 fieldNum;
+  TType type;
+  String name;        // 'var'
+  String className;   // 'class', for T_STRUCT
+  TType ktype;
+  TType vtype;
+  TType etype;
+  const FieldSpec *key;
+  const FieldSpec *val;
+  const FieldSpec *elem;
+
+private:
+  FieldSpec(const FieldSpec &);
+  FieldSpec &operator=(const FieldSpec &);
+};
+
+/**
+ * A struct's $_TSPEC, compiled into a field table: fields in $_TSPEC order
+ * for writing, and a field id index for reading.
+ */
+class StructSpec {
+public:
+  StructSpec(CArrRef spec);
+  ~StructSpec();
+
+  /**
+   * The field with this id, or NULL if the struct has none.
+   */
+  const FieldSpec *field(int64 fieldNum) const {
+    if (fieldNum >= 0 && fieldNum < (int64)m_byId.size()) {
+      return m_byId[fieldNum];
+    }
+    if (m_sparse.empty()) return NULL;
+    std::map<int64, const FieldSpec*>::const_iterator iter =
+      m_sparse.find(fieldNum);
+    return iter == m_sparse.end() ? NULL : iter->second;
+  }
+
+  /**
+   * Fields to write, in $_TSPEC order. When badKey() is true, these are the
+   * ones before the first non-integer key, and writers should fail after
+   * writing them, as they used to when they reached that key.
+   */
+  unsigned int writeCount() const { return m_writeCount; }
+  const FieldSpec &at(unsigned int i) const { return *m_fields[i]; }
+  bool badKey() const { return m_badKey; }
+
+private:
+  static const int64 MaxDenseId = 256;
+
+  std::vector<FieldSpec*> m_fields;
+  std::vector<const FieldSpec*> m_byId;
+  std::map<int64, const FieldSpec*> m_sparse;
+  unsigned int m_writeCount;
+  bool m_badKey;
+
+  StructSpec(const StructSpec &);
+  StructSpec &operator=(const StructSpec &);
+};
+
+/**
+ * Compiled spec of one struct being read or written. The $_TSPEC arrays of
+ * compiled classes are static, so their specs are compiled once and shared
+ * by all threads for the life of the process. Other arrays are compiled once
+ * per request for className, or for this holder only if there is none.
+ */
+class StructSpecHolder {
+public:
+  StructSpecHolder() : m_temp(NULL) {}
+  ~StructSpecHolder() { delete m_temp; }
+
+  const StructSpec &get(CArrRef spec, CStrRef className = null_string);
+
+private:
+  StructSpec *m_temp;
+
+  static ReadWriteMutex s_lock;
+  static hphp_hash_map<const ArrayData*, const StructSpec*,
+                       pointer_hash<ArrayData> > s_specs;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __THRIFT_SPEC_H__
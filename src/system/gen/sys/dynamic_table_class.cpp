@@ -10882,338 +10882,340 @@ static const int64 cpt_static_inits[] = {
   0x0000009500000037,
   (int64)&q_Memcached$$DISTRIBUTION_CONSISTENT,
   0x0000009700000037,
-  (int64)&q_Memcached$$HASH_HSIEH,
+  (int64)&q_Memcached$$SERIALIZER_BINARY,
   0x0000009900000037,
-  (int64)&q_Memcached$$OPT_BINARY_PROTOCOL,
+  (int64)&q_Memcached$$HASH_HSIEH,
   0x0000009b00000037,
-  (int64)&q_Memcached$$RES_UNKNOWN_READ_FAILURE,
+  (int64)&q_Memcached$$OPT_BINARY_PROTOCOL,
   0x0000009d00000037,
-  (int64)&q_Memcached$$RES_NOTFOUND,
+  (int64)&q_Memcached$$RES_UNKNOWN_READ_FAILURE,
   0x0000009f00000037,
-  (int64)&q_Memcached$$RES_PROTOCOL_ERROR,
+  (int64)&q_Memcached$$RES_NOTFOUND,
   0x000000a100000037,
-  (int64)&q_Memcached$$RES_CLIENT_ERROR,
+  (int64)&q_Memcached$$RES_PROTOCOL_ERROR,
   0x000000a300000037,
-  (int64)&q_Memcached$$RES_SERVER_ERROR,
+  (int64)&q_Memcached$$RES_CLIENT_ERROR,
   0x000000a500000037,
-  (int64)&q_Memcached$$HASH_FNV1A_64,
+  (int64)&q_Memcached$$RES_SERVER_ERROR,
   0x000000a700000037,
-  (int64)&q_Memcached$$OPT_CACHE_LOOKUPS,
+  (int64)&q_Memcached$$HASH_FNV1A_64,
   0x000000a900000037,
-  (int64)&q_Memcached$$HASH_FNV1_64,
+  (int64)&q_Memcached$$OPT_CACHE_LOOKUPS,
   0x000000ab00000037,
-  (int64)&q_Memcached$$OPT_SEND_TIMEOUT,
+  (int64)&q_Memcached$$HASH_FNV1_64,
   0x000000ad00000037,
-  (int64)&q_Memcached$$RES_TIMEOUT,
+  (int64)&q_Memcached$$OPT_SEND_TIMEOUT,
   0x000000af00000037,
-  (int64)&q_Memcached$$RES_BAD_KEY_PROVIDED,
+  (int64)&q_Memcached$$RES_TIMEOUT,
   0x000000b100000037,
-  (int64)&q_Memcached$$RES_SOME_ERRORS,
+  (int64)&q_Memcached$$RES_BAD_KEY_PROVIDED,
   0x000000b300000037,
-  (int64)&q_Memcached$$OPT_SOCKET_SEND_SIZE,
+  (int64)&q_Memcached$$RES_SOME_ERRORS,
   0x000000b500000037,
-  (int64)&q_Memcached$$OPT_COMPRESSION,
+  (int64)&q_Memcached$$OPT_SOCKET_SEND_SIZE,
   0x000000b700000037,
-  (int64)&q_Memcached$$SERIALIZER_PHP,
+  (int64)&q_Memcached$$OPT_COMPRESSION,
   0x000000b900000037,
-  (int64)&q_Memcached$$OPT_RETRY_TIMEOUT,
+  (int64)&q_Memcached$$SERIALIZER_PHP,
   0x000000bb00000037,
+  (int64)&q_Memcached$$OPT_RETRY_TIMEOUT,
+  0x000000bd00000037,
   (int64)&q_Memcached$$HAVE_JSON,
-  0x000000bd00000027,
+  0x000000bf00000027,
   (int64)&q_Memcached$$SERIALIZER_JSON,
-  0x000000bf00000037,
-  (int64)&q_Memcached$$SERIALIZER_IGBINARY,
   0x000000c100000037,
-  (int64)&q_Memcached$$OPT_NO_BLOCK,
+  (int64)&q_Memcached$$SERIALIZER_IGBINARY,
   0x000000c300000037,
-  (int64)&q_Memcached$$DISTRIBUTION_MODULA,
+  (int64)&q_Memcached$$OPT_NO_BLOCK,
   0x000000c500000037,
-  (int64)&q_Memcached$$HASH_CRC,
+  (int64)&q_Memcached$$DISTRIBUTION_MODULA,
   0x000000c700000037,
-  (int64)&q_Memcached$$RES_WRITE_FAILURE,
+  (int64)&q_Memcached$$HASH_CRC,
   0x000000c900000037,
-  (int64)&q_Memcached$$HASH_FNV1_32,
+  (int64)&q_Memcached$$RES_WRITE_FAILURE,
   0x000000cb00000037,
-  (int64)&q_Memcached$$OPT_SOCKET_RECV_SIZE,
+  (int64)&q_Memcached$$HASH_FNV1_32,
   0x000000cd00000037,
-  (int64)&q_Memcached$$OPT_POLL_TIMEOUT,
+  (int64)&q_Memcached$$OPT_SOCKET_RECV_SIZE,
   0x000000cf00000037,
-  (int64)&q_Memcached$$OPT_DISTRIBUTION,
+  (int64)&q_Memcached$$OPT_POLL_TIMEOUT,
   0x000000d100000037,
-  (int64)&q_Memcached$$RES_CONNECTION_SOCKET_CREATE_FAILURE,
+  (int64)&q_Memcached$$OPT_DISTRIBUTION,
   0x000000d300000037,
-  (int64)&q_Memcached$$OPT_RECV_TIMEOUT,
+  (int64)&q_Memcached$$RES_CONNECTION_SOCKET_CREATE_FAILURE,
   0x000000d500000037,
-  (int64)&q_Memcached$$GET_PRESERVE_ORDER,
+  (int64)&q_Memcached$$OPT_RECV_TIMEOUT,
   0x000000d700000037,
-  (int64)&q_Memcached$$HASH_DEFAULT,
+  (int64)&q_Memcached$$GET_PRESERVE_ORDER,
   0x000000d900000037,
-  (int64)&q_Memcached$$OPT_BUFFER_WRITES,
+  (int64)&q_Memcached$$HASH_DEFAULT,
   0x000000db00000037,
-  (int64)&q_Memcached$$HASH_FNV1A_32,
+  (int64)&q_Memcached$$OPT_BUFFER_WRITES,
   0x000000dd00000037,
-  (int64)&q_Memcached$$RES_HOST_LOOKUP_FAILURE,
+  (int64)&q_Memcached$$HASH_FNV1A_32,
   0x000000df00000037,
-  (int64)&q_Memcached$$RES_DATA_EXISTS,
+  (int64)&q_Memcached$$RES_HOST_LOOKUP_FAILURE,
   0x000000e100000037,
-  (int64)&q_Memcached$$RES_NOTSTORED,
+  (int64)&q_Memcached$$RES_DATA_EXISTS,
   0x000000e300000037,
-  (int64)&q_Memcached$$HASH_MD5,
+  (int64)&q_Memcached$$RES_NOTSTORED,
   0x000000e500000037,
-  (int64)&q_Memcached$$RES_END,
+  (int64)&q_Memcached$$HASH_MD5,
   0x000000e700000037,
-  (int64)&q_Memcached$$OPT_SERIALIZER,
+  (int64)&q_Memcached$$RES_END,
   0x000000e900000037,
-  (int64)&q_Memcached$$RES_FAILURE,
+  (int64)&q_Memcached$$OPT_SERIALIZER,
   0x000000eb00000037,
+  (int64)&q_Memcached$$RES_FAILURE,
+  0x000000ed00000037,
   (int64)&q_Memcached$$HAVE_IGBINARY,
-  0x000000ed00000027,
+  0x000000ef00000027,
   (int64)&q_Memcached$$OPT_CONNECT_TIMEOUT,
-  0x000000ef00000037,
-  (int64)&q_Memcached$$RES_PARTIAL_READ,
   0x000000f100000037,
-  (int64)&q_Memcached$$HASH_MURMUR,
+  (int64)&q_Memcached$$RES_PARTIAL_READ,
   0x000000f300000037,
-  (int64)&q_Memcached$$RES_PAYLOAD_FAILURE,
+  (int64)&q_Memcached$$HASH_MURMUR,
   0x000000f500000037,
+  (int64)&q_Memcached$$RES_PAYLOAD_FAILURE,
+  0x000000f700000037,
   (int64)&q_Normalizer$$FORM_KD,
-  0x000000f700000047,
-  (int64)&q_Normalizer$$FORM_KC,
   0x000000f900000047,
-  (int64)&q_Normalizer$$NFKC,
+  (int64)&q_Normalizer$$FORM_KC,
   0x000000fb00000047,
-  (int64)&q_Normalizer$$FORM_D,
+  (int64)&q_Normalizer$$NFKC,
   0x000000fd00000047,
-  (int64)&q_Normalizer$$NFC,
+  (int64)&q_Normalizer$$FORM_D,
   0x000000ff00000047,
-  (int64)&q_Normalizer$$NFD,
+  (int64)&q_Normalizer$$NFC,
   0x0000010100000047,
-  (int64)&q_Normalizer$$NFKD,
+  (int64)&q_Normalizer$$NFD,
   0x0000010300000047,
-  (int64)&q_Normalizer$$NONE,
+  (int64)&q_Normalizer$$NFKD,
   0x0000010500000047,
-  (int64)&q_Normalizer$$FORM_C,
+  (int64)&q_Normalizer$$NONE,
   0x0000010700000047,
-  (int64)&q_PDO$$ATTR_CASE,
+  (int64)&q_Normalizer$$FORM_C,
   0x0000010900000047,
-  (int64)&q_PDO$$ATTR_STATEMENT_CLASS,
+  (int64)&q_PDO$$ATTR_CASE,
   0x0000010b00000047,
-  (int64)&q_PDO$$ERRMODE_EXCEPTION,
+  (int64)&q_PDO$$ATTR_STATEMENT_CLASS,
   0x0000010d00000047,
-  (int64)&q_PDO$$CASE_NATURAL,
+  (int64)&q_PDO$$ERRMODE_EXCEPTION,
   0x0000010f00000047,
-  (int64)&q_PDO$$FETCH_OBJ,
+  (int64)&q_PDO$$CASE_NATURAL,
   0x0000011100000047,
-  (int64)&q_PDO$$FETCH_INTO,
+  (int64)&q_PDO$$FETCH_OBJ,
   0x0000011300000047,
-  (int64)&q_PDO$$FETCH_BOUND,
+  (int64)&q_PDO$$FETCH_INTO,
   0x0000011500000047,
-  (int64)&q_PDO$$MYSQL_ATTR_INIT_COMMAND,
+  (int64)&q_PDO$$FETCH_BOUND,
   0x0000011700000047,
-  (int64)&q_PDO$$ATTR_CLIENT_VERSION,
+  (int64)&q_PDO$$MYSQL_ATTR_INIT_COMMAND,
   0x0000011900000047,
-  (int64)&q_PDO$$ATTR_FETCH_CATALOG_NAMES,
+  (int64)&q_PDO$$ATTR_CLIENT_VERSION,
   0x0000011b00000047,
-  (int64)&q_PDO$$CASE_LOWER,
+  (int64)&q_PDO$$ATTR_FETCH_CATALOG_NAMES,
   0x0000011d00000047,
-  (int64)&q_PDO$$FETCH_GROUP,
+  (int64)&q_PDO$$CASE_LOWER,
   0x0000011f00000047,
-  (int64)&q_PDO$$CASE_UPPER,
+  (int64)&q_PDO$$FETCH_GROUP,
   0x0000012100000047,
-  (int64)&q_PDO$$PARAM_EVT_FETCH_POST,
+  (int64)&q_PDO$$CASE_UPPER,
   0x0000012300000047,
-  (int64)&q_PDO$$ATTR_TIMEOUT,
+  (int64)&q_PDO$$PARAM_EVT_FETCH_POST,
   0x0000012500000047,
-  (int64)&q_PDO$$PARAM_EVT_EXEC_PRE,
+  (int64)&q_PDO$$ATTR_TIMEOUT,
   0x0000012700000047,
-  (int64)&q_PDO$$ATTR_ERRMODE,
+  (int64)&q_PDO$$PARAM_EVT_EXEC_PRE,
   0x0000012900000047,
-  (int64)&q_PDO$$ATTR_DEFAULT_FETCH_MODE,
+  (int64)&q_PDO$$ATTR_ERRMODE,
   0x0000012b00000047,
-  (int64)&q_PDO$$ATTR_EMULATE_PREPARES,
+  (int64)&q_PDO$$ATTR_DEFAULT_FETCH_MODE,
   0x0000012d00000047,
-  (int64)&q_PDO$$ATTR_PREFETCH,
+  (int64)&q_PDO$$ATTR_EMULATE_PREPARES,
   0x0000012f00000047,
-  (int64)&q_PDO$$FETCH_UNIQUE,
+  (int64)&q_PDO$$ATTR_PREFETCH,
   0x0000013100000047,
-  (int64)&q_PDO$$MYSQL_ATTR_READ_DEFAULT_GROUP,
+  (int64)&q_PDO$$FETCH_UNIQUE,
   0x0000013300000047,
-  (int64)&q_PDO$$ATTR_SERVER_INFO,
+  (int64)&q_PDO$$MYSQL_ATTR_READ_DEFAULT_GROUP,
   0x0000013500000047,
-  (int64)&q_PDO$$PARAM_EVT_NORMALIZE,
+  (int64)&q_PDO$$ATTR_SERVER_INFO,
   0x0000013700000047,
-  (int64)&q_PDO$$ATTR_CONNECTION_STATUS,
+  (int64)&q_PDO$$PARAM_EVT_NORMALIZE,
   0x0000013900000047,
-  (int64)&q_PDO$$ATTR_ORACLE_NULLS,
+  (int64)&q_PDO$$ATTR_CONNECTION_STATUS,
   0x0000013b00000047,
-  (int64)&q_PDO$$MYSQL_ATTR_FOUND_ROWS,
+  (int64)&q_PDO$$ATTR_ORACLE_NULLS,
   0x0000013d00000047,
-  (int64)&q_PDO$$FETCH_ORI_NEXT,
+  (int64)&q_PDO$$MYSQL_ATTR_FOUND_ROWS,
   0x0000013f00000047,
-  (int64)&q_PDO$$ATTR_FETCH_TABLE_NAMES,
+  (int64)&q_PDO$$FETCH_ORI_NEXT,
   0x0000014100000047,
-  (int64)&q_PDO$$FETCH_ORI_REL,
+  (int64)&q_PDO$$ATTR_FETCH_TABLE_NAMES,
   0x0000014300000047,
-  (int64)&q_PDO$$FETCH_ASSOC,
+  (int64)&q_PDO$$FETCH_ORI_REL,
   0x0000014500000047,
-  (int64)&q_PDO$$ATTR_CURSOR_NAME,
+  (int64)&q_PDO$$FETCH_ASSOC,
   0x0000014700000047,
-  (int64)&q_PDO$$ATTR_MAX_COLUMN_LEN,
+  (int64)&q_PDO$$ATTR_CURSOR_NAME,
   0x0000014900000047,
-  (int64)&q_PDO$$ATTR_AUTOCOMMIT,
+  (int64)&q_PDO$$ATTR_MAX_COLUMN_LEN,
   0x0000014b00000047,
-  (int64)&q_PDO$$PARAM_NULL,
+  (int64)&q_PDO$$ATTR_AUTOCOMMIT,
   0x0000014d00000047,
-  (int64)&q_PDO$$PARAM_EVT_ALLOC,
+  (int64)&q_PDO$$PARAM_NULL,
   0x0000014f00000047,
-  (int64)&q_PDO$$PARAM_BOOL,
+  (int64)&q_PDO$$PARAM_EVT_ALLOC,
   0x0000015100000047,
-  (int64)&q_PDO$$NULL_NATURAL,
+  (int64)&q_PDO$$PARAM_BOOL,
   0x0000015300000047,
-  (int64)&q_PDO$$PARAM_INT,
+  (int64)&q_PDO$$NULL_NATURAL,
   0x0000015500000047,
-  (int64)&q_PDO$$FETCH_NUM,
+  (int64)&q_PDO$$PARAM_INT,
   0x0000015700000047,
-  (int64)&q_PDO$$FETCH_ORI_PRIOR,
+  (int64)&q_PDO$$FETCH_NUM,
   0x0000015900000047,
-  (int64)&q_PDO$$PARAM_EVT_EXEC_POST,
+  (int64)&q_PDO$$FETCH_ORI_PRIOR,
   0x0000015b00000047,
-  (int64)&q_PDO$$MYSQL_ATTR_USE_BUFFERED_QUERY,
+  (int64)&q_PDO$$PARAM_EVT_EXEC_POST,
   0x0000015d00000047,
-  (int64)&q_PDO$$PARAM_STR,
+  (int64)&q_PDO$$MYSQL_ATTR_USE_BUFFERED_QUERY,
   0x0000015f00000047,
-  (int64)&q_PDO$$ATTR_CURSOR,
+  (int64)&q_PDO$$PARAM_STR,
   0x0000016100000047,
-  (int64)&q_PDO$$ATTR_DRIVER_NAME,
+  (int64)&q_PDO$$ATTR_CURSOR,
   0x0000016300000047,
-  (int64)&q_PDO$$FETCH_USE_DEFAULT,
+  (int64)&q_PDO$$ATTR_DRIVER_NAME,
   0x0000016500000047,
-  (int64)&q_PDO$$ATTR_SERVER_VERSION,
+  (int64)&q_PDO$$FETCH_USE_DEFAULT,
   0x0000016700000047,
-  (int64)&q_PDO$$MYSQL_ATTR_DIRECT_QUERY,
+  (int64)&q_PDO$$ATTR_SERVER_VERSION,
   0x0000016900000047,
-  (int64)&q_PDO$$FETCH_PROPS_LATE,
+  (int64)&q_PDO$$MYSQL_ATTR_DIRECT_QUERY,
   0x0000016b00000047,
-  (int64)&q_PDO$$FETCH_COLUMN,
+  (int64)&q_PDO$$FETCH_PROPS_LATE,
   0x0000016d00000047,
-  (int64)&q_PDO$$FETCH_CLASSTYPE,
+  (int64)&q_PDO$$FETCH_COLUMN,
   0x0000016f00000047,
-  (int64)&q_PDO$$FETCH_SERIALIZE,
+  (int64)&q_PDO$$FETCH_CLASSTYPE,
   0x0000017100000047,
-  (int64)&q_PDO$$MYSQL_ATTR_LOCAL_INFILE,
+  (int64)&q_PDO$$FETCH_SERIALIZE,
   0x0000017300000047,
-  (int64)&q_PDO$$FETCH_BOTH,
+  (int64)&q_PDO$$MYSQL_ATTR_LOCAL_INFILE,
   0x0000017500000047,
-  (int64)&q_PDO$$FETCH_KEY_PAIR,
+  (int64)&q_PDO$$FETCH_BOTH,
   0x0000017700000047,
-  (int64)&q_PDO$$PARAM_EVT_FETCH_PRE,
+  (int64)&q_PDO$$FETCH_KEY_PAIR,
   0x0000017900000047,
-  (int64)&q_PDO$$CURSOR_FWDONLY,
+  (int64)&q_PDO$$PARAM_EVT_FETCH_PRE,
   0x0000017b00000047,
-  (int64)&q_PDO$$FETCH_ORI_FIRST,
+  (int64)&q_PDO$$CURSOR_FWDONLY,
   0x0000017d00000047,
-  (int64)&q_PDO$$CURSOR_SCROLL,
+  (int64)&q_PDO$$FETCH_ORI_FIRST,
   0x0000017f00000047,
-  (int64)&q_PDO$$FETCH_ORI_LAST,
+  (int64)&q_PDO$$CURSOR_SCROLL,
   0x0000018100000047,
-  (int64)&q_PDO$$ATTR_PERSISTENT,
+  (int64)&q_PDO$$FETCH_ORI_LAST,
   0x0000018300000047,
-  (int64)&q_PDO$$NULL_EMPTY_STRING,
+  (int64)&q_PDO$$ATTR_PERSISTENT,
   0x0000018500000047,
-  (int64)&q_PDO$$ATTR_STRINGIFY_FETCHES,
+  (int64)&q_PDO$$NULL_EMPTY_STRING,
   0x0000018700000047,
-  (int64)&q_PDO$$MYSQL_ATTR_READ_DEFAULT_FILE,
+  (int64)&q_PDO$$ATTR_STRINGIFY_FETCHES,
   0x0000018900000047,
-  (int64)&q_PDO$$FETCH_FUNC,
+  (int64)&q_PDO$$MYSQL_ATTR_READ_DEFAULT_FILE,
   0x0000018b00000047,
-  (int64)&q_PDO$$FETCH_ORI_ABS,
+  (int64)&q_PDO$$FETCH_FUNC,
   0x0000018d00000047,
-  (int64)&q_PDO$$NULL_TO_STRING,
+  (int64)&q_PDO$$FETCH_ORI_ABS,
   0x0000018f00000047,
-  (int64)&q_PDO$$MYSQL_ATTR_MAX_BUFFER_SIZE,
+  (int64)&q_PDO$$NULL_TO_STRING,
   0x0000019100000047,
-  (int64)&q_PDO$$FETCH_CLASS,
+  (int64)&q_PDO$$MYSQL_ATTR_MAX_BUFFER_SIZE,
   0x0000019300000047,
-  (int64)&q_PDO$$FETCH_LAZY,
+  (int64)&q_PDO$$FETCH_CLASS,
   0x0000019500000047,
-  (int64)&q_PDO$$MYSQL_ATTR_COMPRESS,
+  (int64)&q_PDO$$FETCH_LAZY,
   0x0000019700000047,
-  (int64)&q_PDO$$ERRMODE_WARNING,
+  (int64)&q_PDO$$MYSQL_ATTR_COMPRESS,
   0x0000019900000047,
-  (int64)&q_PDO$$ERRMODE_SILENT,
+  (int64)&q_PDO$$ERRMODE_WARNING,
   0x0000019b00000047,
+  (int64)&q_PDO$$ERRMODE_SILENT,
+  0x0000019d00000047,
   (int64)&q_PDO$$ERR_NONE,
-  0x0000019d00000077,
+  0x0000019f00000077,
   (int64)&q_PDO$$PARAM_LOB,
-  0x0000019f00000047,
-  (int64)&q_PDO$$FETCH_NAMED,
   0x000001a100000047,
-  (int64)&q_PDO$$PARAM_INPUT_OUTPUT,
+  (int64)&q_PDO$$FETCH_NAMED,
   0x000001a300000047,
-  (int64)&q_PDO$$MYSQL_ATTR_IGNORE_SPACE,
+  (int64)&q_PDO$$PARAM_INPUT_OUTPUT,
   0x000001a500000047,
-  (int64)&q_PDO$$PARAM_STMT,
+  (int64)&q_PDO$$MYSQL_ATTR_IGNORE_SPACE,
   0x000001a700000047,
-  (int64)&q_PDO$$PARAM_EVT_FREE,
+  (int64)&q_PDO$$PARAM_STMT,
   0x000001a900000047,
+  (int64)&q_PDO$$PARAM_EVT_FREE,
+  0x000001ab00000047,
   (int64)&q_SpoofChecker$$SINGLE_SCRIPT_CONFUSABLE,
-  0x000001ab00000037,
-  (int64)&q_SpoofChecker$$WHOLE_SCRIPT_CONFUSABLE,
   0x000001ad00000037,
-  (int64)&q_SpoofChecker$$CHAR_LIMIT,
+  (int64)&q_SpoofChecker$$WHOLE_SCRIPT_CONFUSABLE,
   0x000001af00000037,
-  (int64)&q_SpoofChecker$$INVISIBLE,
+  (int64)&q_SpoofChecker$$CHAR_LIMIT,
   0x000001b100000037,
-  (int64)&q_SpoofChecker$$SINGLE_SCRIPT,
+  (int64)&q_SpoofChecker$$INVISIBLE,
   0x000001b300000037,
-  (int64)&q_SpoofChecker$$ANY_CASE,
+  (int64)&q_SpoofChecker$$SINGLE_SCRIPT,
   0x000001b500000037,
-  (int64)&q_SpoofChecker$$MIXED_SCRIPT_CONFUSABLE,
+  (int64)&q_SpoofChecker$$ANY_CASE,
   0x000001b700000037,
+  (int64)&q_SpoofChecker$$MIXED_SCRIPT_CONFUSABLE,
+  0x000001b900000037,
   (int64)&q_XMLReader$$DOC_FRAGMENT,
-  0x000001b900000047,
-  (int64)&q_XMLReader$$NOTATION,
   0x000001bb00000047,
-  (int64)&q_XMLReader$$COMMENT,
+  (int64)&q_XMLReader$$NOTATION,
   0x000001bd00000047,
-  (int64)&q_XMLReader$$ELEMENT,
+  (int64)&q_XMLReader$$COMMENT,
   0x000001bf00000047,
-  (int64)&q_XMLReader$$SUBST_ENTITIES,
+  (int64)&q_XMLReader$$ELEMENT,
   0x000001c100000047,
-  (int64)&q_XMLReader$$DEFAULTATTRS,
+  (int64)&q_XMLReader$$SUBST_ENTITIES,
   0x000001c300000047,
-  (int64)&q_XMLReader$$CDATA,
+  (int64)&q_XMLReader$$DEFAULTATTRS,
   0x000001c500000047,
-  (int64)&q_XMLReader$$LOADDTD,
+  (int64)&q_XMLReader$$CDATA,
   0x000001c700000047,
-  (int64)&q_XMLReader$$TEXT,
+  (int64)&q_XMLReader$$LOADDTD,
   0x000001c900000047,
-  (int64)&q_XMLReader$$WHITESPACE,
+  (int64)&q_XMLReader$$TEXT,
   0x000001cb00000047,
-  (int64)&q_XMLReader$$DOC_TYPE,
+  (int64)&q_XMLReader$$WHITESPACE,
   0x000001cd00000047,
-  (int64)&q_XMLReader$$SIGNIFICANT_WHITESPACE,
+  (int64)&q_XMLReader$$DOC_TYPE,
   0x000001cf00000047,
-  (int64)&q_XMLReader$$PI,
+  (int64)&q_XMLReader$$SIGNIFICANT_WHITESPACE,
   0x000001d100000047,
-  (int64)&q_XMLReader$$DOC,
+  (int64)&q_XMLReader$$PI,
   0x000001d300000047,
-  (int64)&q_XMLReader$$ENTITY,
+  (int64)&q_XMLReader$$DOC,
   0x000001d500000047,
-  (int64)&q_XMLReader$$END_ELEMENT,
+  (int64)&q_XMLReader$$ENTITY,
   0x000001d700000047,
-  (int64)&q_XMLReader$$XML_DECLARATION,
+  (int64)&q_XMLReader$$END_ELEMENT,
   0x000001d900000047,
-  (int64)&q_XMLReader$$NONE,
+  (int64)&q_XMLReader$$XML_DECLARATION,
   0x000001db00000047,
-  (int64)&q_XMLReader$$END_ENTITY,
+  (int64)&q_XMLReader$$NONE,
   0x000001dd00000047,
-  (int64)&q_XMLReader$$ATTRIBUTE,
+  (int64)&q_XMLReader$$END_ENTITY,
   0x000001df00000047,
-  (int64)&q_XMLReader$$VALIDATE,
+  (int64)&q_XMLReader$$ATTRIBUTE,
   0x000001e100000047,
-  (int64)&q_XMLReader$$ENTITY_REF,
+  (int64)&q_XMLReader$$VALIDATE,
   0x000001e300000047,
+  (int64)&q_XMLReader$$ENTITY_REF,
+  0x000001e500000047,
 };
 static const ClassPropTableEntry cpt_table_entries[] = {
   {0x44D1DA387595A403LL,5,1,0,36,4,0,&NAMSTR(s_sys_ss7595a403, "SORT_REGULAR") },
@@ -11302,185 +11304,186 @@ static const ClassPropTableEntry cpt_table_entries[] = {
   {0x78695696B47AF8CDLL,-1,132,0,100,4,0,&NAMSTR(s_sys_ssb47af8cd, "ACTUAL_LOCALE") },
 
   {0x2CCABB2638D29583LL,2,134,0,100,3,0,&NAMSTR(s_sys_ss38d29583, "RES_ERRNO") },
-  {0x6AF4D4CD7B6B9E85LL,23,136,0,100,3,0,&NAMSTR(s_sys_ss7b6b9e85, "OPT_TCP_NODELAY") },
-  {0x1FBB5AC58A77E707LL,19,138,0,100,3,0,&NAMSTR(s_sys_ss8a77e707, "RES_BUFFERED") },
-  {0x261AB88649B2E58ALL,49,140,0,36,3,0,&NAMSTR(s_sys_ss49b2e58a, "OPT_SERVER_FAILURE_LIMIT") },
-  {0x2072FB05B0D6540ALL,45,142,0,100,3,0,&NAMSTR(s_sys_ssb0d6540a, "RES_NO_SERVERS") },
-  {0x5EC3EFCB1563B68DLL,38,144,0,36,3,0,&NAMSTR(s_sys_ss1563b68d, "OPT_LIBKETAMA_COMPATIBLE") },
-  {0x0C53D08ECD9ACC0DLL,45,146,0,100,3,0,&NAMSTR(s_sys_sscd9acc0d, "RES_SUCCESS") },
+  {0x6AF4D4CD7B6B9E85LL,24,136,0,100,3,0,&NAMSTR(s_sys_ss7b6b9e85, "OPT_TCP_NODELAY") },
+  {0x1FBB5AC58A77E707LL,20,138,0,100,3,0,&NAMSTR(s_sys_ss8a77e707, "RES_BUFFERED") },
+  {0x261AB88649B2E58ALL,50,140,0,36,3,0,&NAMSTR(s_sys_ss49b2e58a, "OPT_SERVER_FAILURE_LIMIT") },
+  {0x2072FB05B0D6540ALL,46,142,0,100,3,0,&NAMSTR(s_sys_ssb0d6540a, "RES_NO_SERVERS") },
+  {0x5EC3EFCB1563B68DLL,39,144,0,36,3,0,&NAMSTR(s_sys_ss1563b68d, "OPT_LIBKETAMA_COMPATIBLE") },
+  {0x0C53D08ECD9ACC0DLL,46,146,0,100,3,0,&NAMSTR(s_sys_sscd9acc0d, "RES_SUCCESS") },
   {0x7071566611A71D96LL,1,148,0,36,3,0,&NAMSTR(s_sys_ss11a71d96, "OPT_PREFIX_KEY") },
-  {0x425EDC08E649F716LL,34,150,0,100,3,0,&NAMSTR(s_sys_sse649f716, "OPT_HASH") },
+  {0x425EDC08E649F716LL,35,150,0,100,3,0,&NAMSTR(s_sys_sse649f716, "OPT_HASH") },
   {0x64B6C925C7A41498LL,-4,152,0,100,3,0,&NAMSTR(s_sys_ssc7a41498, "DISTRIBUTION_CONSISTENT") },
-  {0x200711C7E62DFB1CLL,45,154,0,36,3,0,&NAMSTR(s_sys_sse62dfb1c, "HASH_HSIEH") },
-  {0x6B8DE2AA09E1749CLL,20,156,0,36,3,0,&NAMSTR(s_sys_ss09e1749c, "OPT_BINARY_PROTOCOL") },
-  {0x47FC6D6596D2411CLL,2,158,0,100,3,0,&NAMSTR(s_sys_ss96d2411c, "RES_UNKNOWN_READ_FAILURE") },
-  {0x6364909F8AA5869DLL,41,160,0,100,3,0,&NAMSTR(s_sys_ss8aa5869d, "RES_NOTFOUND") },
-  {0x56E8EF0A2966E7A2LL,1,162,0,36,3,0,&NAMSTR(s_sys_ss2966e7a2, "RES_PROTOCOL_ERROR") },
-  {0x4A25210D326D0922LL,1,164,0,100,3,0,&NAMSTR(s_sys_ss326d0922, "RES_CLIENT_ERROR") },
-  {0x2B230612FB5D80A3LL,18,166,0,100,3,0,&NAMSTR(s_sys_ssfb5d80a3, "RES_SERVER_ERROR") },
-  {0x49D8D4184B78B3A5LL,18,168,0,100,3,0,&NAMSTR(s_sys_ssbe91a4e3, "HASH_FNV1A_64") },
-  {0x6808EBB81DDE422FLL,-15,170,0,100,3,0,&NAMSTR(s_sys_ss1dde422f, "OPT_CACHE_LOOKUPS") },
-  {0x3A7E842A627341B2LL,-2,172,0,100,3,0,&NAMSTR(s_sys_ss5769d4fd, "HASH_FNV1_64") },
-  {0x56895500D1F05334LL,20,174,0,100,3,0,&NAMSTR(s_sys_ssd1f05334, "OPT_SEND_TIMEOUT") },
-  {0x6BC90BF53C6E7CC3LL,1,176,0,36,3,0,&NAMSTR(s_sys_ss3c6e7cc3, "RES_TIMEOUT") },
-  {0x4155BF3DCFA655C3LL,17,178,0,100,3,0,&NAMSTR(s_sys_sscfa655c3, "RES_BAD_KEY_PROVIDED") },
-  {0x490A114712BBA544LL,-19,180,0,100,3,0,&NAMSTR(s_sys_ss12bba544, "RES_SOME_ERRORS") },
-  {0x68724938D592E4C6LL,12,182,0,100,3,0,&NAMSTR(s_sys_ssd592e4c6, "OPT_SOCKET_SEND_SIZE") },
-  {0x073E4D38138A7DC7LL,25,184,0,100,3,0,&NAMSTR(s_sys_ss138a7dc7, "OPT_COMPRESSION") },
-  {0x7B91B2E2CC4DE648LL,4,186,0,100,3,0,&NAMSTR(s_sys_sscc4de648, "SERIALIZER_PHP") },
-  {0x138CD297B9FD244BLL,-7,188,0,100,3,0,&NAMSTR(s_sys_ssb9fd244b, "OPT_RETRY_TIMEOUT") },
-  {0x74824687F4C8D7CELL,13,190,0,100,2,0,&NAMSTR(s_sys_ssf4c8d7ce, "HAVE_JSON") },
-  {0x7AC058297870C1D0LL,-22,192,0,100,3,0,&NAMSTR(s_sys_ss7870c1d0, "SERIALIZER_JSON") },
-  {0x2B4E411F0C7596D1LL,-1,194,0,36,3,0,&NAMSTR(s_sys_ss0c7596d1, "SERIALIZER_IGBINARY") },
-  {0x1E8ABFABE00D2651LL,-30,196,0,100,3,0,&NAMSTR(s_sys_sse00d2651, "OPT_NO_BLOCK") },
-  {0x49856B6165627AD4LL,-23,198,0,100,3,0,&NAMSTR(s_sys_ss65627ad4, "DISTRIBUTION_MODULA") },
-  {0x02FAAD1AB87BA2D5LL,-14,200,0,36,3,0,&NAMSTR(s_sys_ssb87ba2d5, "HASH_CRC") },
-  {0x1045EAC17F112855LL,12,202,0,100,3,0,&NAMSTR(s_sys_ss7f112855, "RES_WRITE_FAILURE") },
-  {0x3A3731492FB1B557LL,9,204,0,36,3,0,&NAMSTR(s_sys_ss2bfdc708, "HASH_FNV1_32") },
-  {0x345B7B934684B3D7LL,17,206,0,100,3,0,&NAMSTR(s_sys_ss4684b3d7, "OPT_SOCKET_RECV_SIZE") },
-  {0x296424A39A9F1AD8LL,-19,208,0,100,3,0,&NAMSTR(s_sys_ss9a9f1ad8, "OPT_POLL_TIMEOUT") },
-  {0x3DD14F50C65BCDDBLL,-6,210,0,36,3,0,&NAMSTR(s_sys_ssc65bcddb, "OPT_DISTRIBUTION") },
-  {0x0224412EA957C9DBLL,17,212,0,100,3,0,&NAMSTR(s_sys_ssa957c9db, "RES_CONNECTION_SOCKET_CREATE_FAILURE") },
-  {0x6460D48B93209DDELL,-3,214,0,100,3,0,&NAMSTR(s_sys_ss93209dde, "OPT_RECV_TIMEOUT") },
-  {0x68D025242664C361LL,-35,216,0,100,3,0,&NAMSTR(s_sys_ss2664c361, "GET_PRESERVE_ORDER") },
-  {0x53A1149CE01E8C64LL,6,218,0,100,3,0,&NAMSTR(s_sys_sse01e8c64, "HASH_DEFAULT") },
-  {0x76B0604A2B4408EBLL,-32,220,0,100,3,0,&NAMSTR(s_sys_ss2b4408eb, "OPT_BUFFER_WRITES") },
-  {0x3C4C4E1BC9DFDCECLL,-34,222,0,36,3,0,&NAMSTR(s_sys_ss08c5e518, "HASH_FNV1A_32") },
-  {0x4197FC89C9F88DECLL,-33,224,0,100,3,0,&NAMSTR(s_sys_ssc9f88dec, "RES_HOST_LOOKUP_FAILURE") },
-  {0x56C85759C5701DEDLL,1,226,0,100,3,0,&NAMSTR(s_sys_ssc5701ded, "RES_DATA_EXISTS") },
-  {0x153143A96D687E6ELL,-34,228,0,100,3,0,&NAMSTR(s_sys_ss6d687e6e, "RES_NOTSTORED") },
-  {0x2BB4CFA54A5085F0LL,-15,230,0,100,3,0,&NAMSTR(s_sys_ssfe91db32, "HASH_MD5") },
-  {0x74109B06DAD2F9F1LL,-49,232,0,100,3,0,&NAMSTR(s_sys_ssdad2f9f1, "RES_END") },
-  {0x73ABA23A4A0C5D74LL,-24,234,0,100,3,0,&NAMSTR(s_sys_ss4a0c5d74, "OPT_SERIALIZER") },
-  {0x460A66958F0524F8LL,-6,236,0,100,3,0,&NAMSTR(s_sys_ss8f0524f8, "RES_FAILURE") },
-  {0x1C014F2A2E707EF9LL,-24,238,0,100,2,0,&NAMSTR(s_sys_ss2e707ef9, "HAVE_IGBINARY") },
-  {0x0443DA24DAD42EFBLL,-26,240,0,36,3,0,&NAMSTR(s_sys_ssdad42efb, "OPT_CONNECT_TIMEOUT") },
-  {0x35B252ECC21E5F7BLL,-31,242,0,100,3,0,&NAMSTR(s_sys_ssc21e5f7b, "RES_PARTIAL_READ") },
-  {0x7A68C36A2F5D27FELL,-17,244,0,100,3,0,&NAMSTR(s_sys_ss2f5d27fe, "HASH_MURMUR") },
-  {0x6948F797B210F37FLL,0,246,0,100,3,0,&NAMSTR(s_sys_ssb210f37f, "RES_PAYLOAD_FAILURE") },
+  {0x45158C5784B98919LL,-3,154,0,100,3,0,&NAMSTR(s_sys_ss84b98919, "SERIALIZER_BINARY") },
+  {0x200711C7E62DFB1CLL,45,156,0,36,3,0,&NAMSTR(s_sys_sse62dfb1c, "HASH_HSIEH") },
+  {0x6B8DE2AA09E1749CLL,20,158,0,36,3,0,&NAMSTR(s_sys_ss09e1749c, "OPT_BINARY_PROTOCOL") },
+  {0x47FC6D6596D2411CLL,2,160,0,100,3,0,&NAMSTR(s_sys_ss96d2411c, "RES_UNKNOWN_READ_FAILURE") },
+  {0x6364909F8AA5869DLL,41,162,0,100,3,0,&NAMSTR(s_sys_ss8aa5869d, "RES_NOTFOUND") },
+  {0x56E8EF0A2966E7A2LL,1,164,0,36,3,0,&NAMSTR(s_sys_ss2966e7a2, "RES_PROTOCOL_ERROR") },
+  {0x4A25210D326D0922LL,1,166,0,100,3,0,&NAMSTR(s_sys_ss326d0922, "RES_CLIENT_ERROR") },
+  {0x2B230612FB5D80A3LL,18,168,0,100,3,0,&NAMSTR(s_sys_ssfb5d80a3, "RES_SERVER_ERROR") },
+  {0x49D8D4184B78B3A5LL,18,170,0,100,3,0,&NAMSTR(s_sys_ssbe91a4e3, "HASH_FNV1A_64") },
+  {0x6808EBB81DDE422FLL,-16,172,0,100,3,0,&NAMSTR(s_sys_ss1dde422f, "OPT_CACHE_LOOKUPS") },
+  {0x3A7E842A627341B2LL,-2,174,0,100,3,0,&NAMSTR(s_sys_ss5769d4fd, "HASH_FNV1_64") },
+  {0x56895500D1F05334LL,20,176,0,100,3,0,&NAMSTR(s_sys_ssd1f05334, "OPT_SEND_TIMEOUT") },
+  {0x6BC90BF53C6E7CC3LL,1,178,0,36,3,0,&NAMSTR(s_sys_ss3c6e7cc3, "RES_TIMEOUT") },
+  {0x4155BF3DCFA655C3LL,17,180,0,100,3,0,&NAMSTR(s_sys_sscfa655c3, "RES_BAD_KEY_PROVIDED") },
+  {0x490A114712BBA544LL,-20,182,0,100,3,0,&NAMSTR(s_sys_ss12bba544, "RES_SOME_ERRORS") },
+  {0x68724938D592E4C6LL,12,184,0,100,3,0,&NAMSTR(s_sys_ssd592e4c6, "OPT_SOCKET_SEND_SIZE") },
+  {0x073E4D38138A7DC7LL,25,186,0,100,3,0,&NAMSTR(s_sys_ss138a7dc7, "OPT_COMPRESSION") },
+  {0x7B91B2E2CC4DE648LL,4,188,0,100,3,0,&NAMSTR(s_sys_sscc4de648, "SERIALIZER_PHP") },
+  {0x138CD297B9FD244BLL,-7,190,0,100,3,0,&NAMSTR(s_sys_ssb9fd244b, "OPT_RETRY_TIMEOUT") },
+  {0x74824687F4C8D7CELL,13,192,0,100,2,0,&NAMSTR(s_sys_ssf4c8d7ce, "HAVE_JSON") },
+  {0x7AC058297870C1D0LL,-20,194,0,100,3,0,&NAMSTR(s_sys_ss7870c1d0, "SERIALIZER_JSON") },
+  {0x2B4E411F0C7596D1LL,-1,196,0,36,3,0,&NAMSTR(s_sys_ss0c7596d1, "SERIALIZER_IGBINARY") },
+  {0x1E8ABFABE00D2651LL,-31,198,0,100,3,0,&NAMSTR(s_sys_sse00d2651, "OPT_NO_BLOCK") },
+  {0x49856B6165627AD4LL,-24,200,0,100,3,0,&NAMSTR(s_sys_ss65627ad4, "DISTRIBUTION_MODULA") },
+  {0x02FAAD1AB87BA2D5LL,-14,202,0,36,3,0,&NAMSTR(s_sys_ssb87ba2d5, "HASH_CRC") },
+  {0x1045EAC17F112855LL,12,204,0,100,3,0,&NAMSTR(s_sys_ss7f112855, "RES_WRITE_FAILURE") },
+  {0x3A3731492FB1B557LL,9,206,0,36,3,0,&NAMSTR(s_sys_ss2bfdc708, "HASH_FNV1_32") },
+  {0x345B7B934684B3D7LL,17,208,0,100,3,0,&NAMSTR(s_sys_ss4684b3d7, "OPT_SOCKET_RECV_SIZE") },
+  {0x296424A39A9F1AD8LL,-19,210,0,100,3,0,&NAMSTR(s_sys_ss9a9f1ad8, "OPT_POLL_TIMEOUT") },
+  {0x3DD14F50C65BCDDBLL,-6,212,0,36,3,0,&NAMSTR(s_sys_ssc65bcddb, "OPT_DISTRIBUTION") },
+  {0x0224412EA957C9DBLL,17,214,0,100,3,0,&NAMSTR(s_sys_ssa957c9db, "RES_CONNECTION_SOCKET_CREATE_FAILURE") },
+  {0x6460D48B93209DDELL,-3,216,0,100,3,0,&NAMSTR(s_sys_ss93209dde, "OPT_RECV_TIMEOUT") },
+  {0x68D025242664C361LL,-36,218,0,100,3,0,&NAMSTR(s_sys_ss2664c361, "GET_PRESERVE_ORDER") },
+  {0x53A1149CE01E8C64LL,6,220,0,100,3,0,&NAMSTR(s_sys_sse01e8c64, "HASH_DEFAULT") },
+  {0x76B0604A2B4408EBLL,-32,222,0,100,3,0,&NAMSTR(s_sys_ss2b4408eb, "OPT_BUFFER_WRITES") },
+  {0x3C4C4E1BC9DFDCECLL,-34,224,0,36,3,0,&NAMSTR(s_sys_ss08c5e518, "HASH_FNV1A_32") },
+  {0x4197FC89C9F88DECLL,-33,226,0,100,3,0,&NAMSTR(s_sys_ssc9f88dec, "RES_HOST_LOOKUP_FAILURE") },
+  {0x56C85759C5701DEDLL,1,228,0,100,3,0,&NAMSTR(s_sys_ssc5701ded, "RES_DATA_EXISTS") },
+  {0x153143A96D687E6ELL,-34,230,0,100,3,0,&NAMSTR(s_sys_ss6d687e6e, "RES_NOTSTORED") },
+  {0x2BB4CFA54A5085F0LL,-15,232,0,100,3,0,&NAMSTR(s_sys_ssfe91db32, "HASH_MD5") },
+  {0x74109B06DAD2F9F1LL,-50,234,0,100,3,0,&NAMSTR(s_sys_ssdad2f9f1, "RES_END") },
+  {0x73ABA23A4A0C5D74LL,-24,236,0,100,3,0,&NAMSTR(s_sys_ss4a0c5d74, "OPT_SERIALIZER") },
+  {0x460A66958F0524F8LL,-6,238,0,100,3,0,&NAMSTR(s_sys_ss8f0524f8, "RES_FAILURE") },
+  {0x1C014F2A2E707EF9LL,-24,240,0,100,2,0,&NAMSTR(s_sys_ss2e707ef9, "HAVE_IGBINARY") },
+  {0x0443DA24DAD42EFBLL,-26,242,0,36,3,0,&NAMSTR(s_sys_ssdad42efb, "OPT_CONNECT_TIMEOUT") },
+  {0x35B252ECC21E5F7BLL,-31,244,0,100,3,0,&NAMSTR(s_sys_ssc21e5f7b, "RES_PARTIAL_READ") },
+  {0x7A68C36A2F5D27FELL,-17,246,0,100,3,0,&NAMSTR(s_sys_ss2f5d27fe, "HASH_MURMUR") },
+  {0x6948F797B210F37FLL,0,248,0,100,3,0,&NAMSTR(s_sys_ssb210f37f, "RES_PAYLOAD_FAILURE") },
 
-  {0x2C9DA0E379A28381LL,6,248,0,36,4,0,&NAMSTR(s_sys_ss79a28381, "FORM_KD") },
-  {0x1C369D0E14B76C41LL,1,250,0,36,4,0,&NAMSTR(s_sys_ss14b76c41, "FORM_KC") },
-  {0x3E3AA0A97BD09921LL,0,252,0,100,4,0,&NAMSTR(s_sys_ss7bd09921, "NFKC") },
-  {0x07512AA38ADD1AE2LL,2,254,0,100,4,0,&NAMSTR(s_sys_ss8add1ae2, "FORM_D") },
-  {0x51422F059BEFCD86LL,-3,256,0,100,4,0,&NAMSTR(s_sys_ss9befcd86, "NFC") },
-  {0x58B301790FA834EFLL,-5,258,0,36,4,0,&NAMSTR(s_sys_ss0fa834ef, "NFD") },
-  {0x3CF19F2D23C185CFLL,2,260,0,100,4,0,&NAMSTR(s_sys_ss23c185cf, "NFKD") },
-  {0x2EFDCA1922BFB273LL,-4,262,0,100,4,0,&NAMSTR(s_sys_ss22bfb273, "NONE") },
-  {0x3BE3511FDA9A9E7FLL,-4,264,0,100,4,0,&NAMSTR(s_sys_ssda9a9e7f, "FORM_C") },
+  {0x2C9DA0E379A28381LL,6,250,0,36,4,0,&NAMSTR(s_sys_ss79a28381, "FORM_KD") },
+  {0x1C369D0E14B76C41LL,1,252,0,36,4,0,&NAMSTR(s_sys_ss14b76c41, "FORM_KC") },
+  {0x3E3AA0A97BD09921LL,0,254,0,100,4,0,&NAMSTR(s_sys_ss7bd09921, "NFKC") },
+  {0x07512AA38ADD1AE2LL,2,256,0,100,4,0,&NAMSTR(s_sys_ss8add1ae2, "FORM_D") },
+  {0x51422F059BEFCD86LL,-3,258,0,100,4,0,&NAMSTR(s_sys_ss9befcd86, "NFC") },
+  {0x58B301790FA834EFLL,-5,260,0,36,4,0,&NAMSTR(s_sys_ss0fa834ef, "NFD") },
+  {0x3CF19F2D23C185CFLL,2,262,0,100,4,0,&NAMSTR(s_sys_ss23c185cf, "NFKD") },
+  {0x2EFDCA1922BFB273LL,-4,264,0,100,4,0,&NAMSTR(s_sys_ss22bfb273, "NONE") },
+  {0x3BE3511FDA9A9E7FLL,-4,266,0,100,4,0,&NAMSTR(s_sys_ssda9a9e7f, "FORM_C") },
 
-  {0x1800ED92A8884D00LL,31,266,0,100,4,0,&NAMSTR(s_sys_ssa8884d00, "ATTR_CASE") },
-  {0x07BAFBAE5A431902LL,27,268,0,100,4,0,&NAMSTR(s_sys_ss5a431902, "ATTR_STATEMENT_CLASS") },
-  {0x0229D662F91D9C04LL,1,270,0,100,4,0,&NAMSTR(s_sys_ssf91d9c04, "ERRMODE_EXCEPTION") },
-  {0x3BE7A02FD980AA08LL,7,272,0,100,4,0,&NAMSTR(s_sys_ssd980aa08, "CASE_NATURAL") },
-  {0x099B533427CCC20DLL,2,274,0,100,4,0,&NAMSTR(s_sys_ss27ccc20d, "FETCH_OBJ") },
-  {0x5FAD218776C6E511LL,60,276,0,100,4,0,&NAMSTR(s_sys_ss76c6e511, "FETCH_INTO") },
-  {0x78CB81320C710019LL,44,278,0,100,4,0,&NAMSTR(s_sys_ss0c710019, "FETCH_BOUND") },
-  {0x3158D52C3627FE1BLL,57,280,0,100,4,0,&NAMSTR(s_sys_ss3627fe1b, "MYSQL_ATTR_INIT_COMMAND") },
-  {0x03CF598D3CCCD01CLL,14,282,0,100,4,0,&NAMSTR(s_sys_ss3cccd01c, "ATTR_CLIENT_VERSION") },
-  {0x2BE16C4111A7B41DLL,36,284,0,100,4,0,&NAMSTR(s_sys_ss11a7b41d, "ATTR_FETCH_CATALOG_NAMES") },
-  {0x2A5BA04D0218F11ELL,2,286,0,100,4,0,&NAMSTR(s_sys_ss0218f11e, "CASE_LOWER") },
-  {0x16B15CF4B0DD7E23LL,9,288,0,100,4,0,&NAMSTR(s_sys_ssb0dd7e23, "FETCH_GROUP") },
-  {0x37F650C462FB6A25LL,25,290,0,100,4,0,&NAMSTR(s_sys_ss62fb6a25, "CASE_UPPER") },
-  {0x262D9BE84029992ALL,10,292,0,100,4,0,&NAMSTR(s_sys_ss4029992a, "PARAM_EVT_FETCH_POST") },
-  {0x15D2BCCED7726933LL,2,294,0,100,4,0,&NAMSTR(s_sys_ssd7726933, "ATTR_TIMEOUT") },
-  {0x01B17428BEE0243BLL,26,296,0,100,4,0,&NAMSTR(s_sys_ssbee0243b, "PARAM_EVT_EXEC_PRE") },
-  {0x2739A1D49673D43CLL,31,298,0,36,4,0,&NAMSTR(s_sys_ss9673d43c, "ATTR_ERRMODE") },
-  {0x6AC5C285F4DD863CLL,56,300,0,100,4,0,&NAMSTR(s_sys_ssf4dd863c, "ATTR_DEFAULT_FETCH_MODE") },
-  {0x3E11051E4101D73DLL,-1,302,0,100,4,0,&NAMSTR(s_sys_ss4101d73d, "ATTR_EMULATE_PREPARES") },
-  {0x2189354E22363544LL,-5,304,0,100,4,0,&NAMSTR(s_sys_ss22363544, "ATTR_PREFETCH") },
-  {0x428D5CA64BB99E48LL,35,306,0,100,4,0,&NAMSTR(s_sys_ss4bb99e48, "FETCH_UNIQUE") },
-  {0x39B4E90F36E93B4ELL,50,308,0,100,4,0,&NAMSTR(s_sys_ss36e93b4e, "MYSQL_ATTR_READ_DEFAULT_GROUP") },
-  {0x58A833E2336C6152LL,2,310,0,100,4,0,&NAMSTR(s_sys_ss336c6152, "ATTR_SERVER_INFO") },
-  {0x57B75F4773C81556LL,23,312,0,100,4,0,&NAMSTR(s_sys_ss73c81556, "PARAM_EVT_NORMALIZE") },
-  {0x5495020CF262F15BLL,-24,314,0,36,4,0,&NAMSTR(s_sys_ssf262f15b, "ATTR_CONNECTION_STATUS") },
-  {0x37888F551D85275BLL,36,316,0,100,4,0,&NAMSTR(s_sys_ss1d85275b, "ATTR_ORACLE_NULLS") },
-  {0x416A0550A8F12E61LL,52,318,0,100,4,0,&NAMSTR(s_sys_ssa8f12e61, "MYSQL_ATTR_FOUND_ROWS") },
-  {0x15A3522970275465LL,13,320,0,100,4,0,&NAMSTR(s_sys_ss70275465, "FETCH_ORI_NEXT") },
-  {0x162EAA2134F1C068LL,-19,322,0,100,4,0,&NAMSTR(s_sys_ss34f1c068, "ATTR_FETCH_TABLE_NAMES") },
-  {0x350E9275757FD66FLL,28,324,0,100,4,0,&NAMSTR(s_sys_ss757fd66f, "FETCH_ORI_REL") },
-  {0x6870D9DE66F43D70LL,9,326,0,100,4,0,&NAMSTR(s_sys_ss66f43d70, "FETCH_ASSOC") },
-  {0x713C8339790FC071LL,13,328,0,100,4,0,&NAMSTR(s_sys_ss790fc071, "ATTR_CURSOR_NAME") },
-  {0x1FB97A35B6711374LL,-14,330,0,100,4,0,&NAMSTR(s_sys_ssb6711374, "ATTR_MAX_COLUMN_LEN") },
-  {0x0E51487F9370EE75LL,-14,332,0,100,4,0,&NAMSTR(s_sys_ss9370ee75, "ATTR_AUTOCOMMIT") },
-  {0x630122BA9EC73379LL,4,334,0,36,4,0,&NAMSTR(s_sys_ss9ec73379, "PARAM_NULL") },
-  {0x05B00276031D7D79LL,45,336,0,100,4,0,&NAMSTR(s_sys_ss031d7d79, "PARAM_EVT_ALLOC") },
-  {0x500C039681520C7DLL,-2,338,0,100,4,0,&NAMSTR(s_sys_ss81520c7d, "PARAM_BOOL") },
-  {0x5CF4F38A0D7D087ELL,25,340,0,100,4,0,&NAMSTR(s_sys_ss0d7d087e, "NULL_NATURAL") },
-  {0x3F414F2735132983LL,5,342,0,100,4,0,&NAMSTR(s_sys_ss35132983, "PARAM_INT") },
-  {0x2011B5A528057784LL,15,344,0,100,4,0,&NAMSTR(s_sys_ss28057784, "FETCH_NUM") },
-  {0x5451E44C627DD885LL,18,346,0,100,4,0,&NAMSTR(s_sys_ss627dd885, "FETCH_ORI_PRIOR") },
-  {0x1B8BA5EEAABCB786LL,15,348,0,36,4,0,&NAMSTR(s_sys_ssaabcb786, "PARAM_EVT_EXEC_POST") },
-  {0x1B51C692B91D7486LL,11,350,0,100,4,0,&NAMSTR(s_sys_ssb91d7486, "MYSQL_ATTR_USE_BUFFERED_QUERY") },
-  {0x7E64209D5A925F88LL,32,352,0,100,4,0,&NAMSTR(s_sys_ss5a925f88, "PARAM_STR") },
-  {0x45AB9806DE21EA8ALL,-19,354,0,100,4,0,&NAMSTR(s_sys_ssde21ea8a, "ATTR_CURSOR") },
-  {0x0EDB017494A81E8DLL,18,356,0,100,4,0,&NAMSTR(s_sys_ss94a81e8d, "ATTR_DRIVER_NAME") },
-  {0x126B3038F3355A8ELL,24,358,0,100,4,0,&NAMSTR(s_sys_ssf3355a8e, "FETCH_USE_DEFAULT") },
-  {0x1F200B094608BE8FLL,-39,360,0,36,4,0,&NAMSTR(s_sys_ss4608be8f, "ATTR_SERVER_VERSION") },
-  {0x1175C5F56147488FLL,-22,362,0,100,4,0,&NAMSTR(s_sys_ss6147488f, "MYSQL_ATTR_DIRECT_QUERY") },
-  {0x25BE9238386C2796LL,27,364,0,100,4,0,&NAMSTR(s_sys_ss386c2796, "FETCH_PROPS_LATE") },
-  {0x657BEA5F741C4999LL,19,366,0,36,4,0,&NAMSTR(s_sys_ss741c4999, "FETCH_COLUMN") },
-  {0x18B801DE8D8C9099LL,1,368,0,100,4,0,&NAMSTR(s_sys_ss8d8c9099, "FETCH_CLASSTYPE") },
-  {0x1EC178DF86F4FD9CLL,-3,370,0,100,4,0,&NAMSTR(s_sys_ss86f4fd9c, "FETCH_SERIALIZE") },
-  {0x052245CE02FBF4A0LL,15,372,0,100,4,0,&NAMSTR(s_sys_ss02fbf4a0, "MYSQL_ATTR_LOCAL_INFILE") },
-  {0x28D5B850B76FEEA2LL,-50,374,0,36,4,0,&NAMSTR(s_sys_ssb76feea2, "FETCH_BOTH") },
-  {0x0D0BCCC6768A88A2LL,-4,376,0,100,4,0,&NAMSTR(s_sys_ss768a88a2, "FETCH_KEY_PAIR") },
-  {0x6851B7545234FCA4LL,-43,378,0,100,4,0,&NAMSTR(s_sys_ss5234fca4, "PARAM_EVT_FETCH_PRE") },
-  {0x167DD614E842FAA8LL,2,380,0,100,4,0,&NAMSTR(s_sys_sse842faa8, "CURSOR_FWDONLY") },
-  {0x6AEB66DE7A454FA9LL,2,382,0,100,4,0,&NAMSTR(s_sys_ss7a454fa9, "FETCH_ORI_FIRST") },
-  {0x392400A66B305EAALL,-17,384,0,100,4,0,&NAMSTR(s_sys_ss6b305eaa, "CURSOR_SCROLL") },
-  {0x2F6AE87AF5701AABLL,6,386,0,100,4,0,&NAMSTR(s_sys_ssf5701aab, "FETCH_ORI_LAST") },
-  {0x56D59339A0F5D8B4LL,-60,388,0,100,4,0,&NAMSTR(s_sys_ssa0f5d8b4, "ATTR_PERSISTENT") },
-  {0x08657D6005DD08B8LL,5,390,0,100,4,0,&NAMSTR(s_sys_ss05dd08b8, "NULL_EMPTY_STRING") },
-  {0x60CE39F6493319C5LL,-31,392,0,100,4,0,&NAMSTR(s_sys_ss493319c5, "ATTR_STRINGIFY_FETCHES") },
-  {0x61BD1667BB46C9C6LL,-43,394,0,100,4,0,&NAMSTR(s_sys_ssbb46c9c6, "MYSQL_ATTR_READ_DEFAULT_FILE") },
-  {0x30D00303975C98C8LL,-54,396,0,36,4,0,&NAMSTR(s_sys_ss975c98c8, "FETCH_FUNC") },
-  {0x47D4494BE4FA26C8LL,-37,398,0,100,4,0,&NAMSTR(s_sys_sse4fa26c8, "FETCH_ORI_ABS") },
-  {0x29B68A596E0615CALL,7,400,0,100,4,0,&NAMSTR(s_sys_ss6e0615ca, "NULL_TO_STRING") },
-  {0x73FAA1AA068D19CBLL,-61,402,0,100,4,0,&NAMSTR(s_sys_ss068d19cb, "MYSQL_ATTR_MAX_BUFFER_SIZE") },
-  {0x439351C7C64634D0LL,-64,404,0,100,4,0,&NAMSTR(s_sys_ssc64634d0, "FETCH_CLASS") },
-  {0x5C75BB222F23C4D1LL,-40,406,0,100,4,0,&NAMSTR(s_sys_ss2f23c4d1, "FETCH_LAZY") },
-  {0x57F9152D7EC3A5D3LL,-23,408,0,100,4,0,&NAMSTR(s_sys_ss7ec3a5d3, "MYSQL_ATTR_COMPRESS") },
-  {0x4D1DDF7F772C54DCLL,-70,410,0,100,4,0,&NAMSTR(s_sys_ss772c54dc, "ERRMODE_WARNING") },
-  {0x2E4175EAAB1F75EBLL,-1,412,0,100,4,0,&NAMSTR(s_sys_ssab1f75eb, "ERRMODE_SILENT") },
-  {0x16017F3F58821EF5LL,-47,414,0,100,7,0,&NAMSTR(s_sys_ss58821ef5, "ERR_NONE") },
-  {0x674F9B0D2030C3F6LL,4,416,0,100,4,0,&NAMSTR(s_sys_ss2030c3f6, "PARAM_LOB") },
-  {0x16EC9F213D7F57F7LL,-43,418,0,100,4,0,&NAMSTR(s_sys_ss3d7f57f7, "FETCH_NAMED") },
-  {0x6C0021FD5D20A1F8LL,-42,420,0,100,4,0,&NAMSTR(s_sys_ss5d20a1f8, "PARAM_INPUT_OUTPUT") },
-  {0x13EC16B8F7B7B1FBLL,0,422,0,100,4,0,&NAMSTR(s_sys_ssf7b7b1fb, "MYSQL_ATTR_IGNORE_SPACE") },
-  {0x51938FCA0AE827FDLL,-2,424,0,100,4,0,&NAMSTR(s_sys_ss0ae827fd, "PARAM_STMT") },
-  {0x56335EC3392D8EFELL,-65,426,0,100,4,0,&NAMSTR(s_sys_ss392d8efe, "PARAM_EVT_FREE") },
+  {0x1800ED92A8884D00LL,31,268,0,100,4,0,&NAMSTR(s_sys_ssa8884d00, "ATTR_CASE") },
+  {0x07BAFBAE5A431902LL,27,270,0,100,4,0,&NAMSTR(s_sys_ss5a431902, "ATTR_STATEMENT_CLASS") },
+  {0x0229D662F91D9C04LL,1,272,0,100,4,0,&NAMSTR(s_sys_ssf91d9c04, "ERRMODE_EXCEPTION") },
+  {0x3BE7A02FD980AA08LL,7,274,0,100,4,0,&NAMSTR(s_sys_ssd980aa08, "CASE_NATURAL") },
+  {0x099B533427CCC20DLL,2,276,0,100,4,0,&NAMSTR(s_sys_ss27ccc20d, "FETCH_OBJ") },
+  {0x5FAD218776C6E511LL,60,278,0,100,4,0,&NAMSTR(s_sys_ss76c6e511, "FETCH_INTO") },
+  {0x78CB81320C710019LL,44,280,0,100,4,0,&NAMSTR(s_sys_ss0c710019, "FETCH_BOUND") },
+  {0x3158D52C3627FE1BLL,57,282,0,100,4,0,&NAMSTR(s_sys_ss3627fe1b, "MYSQL_ATTR_INIT_COMMAND") },
+  {0x03CF598D3CCCD01CLL,14,284,0,100,4,0,&NAMSTR(s_sys_ss3cccd01c, "ATTR_CLIENT_VERSION") },
+  {0x2BE16C4111A7B41DLL,36,286,0,100,4,0,&NAMSTR(s_sys_ss11a7b41d, "ATTR_FETCH_CATALOG_NAMES") },
+  {0x2A5BA04D0218F11ELL,2,288,0,100,4,0,&NAMSTR(s_sys_ss0218f11e, "CASE_LOWER") },
+  {0x16B15CF4B0DD7E23LL,9,290,0,100,4,0,&NAMSTR(s_sys_ssb0dd7e23, "FETCH_GROUP") },
+  {0x37F650C462FB6A25LL,25,292,0,100,4,0,&NAMSTR(s_sys_ss62fb6a25, "CASE_UPPER") },
+  {0x262D9BE84029992ALL,10,294,0,100,4,0,&NAMSTR(s_sys_ss4029992a, "PARAM_EVT_FETCH_POST") },
+  {0x15D2BCCED7726933LL,2,296,0,100,4,0,&NAMSTR(s_sys_ssd7726933, "ATTR_TIMEOUT") },
+  {0x01B17428BEE0243BLL,26,298,0,100,4,0,&NAMSTR(s_sys_ssbee0243b, "PARAM_EVT_EXEC_PRE") },
+  {0x2739A1D49673D43CLL,31,300,0,36,4,0,&NAMSTR(s_sys_ss9673d43c, "ATTR_ERRMODE") },
+  {0x6AC5C285F4DD863CLL,56,302,0,100,4,0,&NAMSTR(s_sys_ssf4dd863c, "ATTR_DEFAULT_FETCH_MODE") },
+  {0x3E11051E4101D73DLL,-1,304,0,100,4,0,&NAMSTR(s_sys_ss4101d73d, "ATTR_EMULATE_PREPARES") },
+  {0x2189354E22363544LL,-5,306,0,100,4,0,&NAMSTR(s_sys_ss22363544, "ATTR_PREFETCH") },
+  {0x428D5CA64BB99E48LL,35,308,0,100,4,0,&NAMSTR(s_sys_ss4bb99e48, "FETCH_UNIQUE") },
+  {0x39B4E90F36E93B4ELL,50,310,0,100,4,0,&NAMSTR(s_sys_ss36e93b4e, "MYSQL_ATTR_READ_DEFAULT_GROUP") },
+  {0x58A833E2336C6152LL,2,312,0,100,4,0,&NAMSTR(s_sys_ss336c6152, "ATTR_SERVER_INFO") },
+  {0x57B75F4773C81556LL,23,314,0,100,4,0,&NAMSTR(s_sys_ss73c81556, "PARAM_EVT_NORMALIZE") },
+  {0x5495020CF262F15BLL,-24,316,0,36,4,0,&NAMSTR(s_sys_ssf262f15b, "ATTR_CONNECTION_STATUS") },
+  {0x37888F551D85275BLL,36,318,0,100,4,0,&NAMSTR(s_sys_ss1d85275b, "ATTR_ORACLE_NULLS") },
+  {0x416A0550A8F12E61LL,52,320,0,100,4,0,&NAMSTR(s_sys_ssa8f12e61, "MYSQL_ATTR_FOUND_ROWS") },
+  {0x15A3522970275465LL,13,322,0,100,4,0,&NAMSTR(s_sys_ss70275465, "FETCH_ORI_NEXT") },
+  {0x162EAA2134F1C068LL,-19,324,0,100,4,0,&NAMSTR(s_sys_ss34f1c068, "ATTR_FETCH_TABLE_NAMES") },
+  {0x350E9275757FD66FLL,28,326,0,100,4,0,&NAMSTR(s_sys_ss757fd66f, "FETCH_ORI_REL") },
+  {0x6870D9DE66F43D70LL,9,328,0,100,4,0,&NAMSTR(s_sys_ss66f43d70, "FETCH_ASSOC") },
+  {0x713C8339790FC071LL,13,330,0,100,4,0,&NAMSTR(s_sys_ss790fc071, "ATTR_CURSOR_NAME") },
+  {0x1FB97A35B6711374LL,-14,332,0,100,4,0,&NAMSTR(s_sys_ssb6711374, "ATTR_MAX_COLUMN_LEN") },
+  {0x0E51487F9370EE75LL,-14,334,0,100,4,0,&NAMSTR(s_sys_ss9370ee75, "ATTR_AUTOCOMMIT") },
+  {0x630122BA9EC73379LL,4,336,0,36,4,0,&NAMSTR(s_sys_ss9ec73379, "PARAM_NULL") },
+  {0x05B00276031D7D79LL,45,338,0,100,4,0,&NAMSTR(s_sys_ss031d7d79, "PARAM_EVT_ALLOC") },
+  {0x500C039681520C7DLL,-2,340,0,100,4,0,&NAMSTR(s_sys_ss81520c7d, "PARAM_BOOL") },
+  {0x5CF4F38A0D7D087ELL,25,342,0,100,4,0,&NAMSTR(s_sys_ss0d7d087e, "NULL_NATURAL") },
+  {0x3F414F2735132983LL,5,344,0,100,4,0,&NAMSTR(s_sys_ss35132983, "PARAM_INT") },
+  {0x2011B5A528057784LL,15,346,0,100,4,0,&NAMSTR(s_sys_ss28057784, "FETCH_NUM") },
+  {0x5451E44C627DD885LL,18,348,0,100,4,0,&NAMSTR(s_sys_ss627dd885, "FETCH_ORI_PRIOR") },
+  {0x1B8BA5EEAABCB786LL,15,350,0,36,4,0,&NAMSTR(s_sys_ssaabcb786, "PARAM_EVT_EXEC_POST") },
+  {0x1B51C692B91D7486LL,11,352,0,100,4,0,&NAMSTR(s_sys_ssb91d7486, "MYSQL_ATTR_USE_BUFFERED_QUERY") },
+  {0x7E64209D5A925F88LL,32,354,0,100,4,0,&NAMSTR(s_sys_ss5a925f88, "PARAM_STR") },
+  {0x45AB9806DE21EA8ALL,-19,356,0,100,4,0,&NAMSTR(s_sys_ssde21ea8a, "ATTR_CURSOR") },
+  {0x0EDB017494A81E8DLL,18,358,0,100,4,0,&NAMSTR(s_sys_ss94a81e8d, "ATTR_DRIVER_NAME") },
+  {0x126B3038F3355A8ELL,24,360,0,100,4,0,&NAMSTR(s_sys_ssf3355a8e, "FETCH_USE_DEFAULT") },
+  {0x1F200B094608BE8FLL,-39,362,0,36,4,0,&NAMSTR(s_sys_ss4608be8f, "ATTR_SERVER_VERSION") },
+  {0x1175C5F56147488FLL,-22,364,0,100,4,0,&NAMSTR(s_sys_ss6147488f, "MYSQL_ATTR_DIRECT_QUERY") },
+  {0x25BE9238386C2796LL,27,366,0,100,4,0,&NAMSTR(s_sys_ss386c2796, "FETCH_PROPS_LATE") },
+  {0x657BEA5F741C4999LL,19,368,0,36,4,0,&NAMSTR(s_sys_ss741c4999, "FETCH_COLUMN") },
+  {0x18B801DE8D8C9099LL,1,370,0,100,4,0,&NAMSTR(s_sys_ss8d8c9099, "FETCH_CLASSTYPE") },
+  {0x1EC178DF86F4FD9CLL,-3,372,0,100,4,0,&NAMSTR(s_sys_ss86f4fd9c, "FETCH_SERIALIZE") },
+  {0x052245CE02FBF4A0LL,15,374,0,100,4,0,&NAMSTR(s_sys_ss02fbf4a0, "MYSQL_ATTR_LOCAL_INFILE") },
+  {0x28D5B850B76FEEA2LL,-50,376,0,36,4,0,&NAMSTR(s_sys_ssb76feea2, "FETCH_BOTH") },
+  {0x0D0BCCC6768A88A2LL,-4,378,0,100,4,0,&NAMSTR(s_sys_ss768a88a2, "FETCH_KEY_PAIR") },
+  {0x6851B7545234FCA4LL,-43,380,0,100,4,0,&NAMSTR(s_sys_ss5234fca4, "PARAM_EVT_FETCH_PRE") },
+  {0x167DD614E842FAA8LL,2,382,0,100,4,0,&NAMSTR(s_sys_sse842faa8, "CURSOR_FWDONLY") },
+  {0x6AEB66DE7A454FA9LL,2,384,0,100,4,0,&NAMSTR(s_sys_ss7a454fa9, "FETCH_ORI_FIRST") },
+  {0x392400A66B305EAALL,-17,386,0,100,4,0,&NAMSTR(s_sys_ss6b305eaa, "CURSOR_SCROLL") },
+  {0x2F6AE87AF5701AABLL,6,388,0,100,4,0,&NAMSTR(s_sys_ssf5701aab, "FETCH_ORI_LAST") },
+  {0x56D59339A0F5D8B4LL,-60,390,0,100,4,0,&NAMSTR(s_sys_ssa0f5d8b4, "ATTR_PERSISTENT") },
+  {0x08657D6005DD08B8LL,5,392,0,100,4,0,&NAMSTR(s_sys_ss05dd08b8, "NULL_EMPTY_STRING") },
+  {0x60CE39F6493319C5LL,-31,394,0,100,4,0,&NAMSTR(s_sys_ss493319c5, "ATTR_STRINGIFY_FETCHES") },
+  {0x61BD1667BB46C9C6LL,-43,396,0,100,4,0,&NAMSTR(s_sys_ssbb46c9c6, "MYSQL_ATTR_READ_DEFAULT_FILE") },
+  {0x30D00303975C98C8LL,-54,398,0,36,4,0,&NAMSTR(s_sys_ss975c98c8, "FETCH_FUNC") },
+  {0x47D4494BE4FA26C8LL,-37,400,0,100,4,0,&NAMSTR(s_sys_sse4fa26c8, "FETCH_ORI_ABS") },
+  {0x29B68A596E0615CALL,7,402,0,100,4,0,&NAMSTR(s_sys_ss6e0615ca, "NULL_TO_STRING") },
+  {0x73FAA1AA068D19CBLL,-61,404,0,100,4,0,&NAMSTR(s_sys_ss068d19cb, "MYSQL_ATTR_MAX_BUFFER_SIZE") },
+  {0x439351C7C64634D0LL,-64,406,0,100,4,0,&NAMSTR(s_sys_ssc64634d0, "FETCH_CLASS") },
+  {0x5C75BB222F23C4D1LL,-40,408,0,100,4,0,&NAMSTR(s_sys_ss2f23c4d1, "FETCH_LAZY") },
+  {0x57F9152D7EC3A5D3LL,-23,410,0,100,4,0,&NAMSTR(s_sys_ss7ec3a5d3, "MYSQL_ATTR_COMPRESS") },
+  {0x4D1DDF7F772C54DCLL,-70,412,0,100,4,0,&NAMSTR(s_sys_ss772c54dc, "ERRMODE_WARNING") },
+  {0x2E4175EAAB1F75EBLL,-1,414,0,100,4,0,&NAMSTR(s_sys_ssab1f75eb, "ERRMODE_SILENT") },
+  {0x16017F3F58821EF5LL,-47,416,0,100,7,0,&NAMSTR(s_sys_ss58821ef5, "ERR_NONE") },
+  {0x674F9B0D2030C3F6LL,4,418,0,100,4,0,&NAMSTR(s_sys_ss2030c3f6, "PARAM_LOB") },
+  {0x16EC9F213D7F57F7LL,-43,420,0,100,4,0,&NAMSTR(s_sys_ss3d7f57f7, "FETCH_NAMED") },
+  {0x6C0021FD5D20A1F8LL,-42,422,0,100,4,0,&NAMSTR(s_sys_ss5d20a1f8, "PARAM_INPUT_OUTPUT") },
+  {0x13EC16B8F7B7B1FBLL,0,424,0,100,4,0,&NAMSTR(s_sys_ssf7b7b1fb, "MYSQL_ATTR_IGNORE_SPACE") },
+  {0x51938FCA0AE827FDLL,-2,426,0,100,4,0,&NAMSTR(s_sys_ss0ae827fd, "PARAM_STMT") },
+  {0x56335EC3392D8EFELL,-65,428,0,100,4,0,&NAMSTR(s_sys_ss392d8efe, "PARAM_EVT_FREE") },
 
-  {0x76DAF4F4BD608481LL,6,428,0,100,3,0,&NAMSTR(s_sys_ssbd608481, "SINGLE_SCRIPT_CONFUSABLE") },
-  {0x330C21B4435FDA12LL,4,430,0,100,3,0,&NAMSTR(s_sys_ss435fda12, "WHOLE_SCRIPT_CONFUSABLE") },
-  {0x33D91DB93B53D955LL,0,432,0,100,3,0,&NAMSTR(s_sys_ss3b53d955, "CHAR_LIMIT") },
-  {0x727F3BA1A7798546LL,-1,434,0,100,3,0,&NAMSTR(s_sys_ssa7798546, "INVISIBLE") },
-  {0x7244AE82909D364ALL,-1,436,0,100,3,0,&NAMSTR(s_sys_ss909d364a, "SINGLE_SCRIPT") },
-  {0x5A4E3956DA2E533CLL,-1,438,0,100,3,0,&NAMSTR(s_sys_ssda2e533c, "ANY_CASE") },
-  {0x3189877F80D9ABBFLL,-5,440,0,100,3,0,&NAMSTR(s_sys_ss80d9abbf, "MIXED_SCRIPT_CONFUSABLE") },
+  {0x76DAF4F4BD608481LL,6,430,0,100,3,0,&NAMSTR(s_sys_ssbd608481, "SINGLE_SCRIPT_CONFUSABLE") },
+  {0x330C21B4435FDA12LL,4,432,0,100,3,0,&NAMSTR(s_sys_ss435fda12, "WHOLE_SCRIPT_CONFUSABLE") },
+  {0x33D91DB93B53D955LL,0,434,0,100,3,0,&NAMSTR(s_sys_ss3b53d955, "CHAR_LIMIT") },
+  {0x727F3BA1A7798546LL,-1,436,0,100,3,0,&NAMSTR(s_sys_ssa7798546, "INVISIBLE") },
+  {0x7244AE82909D364ALL,-1,438,0,100,3,0,&NAMSTR(s_sys_ss909d364a, "SINGLE_SCRIPT") },
+  {0x5A4E3956DA2E533CLL,-1,440,0,100,3,0,&NAMSTR(s_sys_ssda2e533c, "ANY_CASE") },
+  {0x3189877F80D9ABBFLL,-5,442,0,100,3,0,&NAMSTR(s_sys_ss80d9abbf, "MIXED_SCRIPT_CONFUSABLE") },
 
-  {0x13B3121CBF212DC1LL,1,442,0,100,4,0,&NAMSTR(s_sys_ssbf212dc1, "DOC_FRAGMENT") },
-  {0x6071F0A4D7F152C9LL,8,444,0,100,4,0,&NAMSTR(s_sys_ssd7f152c9, "NOTATION") },
-  {0x16AD79F9AF3ECC0DLL,11,446,0,100,4,0,&NAMSTR(s_sys_ssaf3ecc0d, "COMMENT") },
-  {0x5BB72110C0F94F8FLL,16,448,0,36,4,0,&NAMSTR(s_sys_ssc0f94f8f, "ELEMENT") },
-  {0x4431B68F8476210FLL,0,450,0,100,4,0,&NAMSTR(s_sys_ss8476210f, "SUBST_ENTITIES") },
-  {0x66710CEFCACCEAD4LL,15,452,0,100,4,0,&NAMSTR(s_sys_sscaccead4, "DEFAULTATTRS") },
-  {0x0A70D397C0570F56LL,15,454,0,100,4,0,&NAMSTR(s_sys_ssc0570f56, "CDATA") },
-  {0x69070452A320C4D8LL,-2,456,0,100,4,0,&NAMSTR(s_sys_ssa320c4d8, "LOADDTD") },
-  {0x4D26D167066BB11DLL,-2,458,0,36,4,0,&NAMSTR(s_sys_ss066bb11d, "TEXT") },
-  {0x507641F239996F9DLL,2,460,0,100,4,0,&NAMSTR(s_sys_ss39996f9d, "WHITESPACE") },
-  {0x7EB865DC91D7AC1FLL,-10,462,0,100,4,0,&NAMSTR(s_sys_ss91d7ac1f, "DOC_TYPE") },
-  {0x4A21896B12C338E5LL,4,464,0,100,4,0,&NAMSTR(s_sys_ss12c338e5, "SIGNIFICANT_WHITESPACE") },
-  {0x18CF3E4A60E4AAACLL,-10,466,0,100,4,0,&NAMSTR(s_sys_ss60e4aaac, "PI") },
-  {0x5C1091C88F8EB6EDLL,-3,468,0,100,4,0,&NAMSTR(s_sys_ss8f8eb6ed, "DOC") },
-  {0x18FB7BF5786BF72FLL,-2,470,0,100,4,0,&NAMSTR(s_sys_ss786bf72f, "ENTITY") },
-  {0x3EBBF7FE181568B0LL,3,472,0,36,4,0,&NAMSTR(s_sys_ss181568b0, "END_ELEMENT") },
-  {0x2907A7E1425D0970LL,-9,474,0,100,4,0,&NAMSTR(s_sys_ss425d0970, "XML_DECLARATION") },
-  {0x2EFDCA1922BFB273LL,-14,476,0,36,4,0,&NAMSTR(s_sys_ss22bfb273, "NONE") },
-  {0x66785D8330DBC573LL,-2,478,0,100,4,0,&NAMSTR(s_sys_ss30dbc573, "END_ENTITY") },
-  {0x21A6FB97A47EB4F5LL,-11,480,0,100,4,0,&NAMSTR(s_sys_ssa47eb4f5, "ATTRIBUTE") },
-  {0x1CA408E02262F737LL,-16,482,0,100,4,0,&NAMSTR(s_sys_ss2262f737, "VALIDATE") },
-  {0x631C49B1B9F742FCLL,-7,484,0,100,4,0,&NAMSTR(s_sys_ssb9f742fc, "ENTITY_REF") },
+  {0x13B3121CBF212DC1LL,1,444,0,100,4,0,&NAMSTR(s_sys_ssbf212dc1, "DOC_FRAGMENT") },
+  {0x6071F0A4D7F152C9LL,8,446,0,100,4,0,&NAMSTR(s_sys_ssd7f152c9, "NOTATION") },
+  {0x16AD79F9AF3ECC0DLL,11,448,0,100,4,0,&NAMSTR(s_sys_ssaf3ecc0d, "COMMENT") },
+  {0x5BB72110C0F94F8FLL,16,450,0,36,4,0,&NAMSTR(s_sys_ssc0f94f8f, "ELEMENT") },
+  {0x4431B68F8476210FLL,0,452,0,100,4,0,&NAMSTR(s_sys_ss8476210f, "SUBST_ENTITIES") },
+  {0x66710CEFCACCEAD4LL,15,454,0,100,4,0,&NAMSTR(s_sys_sscaccead4, "DEFAULTATTRS") },
+  {0x0A70D397C0570F56LL,15,456,0,100,4,0,&NAMSTR(s_sys_ssc0570f56, "CDATA") },
+  {0x69070452A320C4D8LL,-2,458,0,100,4,0,&NAMSTR(s_sys_ssa320c4d8, "LOADDTD") },
+  {0x4D26D167066BB11DLL,-2,460,0,36,4,0,&NAMSTR(s_sys_ss066bb11d, "TEXT") },
+  {0x507641F239996F9DLL,2,462,0,100,4,0,&NAMSTR(s_sys_ss39996f9d, "WHITESPACE") },
+  {0x7EB865DC91D7AC1FLL,-10,464,0,100,4,0,&NAMSTR(s_sys_ss91d7ac1f, "DOC_TYPE") },
+  {0x4A21896B12C338E5LL,4,466,0,100,4,0,&NAMSTR(s_sys_ss12c338e5, "SIGNIFICANT_WHITESPACE") },
+  {0x18CF3E4A60E4AAACLL,-10,468,0,100,4,0,&NAMSTR(s_sys_ss60e4aaac, "PI") },
+  {0x5C1091C88F8EB6EDLL,-3,470,0,100,4,0,&NAMSTR(s_sys_ss8f8eb6ed, "DOC") },
+  {0x18FB7BF5786BF72FLL,-2,472,0,100,4,0,&NAMSTR(s_sys_ss786bf72f, "ENTITY") },
+  {0x3EBBF7FE181568B0LL,3,474,0,36,4,0,&NAMSTR(s_sys_ss181568b0, "END_ELEMENT") },
+  {0x2907A7E1425D0970LL,-9,476,0,100,4,0,&NAMSTR(s_sys_ss425d0970, "XML_DECLARATION") },
+  {0x2EFDCA1922BFB273LL,-14,478,0,36,4,0,&NAMSTR(s_sys_ss22bfb273, "NONE") },
+  {0x66785D8330DBC573LL,-2,480,0,100,4,0,&NAMSTR(s_sys_ss30dbc573, "END_ENTITY") },
+  {0x21A6FB97A47EB4F5LL,-11,482,0,100,4,0,&NAMSTR(s_sys_ssa47eb4f5, "ATTRIBUTE") },
+  {0x1CA408E02262F737LL,-16,484,0,100,4,0,&NAMSTR(s_sys_ss2262f737, "VALIDATE") },
+  {0x631C49B1B9F742FCLL,-7,486,0,100,4,0,&NAMSTR(s_sys_ssb9f742fc, "ENTITY_REF") },
 
 };
 static const int cpt_hash_entries[] = {
@@ -11533,7 +11536,7 @@ static const int cpt_hash_entries[] = {
   -1,
   -1,
   // Memcached hash
-  56,55,-1,-1,53,-1,52,51,-1,-1,-1,50,-1,-1,49,48,-1,47,46,44,43,-1,-1,-1,-1,-1,-1,42,-1,-1,41,-1,-1,40,-1,-1,38,-1,-1,37,35,-1,33,32,-1,-1,30,29,-1,28,-1,-1,27,-1,-1,26,25,24,-1,23,21,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,20,-1,19,-1,-1,18,-1,-1,-1,-1,-1,-1,-1,-1,-1,17,-1,16,14,-1,-1,-1,-1,13,10,-1,-1,-1,9,-1,7,-1,-1,-1,-1,-1,-1,-1,-1,5,-1,-1,3,-1,-1,2,-1,1,-1,0,-1,-1,-1,
+  57,56,-1,-1,54,-1,53,52,-1,-1,-1,51,-1,-1,50,49,-1,48,47,45,44,-1,-1,-1,-1,-1,-1,43,-1,-1,42,-1,-1,41,-1,-1,39,-1,-1,38,36,-1,34,33,-1,-1,31,30,-1,29,-1,-1,28,-1,-1,27,26,25,-1,24,22,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,21,-1,20,-1,-1,19,-1,-1,-1,-1,-1,-1,-1,-1,-1,18,-1,17,15,-1,-1,-1,-1,14,11,-1,-1,10,9,-1,7,-1,-1,-1,-1,-1,-1,-1,-1,5,-1,-1,3,-1,-1,2,-1,1,-1,0,-1,-1,-1,
   // Memcached lists
   -1,
   -1,
@@ -11596,24 +11599,24 @@ const ClassPropTable c_Locale::os_prop_table = {
   cpt_hash_entries+256,0,cpt_table_entries+75,cpt_static_inits
 };
 const ClassPropTable c_Memcached::os_prop_table = {
-  -1,-1,-1,-1,127,25,1,0,
+  -1,-1,-1,-1,127,26,1,0,
   cpt_hash_entries+387,0,cpt_table_entries+77,cpt_static_inits
 };
 const ClassPropTable c_Normalizer::os_prop_table = {
   -1,-1,-1,-1,31,7,1,0,
-  cpt_hash_entries+422,0,cpt_table_entries+134,cpt_static_inits
+  cpt_hash_entries+422,0,cpt_table_entries+135,cpt_static_inits
 };
 const ClassPropTable c_PDO::os_prop_table = {
   -1,-1,-1,-1,255,36,1,0,
-  cpt_hash_entries+681,0,cpt_table_entries+143,cpt_static_inits
+  cpt_hash_entries+681,0,cpt_table_entries+144,cpt_static_inits
 };
 const ClassPropTable c_SpoofChecker::os_prop_table = {
   -1,-1,-1,-1,15,0,1,0,
-  cpt_hash_entries+700,0,cpt_table_entries+224,cpt_static_inits
+  cpt_hash_entries+700,0,cpt_table_entries+225,cpt_static_inits
 };
 const ClassPropTable c_XMLReader::os_prop_table = {
   -1,-1,-1,-1,63,17,1,0,
-  cpt_hash_entries+767,0,cpt_table_entries+231,cpt_static_inits
+  cpt_hash_entries+767,0,cpt_table_entries+232,cpt_static_inits
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -38,6 +38,7 @@ extern StaticString s_sys_ss832ee0e0;
 extern StaticString s_sys_ss837e9a25;
 extern StaticString s_sys_ss8389f3e4;
 extern StaticString s_sys_ss8476210f;
+extern StaticString s_sys_ss84b98919;
 extern StaticString s_sys_ss84e1d89d;
 extern StaticString s_sys_ss855b229d;
 extern StaticString s_sys_ss859fb60c;
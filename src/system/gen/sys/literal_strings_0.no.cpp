@@ -33,6 +33,7 @@ StaticString s_sys_ss832ee0e0("getNamedItemNS");
 StaticString s_sys_ss837e9a25("\000Continuation\000done", 18);
 StaticString s_sys_ss8389f3e4("compare");
 StaticString s_sys_ss8476210f("SUBST_ENTITIES");
+StaticString s_sys_ss84b98919("SERIALIZER_BINARY");
 StaticString s_sys_ss84e1d89d("\000ReflectionClass\000info", 21);
 StaticString s_sys_ss855b229d("createAttributens");
 StaticString s_sys_ss859fb60c("getlocale");
@@ -20,12 +20,22 @@
 #include <runtime/base/memory/memory_manager.h>
 #include <runtime/base/builtin_functions.h>
 #include <runtime/ext/ext_variable.h>
+#include <runtime/ext/ext_string.h>
 #include <runtime/ext/ext_apc.h>
 #include <runtime/ext/ext_mysql.h>
 #include <runtime/ext/ext_curl.h>
 #include <runtime/base/shared/shared_store_base.h>
+#include <runtime/base/shared/sharded_shared_store.h>
+#include <runtime/base/shared/tiny_lfu_shared_store.h>
+#include <runtime/base/array/hphp_array.h>
+#include <runtime/base/array/array_init.h>
 #include <runtime/base/runtime_option.h>
 #include <runtime/base/server/ip_block_map.h>
+#include <runtime/base/preg.h>
+#include <runtime/base/variable_serializer.h>
+#include <runtime/base/server/request_sampler.h>
+#include <runtime/base/server/server_stats.h>
+#include <runtime/base/server/http_protocol.h>
 #include <test/test_mysql_info.inc>
 #include <system/lib/systemlib.h>
 
@@ -49,6 +59,16 @@ bool TestCppBase::RunTests(const std::string &which) {
   RUN_TEST(TestMemoryManager);
 #endif
   RUN_TEST(TestIpBlockMap);
+  RUN_TEST(TestPregCache);
+  RUN_TEST(TestRequestArena);
+  RUN_TEST(TestShardedSharedStore);
+  RUN_TEST(TestTinyLfuSharedStore);
+  RUN_TEST(TestSharedMapCopy);
+  RUN_TEST(TestHphpArrayPacked);
+  RUN_TEST(TestBinarySerialize);
+  RUN_TEST(TestRequestSampler);
+  RUN_TEST(TestByteRange);
+  RUN_TEST(TestServerStats);
   RUN_TEST(TestEqualAsStr);
   return ret;
 }
@@ -1057,6 +1077,599 @@ bool TestCppBase::TestIpBlockMap() {
   return Count(true);
 }
 
+bool TestCppBase::TestPregCache() {
+  int size = RuntimeOption::PregCacheSize;
+  int threshold = RuntimeOption::PregJitHitThreshold;
+  RuntimeOption::PregCacheSize = 8;
+  RuntimeOption::PregJitHitThreshold = 4;
+
+  // cycle through more patterns than the cache holds, so that each entry
+  // gets evicted and recompiled before it is used again
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < 32; i++) {
+      String pattern = String("/^a") + String((int64)i) + "(b+)$/";
+      String subject = String("a") + String((int64)i) + "bbb";
+      Variant matches;
+      VERIFY(same(preg_match(pattern, subject, matches), 1));
+      VERIFY(same(matches[1], "bbb"));
+      VERIFY(same(preg_match(pattern, "xyz"), 0));
+      VERIFY(preg_last_error() == 0);
+    }
+  }
+
+  PCRECacheStats stats;
+  preg_get_pcre_cache_stats(stats);
+  VERIFY(stats.size <= 8);
+  VERIFY(stats.evictions > 0);
+
+  // CLOCK: a pattern hit between every insert keeps getting a second chance,
+  // so only the cold patterns miss
+  String hot = "/^hot(c+)$/";
+  VERIFY(same(preg_match(hot, "hotc"), 1));
+  VERIFY(same(preg_match(hot, "hotc"), 1));
+  PCRECacheStats before;
+  preg_get_pcre_cache_stats(before);
+  for (int i = 0; i < 32; i++) {
+    String pattern = String("/^cold") + String((int64)i) + "$/";
+    VERIFY(same(preg_match(pattern, "x"), 0));
+    VERIFY(same(preg_match(hot, "hotcc"), 1));
+  }
+  preg_get_pcre_cache_stats(stats);
+  VS(stats.misses - before.misses, 32);
+  VERIFY(stats.evictions - before.evictions >= 32 - 8);
+  VERIFY(stats.size <= 8);
+  // the hot pattern stayed cached for well over PregJitHitThreshold hits
+  if (stats.jitSupported) VERIFY(stats.jits > before.jits);
+
+  RuntimeOption::PregCacheSize = size;
+  RuntimeOption::PregJitHitThreshold = threshold;
+  return Count(true);
+}
+
+bool TestCppBase::TestRequestArena() {
+  MemoryUsageStats stats;
+  memset(&stats, 0, sizeof(stats));
+  RequestArena arena;
+  VERIFY(!arena.active());
+  arena.activate(&stats);
+  if (!arena.active()) {
+    // no address space for the arena on this machine
+    return Count(true);
+  }
+
+  // small blocks are recycled through their size class
+  char *p = (char *)arena.alloc(100);
+  VERIFY(p && arena.owns(p));
+  VERIFY(arena.blockSize(p) == 128);
+  VERIFY(stats.usage == 128);
+  arena.free(p);
+  VERIFY(stats.usage == 0);
+  VERIFY(arena.alloc(120) == p);
+  VERIFY(!arena.owns(&stats));
+
+  // a large block at the frontier grows in place
+  char *q = (char *)arena.alloc(RequestArena::MaxSmallSize + 1);
+  VERIFY(q && arena.owns(q));
+  memset(q, 'x', RequestArena::MaxSmallSize + 1);
+  char *r = (char *)arena.realloc(q, RequestArena::PageSize * 3);
+  VERIFY(r == q);
+  VERIFY(arena.blockSize(r) == RequestArena::PageSize * 3);
+  VERIFY(r[RequestArena::MaxSmallSize] == 'x');
+
+  // growing a small block moves it
+  char *s = (char *)arena.realloc(p, 1000);
+  VERIFY(s != p && arena.owns(s));
+  arena.free(s);
+  arena.free(r);
+
+  arena.reset();
+  VERIFY(!arena.active());
+  VERIFY(!arena.owns(p));
+  return Count(true);
+}
+
+bool TestCppBase::TestShardedSharedStore() {
+  int interval = RuntimeOption::ApcPurgeInterval;
+  RuntimeOption::ApcPurgeInterval = 0;
+  {
+    ShardedTableSharedStore store(0, 4);
+    for (int i = 0; i < 100; i++) {
+      String key = String("key") + String((int64)i);
+      VERIFY(store.store(key, i, 0));
+    }
+    VERIFY(store.size() == 100);
+    for (int i = 0; i < 100; i++) {
+      String key = String("key") + String((int64)i);
+      Variant v;
+      VERIFY(store.get(key, v));
+      VS(v, i);
+      VERIFY(store.exists(key));
+    }
+    VERIFY(!store.store("key1", "x", 0, false));
+
+    bool found = false;
+    VS(store.inc("key5", 10, found), 15);
+    VERIFY(found);
+    VERIFY(store.cas("key5", 15, 1));
+    VERIFY(store.erase("key5"));
+    VERIFY(!store.exists("key5"));
+
+    // already expired, and gone once purged
+    VERIFY(store.store("short", "lived", -10));
+    VERIFY(store.size() == 100);
+    store.purgeExpired();
+    VERIFY(store.size() == 99);
+  }
+  RuntimeOption::ApcPurgeInterval = interval;
+  return Count(true);
+}
+
+bool TestCppBase::TestTinyLfuSharedStore() {
+  TinyLfuTableSharedStore store(0, 100);
+  for (int i = 0; i < 50; i++) {
+    String key = String("hot") + String((int64)i);
+    VERIFY(store.store(key, i, 0));
+    for (int j = 0; j < 5; j++) {
+      Variant v;
+      VERIFY(store.get(key, v));
+      VS(v, i);
+    }
+  }
+  VS(store.hits(), 250);
+
+  // a scan of keys used only once doesn't push out the ones used often
+  for (int i = 0; i < 1000; i++) {
+    String key = String("scan") + String((int64)i);
+    VERIFY(store.store(key, i, 0));
+  }
+  VERIFY(store.size() == 100);
+  VERIFY(store.evictions() == 950);
+  VERIFY(store.check());
+  for (int i = 0; i < 50; i++) {
+    String key = String("hot") + String((int64)i);
+    Variant v;
+    VERIFY(store.get(key, v));
+    VS(v, i);
+  }
+
+  bool found = false;
+  VS(store.inc("hot5", 10, found), 15);
+  VERIFY(found);
+  VERIFY(store.cas("hot5", 15, 1));
+  VERIFY(store.erase("hot5"));
+  VERIFY(!store.exists("hot5"));
+  VERIFY(store.size() == 99);
+  VERIFY(store.check());
+
+  int reachable = 0;
+  VERIFY(store.reportStats(reachable, 0).find("<Hit Ratio>") !=
+         string::npos);
+  return Count(true);
+}
+
+bool TestCppBase::TestSharedMapCopy() {
+  f_apc_store("config", CREATE_MAP2("a", CREATE_VECTOR2(1, 2), "b", "x"));
+  Variant v = f_apc_fetch("config");
+  VERIFY(v.getArrayData()->isSharedMap());
+
+  // splitting for copy-on-write keeps it a view of the shared array
+  Array copy(v.getArrayData()->copy());
+  VERIFY(copy->isSharedMap());
+  VS(copy["a"][1], 2);
+  VERIFY(copy.size() == 2);
+
+  // until it's actually written to
+  copy.set("b", "y");
+  VERIFY(!copy->isSharedMap());
+  VS(copy["b"], "y");
+  VS(v["b"], "x");
+  VERIFY(v.getArrayData()->isSharedMap());
+
+  // objects first read after the split are still one object in both views
+  f_apc_store("objs", CREATE_MAP2("s", "x",
+                                  "o", SystemLib::AllocStdClassObject()));
+  Variant a = f_apc_fetch("objs");
+  VS(a["s"], "x");
+  Array b(a.getArrayData()->copy());
+  VS(b["s"], "x");
+  Object o = b["o"].toObject();
+  o->o_set("p", 1);
+  VERIFY(a["o"].toObject().get() == o.get());
+  VS(a["o"].toObject()->o_get("p"), 1);
+
+  f_apc_delete("config");
+  f_apc_delete("objs");
+  return Count(true);
+}
+
+static String binary_serialize(CVarRef v) {
+  VariableSerializer vs(VariableSerializer::BinarySerialize);
+  return vs.serialize(v, true);
+}
+
+static Variant binary_unserialize(CStrRef s) {
+  return unserialize_ex(s, VariableUnserializer::BinarySerialize);
+}
+
+bool TestCppBase::TestBinarySerialize() {
+  {
+    Variant values[] = {
+      null, true, false, 0, 1, -1, 63, -64, 1000000, -1000000,
+      (int64)0x7fffffffffffffffLL, (int64)(-0x7fffffffffffffffLL - 1),
+      0.0, -1.5, 3.14159, "", "x", f_str_repeat("abc", 1000)
+    };
+    for (unsigned int i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+      String s = binary_serialize(values[i]);
+      VERIFY(VariableUnserializer::IsBinary(s.data(), s.size()));
+      VERIFY(same(binary_unserialize(s), values[i]));
+    }
+  }
+  {
+    // repeated keys are written once and referred to by id afterwards
+    Array rows;
+    for (int i = 0; i < 10; i++) {
+      rows.append(CREATE_MAP3("id", i, "name", "n", 5, -i));
+    }
+    Array arr = CREATE_MAP2("rows", rows, "empty", Array::Create());
+    String s = binary_serialize(arr);
+    VERIFY(s.size() < f_serialize(arr).size() / 2);
+    VS(f_serialize(binary_unserialize(s)), f_serialize(arr));
+  }
+  {
+    Object obj(SystemLib::AllocStdClassObject());
+    obj->o_set("a", 1);
+    obj->o_set("b", CREATE_VECTOR2("x", 2.5));
+    Array arr = CREATE_VECTOR3(obj, obj, "tail");
+    Variant v = binary_unserialize(binary_serialize(arr));
+    VS(f_serialize(v), f_serialize(arr));
+    VERIFY(same(v[0], v[1]));
+  }
+  {
+    Variant v1 = 10;
+    Array arr = Array::Create();
+    arr.append(ref(v1));
+    arr.append(ref(v1));
+    Variant v = binary_unserialize(binary_serialize(arr));
+    VS(f_serialize(v), f_serialize(arr));
+    v.lvalAt(0) = 20;
+    VS(v[1], 20);
+  }
+  {
+    // truncated or unknown versions don't unserialize
+    String s = binary_serialize(CREATE_VECTOR2("abc", 12345));
+    VERIFY(same(binary_unserialize(s.substr(0, s.size() - 1)), false));
+    String bad = s.substr(0, 1) + String("\x7f") + s.substr(2);
+    VERIFY(same(binary_unserialize(bad), false));
+  }
+  {
+    // apc reads either format, whatever it is configured to write
+    RuntimeOption::ApcSerializers old = RuntimeOption::ApcSerializer;
+    Object obj(SystemLib::AllocStdClassObject());
+    obj->o_set("a", CREATE_VECTOR2(1, "x"));
+    Array arr = CREATE_MAP2("obj", obj, "b", 1);
+    RuntimeOption::ApcSerializer = RuntimeOption::ApcBinarySerializer;
+    String s = apc_serialize(arr);
+    VERIFY(VariableUnserializer::IsBinary(s.data(), s.size()));
+    VS(f_serialize(apc_unserialize(s)), f_serialize(arr));
+    RuntimeOption::ApcSerializer = RuntimeOption::ApcPhpSerializer;
+    VS(f_serialize(apc_unserialize(s)), f_serialize(arr));
+    VS(f_serialize(apc_unserialize(apc_serialize(arr))), f_serialize(arr));
+    RuntimeOption::ApcSerializer = old;
+  }
+  return Count(true);
+}
+
+bool TestCppBase::TestRequestSampler() {
+  int rate = RuntimeOption::StatsSamplerRate;
+  int interval = RuntimeOption::StatsSamplerInterval;
+  RuntimeOption::StatsSamplerRate = 1;
+  RuntimeOption::StatsSamplerInterval = 1000;
+
+  string out;
+  RequestSampler::Report(out, true);
+
+  RequestSampler::OnRequestStart();
+  {
+    FIFunctionNoMem fi("TestRequestSampler");
+    Timer timer;
+    volatile int64 sum = 0;
+    while (timer.getMicroSeconds() < 100000) {
+      for (int i = 0; i < 10000; i++) sum += i;
+    }
+  }
+  RequestSampler::OnRequestEnd();
+
+  out.clear();
+  RequestSampler::Report(out, true);
+  VERIFY(out.find("TestRequestSampler") != string::npos);
+
+  // counted once only
+  out.clear();
+  RequestSampler::Report(out, false);
+  VERIFY(out.find("TestRequestSampler") == string::npos);
+
+  RuntimeOption::StatsSamplerRate = rate;
+  RuntimeOption::StatsSamplerInterval = interval;
+  return Count(true);
+}
+
+bool TestCppBase::TestByteRange() {
+  int start = -1, end = -1;
+  VERIFY(HttpProtocol::ParseByteRange("bytes=0-99", 1000, start, end) == 1);
+  VERIFY(start == 0 && end == 99);
+  VERIFY(HttpProtocol::ParseByteRange("bytes=500-", 1000, start, end) == 1);
+  VERIFY(start == 500 && end == 999);
+  VERIFY(HttpProtocol::ParseByteRange("bytes=990-2000", 1000, start, end)
+         == 1);
+  VERIFY(start == 990 && end == 999);
+  VERIFY(HttpProtocol::ParseByteRange("bytes=-100", 1000, start, end) == 1);
+  VERIFY(start == 900 && end == 999);
+  VERIFY(HttpProtocol::ParseByteRange("bytes=-5000", 1000, start, end) == 1);
+  VERIFY(start == 0 && end == 999);
+
+  // not satisfiable
+  VERIFY(HttpProtocol::ParseByteRange("bytes=1000-", 1000, start, end) == -1);
+  VERIFY(HttpProtocol::ParseByteRange("bytes=-0", 1000, start, end) == -1);
+  VERIFY(HttpProtocol::ParseByteRange("bytes=0-", 0, start, end) == -1);
+
+  // ignored, the whole file is sent
+  VERIFY(HttpProtocol::ParseByteRange("bytes=0-1,5-6", 1000, start, end)
+         == 0);
+  VERIFY(HttpProtocol::ParseByteRange("bytes=9-1", 1000, start, end) == 0);
+  VERIFY(HttpProtocol::ParseByteRange("items=0-1", 1000, start, end) == 0);
+  VERIFY(HttpProtocol::ParseByteRange("bytes=x-1", 1000, start, end) == 0);
+  VERIFY(HttpProtocol::ParseByteRange("bytes=-", 1000, start, end) == 0);
+  return Count(true);
+}
+
+/**
+ * Logs pages on a thread of its own, as many as it is asked for, and stays
+ * alive until stopped, as a thread's stats go away with it.
+ */
+class StatsLogger : public Synchronizable {
+public:
+  StatsLogger(int key) : m_key(key), m_wanted(0), m_logged(0),
+                         m_stopped(false) {}
+
+  void start() { pthread_create(&m_thread, NULL, Run, this); }
+  void stop() {
+    {
+      Lock lock(getMutex());
+      m_stopped = true;
+      notify();
+    }
+    pthread_join(m_thread, NULL);
+  }
+
+  void logPages(int count) {
+    Lock lock(getMutex());
+    m_wanted += count;
+    notify();
+    while (m_logged < m_wanted) wait();
+  }
+
+private:
+  static void *Run(void *p) {
+    ((StatsLogger*)p)->run();
+    return NULL;
+  }
+
+  void run() {
+    ServerStats::GetLogger();
+    Lock lock(getMutex());
+    while (true) {
+      for (; m_logged < m_wanted; m_logged++) {
+        ServerStats::Log("test.stats.name", 1);
+        ServerStats::Log(m_key, 2);
+        ServerStats::LogPage("/test_server_stats", 200);
+        ServerStats::Reset();
+      }
+      notify();
+      if (m_stopped) break;
+      wait();
+    }
+  }
+
+  pthread_t m_thread;
+  int m_key;
+  int m_wanted;
+  int m_logged;
+  bool m_stopped;
+};
+
+void TestCppBase::StatsTotals(int &hits, int64 &byName, int64 &byId) {
+  hits = 0;
+  byName = byId = 0;
+  list<ServerStats::TimeSlot*> slots;
+  ServerStats::CollectSlots(slots, 0, 0);
+  for (list<ServerStats::TimeSlot*>::const_iterator iter = slots.begin();
+       iter != slots.end(); ++iter) {
+    ServerStats::PageStatsMap &pages = (*iter)->m_pages;
+    for (ServerStats::PageStatsMap::iterator piter = pages.begin();
+         piter != pages.end(); ++piter) {
+      ServerStats::PageStats &ps = piter->second;
+      if (ps.m_url != "/test_server_stats") continue;
+      hits += ps.m_hit;
+      byName += ps.m_values["test.stats.name"];
+      byId += ps.m_values["test.stats.id"];
+    }
+  }
+  ServerStats::FreeSlots(slots);
+}
+
+bool TestCppBase::TestServerStats() {
+  bool enableStats = RuntimeOption::EnableStats;
+  bool enableWebStats = RuntimeOption::EnableWebStats;
+  RuntimeOption::EnableStats = RuntimeOption::EnableWebStats = true;
+  ServerStats::Clear();
+
+  int key = ServerStats::Intern("test.stats.id");
+  vector<StatsLogger*> loggers;
+  vector<ServerStats*> stats;
+  for (int i = 0; i < 4; i++) {
+    StatsLogger *logger = new StatsLogger(key);
+    logger->start();
+    logger->logPages(10);
+    loggers.push_back(logger);
+    Lock lock(ServerStats::s_lock, false);
+    stats.push_back(ServerStats::s_loggers.back());
+  }
+
+  int hits;
+  int64 byName, byId;
+  StatsTotals(hits, byName, byId);
+  VS(hits, 40);
+  VS(byName, 40);
+  VS(byId, 80);
+
+  // pages logged while a report holds the lock wait for the next one
+  {
+    Lock lock(stats[0]->m_lock, false);
+    loggers[0]->logPages(5);
+    VS((int)stats[0]->m_deferred.size(), 5);
+    StatsTotals(hits, byName, byId);
+    VS(hits, 40);
+    VS(byId, 80);
+  }
+  loggers[0]->logPages(1);
+  VERIFY(stats[0]->m_deferred.empty());
+  StatsTotals(hits, byName, byId);
+  VS(hits, 46);
+  VS(byName, 46);
+  VS(byId, 92);
+
+  // a thread's stats go with it
+  for (unsigned int i = 0; i < loggers.size(); i++) {
+    loggers[i]->stop();
+    delete loggers[i];
+  }
+  StatsTotals(hits, byName, byId);
+  VS(hits, 0);
+
+  RuntimeOption::EnableStats = enableStats;
+  RuntimeOption::EnableWebStats = enableWebStats;
+  return Count(true);
+}
+
+static bool is_packed(CArrRef arr) {
+  return static_cast<HphpArray*>(arr.get())->isPacked();
+}
+
+// keys and values in iteration order, as "k=v,k=v"
+static String dump_order(CArrRef arr) {
+  String ret;
+  for (ArrayIter iter(arr); iter; ++iter) {
+    if (!ret.empty()) ret += ",";
+    ret += iter.first().toString() + "=" + iter.second().toString();
+  }
+  return ret;
+}
+
+static Array packed_array(int n) {
+  Array arr(NEW(HphpArray)());
+  for (int i = 0; i < n; i++) arr.append(i * 10);
+  return arr;
+}
+
+bool TestCppBase::TestHphpArrayPacked() {
+  // appends and int-key access in range stay packed, through growing
+  Array arr = packed_array(100);
+  VERIFY(is_packed(arr));
+  VS(arr.size(), 100);
+  VS(arr[0], 0);
+  VS(arr[99], 990);
+  VERIFY(arr[100].isNull());
+  VERIFY(!arr.exists(100));
+  VERIFY(!arr.exists("a"));
+  arr.set(50, "x");
+  VS(arr[50], "x");
+  arr.set(100, 1000);
+  VS(arr[100], 1000);
+  VERIFY(is_packed(arr));
+  VS(arr.pop(), 1000);
+  VS(arr.dequeue(), 0);
+  VERIFY(is_packed(arr));
+  VS(arr[0], 10);
+  arr.prepend(-1);
+  VERIFY(is_packed(arr));
+  VS(dump_order(packed_array(3)), "0=0,1=10,2=20");
+
+  // string key
+  arr = packed_array(3);
+  arr.set("s", "t");
+  VERIFY(!is_packed(arr));
+  VS(arr[1], 10);
+  VS(arr["s"], "t");
+  arr.append(30);
+  VS(dump_order(arr), "0=0,1=10,2=20,s=t,3=30");
+
+  // sparse int key
+  arr = packed_array(3);
+  arr.set(10, "x");
+  VERIFY(!is_packed(arr));
+  VERIFY(!arr.exists(3));
+  arr.append("y");
+  VS(dump_order(arr), "0=0,1=10,2=20,10=x,11=y");
+
+  // negative int key
+  arr = packed_array(2);
+  arr.set(-1, "n");
+  VERIFY(!is_packed(arr));
+  VS(dump_order(arr), "0=0,1=10,-1=n");
+
+  // unset in the middle
+  arr = packed_array(4);
+  arr.remove(1);
+  VERIFY(!is_packed(arr));
+  VS(arr.size(), 3);
+  VERIFY(!arr.exists(1));
+  VS(arr[2], 20);
+  arr.append(40);
+  VS(dump_order(arr), "0=0,2=20,3=30,4=40");
+
+  // unset at the end converts too, and doesn't give back the key
+  arr = packed_array(3);
+  arr.remove(2);
+  VERIFY(!is_packed(arr));
+  VS(arr.size(), 2);
+  arr.append(50);
+  VS(dump_order(arr), "0=0,1=10,3=50");
+
+  // prepend after conversion renumbers int keys and keeps string keys
+  arr = packed_array(2);
+  arr.set("k", "v");
+  arr.prepend("p");
+  VERIFY(!is_packed(arr));
+  VS(dump_order(arr), "0=p,1=0,2=10,k=v");
+
+  // copies of either layout are independent
+  Array src = packed_array(3);
+  Array copy = src;
+  copy.set(0, "c");
+  VS(src[0], 0);
+  VS(copy[0], "c");
+  copy.set("s", 1);
+  VERIFY(is_packed(src));
+  VS(dump_order(src), "0=0,1=10,2=20");
+
+  // arrays made by ArrayInit with UseHphpArray start packed
+  bool useHphpArray = RuntimeOption::UseHphpArray;
+  bool useSmallArray = RuntimeOption::UseSmallArray;
+  RuntimeOption::UseHphpArray = true;
+  RuntimeOption::UseSmallArray = false;
+  arr = CREATE_VECTOR3(1, 2, 3);
+  VERIFY(dynamic_cast<HphpArray*>(arr.get()));
+  VERIFY(is_packed(arr));
+  arr = CREATE_MAP2("a", 1, "b", 2);
+  VERIFY(dynamic_cast<HphpArray*>(arr.get()));
+  VERIFY(!is_packed(arr));
+  VS(dump_order(arr), "a=1,b=2");
+  RuntimeOption::UseHphpArray = useHphpArray;
+  RuntimeOption::UseSmallArray = useSmallArray;
+
+  return Count(true);
+}
+
 bool TestCppBase::TestEqualAsStr() {
 
   const int arr_len = 18;
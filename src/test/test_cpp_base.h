@@ -41,6 +41,16 @@ class TestCppBase : public TestBase {
   bool TestSmartAllocator();
   bool TestMemoryManager();
   bool TestIpBlockMap();
+  bool TestPregCache();
+  bool TestRequestArena();
+  bool TestShardedSharedStore();
+  bool TestTinyLfuSharedStore();
+  bool TestSharedMapCopy();
+  bool TestHphpArrayPacked();
+  bool TestBinarySerialize();
+  bool TestRequestSampler();
+  bool TestByteRange();
+  bool TestServerStats();
 
   /**
    * Date types. This in turn tests StringData, ArrayData, StringOffset,
@@ -62,6 +72,10 @@ class TestCppBase : public TestBase {
 
   // EqualAsStr functions
   bool TestEqualAsStr();
+
+ private:
+  // pages, and counters by name and by id, ServerStats has for a test url
+  static void StatsTotals(int &hits, int64 &byName, int64 &byId);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -321,39 +321,72 @@ bool TestExtApc::test_apc_cas() {
 }
 
 bool TestExtApc::test_apc_bin_dump() {
-  try {
-    f_apc_bin_dump();
-  } catch (NotSupportedException e) {
-    return Count(true);
-  }
-  return Count(false);
+  f_apc_clear_cache();
+  f_apc_store("ts", "TestString");
+  f_apc_store("ta", CREATE_MAP2("a", 1, "b", CREATE_VECTOR2(2.5, true)));
+  f_apc_store("tn", 10);
+  Variant dump = f_apc_bin_dump();
+  VERIFY(dump.isString());
+  f_apc_clear_cache();
+  VERIFY(f_apc_bin_load(dump.toString()));
+  VS(f_apc_fetch("ts"), "TestString");
+  VS(f_apc_fetch("ta"), CREATE_MAP2("a", 1, "b", CREATE_VECTOR2(2.5, true)));
+  VS(f_apc_fetch("tn"), 10);
+
+  // filtering
+  f_apc_clear_cache();
+  f_apc_store("ts", "TestString");
+  f_apc_store("tn", 10);
+  dump = f_apc_bin_dump(0, CREATE_VECTOR1("tn"));
+  f_apc_clear_cache();
+  VERIFY(f_apc_bin_load(dump.toString()));
+  VS(f_apc_fetch("ts"), false);
+  VS(f_apc_fetch("tn"), 10);
+  return Count(true);
 }
 
 bool TestExtApc::test_apc_bin_load() {
-  try {
-    f_apc_bin_load("");
-  } catch (NotSupportedException e) {
-    return Count(true);
-  }
-  return Count(false);
+  f_apc_clear_cache();
+  f_apc_store("ts", "old");
+  f_apc_store("tn", 10);
+  Variant dump = f_apc_bin_dump();
+  f_apc_store("ts", "new");
+  VERIFY(f_apc_bin_load(dump.toString()));
+  VS(f_apc_fetch("ts"), "old");
+
+  VERIFY(!f_apc_bin_load(""));
+  VERIFY(!f_apc_bin_load("HPHPAPC1 garbage"));
+  String data = dump.toString();
+  VERIFY(!f_apc_bin_load(data.substr(0, data.size() - 1)));
+  return Count(true);
 }
 
 bool TestExtApc::test_apc_bin_dumpfile() {
-  try {
-    f_apc_bin_dumpfile(0, null, "");
-  } catch (NotSupportedException e) {
-    return Count(true);
-  }
-  return Count(false);
+  f_apc_clear_cache();
+  f_apc_store("ts", "TestString");
+  Variant bytes = f_apc_bin_dumpfile(0, null, "/tmp/test_apc_bin_dumpfile");
+  VS(bytes, f_apc_bin_dump().toString().size());
+  VS(f_apc_bin_dumpfile(0, null, "/no/such/dir/file"), false);
+  unlink("/tmp/test_apc_bin_dumpfile");
+  return Count(true);
 }
 
 bool TestExtApc::test_apc_bin_loadfile() {
-  try {
-    f_apc_bin_loadfile("");
-  } catch (NotSupportedException e) {
-    return Count(true);
-  }
-  return Count(false);
+  f_apc_clear_cache();
+  f_apc_store("ts", "TestString");
+  f_apc_store("tt", 12, 1000);
+  VS(apc_dump_snapshot("/tmp/test_apc_bin_loadfile"), 2);
+  f_apc_clear_cache();
+  VERIFY(f_apc_bin_loadfile("/tmp/test_apc_bin_loadfile"));
+  VS(f_apc_fetch("ts"), "TestString");
+  VS(f_apc_fetch("tt"), 12);
+
+  f_apc_clear_cache();
+  VS(apc_load_snapshot("/tmp/test_apc_bin_loadfile", 4), 2);
+  VS(f_apc_fetch("ts"), "TestString");
+  unlink("/tmp/test_apc_bin_loadfile");
+  VERIFY(!f_apc_bin_loadfile("/tmp/test_apc_bin_loadfile"));
+  return Count(true);
 }
 
 bool TestExtApc::test_apc_exists() {
@@ -1634,6 +1634,60 @@ bool TestExtArray::test_sort() {
      "    [2] => lemon\n"
      "    [3] => orange\n"
      ")\n");
+
+  // shared, it is sorted into a new array the other copy doesn't see
+  Variant nums = CREATE_MAP4("x", 3, 7, -1, "y", 10, 2, 3);
+  Variant copy = nums;
+  f_sort(ref(nums));
+  VS(f_print_r(nums, true),
+     "Array\n"
+     "(\n"
+     "    [0] => -1\n"
+     "    [1] => 3\n"
+     "    [2] => 3\n"
+     "    [3] => 10\n"
+     ")\n");
+  VS(f_print_r(copy, true),
+     "Array\n"
+     "(\n"
+     "    [x] => 3\n"
+     "    [7] => -1\n"
+     "    [y] => 10\n"
+     "    [2] => 3\n"
+     ")\n");
+  nums.append(4);
+  VS(nums[4], 4);
+
+  // unshared, it is relinked in place, and its string keys are dropped
+  Variant words = CREATE_MAP4("d", "lemon", "a", "orange",
+                              "b", "banana", "c", "apple");
+  ArrayData *data = words.getArrayData();
+  f_sort(ref(words));
+  VERIFY(words.getArrayData() == data);
+  VS(f_print_r(words, true),
+     "Array\n"
+     "(\n"
+     "    [0] => apple\n"
+     "    [1] => banana\n"
+     "    [2] => lemon\n"
+     "    [3] => orange\n"
+     ")\n");
+  VS(words[3], "orange");
+  VERIFY(!words.toArray().exists("d"));
+  words.append("peach");
+  VS(words[4], "peach");
+
+  // numeric strings still compare as numbers
+  Variant strs = CREATE_VECTOR4("10", "9", "b", "2");
+  f_sort(ref(strs));
+  VS(f_print_r(strs, true),
+     "Array\n"
+     "(\n"
+     "    [0] => 2\n"
+     "    [1] => 9\n"
+     "    [2] => 10\n"
+     "    [3] => b\n"
+     ")\n");
   return Count(true);
 }
 
@@ -1663,6 +1717,25 @@ bool TestExtArray::test_asort() {
      "    [d] => lemon\n"
      "    [a] => orange\n"
      ")\n");
+
+  // unshared, it is relinked in place, keeping its keys
+  Variant nums = CREATE_MAP4("x", 3, "y", -1, 7, 10, 2, 5);
+  ArrayData *data = nums.getArrayData();
+  f_asort(ref(nums));
+  VERIFY(nums.getArrayData() == data);
+  VS(f_print_r(nums, true),
+     "Array\n"
+     "(\n"
+     "    [y] => -1\n"
+     "    [x] => 3\n"
+     "    [2] => 5\n"
+     "    [7] => 10\n"
+     ")\n");
+  VS(nums["x"], 3);
+  VS(nums[7], 10);
+  nums.append(4);
+  VS(nums[8], 4);
+
   Variant arr = CREATE_VECTOR3("at", "\xe0s", "as");
   f_i18n_loc_set_default("en_US");
   f_asort(ref(arr), 0, true);
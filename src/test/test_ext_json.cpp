@@ -16,6 +16,7 @@
 
 #include <test/test_ext_json.h>
 #include <runtime/ext/ext_json.h>
+#include <runtime/ext/json_decoder.h>
 #include <system/lib/systemlib.h>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -99,5 +100,34 @@ bool TestExtJson::test_json_decode() {
      (CREATE_MAP1("a", CREATE_VECTOR1(CREATE_MAP1("n", "1st"))),
       CREATE_MAP1("b", CREATE_VECTOR1(CREATE_MAP1("n", "2nd")))));
 
+  VS(f_json_decode("[\"a\\\"\\/\\n\\u00e9\\ud83d\\ude00\"]", true),
+     CREATE_VECTOR1("a\"/\n\xc3\xa9\xf0\x9f\x98\x80"));
+  VS(f_json_decode("[\"\xc3\xa9\"]", true), CREATE_VECTOR1("\xc3\xa9"));
+  VS(f_json_decode("[\"\xc3\"]", true), null);
+  VS(f_json_decode("[\"a\tb\"]", true), null);
+  VS(f_json_decode("[-0, 1., 1.5e2, 0e1]", true), null);
+  VS(f_json_decode("[-0, 1., 1.5e2, 12345678901234567]", true),
+     CREATE_VECTOR4(0, 1.0, 150.0, 12345678901234567LL));
+  VS(f_json_decode("[9223372036854775807, -9223372036854775808]", true),
+     CREATE_VECTOR2(9223372036854775807LL,
+                    (int64)(-9223372036854775807LL - 1)));
+  VS(f_json_decode("[9223372036854775808]", true),
+     CREATE_VECTOR1(9223372036854775808.0));
+  VS(f_json_decode("{\"\":1,\"a\":1,\"a\":2}", true),
+     CREATE_MAP2("", 1, "a", 2));
+  obj = f_json_decode("{\"\":1}");
+  VS(obj.toArray(), CREATE_MAP1("_empty_", 1));
+
+  {
+    const char *json = "{\"key\": [1, 23.5, \"\\u00e9\xc3\xa9\", true, null]}";
+    JsonDecoder decoder(true);
+    for (int i = 0; json[i]; i++) {
+      VERIFY(decoder.feed(json + i, 1));
+    }
+    Variant z;
+    VERIFY(decoder.finish(z));
+    VS(z, f_json_decode(json, true));
+  }
+
   return Count(true);
 }
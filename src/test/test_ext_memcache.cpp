@@ -16,6 +16,11 @@
 
 #include <test/test_ext_memcache.h>
 #include <runtime/ext/ext_memcache.h>
+#include <runtime/ext/ext_options.h>
+#include <runtime/ext/memcache_pool.h>
+#include <runtime/base/runtime_option.h>
+#include <runtime/base/server/server_stats.h>
+#include <test/test_memcached_info.inc>
 
 IMPLEMENT_SEP_EXTENSION_TEST(Memcache);
 ///////////////////////////////////////////////////////////////////////////////
@@ -43,6 +48,9 @@ bool TestExtMemcache::RunTests(const std::string &which) {
   RUN_TEST(test_memcache_get_extended_stats);
   RUN_TEST(test_memcache_set_server_params);
   RUN_TEST(test_memcache_add_server);
+  RUN_TEST(test_memcache_hash_ini);
+  RUN_TEST(test_memcache_pool);
+  RUN_TEST(test_memcache_coalesce_gets);
 
   return ret;
 }
@@ -128,3 +136,218 @@ bool TestExtMemcache::test_memcache_set_server_params() {
 bool TestExtMemcache::test_memcache_add_server() {
   return Count(true);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Pools only need a server list, so these run without a memcached; values
+// only come back when one is running there.
+static const char *test_host() {
+  return *TEST_MEMCACHED_HOSTNAME ? TEST_MEMCACHED_HOSTNAME : "localhost";
+}
+
+static p_Memcache new_memcache(int port = TEST_MEMCACHED_PORT) {
+  p_Memcache memc(p_Memcache(NEWOBJ(c_Memcache))->create());
+  memc->t_addserver(test_host(), port);
+  return memc;
+}
+
+static bool memcache_running(p_Memcache memc) {
+  return !memc->t_getversion().same(false);
+}
+
+bool TestExtMemcache::test_memcache_hash_ini() {
+  // the ini handlers are bound once memcache globals are first used
+  p_Memcache memc1 = new_memcache();
+  memcached_st *mc = &memc1->m_memcache;
+  VERIFY(memcached_behavior_get(mc, MEMCACHED_BEHAVIOR_DISTRIBUTION) ==
+         MEMCACHED_DISTRIBUTION_MODULA);
+  VERIFY(memcached_behavior_get(mc, MEMCACHED_BEHAVIOR_HASH) ==
+         MEMCACHED_HASH_CRC);
+
+  // hash_function used to overwrite hash_strategy
+  f_ini_set("memcache.hash_function", "fnv");
+  p_Memcache memc2 = new_memcache();
+  mc = &memc2->m_memcache;
+  VERIFY(memcached_behavior_get(mc, MEMCACHED_BEHAVIOR_DISTRIBUTION) ==
+         MEMCACHED_DISTRIBUTION_MODULA);
+  VERIFY(memcached_behavior_get(mc, MEMCACHED_BEHAVIOR_HASH) ==
+         MEMCACHED_HASH_FNV1A_32);
+
+  // consistent used to be refused
+  f_ini_set("memcache.hash_strategy", "consistent");
+  f_ini_set("memcache.hash_strategy", "bogus");
+  p_Memcache memc3 = new_memcache();
+  mc = &memc3->m_memcache;
+  VERIFY(memcached_behavior_get(mc, MEMCACHED_BEHAVIOR_DISTRIBUTION) ==
+         MEMCACHED_DISTRIBUTION_CONSISTENT_KETAMA);
+  VERIFY(memcached_behavior_get(mc, MEMCACHED_BEHAVIOR_HASH) ==
+         MEMCACHED_HASH_FNV1A_32);
+
+  f_ini_set("memcache.hash_strategy", "standard");
+  f_ini_set("memcache.hash_function", "crc32");
+  return Count(true);
+}
+
+bool TestExtMemcache::test_memcache_pool() {
+  int poolSize = RuntimeOption::MemcachePoolSize;
+  RuntimeOption::MemcachePoolSize = 1;
+
+  p_Memcache memc1 = new_memcache();
+  p_Memcache memc2 = new_memcache();
+  memcached_st *conn1 = memc1->getConnection();
+  VERIFY(conn1 != &memc1->m_memcache);
+  MemcachePool *pool = memc1->m_pool;
+  VERIFY(pool == MemcachePool::Get(&memc2->m_memcache));
+
+  // checked in on close(), and out again by another object
+  memc1->t_close();
+  VERIFY(memc1->m_conn == NULL);
+  VERIFY(memc2->getConnection() == conn1);
+  VERIFY(memc1->getConnection() != conn1);
+
+  // only PoolSize idle connections are kept
+  memc1->t_close();
+  memc2->t_close();
+  VS((int)pool->m_idle.size(), 1);
+
+  // other servers get a pool of their own
+  p_Memcache memc3 = new_memcache(TEST_MEMCACHED_PORT + 1);
+  memc3->getConnection();
+  VERIFY(memc3->m_pool != pool);
+  memc3->t_close();
+
+  // and so do objects with other timeouts
+  p_Memcache memc4 = new_memcache();
+  memcached_st *mc = &memc4->m_memcache;
+  uint64_t timeout =
+    memcached_behavior_get(mc, MEMCACHED_BEHAVIOR_POLL_TIMEOUT);
+  memcached_behavior_set(mc, MEMCACHED_BEHAVIOR_POLL_TIMEOUT, timeout + 1);
+  VERIFY(MemcachePool::Get(mc) != pool);
+
+  if (memcache_running(memc1)) {
+    VERIFY(memc1->t_set("test_memcache_pool", "foo"));
+    memc1->t_close();
+    VS(memc2->t_get("test_memcache_pool"), "foo");
+    memc2->t_close();
+  }
+
+  RuntimeOption::MemcachePoolSize = poolSize;
+  return Count(true);
+}
+
+/**
+ * One get through a pool, from a thread of its own.
+ */
+class PoolGetter {
+public:
+  PoolGetter(MemcachePool *pool, const char *key)
+    : m_pool(pool), m_key(key), m_found(false), m_batches(0), m_keys(0) {}
+
+  void start() { pthread_create(&m_thread, NULL, Run, this); }
+  void join() { pthread_join(m_thread, NULL); }
+
+  MemcachePool *m_pool;
+  std::string m_key;
+  std::string m_value;
+  bool m_found;
+  int64 m_batches;
+  int64 m_keys;
+
+private:
+  pthread_t m_thread;
+
+  static void *Run(void *p) {
+    PoolGetter *getter = (PoolGetter*)p;
+    ServerStats::GetLogger();
+    memcached_st *mc = getter->m_pool->checkout();
+    uint32_t flags;
+    getter->m_found = getter->m_pool->get(mc, getter->m_key.data(),
+                                          getter->m_key.size(),
+                                          getter->m_value, flags);
+    getter->m_pool->checkin(mc);
+    getter->m_batches = ServerStats::Get("memcache.batch");
+    getter->m_keys = ServerStats::Get("memcache.batch_keys");
+    return NULL;
+  }
+};
+
+bool TestExtMemcache::test_memcache_coalesce_gets() {
+  bool enableStats = RuntimeOption::EnableStats;
+  bool enableWebStats = RuntimeOption::EnableWebStats;
+  RuntimeOption::EnableStats = RuntimeOption::EnableWebStats = true;
+
+  p_Memcache memc = new_memcache();
+  bool running = memcache_running(memc);
+  if (running) {
+    VERIFY(memc->t_set("test_memcache_coalesce", "foo"));
+    memc->t_delete("test_memcache_coalesce_missing");
+  }
+  MemcachePool *pool = MemcachePool::Get(&memc->m_memcache);
+
+  // with a fetch in flight to their server, gets queue up, and whichever
+  // comes first once it's done sends one batch for all of them
+  VS((int)pool->m_servers.size(), 1);
+  MemcachePool::Server &server = pool->m_servers[0];
+  {
+    Lock lock(pool);
+    server.fetching = true;
+  }
+  std::vector<PoolGetter*> getters;
+  for (int i = 0; i < 4; i++) {
+    getters.push_back(new PoolGetter(pool, i < 3 ?
+                                     "test_memcache_coalesce" :
+                                     "test_memcache_coalesce_missing"));
+    getters.back()->start();
+  }
+  while (true) {
+    {
+      Lock lock(pool);
+      if (server.pending.size() == getters.size()) {
+        server.fetching = false;
+        pool->notifyAll();
+        break;
+      }
+    }
+    usleep(1000);
+  }
+
+  int64 batches = 0, keys = 0;
+  for (unsigned int i = 0; i < getters.size(); i++) {
+    PoolGetter *getter = getters[i];
+    getter->join();
+    batches += getter->m_batches;
+    keys += getter->m_keys;
+    if (running) {
+      // the key asked for three times is fetched once and handed to all
+      VS(getter->m_found, i < 3);
+      if (i < 3) VS(getter->m_value, "foo");
+    } else {
+      VERIFY(!getter->m_found);
+    }
+    delete getter;
+  }
+  VS(batches, 1);
+  VS(keys, 4);
+
+  // a server that doesn't answer in time is skipped: the get gives up on
+  // the batch and asks on its own connection
+  {
+    Lock lock(pool);
+    server.fetching = true;
+  }
+  PoolGetter getter(pool, "test_memcache_coalesce");
+  getter.start();
+  getter.join();
+  VS(getter.m_found, running);
+  if (running) VS(getter.m_value, "foo");
+  VS(getter.m_batches, 0);
+  {
+    Lock lock(pool);
+    VERIFY(server.pending.empty());
+    server.fetching = false;
+  }
+
+  RuntimeOption::EnableStats = enableStats;
+  RuntimeOption::EnableWebStats = enableWebStats;
+  return Count(true);
+}
@@ -47,6 +47,9 @@ class TestExtMemcache : public TestCppExt {
   bool test_memcache_get_extended_stats();
   bool test_memcache_set_server_params();
   bool test_memcache_add_server();
+  bool test_memcache_hash_ini();
+  bool test_memcache_pool();
+  bool test_memcache_coalesce_gets();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
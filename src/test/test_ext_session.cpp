@@ -16,6 +16,7 @@
 
 #include <test/test_ext_session.h>
 #include <runtime/ext/ext_session.h>
+#include <runtime/ext/session_store.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -42,6 +43,7 @@ bool TestExtSession::RunTests(const std::string &which) {
   RUN_TEST(test_session_register);
   RUN_TEST(test_session_unregister);
   RUN_TEST(test_session_is_registered);
+  RUN_TEST(test_session_store);
 
   return ret;
 }
@@ -71,6 +73,8 @@ bool TestExtSession::test_session_name() {
 }
 
 bool TestExtSession::test_session_module_name() {
+  VS(f_session_module_name("shm"), "files");
+  VS(f_session_module_name("files"), "shm");
   return Count(true);
 }
 
@@ -154,3 +158,41 @@ bool TestExtSession::test_session_is_registered() {
   }
   return Count(false);
 }
+
+bool TestExtSession::test_session_store() {
+  SessionStore store;
+  String value;
+  int64 version = 0;
+  VERIFY(!store.read("sid", value, version));
+
+  VERIFY(store.write("sid", "a", version, 100));
+  int64 first = version;
+  VERIFY(first > 0);
+  int64 stale = 0;
+  VERIFY(!store.write("sid", "b", stale, 100));
+  VERIFY(store.write("sid", "b", version, 100));
+  VERIFY(version != first);
+  VERIFY(!store.write("sid", "c", first, 100));
+  VERIFY(store.read("sid", value, first));
+  VS(value, "b");
+  VS(first, version);
+  VS(store.size(), 1);
+
+  time_t now = time(NULL);
+  VS(store.sweep(now + 50), 0);
+  VERIFY(store.touch("sid", 1000));
+  VS(store.sweep(now + 500), 0);
+  VS(store.sweep(now + 2000), 1);
+  VS(store.size(), 0);
+  VERIFY(!store.read("sid", value, version));
+  VERIFY(!store.touch("sid", 1000));
+
+  version = 0;
+  VERIFY(store.write("sid", "d", version, 0));
+  VS(store.sweep(now + 1000000), 0);
+  VERIFY(store.remove("sid"));
+  VERIFY(!store.remove("sid"));
+  VS(store.size(), 0);
+  store.reclaim();
+  return Count(true);
+}
@@ -47,6 +47,7 @@ class TestExtSession : public TestCppExt {
   bool test_session_register();
   bool test_session_unregister();
   bool test_session_is_registered();
+  bool test_session_store();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
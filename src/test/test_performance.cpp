@@ -15,7 +15,14 @@
 */
 
 #include <test/test_performance.h>
+#include <runtime/base/array/hphp_array.h>
+#include <runtime/base/array/array_iterator.h>
+#include <runtime/base/variable_serializer.h>
+#include <runtime/base/builtin_functions.h>
+#include <runtime/ext/ext_array.h>
+#include <system/lib/systemlib.h>
 #include <util/util.h>
+#include <util/timer.h>
 
 using namespace std;
 
@@ -49,6 +56,10 @@ bool TestPerformance::RunTests(const std::string &which) {
   bool ret = true;
   RUN_TEST(TestBasicOperations);
   RUN_TEST(TestMemoryUsage);
+  RUN_TEST(TestHphpArrayLayout);
+  RUN_TEST(TestSerializerFormats);
+  RUN_TEST(TestThriftProtocols);
+  RUN_TEST(TestArraySort);
   RUN_TEST(TestAdHocFile);
   RUN_TEST(TestAdHoc);
   return ret;
@@ -147,6 +158,241 @@ bool TestPerformance::TestMemoryUsage() {
   return true;
 }
 
+bool TestPerformance::TestHphpArrayLayout() {
+  const int count = 1000000;
+  const int rounds = 10;
+
+  // Both arrays hold 0..count-1, but adding and removing a string key up
+  // front keeps the second one in the hashed layout.
+  HphpArray *packed = NEW(HphpArray)(0);
+  HphpArray *hashed = NEW(HphpArray)(0);
+  Array holdPacked(packed);
+  Array holdHashed(hashed);
+  hashed->set(String("x"), 0, false);
+  hashed->remove(String("x"), false);
+  for (int i = 0; i < count; i++) {
+    packed->append(i, false);
+    hashed->append(i, false);
+  }
+
+  HphpArray *arrays[] = { packed, hashed };
+  const char *names[] = { "packed", "hashed" };
+  for (int i = 0; i < 2; i++) {
+    int size = 0;
+    arrays[i]->calculate(size);
+    int64 sum = 0;
+    Timer timer(Timer::WallTime);
+    for (int r = 0; r < rounds; r++) {
+      for (ArrayIter iter(arrays[i]); !iter.end(); iter.next()) {
+        sum += iter.second().toInt64();
+      }
+    }
+    printf("%s layout: %d bytes for %d elements, %lld us to iterate "
+           "%d times (sum %lld)\n", names[i], size, count,
+           timer.getMicroSeconds(), rounds, sum);
+  }
+  return true;
+}
+
+bool TestPerformance::TestSerializerFormats() {
+  const int rows = 1000;
+  const int rounds = 100;
+
+  // a typical cached query result: rows of objects with the same properties
+  Array value;
+  for (int i = 0; i < rows; i++) {
+    Object row(SystemLib::AllocStdClassObject());
+    row->o_set("id", i * 1000003LL);
+    row->o_set("name", String("user") + String((int64)i));
+    row->o_set("score", i / 7.0);
+    row->o_set("tags", CREATE_VECTOR3("a", "bb", i));
+    value.append(row);
+  }
+
+  VariableSerializer::Type types[] = {
+    VariableSerializer::APCSerialize, VariableSerializer::BinarySerialize
+  };
+  VariableUnserializer::Type utypes[] = {
+    VariableUnserializer::APCSerialize, VariableUnserializer::BinarySerialize
+  };
+  const char *names[] = { "php", "binary" };
+  for (int i = 0; i < 2; i++) {
+    String s;
+    Timer encode(Timer::WallTime);
+    for (int r = 0; r < rounds; r++) {
+      VariableSerializer vs(types[i]);
+      s = vs.serialize(value, true);
+    }
+    int64 encodeTime = encode.getMicroSeconds();
+
+    int64 count = 0;
+    Timer decode(Timer::WallTime);
+    for (int r = 0; r < rounds; r++) {
+      count += unserialize_ex(s, utypes[i]).toArray().size();
+    }
+    int64 decodeTime = decode.getMicroSeconds();
+
+    printf("%s serializer: %d bytes for %d rows, %lld us to serialize and "
+           "%lld us to unserialize %d times (%lld rows)\n", names[i],
+           s.size(), rows, encodeTime, decodeTime, rounds, count);
+  }
+  return true;
+}
+
+bool TestPerformance::TestThriftProtocols() {
+  // a struct with a nested list of structs, written and read back through
+  // both protocols, so per-field spec lookups and property stores dominate
+  VCR("<?php\n"
+      "class TType {\n"
+      "  const BOOL = 2; const BYTE = 3; const DOUBLE = 4; const I16 = 6;\n"
+      "  const I32 = 8; const I64 = 10; const STRING = 11;\n"
+      "  const STRUCT = 12; const MAP = 13; const SET = 14; const LST = 15;\n"
+      "}\n"
+      "class DummyProtocol {\n"
+      "  public $t;\n"
+      "  function __construct() { $this->t = new DummyTransport(); }\n"
+      "  function getTransport() { return $this->t; }\n"
+      "}\n"
+      "class DummyTransport {\n"
+      "  public $buff = '';\n"
+      "  public $pos = 0;\n"
+      "  function flush() {}\n"
+      "  function write($buff) { $this->buff .= $buff; }\n"
+      "  function read($n) {\n"
+      "    $r = substr($this->buff, $this->pos, $n);\n"
+      "    $this->pos += $n;\n"
+      "    return $r;\n"
+      "  }\n"
+      "}\n"
+      "class Item {\n"
+      "  static $_TSPEC;\n"
+      "  public $id = null; public $name = null; public $score = null;\n"
+      "  public $active = null;\n"
+      "  function __construct() {\n"
+      "    if (!isset(self::$_TSPEC)) {\n"
+      "      self::$_TSPEC = array(\n"
+      "        1 => array('var' => 'id', 'type' => TType::I64),\n"
+      "        2 => array('var' => 'name', 'type' => TType::STRING),\n"
+      "        3 => array('var' => 'score', 'type' => TType::DOUBLE),\n"
+      "        4 => array('var' => 'active', 'type' => TType::BOOL));\n"
+      "    }\n"
+      "  }\n"
+      "}\n"
+      "class Result {\n"
+      "  static $_TSPEC;\n"
+      "  public $code = null; public $items = null; public $attrs = null;\n"
+      "  function __construct() {\n"
+      "    if (!isset(self::$_TSPEC)) {\n"
+      "      self::$_TSPEC = array(\n"
+      "        1 => array('var' => 'code', 'type' => TType::I32),\n"
+      "        2 => array('var' => 'items', 'type' => TType::LST,\n"
+      "                   'etype' => TType::STRUCT,\n"
+      "                   'elem' => array('type' => TType::STRUCT,\n"
+      "                                   'class' => 'Item')),\n"
+      "        3 => array('var' => 'attrs', 'type' => TType::MAP,\n"
+      "                   'ktype' => TType::STRING,\n"
+      "                   'vtype' => TType::I32,\n"
+      "                   'key' => array('type' => TType::STRING),\n"
+      "                   'val' => array('type' => TType::I32)));\n"
+      "    }\n"
+      "  }\n"
+      "}\n"
+      "function timing_get_cpu_time() {\n"
+      "  $rusage = getrusage();\n"
+      "  return ($rusage['ru_utime.tv_sec']*1000*1000 +\n"
+      "          $rusage['ru_utime.tv_usec'] +\n"
+      "          $rusage['ru_stime.tv_sec']*1000*1000 +\n"
+      "          $rusage['ru_stime.tv_usec']);\n"
+      "}\n"
+      "$v = new Result();\n"
+      "$v->code = 200;\n"
+      "$v->items = array();\n"
+      "for ($i = 0; $i < 100; $i++) {\n"
+      "  $item = new Item();\n"
+      "  $item->id = $i * 1000003;\n"
+      "  $item->name = 'item'.$i;\n"
+      "  $item->score = $i / 7;\n"
+      "  $item->active = ($i % 2) == 0;\n"
+      "  $v->items[] = $item;\n"
+      "}\n"
+      "$v->attrs = array('a' => 1, 'bb' => 2, 'ccc' => 3);\n"
+      "foreach (array('binary', 'compact') as $protocol) {\n"
+      "  $p = new DummyProtocol();\n"
+      "  $start = timing_get_cpu_time();\n"
+      "  for ($r = 0; $r < 1000; $r++) {\n"
+      "    $p->t->buff = '';\n"
+      "    if ($protocol == 'binary') {\n"
+      "      thrift_protocol_write_binary($p, 'm', 2, $v, 1, true);\n"
+      "    } else {\n"
+      "      thrift_protocol_write_compact($p, 'm', 2, $v, 1);\n"
+      "    }\n"
+      "  }\n"
+      "  $mid = timing_get_cpu_time();\n"
+      "  for ($r = 0; $r < 1000; $r++) {\n"
+      "    $p->t->pos = 0;\n"
+      "    if ($protocol == 'binary') {\n"
+      "      $w = thrift_protocol_read_binary($p, 'Result', true);\n"
+      "    } else {\n"
+      "      $w = thrift_protocol_read_compact($p, 'Result');\n"
+      "    }\n"
+      "  }\n"
+      "  $end = timing_get_cpu_time();\n"
+      "  if ($w != $v) {\n"
+      "    throw new Exception($protocol.' read back a different struct');\n"
+      "  }\n"
+      "  print $protocol.': '.strlen($p->t->buff).' bytes, '.\n"
+      "    (($mid - $start)/1000).'ms to write and '.\n"
+      "    (($end - $mid)/1000).\"ms to read 1000 times\\n\";\n"
+      "}\n");
+  return true;
+}
+
+bool TestPerformance::TestArraySort() {
+  const int count = 10000;
+  const int rounds = 20;
+
+  Array ints, mixed, strings, keyed;
+  unsigned int seed = 1;
+  for (int i = 0; i < count; i++) {
+    int64 n = rand_r(&seed);
+    ints.append(n);
+    mixed.append(n);
+    strings.append(String("item") + String(n));
+    keyed.set(String("key") + String(n), i);
+  }
+  // one double sends the whole array down the generic comparator path
+  mixed.set(0, 0.5);
+
+  struct {
+    const char *name;
+    char func;
+    CArrRef input;
+  } cases[] = {
+    { "sort(ints)", 's', ints },
+    { "sort(mixed)", 's', mixed },
+    { "sort(strings)", 's', strings },
+    { "asort(strings)", 'a', strings },
+    { "ksort(keyed)", 'k', keyed },
+    { "usort(strings, 'strcmp')", 'u', strings },
+  };
+  for (unsigned int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    Timer timer(Timer::WallTime);
+    for (int r = 0; r < rounds; r++) {
+      // an unshared copy, as a PHP array about to be sorted usually is
+      Variant arr = Array(cases[i].input->copy());
+      switch (cases[i].func) {
+      case 's': f_sort(ref(arr));             break;
+      case 'a': f_asort(ref(arr));            break;
+      case 'k': f_ksort(ref(arr));            break;
+      case 'u': f_usort(ref(arr), "strcmp");  break;
+      }
+    }
+    printf("%s: %lld us to sort %d elements %d times\n", cases[i].name,
+           timer.getMicroSeconds(), count, rounds);
+  }
+  return true;
+}
+
 bool TestPerformance::TestAdHocFile() {
   string input;
   FILE *f = fopen("test/perf_ad_hoc.php", "r");
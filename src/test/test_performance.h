@@ -32,6 +32,10 @@ class TestPerformance : public TestCodeRun {
 
   bool TestBasicOperations();
   bool TestMemoryUsage();
+  bool TestHphpArrayLayout();
+  bool TestSerializerFormats();
+  bool TestThriftProtocols();
+  bool TestArraySort();
   bool TestAdHocFile();
   bool TestAdHoc();
 };
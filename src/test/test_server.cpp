@@ -26,6 +26,7 @@
 #include <runtime/ext/ext_curl.h>
 #include <runtime/ext/ext_options.h>
 #include <runtime/base/server/http_request_handler.h>
+#include <runtime/base/server/libevent_multi_server.h>
 #include <runtime/base/util/http_client.h>
 #include <runtime/base/runtime_option.h>
 
@@ -172,6 +173,7 @@ bool TestServer::RunTests(const std::string &which) {
   // This needs to be the 1st, so to find a good server port.
   RUN_TEST(TestLibeventServer);
 
+  RUN_TEST(TestReusePortServer);
   RUN_TEST(TestInheritFdServer);
   RUN_TEST(TestSanity);
   RUN_TEST(TestServerVariables);
@@ -430,6 +432,53 @@ bool TestServer::TestLibeventServer() {
   return Count(true);
 }
 
+static ServerPtr new_reuse_port_server(int loops) {
+  LibEventMultiServer *server =
+    new LibEventMultiServer("127.0.0.1", s_server_port, loops * 2);
+  for (int i = 0; i < loops; i++) {
+    server->addLoop(ServerPtr
+      (new TypedServer<LibEventServerWithReusePort, TestRequestHandler>
+       ("127.0.0.1", s_server_port, 2, -1)));
+  }
+  return ServerPtr(server);
+}
+
+bool TestServer::TestReusePortServer() {
+  ServerPtr server = new_reuse_port_server(2);
+  server->start();
+
+  // a restarted server must not bind alongside the running one
+  ServerPtr second = new_reuse_port_server(2);
+  bool failed = false;
+  try {
+    second->start();
+  } catch (FailedToListenException e) {
+    failed = true;
+    VS(errno, EADDRINUSE);
+  }
+  VERIFY(failed);
+
+  // nor a single-loop one
+  ServerPtr single(new TypedServer<LibEventServer, TestRequestHandler>
+                   ("127.0.0.1", s_server_port, 2, -1));
+  failed = false;
+  try {
+    single->start();
+  } catch (FailedToListenException e) {
+    failed = true;
+  }
+  VERIFY(failed);
+
+  // once the old one is gone, the same server object can start
+  server->stop();
+  server->waitForEnd();
+  second->start();
+  VERIFY(second->getStatus() == Server::RUNNING);
+  second->stop();
+  second->waitForEnd();
+  return Count(true);
+}
+
 static bool PreBindSocketHelper(struct addrinfo *info) {
   if (info->ai_family != AF_INET && info->ai_family != AF_INET6) {
     printf("No IPV4/6 interface found.\n");
@@ -47,6 +47,7 @@ public:
   // test multithreaded request processing
   bool TestRequestHandling();
   bool TestLibeventServer();
+  bool TestReusePortServer();
 
   // test inheriting server fd
   bool TestInheritFdServer();
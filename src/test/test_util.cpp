@@ -17,6 +17,13 @@
 #include <test/test_util.h>
 #include <util/logger.h>
 #include <util/lfu_table.h>
+#include <util/job_queue.h>
+#include <util/byte_set.h>
+#include <util/async_log_writer.h>
+#include <util/stat_cache.h>
+#include <util/pgo_profile.h>
+#include <util/util.h>
+#include <compiler/compile_cache.h>
 #include <runtime/base/complex_types.h>
 #include <runtime/base/shared/shared_string.h>
 #include <runtime/base/zend/zend_string.h>
@@ -44,6 +51,12 @@ bool TestUtil::RunTests(const std::string &which) {
   RUN_TEST(TestSharedString);
   RUN_TEST(TestCanonicalize);
   RUN_TEST(TestHDF);
+  RUN_TEST(TestJobQueue);
+  RUN_TEST(TestByteSet);
+  RUN_TEST(TestAsyncLogWriter);
+  RUN_TEST(TestStatCache);
+  RUN_TEST(TestPgoProfile);
+  RUN_TEST(TestCompileCache);
   return ret;
 }
 
@@ -268,3 +281,314 @@ bool TestUtil::TestHDF() {
   node = doc["Node"];
   return Count(true);
 }
+
+static int s_jobSum;
+
+class SumWorker : public JobQueueWorker<int> {
+public:
+  virtual void doJob(int job) {
+    atomic_add(s_jobSum, job);
+  }
+};
+
+bool TestUtil::TestJobQueue() {
+  for (int stealing = 0; stealing < 2; stealing++) {
+    for (int lifo = 0; lifo < 2; lifo++) {
+      if (stealing && lifo) {
+        try {
+          JobQueueDispatcher<int, SumWorker> dispatcher(8, false, 0, false,
+                                                        NULL, true, true);
+          VERIFY(false);
+        } catch (Exception &e) {
+        }
+        continue;
+      }
+      s_jobSum = 0;
+      JobQueueDispatcher<int, SumWorker> dispatcher(8, false, 0, false, NULL,
+                                                    lifo, stealing);
+      dispatcher.start();
+      for (int i = 1; i <= 10000; i++) {
+        dispatcher.enqueue(i);
+      }
+      // stop() lets workers drain the queue first
+      dispatcher.stop();
+      VERIFY(s_jobSum == 10000 * 10001 / 2);
+      VERIFY(dispatcher.getQueuedJobs() == 0);
+    }
+  }
+  return Count(true);
+}
+
+bool TestUtil::TestByteSet() {
+  ByteSet quotes("\0'\"\\", 4);
+  ByteSet json("\"\\/", 3, true, true);
+
+  // long enough for both the 16-byte and the byte-by-byte loops
+  string s = "abcdefghijklmnopqrstuvwxyz0123456789";
+  const char *p = s.data();
+  const char *end = p + s.size();
+  VERIFY(quotes.find(p, end) == end);
+  VERIFY(json.find(p, end) == end);
+  VERIFY(quotes.find(p, p) == p);
+
+  for (unsigned int i = 0; i < s.size(); i++) {
+    string t = s;
+    t[i] = '\'';
+    VERIFY(quotes.find(t.data(), t.data() + t.size()) == t.data() + i);
+    VERIFY(json.find(t.data(), t.data() + t.size()) == t.data() + t.size());
+    t[i] = '\0';
+    VERIFY(quotes.find(t.data(), t.data() + t.size()) == t.data() + i);
+    t[i] = '\n';
+    VERIFY(json.find(t.data(), t.data() + t.size()) == t.data() + i);
+    t[i] = '\xe9';
+    VERIFY(json.find(t.data(), t.data() + t.size()) == t.data() + i);
+    VERIFY(quotes.find(t.data(), t.data() + t.size()) ==
+           t.data() + t.size());
+  }
+  VERIFY(json.contains('/'));
+  VERIFY(json.contains('\x1f'));
+  VERIFY(!json.contains(' '));
+  VERIFY(!json.contains('\x7f'));
+  return Count(true);
+}
+
+static string read_all(FILE *f) {
+  fflush(f);
+  rewind(f);
+  string ret;
+  char buf[1024];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    ret.append(buf, n);
+  }
+  return ret;
+}
+
+bool TestUtil::TestAsyncLogWriter() {
+  FILE *f = tmpfile();
+  AsyncLogWriter &writer = AsyncLogWriter::TheWriter;
+  int target = writer.addTarget(f, false);
+  writer.start();
+  int written = 0;
+  string expected;
+  for (int i = 0; i < 1000; i++) {
+    string line = boost::lexical_cast<string>(i) + "\n";
+    string copy = line;
+    if (writer.write(target, line)) {
+      expected += copy;
+      written++;
+    }
+    VERIFY(line.empty());
+  }
+  writer.stop();
+  VERIFY(writer.getWrittenCount() == written);
+  VERIFY(writer.getWrittenCount() + writer.getDroppedCount() == 1000);
+
+  VERIFY(read_all(f) == expected);
+  fclose(f);
+
+  // drain() writes queued lines on the calling thread, so they don't depend
+  // on the writer thread, which is stopped now, ever getting to them
+  f = tmpfile();
+  target = writer.addTarget(f, false);
+  string line = "one\n";
+  VERIFY(writer.write(target, line));
+  line = "two\n";
+  VERIFY(writer.write(target, line));
+  VERIFY(read_all(f) == "");
+  writer.drain();
+  VERIFY(read_all(f) == "one\ntwo\n");
+  line = "three\n";
+  VERIFY(writer.write(target, line));
+  VERIFY(writer.tryDrain(0));
+  VERIFY(read_all(f) == "one\ntwo\nthree\n");
+  VERIFY(writer.getWrittenCount() == written + 3);
+  fclose(f);
+  return Count(true);
+}
+
+static void write_file(const string &name, const char *content) {
+  FILE *f = fopen(name.c_str(), "w");
+  if (f) {
+    fputs(content, f);
+    fclose(f);
+  }
+}
+
+bool TestUtil::TestStatCache() {
+  char dir[] = "/tmp/test_stat_cache.XXXXXX";
+  VERIFY(mkdtemp(dir));
+  string root = dir;
+  string a = root + "/a", b = root + "/b", current = root + "/current";
+  string file = a + "/file.php", other = a + "/other.php";
+  VERIFY(mkdir(a.c_str(), 0777) == 0);
+  VERIFY(mkdir(b.c_str(), 0777) == 0);
+  VERIFY(symlink(a.c_str(), current.c_str()) == 0);
+  write_file(file, "<?php");
+  write_file(b + "/file.php", "<?php");
+
+  StatCache::Start(2);
+  struct stat s;
+  char resolved[PATH_MAX];
+  VERIFY(StatCache::Stat(file.c_str(), &s) == 0 && s.st_size == 5);
+  VERIFY(StatCache::Stat(file.c_str(), &s) == 0 && s.st_size == 5);
+  VERIFY(StatCache::Stat(other.c_str(), &s) == -1 && errno == ENOENT);
+  VERIFY(StatCache::Realpath((current + "/file.php").c_str(), resolved));
+  VERIFY(file == resolved);
+
+  // changes show up once inotify has told the cache about them
+  write_file(file, "<?php\n");
+  write_file(other, "<?php");
+  string next = root + "/next";
+  VERIFY(symlink(b.c_str(), next.c_str()) == 0);
+  VERIFY(rename(next.c_str(), current.c_str()) == 0);
+  usleep(200000);
+  VERIFY(StatCache::Stat(file.c_str(), &s) == 0 && s.st_size == 6);
+  VERIFY(StatCache::Stat(other.c_str(), &s) == 0);
+  VERIFY(StatCache::Realpath((current + "/file.php").c_str(), resolved));
+  VERIFY(b + "/file.php" == resolved);
+
+  // the swap dropped the watch on what current used to point to
+  string swapped = current + "/file.php";
+  VERIFY(StatCache::Stat(swapped.c_str(), &s) == 0 && s.st_size == 5);
+  write_file(b + "/file.php", "<?php\n\n");
+  usleep(200000);
+  VERIFY(StatCache::Stat(swapped.c_str(), &s) == 0 && s.st_size == 7);
+  StatCache::Stop();
+
+  string cmd = "rm -rf " + root;
+  system(cmd.c_str());
+  return Count(true);
+}
+
+static vector<string> make_stack(const char *frames) {
+  vector<string> stack;
+  Util::split(';', frames, stack);
+  return stack;
+}
+
+bool TestUtil::TestPgoProfile() {
+  PgoProfile profile;
+  profile.addStack(make_stack("main;render;escape"), 6);
+  profile.addStack(make_stack("main;render"), 3);
+  profile.addStack(make_stack("main;fib;fib;fib"), 1);
+  VERIFY(profile.getSamples() == 10);
+  VERIFY(profile.getSelf("escape") == 6);
+  VERIFY(profile.getTotal("render") == 9);
+  VERIFY(profile.getTotal("fib") == 1);
+  VERIFY(profile.getCalls("render", "escape") == 6);
+  VERIFY(profile.getCalls("fib", "fib") == 2);
+  VERIFY(profile.getCalls("escape", "render") == 0);
+
+  vector<string> hot;
+  profile.getHotFunctions(0.9, hot);
+  VERIFY(hot.size() == 2 && hot[0] == "escape" && hot[1] == "render");
+
+  // saved profiles add up when loaded
+  char path[] = "/tmp/test_pgo_profile.XXXXXX";
+  int fd = mkstemp(path);
+  VERIFY(fd >= 0);
+  close(fd);
+  VERIFY(profile.save(path));
+  PgoProfile loaded;
+  VERIFY(loaded.load(path));
+  VERIFY(loaded.load(path));
+  unlink(path);
+  VERIFY(loaded.getSamples() == 20);
+  VERIFY(loaded.getSelf("fib") == 2);
+  VERIFY(loaded.getTotal("main") == 20);
+  VERIFY(loaded.getCalls("main", "render") == 18);
+  return Count(true);
+}
+
+bool TestUtil::TestCompileCache() {
+  char dir[] = "/tmp/test_compile_cache_dir.XXXXXX";
+  VERIFY(mkdtemp(dir));
+  string d = dir;
+  write_file(d + "/a.cpp", "a");
+  write_file(d + "/b.cpp", "b");
+
+  CompileCache old;
+  old.setOptionsHash(CompileCache::HashString("options"));
+  old.setFileHash("a.php", "1");
+  old.setFileHash("b.php", "2");
+  old.setFileHash("c.php", "3");
+  old.setOutputHash("a.cpp", CompileCache::HashString("a"));
+  old.setOutputHash("b.cpp", CompileCache::HashString("b"));
+
+  // round trip
+  char path[] = "/tmp/test_compile_cache.XXXXXX";
+  int fd = mkstemp(path);
+  VERIFY(fd >= 0);
+  close(fd);
+  VERIFY(old.save(path));
+  CompileCache loaded;
+  VERIFY(loaded.load(path));
+  unlink(path);
+  VERIFY(loaded.getOptionsHash() == old.getOptionsHash());
+  vector<string> names;
+  loaded.getFiles(names);
+  VERIFY(names.size() == 3);
+  VERIFY(loaded.isUpToDate(old));
+  VERIFY(old.isUpToDate(loaded));
+  VERIFY(loaded.hasOutputs(d));
+
+  CompileCache current;
+  current.setOptionsHash(old.getOptionsHash());
+  current.setFileHash("a.php", "1");
+  current.setFileHash("b.php", "2");
+  current.setFileHash("c.php", "3");
+  VERIFY(loaded.isUpToDate(current));
+
+  // changed, new and removed files
+  current.setFileHash("c.php", "33");
+  VERIFY(!loaded.isUpToDate(current));
+  current.setFileHash("c.php", "3");
+  current.setFileHash("d.php", "4");
+  VERIFY(!loaded.isUpToDate(current));
+  CompileCache fewer;
+  fewer.setOptionsHash(old.getOptionsHash());
+  fewer.setFileHash("a.php", "1");
+  fewer.setFileHash("b.php", "2");
+  VERIFY(!loaded.isUpToDate(fewer));
+
+  // outputs that were edited or cleaned away have to be generated again
+  write_file(d + "/b.cpp", "B");
+  VERIFY(!loaded.hasOutputs(d));
+  write_file(d + "/b.cpp", "b");
+  VERIFY(loaded.hasOutputs(d));
+  unlink((d + "/b.cpp").c_str());
+  VERIFY(!loaded.hasOutputs(d));
+  unlink((d + "/a.cpp").c_str());
+  CompileCache noOutputs;
+  VERIFY(!noOutputs.hasOutputs(d));
+
+  // different options, or a file that can't be hashed, rebuild everything
+  CompileCache same;
+  same.setOptionsHash(CompileCache::HashString("other options"));
+  same.setFileHash("a.php", "1");
+  same.setFileHash("b.php", "2");
+  same.setFileHash("c.php", "3");
+  VERIFY(!loaded.isUpToDate(same));
+  same.setOptionsHash(old.getOptionsHash());
+  VERIFY(loaded.isUpToDate(same));
+  same.setFileHash("c.php", "");
+  VERIFY(!loaded.isUpToDate(same));
+
+  // profile directories hash by file names and contents
+  write_file(d + "/1.prof", "one");
+  write_file(d + "/2.prof", "two");
+  string hash = CompileCache::HashDir(d);
+  VERIFY(!hash.empty());
+  VERIFY(CompileCache::HashDir(d) == hash);
+  write_file(d + "/2.prof", "TWO");
+  string changed = CompileCache::HashDir(d);
+  VERIFY(changed != hash);
+  VERIFY(rename((d + "/2.prof").c_str(), (d + "/3.prof").c_str()) == 0);
+  VERIFY(CompileCache::HashDir(d) != changed);
+  unlink((d + "/1.prof").c_str());
+  unlink((d + "/3.prof").c_str());
+  rmdir(dir);
+  VERIFY(CompileCache::HashDir(d) == "");
+  return Count(true);
+}
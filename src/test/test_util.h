@@ -32,6 +32,12 @@ class TestUtil : public TestBase {
   bool TestSharedString();
   bool TestCanonicalize();
   bool TestHDF();
+  bool TestJobQueue();
+  bool TestByteSet();
+  bool TestAsyncLogWriter();
+  bool TestStatCache();
+  bool TestPgoProfile();
+  bool TestCompileCache();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
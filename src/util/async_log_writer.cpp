@@ -0,0 +1,298 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "async_log_writer.h"
+#include "logger.h"
+#include "lock.h"
+#include <sys/uio.h>
+#include <limits.h>
+
+using namespace std;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+int AsyncLogWriter::QueueSize = 4096;
+int AsyncLogWriter::FlushInterval = 10;
+AsyncLogWriter AsyncLogWriter::TheWriter;
+
+/**
+ * Only the owning thread moves m_tail, and only the thread holding
+ * m_flushMutex, normally the writer thread, moves m_head, so the entries
+ * between them belong to the writer.
+ */
+class AsyncLogWriter::Ring {
+public:
+  Ring(int size) : m_head(0), m_tail(0), m_dropped(0), m_orphaned(false) {
+    int n = 2;
+    while (n < size) n <<= 1;
+    m_entries.resize(n);
+    m_mask = n - 1;
+  }
+
+  struct Entry {
+    int target;
+    std::string line;
+  };
+  std::vector<Entry> m_entries;
+  uint32 m_mask;
+  volatile uint32 m_head;
+  volatile uint32 m_tail;
+  volatile int64 m_dropped;
+  volatile bool m_orphaned; // owning thread has exited
+};
+
+/**
+ * A thread's ring may still hold lines when the thread exits, so the ring is
+ * handed over to the writer thread to free, instead of being deleted here.
+ */
+class AsyncLogWriter::RingHolder {
+public:
+  RingHolder() : ring(NULL) {}
+  ~RingHolder() {
+    if (ring) ring->m_orphaned = true;
+  }
+  Ring *ring;
+};
+
+IMPLEMENT_THREAD_LOCAL(AsyncLogWriter::RingHolder, AsyncLogWriter::s_ring);
+
+///////////////////////////////////////////////////////////////////////////////
+
+AsyncLogWriter::AsyncLogWriter()
+  : m_thread(this, &AsyncLogWriter::threadFunc), m_flushMutex(false),
+    m_running(false),
+    m_stopped(false), m_written(0), m_retiredDropped(0) {
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+  stop();
+  for (unsigned int i = 0; i < m_rings.size(); i++) {
+    delete m_rings[i];
+  }
+  for (unsigned int i = 0; i < m_targets.size(); i++) {
+    delete m_targets[i];
+  }
+}
+
+int AsyncLogWriter::addTarget(FILE *f, bool isPipe) {
+  Target *target = new Target();
+  target->file = f;
+  target->isPipe = isPipe;
+  Lock lock(getMutex());
+  m_targets.push_back(target);
+  return m_targets.size() - 1;
+}
+
+int AsyncLogWriter::addTarget(Cronolog *cronolog) {
+  Target *target = new Target();
+  target->cronolog = cronolog;
+  Lock lock(getMutex());
+  m_targets.push_back(target);
+  return m_targets.size() - 1;
+}
+
+void AsyncLogWriter::start() {
+  Lock lock(getMutex());
+  if (m_running) return;
+  m_stopped = false;
+  m_running = true;
+  m_thread.start();
+}
+
+void AsyncLogWriter::stop() {
+  {
+    Lock lock(getMutex());
+    if (!m_running) return;
+    m_running = false;
+    m_stopped = true;
+    notify();
+  }
+  m_thread.waitForEnd();
+  // picks up lines pushed by threads that had not yet seen m_running change
+  drain();
+}
+
+void AsyncLogWriter::drain() {
+  Lock lock(m_flushMutex);
+  flush();
+}
+
+bool AsyncLogWriter::tryDrain(int timeoutMs) {
+  // not reentrant, so this fails on a thread that crashed inside flush()
+  for (int i = 0; !m_flushMutex.tryLock(); i++) {
+    if (i >= timeoutMs) return false;
+    usleep(1000);
+  }
+  flush();
+  m_flushMutex.unlock();
+  return true;
+}
+
+bool AsyncLogWriter::write(int target, std::string &line) {
+  RingHolder *holder = s_ring.get();
+  Ring *ring = holder->ring;
+  if (ring == NULL) {
+    ring = new Ring(QueueSize);
+    Lock lock(getMutex());
+    m_rings.push_back(ring);
+    holder->ring = ring;
+  }
+
+  uint32 tail = ring->m_tail;
+  if (tail - ring->m_head > ring->m_mask) {
+    ring->m_dropped++;
+    line.clear();
+    return false;
+  }
+  Ring::Entry &entry = ring->m_entries[tail & ring->m_mask];
+  entry.target = target;
+  entry.line.swap(line); // hands back the buffer the writer cleared
+  __sync_synchronize();
+  ring->m_tail = tail + 1;
+  return true;
+}
+
+int64 AsyncLogWriter::getWrittenCount() {
+  Lock lock(getMutex());
+  return m_written;
+}
+
+int64 AsyncLogWriter::getDroppedCount() {
+  Lock lock(getMutex());
+  int64 dropped = m_retiredDropped;
+  for (unsigned int i = 0; i < m_rings.size(); i++) {
+    dropped += m_rings[i]->m_dropped;
+  }
+  return dropped;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AsyncLogWriter::threadFunc() {
+  while (true) {
+    {
+      Lock lock(getMutex());
+      if (m_stopped) break;
+      wait(0, (long long)FlushInterval * 1000000);
+    }
+    drain();
+  }
+  drain();
+}
+
+void AsyncLogWriter::flush() {
+  vector<Ring*> rings;
+  vector<Target*> targets;
+  {
+    Lock lock(getMutex());
+    rings = m_rings;
+    targets = m_targets;
+  }
+
+  vector<uint32> tails(rings.size());
+  vector<vector<string*> > lines(targets.size());
+  for (unsigned int i = 0; i < rings.size(); i++) {
+    Ring *ring = rings[i];
+    tails[i] = ring->m_tail;
+    __sync_synchronize();
+    for (uint32 j = ring->m_head; j != tails[i]; j++) {
+      Ring::Entry &entry = ring->m_entries[j & ring->m_mask];
+      if (entry.target >= 0 && entry.target < (int)targets.size()) {
+        lines[entry.target].push_back(&entry.line);
+      }
+    }
+  }
+
+  int64 written = 0;
+  for (unsigned int i = 0; i < targets.size(); i++) {
+    if (!lines[i].empty()) {
+      writeTarget(*targets[i], lines[i]);
+      written += lines[i].size();
+    }
+  }
+
+  for (unsigned int i = 0; i < rings.size(); i++) {
+    Ring *ring = rings[i];
+    for (uint32 j = ring->m_head; j != tails[i]; j++) {
+      ring->m_entries[j & ring->m_mask].line.clear();
+    }
+    __sync_synchronize();
+    ring->m_head = tails[i];
+  }
+
+  Lock lock(getMutex());
+  m_written += written;
+  for (unsigned int i = 0; i < m_rings.size(); ) {
+    Ring *ring = m_rings[i];
+    if (ring->m_orphaned) {
+      __sync_synchronize();
+      if (ring->m_head == ring->m_tail) {
+        m_retiredDropped += ring->m_dropped;
+        delete ring;
+        m_rings[i] = m_rings.back();
+        m_rings.pop_back();
+        continue;
+      }
+    }
+    i++;
+  }
+}
+
+static void write_all(int fd, struct iovec *iov, int count) {
+  while (count > 0) {
+    ssize_t n = writev(fd, iov, count);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+    while (count > 0 && (size_t)n >= iov->iov_len) {
+      n -= iov->iov_len;
+      iov++;
+      count--;
+    }
+    if (count > 0) {
+      iov->iov_base = (char *)iov->iov_base + n;
+      iov->iov_len -= n;
+    }
+  }
+}
+
+void AsyncLogWriter::writeTarget(Target &target, vector<string*> &lines) {
+  FILE *f = target.cronolog ? target.cronolog->getOutputFile() : target.file;
+  if (f == NULL) return;
+  int fd = fileno(f);
+
+  struct iovec iov[IOV_MAX];
+  for (unsigned int i = 0; i < lines.size(); ) {
+    int count = 0;
+    while (count < IOV_MAX && i < lines.size()) {
+      string *line = lines[i++];
+      iov[count].iov_base = (void *)line->data();
+      iov[count].iov_len = line->size();
+      target.bytesWritten += line->size();
+      count++;
+    }
+    write_all(fd, iov, count);
+  }
+
+  if (!target.isPipe) {
+    Logger::checkDropCache(target.bytesWritten, target.prevBytesWritten, f);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
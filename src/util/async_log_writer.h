@@ -0,0 +1,120 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __ASYNC_LOG_WRITER_H__
+#define __ASYNC_LOG_WRITER_H__
+
+#include "base.h"
+#include "async_func.h"
+#include "synchronizable.h"
+#include "cronolog.h"
+#include "thread_local.h"
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Moves log file I/O off the threads that produce log lines.
+ *
+ * Each producing thread gets a fixed size ring of lines that only it pushes
+ * to and only the writer thread pops from, so neither side takes a lock. The
+ * writer thread wakes up every FlushInterval milliseconds, collects whatever
+ * all rings hold, and hands each target's lines to one writev() call. When a
+ * thread's ring is full, the line is dropped and counted, rather than making
+ * a request wait on the disk.
+ *
+ * Lines from one thread stay in order, but lines from different threads may
+ * be interleaved differently from when they were produced.
+ */
+class AsyncLogWriter : public Synchronizable {
+public:
+  static int QueueSize;     // lines each thread can have waiting
+  static int FlushInterval; // in milliseconds
+  static AsyncLogWriter TheWriter;
+
+public:
+  AsyncLogWriter();
+  ~AsyncLogWriter();
+
+  /**
+   * Registers an output, and returns the id to write() lines to. Cronolog
+   * targets are rotated by the writer thread. Drop cache accounting is
+   * skipped for pipes.
+   */
+  int addTarget(FILE *f, bool isPipe);
+  int addTarget(Cronolog *cronolog);
+
+  void start();
+  bool isRunning() const { return m_running; }
+
+  /**
+   * Writes out everything queued so far and stops the writer thread.
+   */
+  void stop();
+
+  /**
+   * Writes out everything queued so far on the calling thread, so lines that
+   * must not be lost, like the last ones before a crash, don't wait for the
+   * writer thread. tryDrain() gives up after timeoutMs if another thread is
+   * writing, e.g. when that thread crashed in the middle of it; it is for
+   * signal handlers.
+   */
+  void drain();
+  bool tryDrain(int timeoutMs);
+
+  /**
+   * Takes over line's content without copying, so line is left empty.
+   * Returns false if the line was dropped.
+   */
+  bool write(int target, std::string &line);
+
+  int64 getWrittenCount();
+  int64 getDroppedCount();
+
+private:
+  class Ring;
+  class RingHolder;
+  class Target {
+  public:
+    Target() : file(NULL), isPipe(false), cronolog(NULL),
+               bytesWritten(0), prevBytesWritten(0) {}
+    FILE *file;
+    bool isPipe;
+    Cronolog *cronolog;
+    int bytesWritten;
+    int prevBytesWritten;
+  };
+
+  std::vector<Target*> m_targets;
+  std::vector<Ring*> m_rings;
+  AsyncFunc<AsyncLogWriter> m_thread;
+  Mutex m_flushMutex; // one thread at a time consumes the rings
+  bool m_running;
+  bool m_stopped;
+  int64 m_written;
+  int64 m_retiredDropped; // from rings of threads that have exited
+
+  static DECLARE_THREAD_LOCAL(RingHolder, s_ring);
+
+  void threadFunc();
+  void flush();
+  void writeTarget(Target &target, std::vector<std::string*> &lines);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __ASYNC_LOG_WRITER_H__
@@ -0,0 +1,95 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_BYTE_SET_H__
+#define __HPHP_BYTE_SET_H__
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A set of bytes to look for in a string, for escaping functions to copy
+ * everything up to the next byte that needs escaping in one go. Besides up
+ * to MaxBytes given bytes, control characters (below 0x20) and bytes with
+ * the high bit set can be included as whole ranges. With SSE2, find() tests
+ * 16 bytes a time.
+ */
+class ByteSet {
+public:
+  static const int MaxBytes = 8;
+
+  ByteSet(const char *bytes, int count, bool controls = false,
+          bool highBit = false)
+    : m_count(count), m_controls(controls), m_highBit(highBit) {
+    memset(m_table, 0, sizeof(m_table));
+    for (int i = 0; i < count && i < MaxBytes; i++) {
+      m_bytes[i] = bytes[i];
+      m_table[(unsigned char)bytes[i]] = true;
+    }
+    if (m_count > MaxBytes) m_count = MaxBytes;
+    for (int c = 0; c < 256; c++) {
+      if ((controls && c < 0x20) || (highBit && c >= 0x80)) {
+        m_table[c] = true;
+      }
+    }
+  }
+
+  bool contains(char c) const { return m_table[(unsigned char)c];}
+
+  /**
+   * Position of the first byte in [p, end) that is in this set, or end.
+   */
+  const char *find(const char *p, const char *end) const {
+#ifdef __SSE2__
+    const __m128i low = _mm_set1_epi8(0x1f);
+    while (end - p >= 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)p);
+      __m128i hit = _mm_setzero_si128();
+      for (int i = 0; i < m_count; i++) {
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8(m_bytes[i])));
+      }
+      if (m_controls) {
+        // unsigned v <= 0x1f
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(v, low), v));
+      }
+      int mask = _mm_movemask_epi8(hit);
+      if (m_highBit) mask |= _mm_movemask_epi8(v);
+      if (mask) return p + __builtin_ctz(mask);
+      p += 16;
+    }
+#endif
+    while (p < end && !m_table[(unsigned char)*p]) p++;
+    return p;
+  }
+
+private:
+  char m_bytes[MaxBytes];
+  int m_count;
+  bool m_controls;
+  bool m_highBit;
+  bool m_table[256];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_BYTE_SET_H__
@@ -22,6 +22,9 @@
 #include "async_job.h"
 #include "util.h"
 #include <boost/lexical_cast.hpp>
+#ifdef HAVE_MYSQL_NONBLOCKING
+#include <sys/epoll.h>
+#endif
 
 using namespace std;
 using namespace boost;
@@ -97,6 +100,8 @@ const std::string &ServerData::getPassword() const {
 unsigned int DBConn::DefaultWorkerCount = 50;
 unsigned int DBConn::DefaultConnectTimeout = 1000;
 unsigned int DBConn::DefaultReadTimeout = 1000;
+bool DBConn::UseEventLoop = true;
+DBConn::QueryStatsHook DBConn::ParallelQueryStats = NULL;
 
 Mutex DBConn::s_mutex;
 DBConn::DatabaseMap DBConn::s_localDatabases;
@@ -115,6 +120,12 @@ void DBConn::AddLocalDB(int dbId, const char *ip, const char *db,
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static int64 now_usec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 DBConn::DBConn(int maxRetryOpenOnFail, int maxRetryQueryOnFail)
   : m_conn(NULL), m_connectTimeout(DefaultConnectTimeout),
     m_readTimeout(DefaultReadTimeout),
@@ -315,14 +326,344 @@ int DBConn::parallelExecute(const ServerQueryVec &sqls, DBDataSetPtrVec &dss,
   return parallelExecute(jobs, errors, maxThread);
 }
 
+#ifdef HAVE_MYSQL_NONBLOCKING
+///////////////////////////////////////////////////////////////////////////////
+// event loop for parallel executions
+
+/**
+ * Runs each job as a state machine over one nonblocking connection, with all
+ * connections waited on by one epoll descriptor. Like threads of the pool, at
+ * most maxConn connections are open at a time. Timeouts are the same socket
+ * timeouts the pool sets, reported by the client library as MYSQL_WAIT_TIMEOUT.
+ */
+class DBConn::QueryLoop {
+public:
+  QueryLoop(QueryJobPtrVec &jobs, int maxConn);
+  ~QueryLoop();
+
+  /**
+   * Returns false without running any job if no epoll descriptor is
+   * available.
+   */
+  bool run();
+
+private:
+  enum State { Idle, Connecting, Querying, Storing, Done };
+
+  class Query {
+  public:
+    Query() : job(NULL), conn(NULL), connRet(NULL), result(NULL), err(0),
+              state(Idle), fd(-1), timeout(0), attempts(0), start(0) {}
+    QueryJob *job;
+    MYSQL *conn;
+    MYSQL *connRet;
+    MYSQL_RES *result;
+    int err;
+    State state;
+    int fd;        // registered with epoll, or -1
+    int64 timeout; // when the client library wants to be called back, or 0
+    int attempts;  // connections tried
+    int64 start;
+  };
+
+  std::vector<Query> m_queries;
+  int m_maxConn;
+  int m_epoll;
+  unsigned int m_next;
+  int m_active;
+
+  void start(Query &q);
+  void connect(Query &q);
+  void advance(Query &q, int ready);
+  void step(Query &q, int status);
+  void wait(Query &q, int status);
+  void connectFailed(Query &q);
+  void queryFailed(Query &q);
+  void stored(Query &q);
+  void closeConn(Query &q);
+  void finish(Query &q);
+};
+
+DBConn::QueryLoop::QueryLoop(QueryJobPtrVec &jobs, int maxConn)
+  : m_queries(jobs.size()), m_maxConn(maxConn), m_next(0), m_active(0) {
+  for (unsigned int i = 0; i < jobs.size(); i++) {
+    m_queries[i].job = jobs[i].get();
+  }
+  m_epoll = epoll_create(maxConn);
+}
+
+DBConn::QueryLoop::~QueryLoop() {
+  for (unsigned int i = 0; i < m_queries.size(); i++) {
+    closeConn(m_queries[i]);
+  }
+  if (m_epoll >= 0) ::close(m_epoll);
+}
+
+bool DBConn::QueryLoop::run() {
+  if (m_epoll < 0) return false;
+
+  vector<struct epoll_event> events(m_maxConn);
+  while (true) {
+    while (m_next < m_queries.size() && m_active < m_maxConn) {
+      start(m_queries[m_next++]);
+    }
+    if (m_active == 0) break;
+
+    int64 now = now_usec();
+    int timeout = -1;
+    for (unsigned int i = 0; i < m_next; i++) {
+      Query &q = m_queries[i];
+      if (q.state != Done && q.timeout) {
+        int ms = q.timeout > now ? (q.timeout - now + 999) / 1000 : 0;
+        if (timeout < 0 || ms < timeout) timeout = ms;
+      }
+    }
+
+    int n = epoll_wait(m_epoll, &events[0], events.size(), timeout);
+    if (n < 0 && errno != EINTR) {
+      string msg = "(epoll_wait failed: " + Util::safe_strerror(errno) + ")";
+      for (unsigned int i = 0; i < m_next; i++) {
+        Query &q = m_queries[i];
+        if (q.state != Done) {
+          q.job->m_affected = -1;
+          q.job->m_error.code = -1;
+          q.job->m_error.msg = msg;
+          finish(q);
+        }
+      }
+      continue;
+    }
+    for (int i = 0; i < n; i++) {
+      Query &q = m_queries[events[i].data.u32];
+      uint32 e = events[i].events;
+      int ready = 0;
+      if (e & (EPOLLIN | EPOLLERR | EPOLLHUP)) ready |= MYSQL_WAIT_READ;
+      if (e & (EPOLLOUT | EPOLLERR | EPOLLHUP)) ready |= MYSQL_WAIT_WRITE;
+      if (e & EPOLLPRI) ready |= MYSQL_WAIT_EXCEPT;
+      if (q.state != Done) advance(q, ready);
+    }
+
+    now = now_usec();
+    for (unsigned int i = 0; i < m_next; i++) {
+      Query &q = m_queries[i];
+      if (q.state != Done && q.timeout && q.timeout <= now) {
+        advance(q, MYSQL_WAIT_TIMEOUT);
+      }
+    }
+  }
+  return true;
+}
+
+void DBConn::QueryLoop::start(Query &q) {
+  QueryJob *job = q.job;
+  Util::replaceAll(job->m_sql, "INDEX",
+                   lexical_cast<string>(job->m_index).c_str());
+  q.start = now_usec();
+  m_active++;
+
+  if (!job->m_server) {
+    job->m_affected = -1;
+    job->m_error.code = -1;
+    job->m_error.msg = "(server info missing)";
+    finish(q);
+    return;
+  }
+  connect(q);
+}
+
+void DBConn::QueryLoop::connect(Query &q) {
+  QueryJob *job = q.job;
+  int connectTimeout = job->m_connectTimeout;
+  int readTimeout = job->m_readTimeout;
+  if (connectTimeout <= 0) connectTimeout = DefaultConnectTimeout;
+  if (readTimeout <= 0) readTimeout = DefaultReadTimeout;
+
+  q.attempts++;
+  q.conn = mysql_init(NULL);
+  mysql_options(q.conn, MYSQL_OPT_NONBLOCK, 0);
+  MySQLUtil::set_mysql_timeout(q.conn, MySQLUtil::ConnectTimeout,
+                               connectTimeout);
+  MySQLUtil::set_mysql_timeout(q.conn, MySQLUtil::ReadTimeout, readTimeout);
+
+  ServerData &server = *job->m_server;
+  q.state = Connecting;
+  int status = mysql_real_connect_start(&q.connRet, q.conn,
+                                        server.getIP().c_str(),
+                                        server.getUserName().c_str(),
+                                        server.getPassword().c_str(),
+                                        server.getDatabase().c_str(),
+                                        server.getPort(), NULL, 0);
+  step(q, status);
+}
+
+void DBConn::QueryLoop::advance(Query &q, int ready) {
+  int status = 0;
+  switch (q.state) {
+  case Connecting:
+    status = mysql_real_connect_cont(&q.connRet, q.conn, ready);
+    break;
+  case Querying:
+    status = mysql_real_query_cont(&q.err, q.conn, ready);
+    break;
+  case Storing:
+    status = mysql_store_result_cont(&q.result, q.conn, ready);
+    break;
+  default:
+    ASSERT(false);
+    return;
+  }
+  step(q, status);
+}
+
+void DBConn::QueryLoop::step(Query &q, int status) {
+  while (status == 0) {
+    switch (q.state) {
+    case Connecting:
+      if (q.connRet == NULL) {
+        connectFailed(q);
+        return;
+      }
+      q.state = Querying;
+      status = mysql_real_query_start(&q.err, q.conn, q.job->m_sql.data(),
+                                      q.job->m_sql.size());
+      break;
+    case Querying:
+      if (q.err) {
+        queryFailed(q);
+        return;
+      }
+      q.state = Storing;
+      status = mysql_store_result_start(&q.result, q.conn);
+      break;
+    case Storing:
+      stored(q);
+      return;
+    default:
+      ASSERT(false);
+      return;
+    }
+  }
+  wait(q, status);
+}
+
+void DBConn::QueryLoop::wait(Query &q, int status) {
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  if (status & MYSQL_WAIT_READ) ev.events |= EPOLLIN;
+  if (status & MYSQL_WAIT_WRITE) ev.events |= EPOLLOUT;
+  if (status & MYSQL_WAIT_EXCEPT) ev.events |= EPOLLPRI;
+  ev.data.u32 = &q - &m_queries[0];
+
+  int fd = mysql_get_socket(q.conn);
+  if (fd != q.fd) {
+    if (q.fd >= 0) epoll_ctl(m_epoll, EPOLL_CTL_DEL, q.fd, NULL);
+    q.fd = fd;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &ev);
+  } else {
+    epoll_ctl(m_epoll, EPOLL_CTL_MOD, fd, &ev);
+  }
+
+  q.timeout = 0;
+  if (status & MYSQL_WAIT_TIMEOUT) {
+    q.timeout = now_usec() + (int64)mysql_get_timeout_value_ms(q.conn) * 1000;
+  }
+}
+
+void DBConn::QueryLoop::connectFailed(Query &q) {
+  QueryJob *job = q.job;
+  int code = mysql_errno(q.conn);
+  const char *msg = mysql_error(q.conn);
+  string smsg = msg ? msg : "";
+  closeConn(q);
+
+  // same as the pool, which retries opening but not queries
+  if (job->m_retryQueryOnFail && q.attempts <= job->m_maxRetryQueryOnFail) {
+    connect(q);
+    return;
+  }
+  DBConnectionException e(code, job->m_server->getIP().c_str(),
+                          job->m_server->getDatabase().c_str(),
+                          smsg.c_str());
+  job->m_affected = -1;
+  job->m_error.code = code;
+  job->m_error.msg = e.getMessage();
+  finish(q);
+}
+
+void DBConn::QueryLoop::queryFailed(Query &q) {
+  QueryJob *job = q.job;
+  int code = mysql_errno(q.conn);
+  DatabaseException e(code, "Failed to execute SQL '%s': %s (%d)",
+                      job->m_sql.c_str(), mysql_error(q.conn), code);
+  job->m_affected = -1;
+  job->m_error.code = code;
+  job->m_error.msg = e.getMessage();
+  finish(q);
+}
+
+void DBConn::QueryLoop::stored(Query &q) {
+  QueryJob *job = q.job;
+  if (q.result == NULL && mysql_errno(q.conn)) {
+    queryFailed(q);
+    return;
+  }
+
+  job->m_affected = mysql_affected_rows(q.conn);
+  if (job->m_dsResult) {
+    DBDataSet ds;
+    ds.addResult(q.conn, q.result);
+    job->m_dsResult->addDataSet(ds);
+  } else {
+    mysql_free_result(q.result);
+  }
+  q.result = NULL;
+  finish(q);
+}
+
+void DBConn::QueryLoop::closeConn(Query &q) {
+  if (q.fd >= 0) {
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, q.fd, NULL);
+    q.fd = -1;
+  }
+  if (q.result) {
+    mysql_free_result(q.result);
+    q.result = NULL;
+  }
+  if (q.conn) {
+    mysql_close(q.conn);
+    q.conn = NULL;
+  }
+  q.timeout = 0;
+}
+
+void DBConn::QueryLoop::finish(Query &q) {
+  closeConn(q);
+  q.state = Done;
+  q.job->m_usec = now_usec() - q.start;
+  m_active--;
+}
+
+#endif // HAVE_MYSQL_NONBLOCKING
+
 int DBConn::parallelExecute(QueryJobPtrVec &jobs, ErrorInfoMap &errors,
                             int maxThread) {
   if (maxThread <= 0) maxThread = DefaultWorkerCount;
-  JobDispatcher<QueryJob, QueryWorker>(jobs, maxThread).run();
+  bool done = false;
+#ifdef HAVE_MYSQL_NONBLOCKING
+  if (UseEventLoop) {
+    done = QueryLoop(jobs, maxThread).run();
+  }
+#endif
+  if (!done) {
+    JobDispatcher<QueryJob, QueryWorker>(jobs, maxThread).run();
+  }
 
   int affected = 0;
   for (unsigned int i = 0; i < jobs.size(); i++) {
     QueryJobPtr job = jobs[i];
+    if (ParallelQueryStats && job->m_server) {
+      ParallelQueryStats(*job->m_server, job->m_usec, job->m_affected >= 0);
+    }
 
     int count = job->m_affected;
     if (count >= 0) {
@@ -335,6 +676,12 @@ int DBConn::parallelExecute(QueryJobPtrVec &jobs, ErrorInfoMap &errors,
 }
 
 void DBConn::QueryWorker::doJob(QueryJobPtr job) {
+  int64 start = now_usec();
+  doJobImpl(job);
+  job->m_usec = now_usec() - start;
+}
+
+void DBConn::QueryWorker::doJobImpl(QueryJobPtr job) {
   string &sql = job->m_sql;
   Util::replaceAll(sql, "INDEX", lexical_cast<string>(job->m_index).c_str());
 
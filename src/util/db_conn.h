@@ -95,6 +95,21 @@ class DBConn {
   static unsigned int DefaultConnectTimeout;
   static unsigned int DefaultReadTimeout;
 
+  /**
+   * Whether parallelExecute() multiplexes all its queries over nonblocking
+   * connections on the calling thread, instead of running them on a pool of
+   * threads. Only takes effect when built with HAVE_MYSQL_NONBLOCKING.
+   */
+  static bool UseEventLoop;
+
+  /**
+   * Called on the calling thread for each query of a parallelExecute(), with
+   * how long it took in microseconds, including connecting and retries.
+   */
+  typedef void (*QueryStatsHook)(const ServerData &server, int64 usec,
+                                 bool success);
+  static QueryStatsHook ParallelQueryStats;
+
  public:
   DBConn(int maxRetryOpenOnFail = 0, int maxRetryQueryOnFail = 1);
   ~DBConn();
@@ -192,7 +207,7 @@ class DBConn {
         m_retryQueryOnFail(retryQueryOnFail), m_connectTimeout(connectTimeout),
         m_readTimeout(readTimeout),
         m_maxRetryOpenOnFail(maxRetryOpenOnFail),
-        m_maxRetryQueryOnFail(maxRetryQueryOnFail) {}
+        m_maxRetryQueryOnFail(maxRetryQueryOnFail), m_usec(0) {}
 
     ServerDataPtr m_server;
     std::string m_sql;
@@ -206,6 +221,7 @@ class DBConn {
     int m_readTimeout;
     int m_maxRetryOpenOnFail;
     int m_maxRetryQueryOnFail;
+    int64 m_usec;
   };
 
   class QueryWorker {
@@ -213,10 +229,16 @@ class DBConn {
     void onThreadEnter() {}
     void doJob(QueryJobPtr job);
     void onThreadExit() { mysql_thread_end();}
+  private:
+    void doJobImpl(QueryJobPtr job);
   };
 
   static int parallelExecute(QueryJobPtrVec &jobs, ErrorInfoMap &errors,
                              int maxThread);
+
+#ifdef HAVE_MYSQL_NONBLOCKING
+  class QueryLoop;
+#endif
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -19,6 +19,7 @@
 #include "compression.h"
 #include "util.h"
 #include "logger.h"
+#include "hash.h"
 #include <sys/mman.h>
 
 using namespace std;
@@ -84,6 +85,7 @@ void FileCache::writeDirectories(const char *name) {
         buffer.data = NULL;
         buffer.clen = -2;
         buffer.cdata = NULL;
+        buffer.hash = 0;
       }
     }
   }
@@ -113,6 +115,7 @@ void FileCache::write(const char *name, bool addDirectories /* = true */) {
   buffer.data = NULL;
   buffer.clen = -1;
   buffer.cdata = NULL;
+  buffer.hash = 0;
 
   if (addDirectories) {
     writeDirectories(name);
@@ -135,6 +138,7 @@ void FileCache::write(const char *name, const char *fullpath) {
   buffer.data = NULL;
   buffer.clen = -1;
   buffer.cdata = NULL;
+  buffer.hash = 0;
 
   if (len) {
     FILE *f = fopen(fullpath, "r");
@@ -274,6 +278,7 @@ void FileCache::load(const char *filename, bool onDemandUncompress,
     buffer.data = NULL;
     buffer.clen = -1;
     buffer.cdata = NULL;
+    buffer.hash = 0;
 
     if (len > 0) {
       buffer.data = (char *)malloc(len + 1);
@@ -377,6 +382,7 @@ void FileCache::loadMmap(const char *filename, short version) {
     buffer.data = NULL;
     buffer.clen = -1;
     buffer.cdata = NULL;
+    buffer.hash = 0;
 
     if (len > 0) {
       if (p + len >= e) {
@@ -436,11 +442,23 @@ bool FileCache::exists(const char *name,
   return exists(GetRelativePath(name).c_str());
 }
 
-char *FileCache::read(const char *name, int &len, bool &compressed) const {
+char *FileCache::read(const char *name, int &len, bool &compressed,
+                      int64 *hash /* = NULL */) const {
   if (name && *name) {
     FileMap::const_iterator iter = m_files.find(name);
     if (iter != m_files.end()) {
       const Buffer &buf = iter->second;
+      if (hash) {
+        if (!buf.hash) {
+          // racing readers all store the same value
+          const char *archived = buf.cdata ? buf.cdata : buf.data;
+          int alen = buf.cdata ? buf.clen : buf.len;
+          if (alen > 0) {
+            buf.hash = hash_string_cs(archived, alen) ^ hash_int64(alen);
+          }
+        }
+        *hash = buf.hash;
+      }
       if (compressed && buf.cdata) {
         len = buf.clen;
         ASSERT(len > 0);
@@ -52,7 +52,8 @@ public:
   bool fileExists(const char *name, bool isRelative = true) const;
   bool dirExists(const char *name, bool isRelative = true) const;
   bool exists(const char *name, bool isRelative = true) const;
-  char *read(const char *name, int &len, bool &compressed) const;
+  char *read(const char *name, int &len, bool &compressed,
+             int64 *hash = NULL) const;
   int64 fileSize(const char *name, bool isRelative) const;
   void dump();
 
@@ -63,6 +64,9 @@ private:
     char *data;  // uncompressed data
     int clen;    // compressed len
     char *cdata; // compressed data
+    // of the archived bytes, only computed the first time a read asks for
+    // it, so loading doesn't touch every page of the archive
+    mutable int64 hash;
   };
   typedef hphp_hash_map<std::string, Buffer, string_hash> FileMap;
 
@@ -63,6 +63,15 @@ namespace HPHP {
  * store prepared jobs. With JobQueueDispatcher, job queue is normally empty
  * initially and new jobs are pushed into the queue over time. Also, workers
  * can be stopped individually.
+ *
+ * With "workStealing" on, jobs are spread over one small deque per worker
+ * instead of going through the queue's single lock. A worker serves its own
+ * deque first, then steals from the others, and spins for a while before it
+ * goes to sleep. The queue lock is then only taken to put workers to sleep
+ * and to wake them up.
+ *
+ * "lifo" can't be combined with it: with jobs spread over many deques, no
+ * worker can tell which job is the newest in the queue.
  */
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -81,17 +90,35 @@ public:
    * Constructor.
    */
   JobQueue(int threadCount, bool threadRoundRobin, int dropCacheTimeout,
-           bool dropStack, bool lifo)
+           bool dropStack, bool lifo, bool workStealing = false)
       : SynchronizableMulti(threadRoundRobin ? 1 : threadCount),
         m_jobCount(0), m_stopped(false), m_workerCount(0),
         m_dropCacheTimeout(dropCacheTimeout), m_dropStack(dropStack),
-        m_lifo(lifo) {
+        m_lifo(lifo), m_sleepers(0), m_nextDeque(0) {
+    if (workStealing) {
+      if (lifo) {
+        throw Exception("JobQueue: lifo can't be used with work stealing");
+      }
+      for (int i = 0; i < threadCount; i++) {
+        m_deques.push_back(new WorkerDeque());
+      }
+    }
+  }
+
+  ~JobQueue() {
+    for (unsigned int i = 0; i < m_deques.size(); i++) {
+      delete m_deques[i];
+    }
   }
 
   /**
    * Put a job into the queue and notify a worker to pick it up.
    */
   void enqueue(TJob job) {
+    if (!m_deques.empty()) {
+      enqueueStealing(job);
+      return;
+    }
     Lock lock(this);
     m_jobs.push_back(job);
     m_jobCount = m_jobs.size();
@@ -104,6 +131,9 @@ public:
    * the job object correctly.
    */
   TJob dequeue(int id, bool inc = false) {
+    if (!m_deques.empty()) {
+      return dequeueStealing(id, inc);
+    }
     Lock lock(this);
     bool flushed = false;
     while (m_jobs.empty()) {
@@ -168,6 +198,17 @@ public:
   }
 
  private:
+  // Spinning doubles when a job showed up in time, and halves when not.
+  static const int MinSpins = 16;
+  static const int MaxSpins = 16384;
+
+  struct WorkerDeque {
+    WorkerDeque() : spins(MinSpins) {}
+    SpinLock lock;
+    std::deque<TJob> jobs;
+    int spins; // only touched by the deque's own worker
+  };
+
   int m_jobCount;
   std::deque<TJob> m_jobs;
   bool m_stopped;
@@ -175,15 +216,106 @@ public:
   int m_dropCacheTimeout;
   bool m_dropStack;
   bool m_lifo;
+
+  std::vector<WorkerDeque*> m_deques;
+  int m_sleepers;
+  int m_nextDeque;
+
+  void enqueueStealing(TJob job) {
+    // Counted before it is visible, so m_jobCount never drops below zero.
+    atomic_inc(m_jobCount);
+    WorkerDeque *q =
+      m_deques[(unsigned int)atomic_inc(m_nextDeque) % m_deques.size()];
+    {
+      BaseConditionalLock<SpinLock> lock(q->lock, true, false);
+      q->jobs.push_back(job);
+    }
+    // atomic_inc() above is a full barrier, so either we see a sleeper here,
+    // or the sleeper sees the job after registering itself.
+    if (*(volatile int *)&m_sleepers > 0) {
+      Lock lock(this);
+      notify();
+    }
+  }
+
+  bool takeJob(int id, TJob &job) {
+    if (*(volatile int *)&m_jobCount <= 0) return false;
+    int count = m_deques.size();
+    for (int i = 0; i < count; i++) {
+      WorkerDeque *q = m_deques[(id + i) % count];
+      BaseConditionalLock<SpinLock> lock(q->lock, true, false);
+      if (q->jobs.empty()) continue;
+      job = q->jobs.front();
+      q->jobs.pop_front();
+      return true;
+    }
+    return false;
+  }
+
+  bool spinForJob(WorkerDeque *q) {
+    int spins = q->spins;
+    for (int i = 0; i < spins; i++) {
+      if (*(volatile int *)&m_jobCount > 0) {
+        if (spins < MaxSpins) q->spins = spins * 2;
+        return true;
+      }
+#if defined(__x86_64__) || defined(__i386__)
+      asm volatile("pause");
+#endif
+    }
+    if (spins > MinSpins) q->spins = spins / 2;
+    return false;
+  }
+
+  TJob dequeueStealing(int id, bool inc) {
+    ASSERT(id >= 0);
+    WorkerDeque *own = m_deques[id % m_deques.size()];
+    bool flushed = false;
+    while (true) {
+      TJob job;
+      if (takeJob(id % m_deques.size(), job)) {
+        // Counted as active before the job stops being queued, so waitEmpty()
+        // never sees both at zero while a job is in flight.
+        if (inc) incActiveWorker();
+        atomic_dec(m_jobCount);
+        return job;
+      }
+      if (spinForJob(own)) continue;
+
+      Lock lock(this);
+      atomic_inc(m_sleepers);
+      if (*(volatile int *)&m_jobCount > 0) {
+        atomic_dec(m_sleepers);
+        continue;
+      }
+      if (m_stopped) {
+        atomic_dec(m_sleepers);
+        throw StopSignal();
+      }
+      if (m_dropCacheTimeout <= 0 || flushed) {
+        wait(id, false);
+      } else if (!wait(id, true, m_dropCacheTimeout)) {
+        // since we timed out, maybe we can turn idle without holding memory
+        if (*(volatile int *)&m_jobCount <= 0) {
+          Util::flush_thread_caches();
+          if (m_dropStack && Util::s_stackLimit) {
+            Util::flush_thread_stack();
+          }
+          flushed = true;
+        }
+      }
+      atomic_dec(m_sleepers);
+    }
+  }
 };
 
 template<typename TJob>
 class JobQueue<TJob,true> : public JobQueue<TJob,false> {
 public:
   JobQueue(int threadCount, bool threadRoundRobin, int dropCacheTimeout,
-           bool dropStack, bool lifo) :
+           bool dropStack, bool lifo, bool workStealing = false) :
     JobQueue<TJob,false>(threadCount, threadRoundRobin, dropCacheTimeout,
-                         dropStack, lifo) {
+                         dropStack, lifo, workStealing) {
     pthread_cond_init(&m_cond, NULL);
   }
   ~JobQueue() {
@@ -299,10 +431,10 @@ public:
    */
   JobQueueDispatcher(int threadCount, bool threadRoundRobin,
                      int dropCacheTimeout, bool dropStack, void *opaque,
-                     bool lifo = false)
+                     bool lifo = false, bool workStealing = false)
       : m_stopped(true), m_id(0), m_opaque(opaque),
         m_queue(threadCount, threadRoundRobin, dropCacheTimeout, dropStack,
-                lifo) {
+                lifo, workStealing) {
     ASSERT(threadCount >= 1);
     for (int i = 0; i < threadCount; i++) {
       addWorkerImpl(false);
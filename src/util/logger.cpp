@@ -22,6 +22,7 @@
 #include "util.h"
 #include "log_aggregator.h"
 #include "text_color.h"
+#include "async_log_writer.h"
 #include <util/atomic.h>
 
 using namespace std;
@@ -29,14 +30,17 @@ using namespace std;
 #define IMPLEMENT_LOGLEVEL(LOGLEVEL, err)                               \
   void Logger::LOGLEVEL(const char *fmt, ...) {                         \
     if (LogLevel < Log ## LOGLEVEL) return;                             \
+    SyncScope sync(Log ## LOGLEVEL == LogError);                        \
     va_list ap; va_start(ap, fmt); Log(err, fmt, ap); va_end(ap);       \
   }                                                                     \
   void Logger::LOGLEVEL(const std::string &msg) {                       \
     if (LogLevel < Log ## LOGLEVEL) return;                             \
+    SyncScope sync(Log ## LOGLEVEL == LogError);                        \
     Log(err, msg, NULL);                                                \
   }                                                                     \
   void Logger::Raw ## LOGLEVEL(const std::string &msg) {                \
     if (LogLevel < Log ## LOGLEVEL) return;                             \
+    SyncScope sync(Log ## LOGLEVEL == LogError);                        \
     Log(err, msg, NULL, false);                                         \
   }                                                                     \
 
@@ -44,6 +48,10 @@ namespace HPHP {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// how long an error line waits for a thread that is writing out the queues
+// before leaving the rest to the writer thread
+static const int SyncDrainTimeout = 1000; // in milliseconds
+
 IMPLEMENT_LOGLEVEL(Error,   true);
 IMPLEMENT_LOGLEVEL(Warning, true);
 IMPLEMENT_LOGLEVEL(Info,    false);
@@ -65,6 +73,10 @@ bool Logger::LogHeader = false;
 bool Logger::LogNativeStackTrace = true;
 std::string Logger::ExtraHeader;
 int Logger::MaxMessagesPerRequest = -1;
+bool Logger::UseAsyncWriter = false;
+int Logger::s_asyncTarget = -1;
+FILE *Logger::s_asyncOutput = NULL;
+Logger::PFUNC_DROPPED Logger::s_droppedHook = NULL;
 IMPLEMENT_THREAD_LOCAL(Logger::ThreadData, Logger::s_threadData);
 
 Logger *Logger::s_logger = new Logger();
@@ -143,8 +155,15 @@ void Logger::log(bool err, const std::string &msg,
   }
   FILE *stdf = err ? stderr : stdout;
   if (UseLogFile) {
-    FILE *f;
-    if (UseCronolog) {
+    // SetNewOutput() may have switched the output to a file the writer
+    // thread does not know about
+    bool async = s_asyncTarget >= 0 && AsyncLogWriter::TheWriter.isRunning() &&
+      UseCronolog == (s_asyncOutput == NULL) &&
+      (UseCronolog || Output == s_asyncOutput);
+    FILE *f = NULL;
+    if (async) {
+      // written by AsyncLogWriter's thread
+    } else if (UseCronolog) {
       f = cronOutput.getOutputFile();
       if (!f) f = stdf;
     } else {
@@ -161,16 +180,33 @@ void Logger::log(bool err, const std::string &msg,
     }
     const char *escaped = escape ? EscapeString(msg) : msg.c_str();
     const char *ending = escapeMore ? "\\n" : "\n";
-    int bytes;
-    if (f == stdf && Util::s_stderr_color) {
-      bytes =
-        fprintf(f, "%s%s%s%s%s",
-                Util::s_stderr_color, sheader.c_str(), msg.c_str(), ending,
-                ANSI_COLOR_END);
+    if (async) {
+      string line = sheader;
+      line += escaped;
+      line += ending;
+      AsyncLogWriter &writer = AsyncLogWriter::TheWriter;
+      if (threadData->sync) {
+        // makes room for the line, too, as only this thread adds to its queue
+        writer.tryDrain(SyncDrainTimeout);
+      }
+      if (!writer.write(s_asyncTarget, line) && s_droppedHook) {
+        s_droppedHook();
+      }
+      if (threadData->sync) {
+        writer.tryDrain(SyncDrainTimeout);
+      }
     } else {
-      bytes = fprintf(f, "%s%s%s", sheader.c_str(), escaped, ending);
+      int bytes;
+      if (f == stdf && Util::s_stderr_color) {
+        bytes =
+          fprintf(f, "%s%s%s%s%s",
+                  Util::s_stderr_color, sheader.c_str(), msg.c_str(), ending,
+                  ANSI_COLOR_END);
+      } else {
+        bytes = fprintf(f, "%s%s%s", sheader.c_str(), escaped, ending);
+      }
+      atomic_add(bytesWritten, bytes);
     }
-    atomic_add(bytesWritten, bytes);
     FILE *tf = threadData->log;
     if (tf) {
       threadData->bytesWritten +=
@@ -188,9 +224,11 @@ void Logger::log(bool err, const std::string &msg,
       free((void*)escaped);
     }
 
-    fflush(f);
-    if (UseCronolog || (Output && !Logger::IsPipeOutput)) {
-      checkDropCache(bytesWritten, prevBytesWritten, f);
+    if (!async) {
+      fflush(f);
+      if (UseCronolog || (Output && !Logger::IsPipeOutput)) {
+        checkDropCache(bytesWritten, prevBytesWritten, f);
+      }
     }
   }
 }
@@ -266,12 +304,40 @@ void Logger::ClearThreadLog() {
   threadData->log = NULL;
 }
 
+Logger::SyncScope::SyncScope(bool sync)
+  : m_threadData(sync ? s_threadData.get() : NULL) {
+  if (m_threadData) ++m_threadData->sync;
+}
+
+Logger::SyncScope::~SyncScope() {
+  if (m_threadData) --m_threadData->sync;
+}
+
 void Logger::SetThreadHook(PFUNC_LOG func, void *data) {
   ThreadData *threadData = s_threadData.get();
   threadData->hook = func;
   threadData->hookData = data;
 }
 
+void Logger::StartAsyncWriter() {
+  if (s_asyncTarget < 0 && UseLogFile) {
+    if (UseCronolog) {
+      if (!cronOutput.m_template.empty() || cronOutput.m_file) {
+        s_asyncTarget = AsyncLogWriter::TheWriter.addTarget(&cronOutput);
+      }
+    } else if (Output) {
+      s_asyncOutput = Output;
+      s_asyncTarget = AsyncLogWriter::TheWriter.addTarget(Output,
+                                                          IsPipeOutput);
+    }
+  }
+  AsyncLogWriter::TheWriter.start();
+}
+
+void Logger::StopAsyncWriter() {
+  AsyncLogWriter::TheWriter.stop();
+}
+
 void Logger::SetNewOutput(FILE *output) {
   Logger::UseCronolog = false;
   ThreadData *threadData = s_threadData.get();
@@ -61,6 +61,7 @@ public:
   static bool LogNativeStackTrace;
   static std::string ExtraHeader;
   static int MaxMessagesPerRequest;
+  static bool UseAsyncWriter;
 
   static void Error(const std::string &msg);
   static void Warning(const std::string &msg);
@@ -88,6 +89,23 @@ public:
   static void ClearThreadLog();
   static void SetNewOutput(FILE *output);
 
+  /**
+   * While started, lines for the log file are written by AsyncLogWriter's
+   * thread. Thread logs and hooks are still called on the logging thread.
+   * Error lines are written out before Error() returns, along with all lines
+   * queued before them, so they make it to disk even if the process dies
+   * right after.
+   */
+  static void StartAsyncWriter();
+  static void StopAsyncWriter();
+
+  /**
+   * Called on the logging thread for each line the async writer dropped
+   * because the thread's queue was full.
+   */
+  typedef void (*PFUNC_DROPPED)();
+  static void SetDroppedHook(PFUNC_DROPPED func) { s_droppedHook = func;}
+
   typedef void (*PFUNC_LOG)(const char *header, const char *msg,
                             const char *ending, void *data);
   static void SetThreadHook(PFUNC_LOG func, void *data);
@@ -108,9 +126,10 @@ public:
 protected:
   class ThreadData {
   public:
-    ThreadData() : request(0), message(0), log(NULL), hook(NULL) {}
+    ThreadData() : request(0), message(0), sync(0), log(NULL), hook(NULL) {}
     int request;
     int message;
+    int sync;
     int bytesWritten;
     int prevBytesWritten;
     FILE *log;
@@ -119,6 +138,18 @@ protected:
   };
   static DECLARE_THREAD_LOCAL(ThreadData, s_threadData);
 
+  /**
+   * Lines logged by this thread while one is in scope with sync set don't
+   * wait in the async writer's queue.
+   */
+  class SyncScope {
+  public:
+    SyncScope(bool sync);
+    ~SyncScope();
+  private:
+    ThreadData *m_threadData;
+  };
+
   static void Log(bool err, const char *fmt, va_list ap);
   static void LogEscapeMore(bool err, const char *fmt, va_list ap);
   static void Log(bool err, const std::string &msg,
@@ -141,6 +172,9 @@ protected:
   static std::string GetHeader();
 private:
   static Logger *s_logger;
+  static int s_asyncTarget;
+  static FILE *s_asyncOutput; // NULL when writing to cronOutput
+  static PFUNC_DROPPED s_droppedHook;
 
 };
 
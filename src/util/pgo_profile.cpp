@@ -0,0 +1,152 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "pgo_profile.h"
+#include "util.h"
+
+using namespace std;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+void PgoProfile::addStack(const vector<string> &frames, int64 count) {
+  if (frames.empty() || count <= 0) return;
+  m_samples += count;
+  m_functions[frames.back()].self += count;
+
+  // recursive functions count once per sample
+  set<string> seen;
+  for (unsigned int i = 0; i < frames.size(); i++) {
+    if (seen.insert(frames[i]).second) {
+      m_functions[frames[i]].total += count;
+    }
+    if (i > 0) {
+      m_calls[make_pair(frames[i - 1], frames[i])] += count;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// file format
+
+void PgoProfile::parse(const char *line) {
+  vector<string> fields;
+  Util::split('\t', line, fields);
+  if (fields.size() == 4 && fields[0] == "f") {
+    Counts &counts = m_functions[fields[3]];
+    int64 self = atoll(fields[1].c_str());
+    counts.self += self;
+    counts.total += atoll(fields[2].c_str());
+    m_samples += self;
+  } else if (fields.size() == 4 && fields[0] == "c") {
+    m_calls[make_pair(fields[2], fields[3])] += atoll(fields[1].c_str());
+  }
+}
+
+bool PgoProfile::load(const char *filename) {
+  FILE *f = fopen(filename, "r");
+  if (f == NULL) return false;
+  char line[4096];
+  while (fgets(line, sizeof(line), f)) {
+    int len = strlen(line);
+    if (len > 0 && line[len - 1] == '\n') line[len - 1] = '\0';
+    parse(line);
+  }
+  fclose(f);
+  return true;
+}
+
+void PgoProfile::write(string &out) const {
+  char buf[64];
+  for (CountMap::const_iterator iter = m_functions.begin();
+       iter != m_functions.end(); ++iter) {
+    snprintf(buf, sizeof(buf), "f\t%lld\t%lld\t",
+             iter->second.self, iter->second.total);
+    out += buf;
+    out += iter->first;
+    out += '\n';
+  }
+  for (CallMap::const_iterator iter = m_calls.begin();
+       iter != m_calls.end(); ++iter) {
+    snprintf(buf, sizeof(buf), "c\t%lld\t", iter->second);
+    out += buf;
+    out += iter->first.first;
+    out += '\t';
+    out += iter->first.second;
+    out += '\n';
+  }
+}
+
+bool PgoProfile::save(const char *filename) const {
+  string out;
+  write(out);
+  // readers never see a half written profile
+  string tmp = string(filename) + ".tmp";
+  FILE *f = fopen(tmp.c_str(), "w");
+  if (f == NULL) return false;
+  bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+  ok = fclose(f) == 0 && ok;
+  if (!ok || rename(tmp.c_str(), filename) != 0) {
+    unlink(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// queries
+
+int64 PgoProfile::getSelf(const string &name) const {
+  CountMap::const_iterator iter = m_functions.find(name);
+  return iter == m_functions.end() ? 0 : iter->second.self;
+}
+
+int64 PgoProfile::getTotal(const string &name) const {
+  CountMap::const_iterator iter = m_functions.find(name);
+  return iter == m_functions.end() ? 0 : iter->second.total;
+}
+
+int64 PgoProfile::getCalls(const string &caller, const string &callee) const {
+  CallMap::const_iterator iter = m_calls.find(make_pair(caller, callee));
+  return iter == m_calls.end() ? 0 : iter->second;
+}
+
+static bool by_self(const pair<int64, string> &a,
+                    const pair<int64, string> &b) {
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+void PgoProfile::getHotFunctions(double coverage,
+                                 vector<string> &names) const {
+  vector<pair<int64, string> > functions;
+  for (CountMap::const_iterator iter = m_functions.begin();
+       iter != m_functions.end(); ++iter) {
+    if (iter->second.self > 0) {
+      functions.push_back(make_pair(iter->second.self, iter->first));
+    }
+  }
+  sort(functions.begin(), functions.end(), by_self);
+
+  int64 covered = 0;
+  for (unsigned int i = 0; i < functions.size(); i++) {
+    if (covered >= coverage * m_samples) break;
+    covered += functions[i].first;
+    names.push_back(functions[i].second);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
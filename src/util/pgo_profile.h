@@ -0,0 +1,86 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __PGO_PROFILE_H__
+#define __PGO_PROFILE_H__
+
+#include "base.h"
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Profile for a profile-guided second pass of the compiler, built from PHP
+ * stacks sampled out of production requests. For each function it counts
+ * the samples it was running in (self) and the samples it was anywhere on
+ * the stack in (total). For each caller and callee pair it counts the
+ * samples with the callee called directly from the caller.
+ *
+ * The file format is text, one tab separated record per line, so profiles
+ * taken from several servers can simply be concatenated:
+ *
+ *   f <self> <total> <function>
+ *   c <samples> <caller> <callee>
+ */
+class PgoProfile {
+public:
+  PgoProfile() : m_samples(0) {}
+
+  /**
+   * One sampled stack, outermost frame first, seen count times.
+   */
+  void addStack(const std::vector<std::string> &frames, int64 count);
+
+  /**
+   * Adds a saved profile to this one.
+   */
+  bool load(const char *filename);
+  bool save(const char *filename) const;
+  void write(std::string &out) const;
+
+  bool empty() const { return m_samples == 0; }
+  int64 getSamples() const { return m_samples; }
+  int64 getSelf(const std::string &name) const;
+  int64 getTotal(const std::string &name) const;
+  int64 getCalls(const std::string &caller, const std::string &callee) const;
+
+  /**
+   * The functions that together run in coverage (0 to 1) of all samples,
+   * hottest first.
+   */
+  void getHotFunctions(double coverage,
+                       std::vector<std::string> &names) const;
+
+private:
+  struct Counts {
+    Counts() : self(0), total(0) {}
+    int64 self;
+    int64 total;
+  };
+  typedef hphp_hash_map<std::string, Counts, string_hash> CountMap;
+  typedef std::map<std::pair<std::string, std::string>, int64> CallMap;
+
+  int64 m_samples;
+  CountMap m_functions;
+  CallMap m_calls;
+
+  void parse(const char *line);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __PGO_PROFILE_H__
@@ -19,6 +19,7 @@
 #include "base.h"
 #include "lock.h"
 #include "logger.h"
+#include "async_log_writer.h"
 #include "util.h"
 
 #include <execinfo.h>
@@ -96,6 +97,10 @@ static void bt_handler(int sig) {
 
   Logger::Error("Core dumped: %s", strsignal(sig));
 
+  // Lines still queued for the async log writer die with the process. Other
+  // threads may have queued some, or errors may not be logged at all.
+  AsyncLogWriter::TheWriter.tryDrain(1000);
+
   // re-raise the signal and pass it to the default handler
   // to terminate the process.
   raise(sig);
@@ -0,0 +1,381 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#include "stat_cache.h"
+#include "atomic.h"
+#include "hash.h"
+#include "lock.h"
+#include "logger.h"
+
+using namespace std;
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+static const uint32_t WatchMask =
+  IN_ATTRIB | IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+  IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+// events that can change what any path under the directory resolves to
+static const uint32_t FlushMask =
+  IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+  IN_MOVE_SELF | IN_UNMOUNT | IN_Q_OVERFLOW | IN_IGNORED;
+
+/**
+ * Cached results for one path. Only the writer holding m_lock changes the
+ * fields below version, bumping version to odd before and back to even
+ * after, so readers can copy them out and retry if version moved.
+ */
+struct StatCache::Node {
+  Node(const char *p, Node *n)
+    : path(p), next(n), version(0), statGen(-1), statErrno(0),
+      statExpires(0), realpathGen(-1), realpathErrno(0), realpath(NULL),
+      realpathExpires(0) {
+    memset(&st, 0, sizeof(st));
+  }
+
+  const std::string path;
+  Node * const next;
+  volatile uint32_t version;
+
+  int statGen;          // m_gen the result was read in, -1 if none
+  int statErrno;
+  struct stat st;
+  time_t statExpires;   // 0 if watched
+
+  int realpathGen;
+  int realpathErrno;
+  const char *realpath; // interned in m_names
+  time_t realpathExpires;
+
+  void beginWrite() {
+    version++;
+    __sync_synchronize();
+  }
+  void endWrite() {
+    __sync_synchronize();
+    version++;
+  }
+
+  bool readStat(int gen, struct stat *buf, int &err) const {
+    while (true) {
+      uint32_t v = version;
+      if (v & 1) continue;
+      __sync_synchronize();
+      bool valid = statGen == gen;
+      time_t expires = statExpires;
+      err = statErrno;
+      if (valid && !err) memcpy(buf, &st, sizeof(st));
+      __sync_synchronize();
+      if (version != v) continue;
+      return valid && (!expires || time(NULL) < expires);
+    }
+  }
+
+  bool readRealpath(int gen, const char *&resolved, int &err) const {
+    while (true) {
+      uint32_t v = version;
+      if (v & 1) continue;
+      __sync_synchronize();
+      bool valid = realpathGen == gen;
+      time_t expires = realpathExpires;
+      err = realpathErrno;
+      resolved = realpath;
+      __sync_synchronize();
+      if (version != v) continue;
+      return valid && (!expires || time(NULL) < expires);
+    }
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// static interface
+
+StatCache *StatCache::s_cache = NULL;
+
+void StatCache::Start(int revalidateSeconds) {
+  if (s_cache) return;
+  StatCache *cache = new StatCache(revalidateSeconds);
+  if (cache->m_fd >= 0) cache->m_thread.start();
+  __sync_synchronize();
+  s_cache = cache;
+}
+
+void StatCache::Stop() {
+  StatCache *cache = s_cache;
+  if (!cache) return;
+  s_cache = NULL;
+  cache->m_stopped = true;
+  cache->m_thread.waitForEnd();
+  // lookups that started before s_cache was cleared may still be walking
+  // the table, so it is left allocated
+}
+
+int StatCache::Stat(const char *path, struct stat *buf) {
+  StatCache *cache = s_cache;
+  if (!cache || path[0] != '/') return ::stat(path, buf);
+  return cache->stat(path, buf);
+}
+
+char *StatCache::Realpath(const char *path, char *resolved) {
+  StatCache *cache = s_cache;
+  if (!cache || path[0] != '/') return ::realpath(path, resolved);
+  return cache->realpath(path, resolved);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+StatCache::StatCache(int revalidateSeconds)
+  : m_fd(-1), m_revalidate(revalidateSeconds), m_stopped(false), m_gen(0),
+    m_thread(this, &StatCache::watch), m_warned(false) {
+  memset((void*)m_buckets, 0, sizeof(m_buckets));
+  m_fd = inotify_init();
+  if (m_fd < 0) {
+    Logger::Warning("StatCache: inotify_init() failed (%s), revalidating "
+                    "entries every %d seconds instead",
+                    strerror(errno), m_revalidate);
+  }
+}
+
+StatCache::~StatCache() {
+  if (m_fd >= 0) close(m_fd);
+}
+
+StatCache::Node *StatCache::find(const char *path, int64 hash) const {
+  for (Node *node = m_buckets[hash & (BucketCount - 1)]; node;
+       node = node->next) {
+    if (node->path == path) return node;
+  }
+  return NULL;
+}
+
+StatCache::Node *StatCache::getNode(const char *path, int64 hash) {
+  Node *node = find(path, hash);
+  if (!node) {
+    Node * volatile &bucket = m_buckets[hash & (BucketCount - 1)];
+    node = new Node(path, bucket);
+    // publish the node only after it is fully constructed
+    __sync_synchronize();
+    bucket = node;
+  }
+  return node;
+}
+
+bool StatCache::watchDir(const string &dir) {
+  // a directory is only in m_dirs when all its ancestors are watched too
+  if (m_dirs.find(dir) != m_dirs.end()) return true;
+  if (m_fd < 0) return false;
+  if (dir != "/") {
+    size_t pos = dir.rfind('/');
+    if (!watchDir(pos ? dir.substr(0, pos) : string("/"))) return false;
+  }
+  int wd = inotify_add_watch(m_fd, dir.c_str(), WatchMask);
+  if (wd < 0) {
+    if (errno == ENOSPC && !m_warned) {
+      m_warned = true;
+      Logger::Warning("StatCache: out of inotify watches, revalidating "
+                      "entries every %d seconds instead", m_revalidate);
+    }
+    return false;
+  }
+  m_dirs[dir] = wd;
+  m_wds[wd].push_back(dir);
+  return true;
+}
+
+bool StatCache::watchParent(const char *path) {
+  const char *slash = strrchr(path, '/');
+  if (slash == path) return watchDir("/");
+  return watchDir(string(path, slash - path));
+}
+
+time_t StatCache::expiry(bool watched) const {
+  return watched ? 0 : time(NULL) + m_revalidate;
+}
+
+int StatCache::stat(const char *path, struct stat *buf) {
+  int64 hash = hash_string(path, strlen(path));
+  int err;
+  Node *node = find(path, hash);
+  if (node && node->readStat(m_gen, buf, err)) {
+    if (!err) return 0;
+    errno = err;
+    return -1;
+  }
+
+  Lock lock(m_lock);
+  node = getNode(path, hash);
+  // watch before looking, so that no change after the stat() goes unseen
+  int gen = m_gen;
+  bool watched = watchParent(path);
+  int ret = ::stat(path, buf);
+  err = ret ? errno : 0;
+  if ((watched || m_revalidate > 0) && (!err || err == ENOENT)) {
+    node->beginWrite();
+    node->statGen = gen;
+    node->statErrno = err;
+    if (!err) node->st = *buf;
+    node->statExpires = expiry(watched);
+    node->endWrite();
+  }
+  errno = err;
+  return ret;
+}
+
+char *StatCache::realpath(const char *path, char *resolved) {
+  int64 hash = hash_string(path, strlen(path));
+  const char *cached;
+  int err;
+  Node *node = find(path, hash);
+  if (node && node->readRealpath(m_gen, cached, err)) {
+    if (!cached) {
+      errno = err;
+      return NULL;
+    }
+    strcpy(resolved, cached);
+    return resolved;
+  }
+
+  Lock lock(m_lock);
+  node = getNode(path, hash);
+  int gen = m_gen;
+  bool watched = watchParent(path);
+  char *ret = ::realpath(path, resolved);
+  err = ret ? 0 : errno;
+  if (ret) watched = watchParent(resolved) && watched;
+  if ((watched || m_revalidate > 0) && (!err || err == ENOENT)) {
+    node->beginWrite();
+    node->realpathGen = gen;
+    node->realpathErrno = err;
+    node->realpath = ret ? m_names.insert(ret).first->c_str() : NULL;
+    node->realpathExpires = expiry(watched);
+    node->endWrite();
+  }
+  errno = err;
+  return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// inotify thread
+
+void StatCache::watch() {
+  char buf[64 * 1024]
+    __attribute__((aligned(__alignof__(struct inotify_event))));
+  while (!m_stopped) {
+    struct pollfd fds;
+    fds.fd = m_fd;
+    fds.events = POLLIN;
+    fds.revents = 0;
+    if (poll(&fds, 1, 1000) <= 0) continue;
+    ssize_t len = read(m_fd, buf, sizeof(buf));
+    for (char *p = buf; len > 0 && p < buf + len; ) {
+      struct inotify_event *event = (struct inotify_event *)p;
+      onEvent(event);
+      p += sizeof(struct inotify_event) + event->len;
+    }
+  }
+}
+
+void StatCache::onEvent(const struct inotify_event *event) {
+  if (event->mask & IN_IGNORED) {
+    // also sent for the watches reset() removes
+    Lock lock(m_lock);
+    if (m_wds.find(event->wd) == m_wds.end()) return;
+  }
+  if (event->mask & FlushMask) {
+    if (event->mask & (IN_MOVE_SELF | IN_IGNORED | IN_Q_OVERFLOW)) {
+      // watched paths no longer match what is watched
+      reset();
+    } else {
+      unwatch(event);
+    }
+    return;
+  }
+
+  Lock lock(m_lock);
+  hphp_hash_map<int, vector<string> >::const_iterator iter =
+    m_wds.find(event->wd);
+  if (iter == m_wds.end()) return;
+  for (unsigned int i = 0; i < iter->second.size(); i++) {
+    string path = iter->second[i];
+    if (event->len) {
+      if (path != "/") path += '/';
+      path += event->name;
+    }
+    Node *node = find(path.c_str(), hash_string(path.data(), path.size()));
+    if (node) {
+      node->beginWrite();
+      node->statGen = -1;
+      node->endWrite();
+    }
+  }
+}
+
+void StatCache::unwatch(const struct inotify_event *event) {
+  Lock lock(m_lock);
+  hphp_hash_map<int, vector<string> >::const_iterator iter =
+    m_wds.find(event->wd);
+  if (iter != m_wds.end() && event->len) {
+    // A symlink or directory swapped in under a watched directory: watches
+    // on directories under the old one don't see changes to the new one.
+    vector<string> changed;
+    for (unsigned int i = 0; i < iter->second.size(); i++) {
+      string path = iter->second[i];
+      if (path != "/") path += '/';
+      changed.push_back(path + event->name);
+    }
+    vector<string> dirs;
+    for (hphp_hash_map<string, int, string_hash>::const_iterator diter =
+           m_dirs.begin(); diter != m_dirs.end(); ++diter) {
+      const string &dir = diter->first;
+      for (unsigned int i = 0; i < changed.size(); i++) {
+        const string &path = changed[i];
+        if (dir.compare(0, path.size(), path) == 0 &&
+            (dir.size() == path.size() || dir[path.size()] == '/')) {
+          dirs.push_back(dir);
+          break;
+        }
+      }
+    }
+    for (unsigned int i = 0; i < dirs.size(); i++) {
+      int wd = m_dirs[dirs[i]];
+      m_dirs.erase(dirs[i]);
+      vector<string> &paths = m_wds[wd];
+      paths.erase(std::find(paths.begin(), paths.end(), dirs[i]));
+      if (paths.empty()) {
+        inotify_rm_watch(m_fd, wd);
+        m_wds.erase(wd);
+      }
+    }
+  }
+  // a miss can't see the new generation while a stale watch is left
+  atomic_inc(m_gen);
+}
+
+void StatCache::reset() {
+  Lock lock(m_lock);
+  if (m_wds.empty()) return;
+  for (hphp_hash_map<int, vector<string> >::const_iterator iter =
+         m_wds.begin(); iter != m_wds.end(); ++iter) {
+    inotify_rm_watch(m_fd, iter->first);
+  }
+  m_wds.clear();
+  m_dirs.clear();
+  atomic_inc(m_gen);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,107 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __STAT_CACHE_H__
+#define __STAT_CACHE_H__
+
+#include "base.h"
+#include "async_func.h"
+#include "mutex.h"
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Process-wide cache of stat() and realpath() results for absolute paths,
+ * so that resolving the same include files on every request doesn't cost
+ * syscalls each time.
+ *
+ * Entries are kept current with inotify. Every directory on the way to a
+ * cached path is watched. A file's content or attribute event drops that
+ * file's entry. A create, delete or rename in any watched directory drops
+ * every entry, since a replaced symlink or directory can change what any
+ * path under it resolves to, and drops the watches under it, which may be
+ * on what used to be there. Entries under a directory that can't be
+ * watched, because inotify is unavailable or out of watches, are trusted
+ * for revalidateSeconds only.
+ *
+ * Lookups take no locks. Each path has one node that is never freed, so
+ * only paths the server itself resolves belong here, not ones taken from
+ * requests. Node contents are guarded by a sequence counter. Misses and
+ * inotify events are serialized on a mutex.
+ *
+ * Until Start() is called, Stat() and Realpath() simply call stat() and
+ * realpath().
+ */
+class StatCache {
+public:
+  static void Start(int revalidateSeconds);
+  static void Stop();
+
+  /**
+   * Same contract as stat(2): 0, or -1 with errno set.
+   */
+  static int Stat(const char *path, struct stat *buf);
+
+  /**
+   * Same contract as realpath(3); resolved must have room for PATH_MAX
+   * bytes.
+   */
+  static char *Realpath(const char *path, char *resolved);
+
+  void watch();
+
+private:
+  struct Node;
+  static const int BucketCount = 16384;
+  static StatCache *s_cache;
+
+  int m_fd;
+  int m_revalidate;
+  volatile bool m_stopped;
+  int m_gen;
+  Node * volatile m_buckets[BucketCount];
+  AsyncFunc<StatCache> m_thread;
+
+  // guarded by m_lock
+  Mutex m_lock;
+  hphp_hash_map<std::string, int, string_hash> m_dirs;
+  hphp_hash_map<int, std::vector<std::string> > m_wds;
+  std::set<std::string> m_names;
+  bool m_warned;
+
+  StatCache(int revalidateSeconds);
+  ~StatCache();
+
+  Node *find(const char *path, int64 hash) const;
+  Node *getNode(const char *path, int64 hash);
+  bool watchDir(const std::string &dir);
+  bool watchParent(const char *path);
+  time_t expiry(bool watched) const;
+  void onEvent(const struct inotify_event *event);
+  void unwatch(const struct inotify_event *event);
+  void reset();
+
+  int stat(const char *path, struct stat *buf);
+  char *realpath(const char *path, char *resolved);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __STAT_CACHE_H__
@@ -45,7 +45,12 @@ bool Synchronizable::wait(long seconds, long long nanosecs) {
   struct timespec ts;
   gettime(CLOCK_REALTIME, &ts);
   ts.tv_sec += seconds;
-  ts.tv_nsec += nanosecs;
+  ts.tv_sec += nanosecs / 1000000000;
+  ts.tv_nsec += nanosecs % 1000000000;
+  if (ts.tv_nsec >= 1000000000) {
+    ts.tv_sec++;
+    ts.tv_nsec -= 1000000000;
+  }
 
   int ret = pthread_cond_timedwait(&m_cond, &m_mutex.getRaw(), &ts);
   ASSERT(ret != EPERM); // did you lock the mutex?
@@ -0,0 +1,521 @@
+/*
+   +----------------------------------------------------------------------+
+   | HipHop for PHP                                                       |
+   +----------------------------------------------------------------------+
+   | Copyright (c) 2010- Facebook, Inc. (http://www.facebook.com)         |
+   +----------------------------------------------------------------------+
+   | This source file is subject to version 3.01 of the PHP license,      |
+   | that is bundled with this package in the file LICENSE, and is        |
+   | available through the world-wide-web at the following url:           |
+   | http://www.php.net/license/3_01.txt                                  |
+   | If you did not receive a copy of the PHP license and are unable to   |
+   | obtain it through the world-wide-web, please send a note to          |
+   | license@php.net so we can mail you a copy immediately.               |
+   +----------------------------------------------------------------------+
+*/
+
+#ifndef __HPHP_UTIL_TINY_LFU_TABLE_H__
+#define __HPHP_UTIL_TINY_LFU_TABLE_H__
+
+#include <util/base.h>
+#include <util/lock.h>
+#include <util/logger.h>
+#include <util/lfu_table.h>
+
+namespace HPHP {
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Count-min sketch of 4-bit counters, four per key, packed sixteen to a
+ * 64-bit word. Counters saturate at 15 and are all halved once the number of
+ * increments reaches ten times the table size, so that keys that used to be
+ * popular fade out. Increments are atomic and may race with halving, in
+ * which case some of them are lost; the counts are only estimates anyway.
+ */
+class FrequencySketch {
+public:
+  FrequencySketch(size_t capacity) : m_additions(0) {
+    size_t size = 8;
+    while (size < capacity) size <<= 1;
+    m_table.resize(size);
+    m_tableMask = size - 1;
+    m_sampleSize = 10 * size;
+  }
+
+  void increment(uint64 hash) {
+    int start = (spread(hash) & 3) << 2;
+    bool added = false;
+    for (int i = 0; i < 4; i++) {
+      added |= incrementAt(indexOf(hash, i), start + i);
+    }
+    if (added &&
+        __sync_add_and_fetch(&m_additions, 1) == m_sampleSize) {
+      reset();
+    }
+  }
+
+  int frequency(uint64 hash) const {
+    int start = (spread(hash) & 3) << 2;
+    int freq = 15;
+    for (int i = 0; i < 4; i++) {
+      int count = (m_table[indexOf(hash, i)] >> ((start + i) << 2)) & 0xf;
+      if (count < freq) freq = count;
+    }
+    return freq;
+  }
+
+  void clear() {
+    for (size_t i = 0; i < m_table.size(); i++) {
+      m_table[i] = 0;
+    }
+    m_additions = 0;
+  }
+
+private:
+  std::vector<uint64> m_table;
+  size_t m_tableMask;
+  int64 m_sampleSize;
+  int64 m_additions;
+
+  static uint64 spread(uint64 h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  size_t indexOf(uint64 hash, int i) const {
+    static const uint64 seeds[] = {
+      0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+      0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL
+    };
+    uint64 h = (hash + seeds[i]) * seeds[i];
+    h += h >> 32;
+    return h & m_tableMask;
+  }
+
+  bool incrementAt(size_t index, int counter) {
+    uint64 *word = &m_table[index];
+    int shift = counter << 2;
+    for (;;) {
+      uint64 old = *word;
+      if (((old >> shift) & 0xf) == 0xf) return false;
+      if (__sync_bool_compare_and_swap(word, old, old + (1ULL << shift))) {
+        return true;
+      }
+    }
+  }
+
+  void reset() {
+    for (size_t i = 0; i < m_table.size(); i++) {
+      m_table[i] = (m_table[i] >> 1) & 0x7777777777777777ULL;
+    }
+    __sync_fetch_and_sub(&m_additions, m_sampleSize / 2);
+  }
+};
+
+/**
+ * A lookup table with a maximum size that evicts with the W-TinyLFU policy.
+ *
+ * New keys go into a small LRU window, about 1% of the capacity. Keys pushed
+ * out of the window are candidates for the main area, a segmented LRU with
+ * a probation and a protected (80%) segment. Once the table is full, the
+ * candidate is only admitted if its estimated frequency is higher than that
+ * of the least recently used key on probation, which is evicted instead.
+ * A hit on probation promotes the key to the protected segment, and the
+ * least recently used protected key goes back on probation when that
+ * segment overflows. Frequencies come from a FrequencySketch that counts
+ * every lookup, including misses, so a key that keeps getting evicted and
+ * fetched again will eventually get in.
+ *
+ * All of the bookkeeping is O(1) list splicing. Like LFUTable, there is a
+ * read/write lock for the map and a lock for the lists, acquired in that
+ * order. Lookups only try the list lock, and skip moving the key if another
+ * thread holds it; its frequency is still counted, which is what admission
+ * decisions are based on.
+ *
+ * Immortal keys are never evicted and don't count towards the capacity. If
+ * max capacity is 0, nothing is ever evicted and no list work is done.
+ */
+template<class K, class V, class H, class E,
+         class D = LFUNullDestructor<K, V> >
+class TinyLFUTable {
+  enum Segment {
+    Window,
+    Probation,
+    Protected,
+    Immortal,
+    Unbounded    // in a table without maximum capacity
+  };
+
+  class Node {
+  public:
+    Node(const K &k, uint64 h)
+      : key(k), prev(NULL), next(NULL), hash(h), segment(Window) {}
+    ~Node() {
+      D d;
+      d(key, val);
+    }
+    const K &key;
+    V val;
+    Node *prev;
+    Node *next;
+    uint64 hash;
+    Segment segment;
+  };
+
+  // Most recently used at the head
+  class List {
+  public:
+    List() : head(NULL), tail(NULL), size(0) {}
+    void pushFront(Node *n) {
+      n->prev = NULL;
+      n->next = head;
+      if (head) head->prev = n;
+      head = n;
+      if (!tail) tail = n;
+      ++size;
+    }
+    void remove(Node *n) {
+      if (n->prev) n->prev->next = n->next; else head = n->next;
+      if (n->next) n->next->prev = n->prev; else tail = n->prev;
+      n->prev = n->next = NULL;
+      --size;
+    }
+    void moveToFront(Node *n) {
+      if (n == head) return;
+      remove(n);
+      pushFront(n);
+    }
+    Node *head;
+    Node *tail;
+    size_t size;
+  };
+
+  class Map : public hphp_hash_map<K, Node*, H, E> {};
+
+public:
+  /**
+   * AtomicReader is used to perform a lookup under the internal
+   * lock of the table. It takes the read lock.
+   */
+  class AtomicReader {
+  public:
+    virtual ~AtomicReader() {}
+    virtual void read(const K &key, const V &val) = 0;
+  };
+  /**
+   * AtomicUpdater is used to perform a update/insert under the internal
+   * lock of the table. It takes the write lock.
+   * The update method is given a reference to the value in the table and
+   * a bool that specifies if the element was newly added.
+   * It the method returns true, the element is deleted.
+   */
+  class AtomicUpdater {
+  public:
+    virtual ~AtomicUpdater() {}
+    virtual bool update(const K &key, V &val, bool newlyCreated) = 0;
+  };
+
+public:
+  TinyLFUTable(size_t maxCap)
+    : m_sketch(maxCap), m_immortalCount(0), m_maximumCapacity(maxCap),
+      m_hits(0), m_misses(0), m_evictions(0) {
+    m_windowCapacity = maxCap / 100;
+    if (m_windowCapacity == 0) m_windowCapacity = 1;
+    size_t mainCapacity =
+      maxCap > m_windowCapacity ? maxCap - m_windowCapacity : 0;
+    m_protectedCapacity = mainCapacity * 8 / 10;
+  }
+  ~TinyLFUTable() {
+    clear();
+  }
+
+  void insert(const K &k, const V &v) {
+    WriteLock lock(m_mapLock);
+    // looking it up first counts the access in either case
+    if (_getNode(k)) _erase(k);
+    _createNode(k, false)->val = v;
+  }
+
+  bool atomicRead(const K &k, AtomicReader &reader) {
+    ReadLock lock(m_mapLock);
+    Node *n = _getNode(k);
+    if (n) {
+      atomic_add(m_hits, (int64)1);
+      reader.read(n->key, n->val);
+      return true;
+    }
+    atomic_add(m_misses, (int64)1);
+    return false;
+  }
+
+  void atomicForeach(AtomicReader &reader) {
+    ReadLock lock(m_mapLock);
+    for (typename Map::const_iterator it = m_map.begin();
+         it != m_map.end(); ++it) {
+      reader.read(it->first, it->second->val);
+    }
+  }
+
+  void atomicUpdate(const K &k, AtomicUpdater &updater, bool createNew,
+                    bool immortal = false) {
+    WriteLock lock(m_mapLock);
+    Node *n = _getNode(k);
+    bool created = false;
+    if (!n && createNew) {
+      n = _createNode(k, immortal);
+      created = true;
+    }
+    if (n && updater.update(n->key, n->val, created)) {
+      _erase(n->key);
+    }
+  }
+
+  void erase(const K &k) {
+    WriteLock lock(m_mapLock);
+    _erase(k);
+  }
+
+  bool lookup(const K &k, V &result) {
+    ReadLock lock(m_mapLock);
+    Node *n = _getNode(k);
+    if (n) {
+      atomic_add(m_hits, (int64)1);
+      result = n->val;
+      return true;
+    }
+    atomic_add(m_misses, (int64)1);
+    return false;
+  }
+
+  size_t size() const {
+    return m_map.size();
+  }
+  size_t maximumCapacity() const {
+    return m_maximumCapacity;
+  }
+  size_t immortalCount() const {
+    return m_immortalCount;
+  }
+
+  /**
+   * Lookups that found or didn't find their key, and keys evicted to make
+   * room, since the table was created or last cleared.
+   */
+  int64 hits() const { return m_hits; }
+  int64 misses() const { return m_misses; }
+  int64 evictions() const { return m_evictions; }
+
+  void clear() {
+    WriteLock lock(m_mapLock);
+    Lock qlock(m_queueLock);
+    typename Map::iterator it = m_map.begin();
+    while (it != m_map.end()) {
+      typename Map::iterator cit = it++;
+      Node *n = cit->second;
+      m_map.erase(cit);
+      delete n;
+    }
+    m_window = m_probation = m_protected = List();
+    m_immortalCount = 0;
+    m_sketch.clear();
+    m_hits = m_misses = m_evictions = 0;
+  }
+
+  bool check() {
+    WriteLock lock(m_mapLock);
+    Lock qlock(m_queueLock);
+
+    bool fail = false;
+    size_t mortal = checkList(m_window, Window, fail) +
+      checkList(m_probation, Probation, fail) +
+      checkList(m_protected, Protected, fail);
+    if (m_maximumCapacity) {
+      if (mortal + m_immortalCount != m_map.size()) {
+        fail = true;
+        Logger::Error("Value in map not in any segment");
+        ASSERT(!fail);
+      }
+      if (mortal > m_maximumCapacity) {
+        fail = true;
+        Logger::Error("Maximum capacity exceeded");
+        ASSERT(!fail);
+      }
+    }
+    return !fail;
+  }
+
+private:
+  //////////////////////////////////////////////////////////////////////////////
+  // These methods are to be used when the map lock is already acquired.
+
+  Node *_getNode(const K &k) {
+    H h;
+    uint64 hash = h(k);
+    if (m_maximumCapacity) m_sketch.increment(hash);
+    typename Map::iterator it = m_map.find(k);
+    if (it == m_map.end()) return NULL;
+    Node *n = it->second;
+    if (n->segment < Immortal && m_queueLock.tryLock()) {
+      onHit(n);
+      m_queueLock.unlock();
+    }
+    return n;
+  }
+
+  Node *_createNode(const K &k, bool immortal) {
+    H h;
+    typename Map::iterator ins =
+      m_map.insert(std::pair<const K, Node*>(k, NULL)).first;
+    Node *n = new Node(ins->first, h(k));
+    ins->second = n;
+    if (immortal) {
+      n->segment = Immortal;
+      ++m_immortalCount;
+      return n;
+    }
+    if (!m_maximumCapacity) {
+      n->segment = Unbounded;
+      return n;
+    }
+    Lock lock(m_queueLock);
+    m_window.pushFront(n);
+    if (m_window.size > m_windowCapacity) {
+      Node *candidate = m_window.tail;
+      m_window.remove(candidate);
+      candidate->segment = Probation;
+      m_probation.pushFront(candidate);
+    }
+    while (m_window.size + m_probation.size + m_protected.size >
+           m_maximumCapacity) {
+      evictOne();
+    }
+    return n;
+  }
+
+  void _erase(const K &k) {
+    typename Map::iterator it = m_map.find(k);
+    if (it == m_map.end()) return;
+    Node *n = it->second;
+    m_map.erase(it);
+    if (n->segment == Immortal) {
+      --m_immortalCount;
+    } else if (n->segment != Unbounded) {
+      Lock lock(m_queueLock);
+      listOf(n->segment).remove(n);
+    }
+    delete n;
+  }
+
+private:
+  //////////////////////////////////////////////////////////////////////////////
+  // List methods, to be used with both locks held.
+
+  List &listOf(Segment s) {
+    switch (s) {
+      case Window:    return m_window;
+      case Probation: return m_probation;
+      default:        return m_protected;
+    }
+  }
+
+  void onHit(Node *n) {
+    switch (n->segment) {
+      case Window:
+        m_window.moveToFront(n);
+        break;
+      case Probation:
+        m_probation.remove(n);
+        n->segment = Protected;
+        m_protected.pushFront(n);
+        if (m_protected.size > m_protectedCapacity) {
+          Node *demoted = m_protected.tail;
+          m_protected.remove(demoted);
+          demoted->segment = Probation;
+          m_probation.pushFront(demoted);
+        }
+        break;
+      case Protected:
+        m_protected.moveToFront(n);
+        break;
+      default:
+        break;
+    }
+  }
+
+  // The candidate that just left the window is at the head of probation, and
+  // competes against the key at its tail. Ties go to the incumbent, so that
+  // a burst of one-off keys can't flush the main area.
+  void evictOne() {
+    Node *victim;
+    if (m_probation.size > 1) {
+      Node *candidate = m_probation.head;
+      victim = m_probation.tail;
+      if (m_sketch.frequency(candidate->hash) <=
+          m_sketch.frequency(victim->hash)) {
+        victim = candidate;
+      }
+    } else if (m_probation.size) {
+      victim = m_probation.tail;
+    } else if (m_protected.size) {
+      victim = m_protected.tail;
+    } else {
+      victim = m_window.tail;
+    }
+    listOf(victim->segment).remove(victim);
+    m_map.erase(victim->key);
+    delete victim;
+    ++m_evictions;
+  }
+
+  size_t checkList(const List &list, Segment s, bool &fail) {
+    size_t count = 0;
+    Node *prev = NULL;
+    for (Node *n = list.head; n; prev = n, n = n->next) {
+      ++count;
+      if (m_map.find(n->key) == m_map.end()) {
+        fail = true;
+        Logger::Error("Value in segment not in map");
+        ASSERT(!fail);
+      }
+      if (n->prev != prev || n->segment != s) {
+        fail = true;
+        Logger::Error("Segment list corrupted");
+        ASSERT(!fail);
+      }
+    }
+    if (prev != list.tail || count != list.size) {
+      fail = true;
+      Logger::Error("Segment tail or size incorrect");
+      ASSERT(!fail);
+    }
+    return count;
+  }
+
+private:
+  Map m_map;
+  List m_window;
+  List m_probation;
+  List m_protected;
+  FrequencySketch m_sketch;
+  size_t m_immortalCount;
+
+  // Locks in acquisition order
+  ReadWriteMutex m_mapLock;
+  Mutex m_queueLock;
+
+  // Options
+  size_t m_maximumCapacity;
+  size_t m_windowCapacity;
+  size_t m_protectedCapacity;
+
+  int64 m_hits;
+  int64 m_misses;
+  int64 m_evictions;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}
+
+#endif // __HPHP_UTIL_TINY_LFU_TABLE_H__